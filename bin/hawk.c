@@ -98,10 +98,13 @@ struct arg_t
 {
 	hawk_parsestd_t* psin; /* input source streams */
 	hawk_bch_t*      osf;  /* output source file */
+	hawk_bch_t*      ctf;  /* compiled tree file */
+	hawk_bch_t*      pff;  /* profile output file */
 	hawk_main_xarg_t icf; /* input console files */
 	hawk_main_xarg_t ocf; /* output console files */
 	gvm_t            gvm; /* global variable map */
 	hawk_bch_t*      fs;   /* field separator */
+	int              jsonl; /* RS set to @jsonl */
 	hawk_bch_t*      call; /* function to call */
 	hawk_cmgr_t*     script_cmgr;
 	hawk_cmgr_t*     conin_cmgr;
@@ -251,6 +254,19 @@ static int apply_fs_and_gvs_to_rtx (hawk_rtx_t* rtx, const arg_t* arg)
 		hawk_rtx_refdownval(rtx, fs);
 	}
 
+	if (arg->jsonl)
+	{
+		hawk_val_t* rs;
+
+		/* read each input line as a JSON value into JSONREC */
+		rs = hawk_rtx_makestrvalwithbcstr(rtx, "@jsonl");
+		if (HAWK_UNLIKELY(!rs)) return -1;
+
+		hawk_rtx_refupval(rtx, rs);
+		hawk_rtx_setgbl(rtx, HAWK_GBL_RS, rs);
+		hawk_rtx_refdownval(rtx, rs);
+	}
+
 	if (arg->gvm.capa > 0)
 	{
 		/* set the value of user-defined global variables
@@ -416,12 +432,17 @@ static void print_usage (FILE* out, const hawk_bch_t* argv0, const hawk_bch_t* r
 	fprintf(out, "%s\n", _("                                   passed to the function as parameters"));
 	fprintf(out, "%s\n", _(" -f/--file            file         set the source script file"));
 	fprintf(out, "%s\n", _(" -d/--deparsed-file   file         set the deparsed script file to produce"));
+	fprintf(out, "%s\n", _(" --compile-to         file         save the parsed script to a file and exit."));
+	fprintf(out, "%s\n", _("                                   -f accepts the file produced"));
+	fprintf(out, "%s\n", _(" --profile            file         write the execution profile to a file."));
+	fprintf(out, "%s\n", _("                                   folded stacks go to file.folded"));
 	fprintf(out, "%s\n", _(" -t/--console-output  file         set the console output file"));
 	fprintf(out, "%s\n", _("                                   multiple -t options are allowed"));
 	fprintf(out, "%s\n", _(" -F/--field-separator string       set a field separator(FS)"));
 	fprintf(out, "%s\n", _(" -v/--assign          var=value    add a global variable with a value"));
 	fprintf(out, "%s\n", _(" -m/--memory-limit    number       limit the memory usage (bytes)"));
 	fprintf(out, "%s\n", _(" -w                                expand datafile wildcards"));
+	fprintf(out, "%s\n", _(" --jsonl                           read each input line as JSON into JSONREC"));
 
 #if defined(HAWK_OOCH_IS_UCH)
 	fprintf(out, "%s\n", _(" --script-encoding    string       specify script file encoding name"));
@@ -480,6 +501,8 @@ static int process_argv (int argc, hawk_bch_t* argv[], const hawk_bch_t* real_ar
 		{ ":call",             'c' },
 		{ ":file",             'f' },
 		{ ":deparsed-file",    'd' },
+		{ ":compile-to",       '\0' },
+		{ ":profile",          '\0' },
 		{ ":console-output",   't' },
 		{ ":field-separator",  'F' },
 		{ ":assign",           'v' },
@@ -491,6 +514,7 @@ static int process_argv (int argc, hawk_bch_t* argv[], const hawk_bch_t* real_ar
 		{ ":includedirs",      'I' },
 		{ ":modlibdirs",       '\0' },
 
+		{ "jsonl",             '\0' },
 		{ "modern",            '\0' },
 		{ "classic",           '\0' },
 
@@ -682,6 +706,10 @@ static int process_argv (int argc, hawk_bch_t* argv[], const hawk_bch_t* real_ar
 						goto oops;
 					}
 				}
+				else if (hawk_comp_bcstr(opt.lngopt, "jsonl", 0) == 0)
+				{
+					arg->jsonl = 1;
+				}
 				else if (hawk_comp_bcstr(opt.lngopt, "modern", 0) == 0)
 				{
 					arg->modern = 1;
@@ -694,6 +722,14 @@ static int process_argv (int argc, hawk_bch_t* argv[], const hawk_bch_t* real_ar
 				{
 					arg->modlibdirs = opt.arg;
 				}
+				else if (hawk_comp_bcstr(opt.lngopt, "compile-to", 0) == 0)
+				{
+					arg->ctf = opt.arg;
+				}
+				else if (hawk_comp_bcstr(opt.lngopt, "profile", 0) == 0)
+				{
+					arg->pff = opt.arg;
+				}
 				else
 				{
 					for (i = 0; opttab[i].name; i++)
@@ -831,6 +867,137 @@ static void print_hawk_rtx_error(hawk_rtx_t* rtx)
 	);
 }
 
+static int load_compiled (hawk_t* hawk, struct arg_t* arg)
+{
+	FILE* fp;
+	hawk_uint8_t hdr[16];
+	hawk_uint8_t* buf;
+	hawk_oow_t len, n;
+	long x;
+
+	/* a compiled file is recognized when it's the only source file given */
+	if (arg->psin[0].type != HAWK_PARSESTD_FILEB || arg->psin[1].type != HAWK_PARSESTD_NULL) return 0;
+
+	fp = fopen(arg->psin[0].u.fileb.path, "rb");
+	if (!fp) return 0; /* let hawk_parsestd() report the error */
+
+	len = fread(hdr, 1, HAWK_SIZEOF(hdr), fp);
+	if (!hawk_istree(hdr, len))
+	{
+		fclose(fp);
+		return 0;
+	}
+
+	buf = HAWK_NULL;
+	if (fseek(fp, 0, SEEK_END) <= -1 || (x = ftell(fp)) <= -1 || fseek(fp, 0, SEEK_SET) <= -1) goto oops;
+	len = x;
+	buf = (hawk_uint8_t*)malloc(len + 1);
+	if (!buf) goto oops;
+	n = fread(buf, 1, len, fp);
+	if (n != len) goto oops;
+	fclose(fp);
+
+	/* the sources recorded are parsed again if they have changed.
+	 * they are read with the default encoding like the -f files */
+	x = hawk_loadtreestd(hawk, buf, len, HAWK_NULL);
+	free(buf);
+	if (x <= -1)
+	{
+		print_hawk_error(hawk);
+		return -1;
+	}
+	return 1;
+
+oops:
+	hawk_main_print_error("cannot read %s\n", arg->psin[0].u.fileb.path);
+	if (buf) free(buf);
+	fclose(fp);
+	return -1;
+}
+
+static int save_compiled (hawk_t* hawk, struct arg_t* arg)
+{
+	FILE* fp;
+	void* ptr;
+	hawk_oow_t len;
+	int n = 0;
+
+	ptr = hawk_savetree(hawk, &len);
+	if (!ptr)
+	{
+		print_hawk_error(hawk);
+		return -1;
+	}
+
+	fp = fopen(arg->ctf, "wb");
+	if (fp)
+	{
+		n = (fwrite(ptr, 1, len, fp) == len);
+		if (fclose(fp) != 0) n = 0;
+	}
+	hawk_freemem(hawk, ptr);
+
+	if (!fp || !n)
+	{
+		hawk_main_print_error("cannot write %s\n", arg->ctf);
+		return -1;
+	}
+	return 0;
+}
+
+static int save_profile_to (hawk_rtx_t* rtx, hawk_rtx_prof_fmt_t fmt, const hawk_bch_t* path)
+{
+	FILE* fp;
+	hawk_bch_t* ptr;
+	hawk_oow_t len;
+	int n = 0;
+
+	ptr = hawk_rtx_dumpprof(rtx, fmt, &len);
+	if (!ptr)
+	{
+		print_hawk_rtx_error(rtx);
+		return -1;
+	}
+
+	fp = fopen(path, "wb");
+	if (fp)
+	{
+		n = (fwrite(ptr, 1, len, fp) == len);
+		if (fclose(fp) != 0) n = 0;
+	}
+	hawk_rtx_freemem(rtx, ptr);
+
+	if (!fp || !n)
+	{
+		hawk_main_print_error("cannot write %s\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+static int save_profile (hawk_rtx_t* rtx, struct arg_t* arg)
+{
+	hawk_bch_t* path;
+	hawk_oow_t len;
+	int n;
+
+	if (save_profile_to(rtx, HAWK_RTX_PROF_REPORT, arg->pff) <= -1) return -1;
+
+	len = hawk_count_bcstr(arg->pff);
+	path = (hawk_bch_t*)malloc(len + 8);
+	if (!path)
+	{
+		hawk_main_print_error("out of memory\n");
+		return -1;
+	}
+	hawk_copy_bchars_to_bcstr_unlimited(path, arg->pff, len);
+	hawk_copy_bcstr_unlimited(&path[len], ".folded");
+
+	n = save_profile_to(rtx, HAWK_RTX_PROF_FOLDED, path);
+	free(path);
+	return n;
+}
+
 int main_hawk(int argc, hawk_bch_t* argv[], const hawk_bch_t* real_argv0)
 {
 	hawk_t* hawk = HAWK_NULL;
@@ -968,12 +1135,21 @@ int main_hawk(int argc, hawk_bch_t* argv[], const hawk_bch_t* real_argv0)
 		goto oops;
 	}
 
-	if (hawk_parsestd(hawk, arg.psin, ((arg.osf == HAWK_NULL)? HAWK_NULL: &psout)) <= -1)
+	i = load_compiled(hawk, &arg);
+	if (i <= -1) goto oops;
+	if (i == 0 && hawk_parsestd(hawk, arg.psin, ((arg.osf == HAWK_NULL)? HAWK_NULL: &psout)) <= -1)
 	{
 		print_hawk_error(hawk);
 		goto oops;
 	}
 
+	if (arg.ctf)
+	{
+		/* save the parsed script without running it */
+		if (save_compiled(hawk, &arg) >= 0) ret = 0;
+		goto oops;
+	}
+
 	rtx = hawk_rtx_openstdwithbcstrandcmgrs(
 		hawk, 0, argv[0],
 		(arg.call? HAWK_NULL: arg.icf.ptr), /* console input */
@@ -993,6 +1169,16 @@ int main_hawk(int argc, hawk_bch_t* argv[], const hawk_bch_t* real_argv0)
 		goto oops;
 	}
 
+	if (arg.pff)
+	{
+		int on = 1;
+		if (hawk_rtx_setopt(rtx, HAWK_RTX_OPT_PROFILE, &on) <= -1)
+		{
+			print_hawk_rtx_error(rtx);
+			goto oops;
+		}
+	}
+
 	app_rtx = rtx;
 	hawk_rtx_pushecb(rtx, &rtx_ecb);
 
@@ -1015,6 +1201,12 @@ int main_hawk(int argc, hawk_bch_t* argv[], const hawk_bch_t* real_argv0)
 
 	unset_intr_run();
 
+	if (arg.pff && save_profile(rtx, &arg) <= -1)
+	{
+		if (retv) hawk_rtx_refdownval(rtx, retv);
+		goto oops;
+	}
+
 	if (retv)
 	{
 		hawk_int_t tmp;
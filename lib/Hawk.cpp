@@ -374,6 +374,21 @@ Hawk::Value::Value (const Value& v): run(v.run), val(v.val)
 	this->cached.mbs.len = 0;
 }
 
+#if defined(HAWK_CXX_ENABLE_CXX11_MOVE)
+Hawk::Value::Value (Value&& v) HAWK_CXX_NOEXCEPT: run(v.run), val(v.val)
+{
+	this->cached.str = v.cached.str;
+	this->cached.mbs = v.cached.mbs;
+
+	v.run = HAWK_NULL;
+	v.val = hawk_get_nil_val();
+	v.cached.str.ptr = HAWK_NULL;
+	v.cached.str.len = 0;
+	v.cached.mbs.ptr = HAWK_NULL;
+	v.cached.mbs.len = 0;
+}
+#endif
+
 Hawk::Value::~Value ()
 {
 	if (this->run)
@@ -413,6 +428,29 @@ Hawk::Value& Hawk::Value::operator= (const Value& v)
 	return *this;
 }
 
+#if defined(HAWK_CXX_ENABLE_CXX11_MOVE)
+Hawk::Value& Hawk::Value::operator= (Value&& v) HAWK_CXX_NOEXCEPT
+{
+	if (this == &v) return *this;
+
+	this->clear ();
+
+	this->run = v.run;
+	this->val = v.val;
+	this->cached.str = v.cached.str;
+	this->cached.mbs = v.cached.mbs;
+
+	v.run = HAWK_NULL;
+	v.val = hawk_get_nil_val();
+	v.cached.str.ptr = HAWK_NULL;
+	v.cached.str.len = 0;
+	v.cached.mbs.ptr = HAWK_NULL;
+	v.cached.mbs.len = 0;
+
+	return *this;
+}
+#endif
+
 void Hawk::Value::clear ()
 {
 	if (this->run)
@@ -616,6 +654,58 @@ int Hawk::Value::getMbs (const hawk_bch_t** str, hawk_oow_t* len) const
 	return 0;
 }
 
+int Hawk::Value::getStrView (const hawk_ooch_t** str, hawk_oow_t* len) const
+{
+	HAWK_ASSERT(this->val != HAWK_NULL);
+
+	if (this->run)
+	{
+		switch (HAWK_RTX_GETVALTYPE(this->run->rtx, this->val))
+		{
+			case HAWK_VAL_NIL:
+				break;
+
+			case HAWK_VAL_STR:
+				*str = ((hawk_val_str_t*)this->val)->val.ptr;
+				*len = ((hawk_val_str_t*)this->val)->val.len;
+				return 0;
+
+			default:
+				return -1;
+		}
+	}
+
+	*str = getEmptyStr();
+	*len = 0;
+	return 0;
+}
+
+int Hawk::Value::getMbsView (const hawk_bch_t** str, hawk_oow_t* len) const
+{
+	HAWK_ASSERT(this->val != HAWK_NULL);
+
+	if (this->run)
+	{
+		switch (HAWK_RTX_GETVALTYPE(this->run->rtx, this->val))
+		{
+			case HAWK_VAL_NIL:
+				break;
+
+			case HAWK_VAL_MBS:
+				*str = ((hawk_val_mbs_t*)this->val)->val.ptr;
+				*len = ((hawk_val_mbs_t*)this->val)->val.len;
+				return 0;
+
+			default:
+				return -1;
+		}
+	}
+
+	*str = getEmptyMbs();
+	*len = 0;
+	return 0;
+}
+
 int Hawk::Value::getBob (const void** ptr, hawk_oow_t* len) const
 {
 	const void* p = getEmptyBob();
@@ -1481,6 +1571,122 @@ bool Hawk::Run::isHalt () const
 	return !!hawk_rtx_ishalt(this->rtx);
 }
 
+int Hawk::Run::setProfile (bool on)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+	int v = on;
+	return hawk_rtx_setopt(this->rtx, HAWK_RTX_OPT_PROFILE, &v);
+}
+
+bool Hawk::Run::isProfile () const
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+	int v = 0;
+	hawk_rtx_getopt (this->rtx, HAWK_RTX_OPT_PROFILE, &v);
+	return !!v;
+}
+
+hawk_bch_t* Hawk::Run::dumpProfile (hawk_rtx_prof_fmt_t fmt, hawk_oow_t* len)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+	return hawk_rtx_dumpprof(this->rtx, fmt, len);
+}
+
+void Hawk::Run::freeMem (void* ptr)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+	hawk_rtx_freemem (this->rtx, ptr);
+}
+
+int Hawk::Run::loop (Value* ret)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+
+	hawk_val_t* rv = hawk_rtx_loop(this->rtx);
+	if (rv == HAWK_NULL) return -1;
+
+	ret->setVal(this, rv);
+	hawk_rtx_refdownval(this->rtx, rv);
+
+	return 0;
+}
+
+int Hawk::Run::call (const hawk_bch_t* name, Value* ret, const Value* args, hawk_oow_t nargs)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+
+	hawk_val_t* buf[16];
+	hawk_val_t** ptr = HAWK_NULL;
+
+	if (args != HAWK_NULL)
+	{
+		if (nargs <= HAWK_COUNTOF(buf)) ptr = buf;
+		else
+		{
+			ptr = (hawk_val_t**)hawk_rtx_allocmem(this->rtx, HAWK_SIZEOF(hawk_val_t*) * nargs);
+			if (ptr == HAWK_NULL) return -1;
+		}
+
+		for (hawk_oow_t i = 0; i < nargs; i++) ptr[i] = (hawk_val_t*)args[i];
+	}
+
+	hawk_val_t* rv = hawk_rtx_callwithbcstr(this->rtx, name, ptr, nargs);
+
+	if (ptr != HAWK_NULL && ptr != buf) hawk_rtx_freemem(this->rtx, ptr);
+
+	if (rv == HAWK_NULL) return -1;
+
+	ret->setVal(this, rv);
+
+	hawk_rtx_refdownval(this->rtx, rv);
+	return 0;
+}
+
+int Hawk::Run::call (const hawk_uch_t* name, Value* ret, const Value* args, hawk_oow_t nargs)
+{
+	HAWK_ASSERT(this->rtx != HAWK_NULL);
+
+	hawk_val_t* buf[16];
+	hawk_val_t** ptr = HAWK_NULL;
+
+	if (args != HAWK_NULL)
+	{
+		if (nargs <= HAWK_COUNTOF(buf)) ptr = buf;
+		else
+		{
+			ptr = (hawk_val_t**)hawk_rtx_allocmem(this->rtx, HAWK_SIZEOF(hawk_val_t*) * nargs);
+			if (ptr == HAWK_NULL) return -1;
+		}
+
+		for (hawk_oow_t i = 0; i < nargs; i++) ptr[i] = (hawk_val_t*)args[i];
+	}
+
+	hawk_val_t* rv = hawk_rtx_callwithucstr(this->rtx, name, ptr, nargs);
+
+	if (ptr != HAWK_NULL && ptr != buf) hawk_rtx_freemem(this->rtx, ptr);
+
+	if (rv == HAWK_NULL) return -1;
+
+	ret->setVal(this, rv);
+
+	hawk_rtx_refdownval(this->rtx, rv);
+	return 0;
+}
+
+int Hawk::Run::exec (Value* ret, const Value* args, hawk_oow_t nargs)
+{
+	int n = (this->rtx->hawk->parse.pragma.entry[0] != '\0')?
+		this->call(this->rtx->hawk->parse.pragma.entry, ret, args, nargs): this->loop(ret);
+
+#if defined(HAWK_ENABLE_GC)
+	/* i assume this function is a usual hawk program starter.
+	 * call garbage collection after a whole program finishes */
+	hawk_rtx_gc(this->rtx, HAWK_RTX_GC_GEN_FULL);
+#endif
+
+	return n;
+}
+
 hawk_errnum_t Hawk::Run::getErrorNumber () const
 {
 	HAWK_ASSERT(this->rtx != HAWK_NULL);
@@ -1997,17 +2203,9 @@ int Hawk::loop (Value* ret)
 	HAWK_ASSERT(this->hawk != HAWK_NULL);
 	HAWK_ASSERT(this->runctx.rtx != HAWK_NULL);
 
-	hawk_val_t* rv = hawk_rtx_loop(this->runctx.rtx);
-	if (rv == HAWK_NULL)
-	{
-		this->retrieveError(&this->runctx);
-		return -1;
-	}
-
-	ret->setVal(&this->runctx, rv);
-	hawk_rtx_refdownval(this->runctx.rtx, rv);
-
-	return 0;
+	int n = this->runctx.loop(ret);
+	if (n <= -1) this->retrieveError(&this->runctx);
+	return n;
 }
 
 int Hawk::call (const hawk_bch_t* name, Value* ret, const Value* args, hawk_oow_t nargs)
@@ -2015,40 +2213,9 @@ int Hawk::call (const hawk_bch_t* name, Value* ret, const Value* args, hawk_oow_
 	HAWK_ASSERT(this->hawk != HAWK_NULL);
 	HAWK_ASSERT(this->runctx.rtx != HAWK_NULL);
 
-	hawk_val_t* buf[16];
-	hawk_val_t** ptr = HAWK_NULL;
-
-	if (args != HAWK_NULL)
-	{
-		if (nargs <= HAWK_COUNTOF(buf)) ptr = buf;
-		else
-		{
-			ptr = (hawk_val_t**)hawk_allocmem(this->hawk, HAWK_SIZEOF(hawk_val_t*) * nargs);
-			if (ptr == HAWK_NULL)
-			{
-				this->runctx.setError(HAWK_ENOMEM);
-				this->retrieveError(&this->runctx);
-				return -1;
-			}
-		}
-
-		for (hawk_oow_t i = 0; i < nargs; i++) ptr[i] = (hawk_val_t*)args[i];
-	}
-
-	hawk_val_t* rv = hawk_rtx_callwithbcstr(this->runctx.rtx, name, ptr, nargs);
-
-	if (ptr != HAWK_NULL && ptr != buf) hawk_freemem(this->hawk, ptr);
-
-	if (rv == HAWK_NULL)
-	{
-		this->retrieveError(&this->runctx);
-		return -1;
-	}
-
-	ret->setVal(&this->runctx, rv);
-
-	hawk_rtx_refdownval(this->runctx.rtx, rv);
-	return 0;
+	int n = this->runctx.call(name, ret, args, nargs);
+	if (n <= -1) this->retrieveError(&this->runctx);
+	return n;
 }
 
 int Hawk::call (const hawk_uch_t* name, Value* ret, const Value* args, hawk_oow_t nargs)
@@ -2056,53 +2223,18 @@ int Hawk::call (const hawk_uch_t* name, Value* ret, const Value* args, hawk_oow_
 	HAWK_ASSERT(this->hawk != HAWK_NULL);
 	HAWK_ASSERT(this->runctx.rtx != HAWK_NULL);
 
-	hawk_val_t* buf[16];
-	hawk_val_t** ptr = HAWK_NULL;
-
-	if (args != HAWK_NULL)
-	{
-		if (nargs <= HAWK_COUNTOF(buf)) ptr = buf;
-		else
-		{
-			ptr = (hawk_val_t**)hawk_allocmem(this->hawk, HAWK_SIZEOF(hawk_val_t*) * nargs);
-			if (ptr == HAWK_NULL)
-			{
-				this->runctx.setError(HAWK_ENOMEM);
-				this->retrieveError(&this->runctx);
-				return -1;
-			}
-		}
-
-		for (hawk_oow_t i = 0; i < nargs; i++) ptr[i] = (hawk_val_t*)args[i];
-	}
-
-	hawk_val_t* rv = hawk_rtx_callwithucstr(this->runctx.rtx, name, ptr, nargs);
-
-	if (ptr != HAWK_NULL && ptr != buf) hawk_freemem(this->hawk, ptr);
-
-	if (rv == HAWK_NULL)
-	{
-		this->retrieveError(&this->runctx);
-		return -1;
-	}
-
-	ret->setVal(&this->runctx, rv);
-
-	hawk_rtx_refdownval(this->runctx.rtx, rv);
-	return 0;
+	int n = this->runctx.call(name, ret, args, nargs);
+	if (n <= -1) this->retrieveError(&this->runctx);
+	return n;
 }
 
 int Hawk::exec (Value* ret, const Value* args, hawk_oow_t nargs)
 {
-	int n = (this->runctx.rtx->hawk->parse.pragma.entry[0] != '\0')?
-		this->call(this->runctx.rtx->hawk->parse.pragma.entry, ret, args, nargs): this->loop(ret);
-
-#if defined(HAWK_ENABLE_GC)
-        /* i assume this function is a usual hawk program starter.
-         * call garbage collection after a whole program finishes */
-        hawk_rtx_gc(this->runctx.rtx, HAWK_RTX_GC_GEN_FULL);
-#endif
+	HAWK_ASSERT(this->hawk != HAWK_NULL);
+	HAWK_ASSERT(this->runctx.rtx != HAWK_NULL);
 
+	int n = this->runctx.exec(ret, args, nargs);
+	if (n <= -1) this->retrieveError(&this->runctx);
 	return n;
 }
 
@@ -2121,7 +2253,16 @@ int Hawk::raiseSignal (int sig)
 int Hawk::init_runctx ()
 {
 	if (this->runctx.rtx) return 0;
+	return this->init_run(&this->runctx);
+}
+
+void Hawk::fini_runctx ()
+{
+	this->fini_run(&this->runctx);
+}
 
+int Hawk::init_run (Run* run)
+{
 	hawk_rio_cbs_t rio;
 	HAWK_MEMSET(&rio, 0, HAWK_SIZEOF(rio));
 
@@ -2138,33 +2279,199 @@ int Hawk::init_runctx ()
 	}
 
 	rtx->instsize_ += HAWK_SIZEOF(rxtn_t);
-	this->runctx.rtx = rtx;
+	run->rtx = rtx;
 
 	rxtn_t* rxtn = GET_RXTN(rtx);
-	rxtn->run = &this->runctx;
-	HAWK_MEMSET(&this->runctx.rtx_ecb, 0, HAWK_SIZEOF(this->runctx.rtx_ecb));
-	this->runctx.rtx_ecb.sigset = rtx_on_sigset;
-	hawk_rtx_pushecb(rtx, &this->runctx.rtx_ecb);
+	rxtn->run = run;
+	HAWK_MEMSET(&run->rtx_ecb, 0, HAWK_SIZEOF(run->rtx_ecb));
+	run->rtx_ecb.sigset = rtx_on_sigset;
+	hawk_rtx_pushecb(rtx, &run->rtx_ecb);
+
+	if (this->prepareRun(*run) <= -1)
+	{
+		this->fini_run(run);
+		return -1;
+	}
 
 	return 0;
 }
 
-void Hawk::fini_runctx ()
+void Hawk::fini_run (Run* run)
 {
-	if (this->runctx.rtx)
+	if (run->rtx)
+	{
+		if (run->envp)
+		{
+			hawk_rtx_freemem(run->rtx, run->envp);
+			run->envp = HAWK_NULL;
+			run->env_map = HAWK_NULL;
+			run->env_map_rev = 0;
+			run->env_type = HAWK_RTX_ENV_MK_BPP;
+		}
+
+		hawk_rtx_close(run->rtx);
+		run->rtx = HAWK_NULL;
+	}
+}
+
+Hawk::Run* Hawk::new_run ()
+{
+	void* ptr = this->getMmgr()->allocate(HAWK_SIZEOF(Run), false);
+	if (!ptr)
+	{
+		this->setError(HAWK_ENOMEM);
+		return HAWK_NULL;
+	}
+
+	Run* run = new(this->getMmgr(), ptr) Run(this);
+	if (this->init_run(run) <= -1)
+	{
+		HAWK_CXX_CALL_DESTRUCTOR(run, Run);
+		this->getMmgr()->dispose(run);
+		return HAWK_NULL;
+	}
+
+	return run;
+}
+
+void Hawk::delete_run (Run* run)
+{
+	this->fini_run(run);
+	HAWK_CXX_CALL_DESTRUCTOR(run, Run);
+	this->getMmgr()->dispose(run);
+}
+
+int Hawk::prepareRun (Run& run)
+{
+	// nothing to do
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////
+// Hawk::RunPool
+//////////////////////////////////////////////////////////////////
+
+Hawk::RunPool::RunPool (Hawk* hawk): hawk(hawk), mtx(HAWK_NULL), idle(HAWK_NULL), idle_count(0), idle_capa(0), busy_count(0)
+{
+}
+
+Hawk::RunPool::~RunPool ()
+{
+	this->close();
+}
+
+int Hawk::RunPool::open (hawk_oow_t max_idle)
+{
+	HAWK_ASSERT(this->mtx == HAWK_NULL);
+
+	if (!this->hawk->runctx.rtx)
+	{
+		// the program must have been parsed
+		this->hawk->setError(HAWK_EPERM);
+		return -1;
+	}
+
+	this->mtx = hawk_mtx_open((hawk_gem_t*)*this->hawk, 0, 0);
+	if (!this->mtx)
 	{
-		if (this->runctx.envp)
+		this->hawk->retrieveError();
+		return -1;
+	}
+
+	if (max_idle > 0)
+	{
+		this->idle = (Run**)hawk_allocmem(this->hawk->hawk, HAWK_SIZEOF(*this->idle) * max_idle);
+		if (!this->idle)
 		{
-			hawk_rtx_freemem(this->runctx.rtx, this->runctx.envp);
-			this->runctx.envp = HAWK_NULL;
-			this->runctx.env_map = HAWK_NULL;
-			this->runctx.env_map_rev = 0;
-			this->runctx.env_type = HAWK_RTX_ENV_MK_BPP;
+			this->hawk->retrieveError();
+			hawk_mtx_close(this->mtx);
+			this->mtx = HAWK_NULL;
+			return -1;
 		}
+	}
 
-		hawk_rtx_close(this->runctx.rtx);
-		this->runctx.rtx = HAWK_NULL;
+	this->idle_count = 0;
+	this->idle_capa = max_idle;
+	this->busy_count = 0;
+	return 0;
+}
+
+void Hawk::RunPool::close ()
+{
+	if (!this->mtx) return;
+
+	HAWK_ASSERT(this->busy_count == 0);
+	while (this->idle_count > 0) this->hawk->delete_run(this->idle[--this->idle_count]);
+	if (this->idle)
+	{
+		hawk_freemem(this->hawk->hawk, this->idle);
+		this->idle = HAWK_NULL;
+	}
+	this->idle_capa = 0;
+
+	hawk_mtx_close(this->mtx);
+	this->mtx = HAWK_NULL;
+}
+
+Hawk::Run* Hawk::RunPool::acquire ()
+{
+	Run* run;
+
+	HAWK_ASSERT(this->mtx != HAWK_NULL);
+
+	hawk_mtx_lock(this->mtx, HAWK_NULL);
+	if (this->idle_count > 0)
+	{
+		run = this->idle[--this->idle_count];
 	}
+	else
+	{
+		// creating a context touches the hawk object. do it in the lock
+		run = this->hawk->new_run();
+	}
+	if (run) this->busy_count++;
+	hawk_mtx_unlock(this->mtx);
+
+	return run;
+}
+
+void Hawk::RunPool::release (Run* run)
+{
+	HAWK_ASSERT(this->mtx != HAWK_NULL);
+
+	// reset the context outside the lock. it only touches the context itself
+	// and the global variables like ARGV set up by prepareRun().
+	bool reusable = hawk_rtx_reset(run->rtx) >= 0 && this->hawk->prepareRun(*run) >= 0;
+
+	hawk_mtx_lock(this->mtx, HAWK_NULL);
+	this->busy_count--;
+	if (reusable && this->idle_count < this->idle_capa)
+	{
+		this->idle[this->idle_count++] = run;
+	}
+	else
+	{
+		// closing a context finalizes the modules with the data shared
+		// over all the contexts. do it in the lock like creation
+		this->hawk->delete_run(run);
+	}
+	hawk_mtx_unlock(this->mtx);
+}
+
+hawk_oow_t Hawk::RunPool::getIdleCount () const
+{
+	hawk_mtx_lock(this->mtx, HAWK_NULL);
+	hawk_oow_t n = this->idle_count;
+	hawk_mtx_unlock(this->mtx);
+	return n;
+}
+
+hawk_oow_t Hawk::RunPool::getBusyCount () const
+{
+	hawk_mtx_lock(this->mtx, HAWK_NULL);
+	hawk_oow_t n = this->busy_count;
+	hawk_mtx_unlock(this->mtx);
+	return n;
 }
 
 int Hawk::getTrait () const
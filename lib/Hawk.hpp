@@ -28,6 +28,7 @@
 #define _HAWK_HAWK_HPP_
 
 #include <hawk.h>
+#include <hawk-mtx.h>
 
 #define HAWK_USE_HTB_FOR_FUNCTION_MAP 1
 //#define HAWK_VALUE_USE_IN_CLASS_PLACEMENT_NEW 1
@@ -391,6 +392,8 @@ public:
 
 	class Run;
 	friend class Run;
+	class RunPool;
+	friend class RunPool;
 
 
 protected:
@@ -1016,9 +1019,21 @@ public:
 		Value (Run* run);
 
 		Value (const Value& v);
+	#if defined(HAWK_CXX_ENABLE_CXX11_MOVE)
+		///
+		/// The move constructor takes over the inner value and the
+		/// cached conversion buffers of \a v without touching the
+		/// reference count. \a v is left as an empty value associated
+		/// with no runtime context.
+		///
+		Value (Value&& v) HAWK_CXX_NOEXCEPT;
+	#endif
 		~Value ();
 
 		Value& operator= (const Value& v);
+	#if defined(HAWK_CXX_ENABLE_CXX11_MOVE)
+		Value& operator= (Value&& v) HAWK_CXX_NOEXCEPT;
+	#endif
 
 		void clear ();
 
@@ -1100,6 +1115,23 @@ public:
 		int getMbs (const hawk_bch_t** str, hawk_oow_t* len) const;
 		int getBob (const void** str, hawk_oow_t* len) const;
 
+		///
+		/// The getStrView() function points \a str to the characters
+		/// held in the inner value without copying or converting them.
+		/// It succeeds only if the inner value is a character string
+		/// or nil. The pointer stays valid as long as the inner value
+		/// is kept by this object.
+		/// \return 0 on success, -1 if the value requires conversion.
+		///         Use getStr() in the latter case.
+		///
+		int getStrView (const hawk_ooch_t** str, hawk_oow_t* len) const;
+
+		///
+		/// The getMbsView() function is the same as getStrView() except
+		/// that it works on a byte string value.
+		///
+		int getMbsView (const hawk_bch_t** str, hawk_oow_t* len) const;
+
 		int setVal (hawk_val_t* v);
 		int setVal (Run* r, hawk_val_t* v);
 
@@ -1257,6 +1289,46 @@ public:
 		void halt () const;
 		bool isHalt () const;
 
+		///
+		/// The setProfile() function starts or stops collecting the
+		/// execution profile of this context.
+		/// \return 0 on success, -1 on failure
+		///
+		int setProfile (bool on);
+		bool isProfile () const;
+
+		///
+		/// The dumpProfile() function formats the profile collected
+		/// in the format \a fmt. The text returned must be freed with
+		/// freeMem().
+		/// \return text on success, #HAWK_NULL on failure
+		///
+		hawk_bch_t* dumpProfile (hawk_rtx_prof_fmt_t fmt, hawk_oow_t* len = HAWK_NULL);
+		void freeMem (void* ptr);
+
+		///
+		/// The loop() function executes the BEGIN block, pattern-action
+		/// blocks, and the END block in this context. The error is kept
+		/// in this context on failure.
+		/// \return 0 on success, -1 on failure
+		///
+		int loop (Value* ret);
+
+		///
+		/// The call() function invokes a function named \a name in
+		/// this context.
+		/// \return 0 on success, -1 on failure
+		///
+		int call (const hawk_bch_t* name, Value* ret, const Value* args, hawk_oow_t nargs);
+		int call (const hawk_uch_t* name, Value* ret, const Value* args, hawk_oow_t nargs);
+
+		///
+		/// The exec() function calls call() for the entry function
+		/// specified with @pragma entry and loop() otherwise.
+		/// \return 0 on success, -1 on failure
+		///
+		int exec (Value* ret, const Value* args, hawk_oow_t nargs);
+
 		hawk_errnum_t getErrorNumber () const;
 		hawk_loc_t getErrorLocation () const;
 		const hawk_ooch_t* getErrorMessage () const;
@@ -1365,6 +1437,75 @@ public:
 		hawk_rtx_env_mk_type_t env_type;
 	};
 
+	///
+	/// The RunPool class hands out runtime contexts over the program
+	/// parsed by a Hawk object so that multiple threads can run the
+	/// program at the same time. A context released is reset and kept
+	/// for the next acquisition instead of being destroyed.
+	///
+	/// The parse tree, the global variable names, the options and the
+	/// functions added are only read by the runtime contexts once the
+	/// program has been parsed. Don't parse again, change them or close
+	/// the Hawk object while the pool is open. The memory manager of the
+	/// Hawk object must be thread-safe. The error of a failed acquisition
+	/// is set to the Hawk object, which is not protected against other
+	/// threads calling into it. The console streams of HawkStd keep their
+	/// position in the HawkStd object and the contexts from a pool should
+	/// not read from or write to the console concurrently.
+	///
+	/// The pool creates and closes the contexts in its lock. A module
+	/// keeping data per context must still guard the lookups made while
+	/// the contexts run. The sys module does. The external modules like
+	/// ffi, memc, mysql, sqlite and uci don't and the program using them
+	/// must not run from a pool.
+	///
+	class HAWK_EXPORT RunPool: public Uncopyable
+	{
+	public:
+		RunPool (Hawk* hawk);
+		~RunPool ();
+
+		///
+		/// The open() function prepares the pool for the program
+		/// parsed. Up to \a max_idle contexts released are kept for reuse.
+		/// \return 0 on success, -1 on failure
+		///
+		int open (hawk_oow_t max_idle = 16);
+
+		///
+		/// The close() function destroys the idle contexts. All the
+		/// contexts acquired must have been released before it is called.
+		///
+		void close ();
+
+		///
+		/// The acquire() function returns an idle context or a new
+		/// context if there is no idle one. It is safe to call it from
+		/// multiple threads.
+		/// \return context on success, #HAWK_NULL on failure
+		///
+		Run* acquire ();
+
+		///
+		/// The release() function gives back a context acquired. The
+		/// context is reset to the initial state for the next use.
+		/// All Value objects created for the context must have been
+		/// destroyed before the call.
+		///
+		void release (Run* run);
+
+		hawk_oow_t getIdleCount () const;
+		hawk_oow_t getBusyCount () const;
+
+	protected:
+		Hawk* hawk;
+		hawk_mtx_t* mtx;
+		Run** idle;
+		hawk_oow_t idle_count;
+		hawk_oow_t idle_capa;
+		hawk_oow_t busy_count;
+	};
+
 	///
 	/// Returns the primitive handle
 	///
@@ -1427,6 +1568,12 @@ public:
 	/// sigset callback of #hawk_rtx_ecb_t.
 	virtual void uponSigset (Run& run, int sig, bool reset);
 
+	/// The prepareRun() function is called back after a runtime context
+	/// has been created for the program parsed. Override it to set up
+	/// the context before it runs.
+	/// \return 0 on success, -1 on failure
+	virtual int prepareRun (Run& run);
+
 	///
 	/// The parse() function parses the source code read from the input
 	/// stream \a in and writes the parse tree to the output stream \a out.
@@ -1927,6 +2074,10 @@ private:
 
 	int init_runctx ();
 	void fini_runctx ();
+	int init_run (Run* run);
+	void fini_run (Run* run);
+	Run* new_run ();
+	void delete_run (Run* run);
 	int dispatch_function (Run* run, const hawk_fnc_info_t* fi);
 
 	static const hawk_ooch_t* xerrstr (hawk_t* a, hawk_errnum_t num);
@@ -2061,6 +2212,7 @@ public:
 	int getEnvironGlobalId () const { return this->gbl_environ; }
 
 protected:
+	int prepareRun (Run& run);
 	int make_additional_globals (Run* run);
 	int build_argcv (Run* run);
 	int build_environ (Run* run, hawk_env_char_t* envarr[]);
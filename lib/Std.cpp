@@ -342,13 +342,6 @@ void HawkStd::uponClosing ()
 HawkStd::Run* HawkStd::parse (Source& in, Source& out)
 {
 	Run* run = Hawk::parse(in, out);
-	if (run)
-	{
-		hawk_rio_cbs_t rio;
-		hawk_rtx_getrio(*run, &rio);
-		rio.env_mk = rtx_env_maker;
-		hawk_rtx_setrio(*run, &rio);
-	}
 
 	if (this->cmgrtab_inited)
 	{
@@ -372,11 +365,19 @@ HawkStd::Run* HawkStd::parse (Source& in, Source& out)
 		this->cmgrtab_inited = true;
 	}
 
-	if (run && this->make_additional_globals(run) <= -1) return HAWK_NULL;
-
 	return run;
 }
 
+int HawkStd::prepareRun (Run& run)
+{
+	hawk_rio_cbs_t rio;
+	hawk_rtx_getrio(run, &rio);
+	rio.env_mk = rtx_env_maker;
+	hawk_rtx_setrio(run, &rio);
+
+	return this->make_additional_globals(&run);
+}
+
 int HawkStd::build_argcv (Run* run)
 {
 	Value argv(run);
@@ -418,9 +419,9 @@ int HawkStd::build_environ (Run* run, hawk_env_char_t* envarr[])
 			eq = hawk_find_bchar_in_bcstr(envarr[count], HAWK_BT('='));
 			if (eq == HAWK_NULL || eq == envarr[count]) continue;
 
-			*eq = HAWK_BT('\0');
-
-			kptr = hawk_rtx_dupbtoucstr(rtx, envarr[count], &klen, 1);
+			/* don't write to the environment strings. the contexts
+			 * in other threads may be reading them at the same time */
+			kptr = hawk_rtx_dupbtouchars(rtx, envarr[count], eq - envarr[count], &klen, 1);
 			vptr = hawk_rtx_dupbtoucstr(rtx, eq + 1, &vlen, 1);
 			if (kptr == HAWK_NULL || vptr == HAWK_NULL)
 			{
@@ -433,15 +434,11 @@ int HawkStd::build_environ (Run* run, hawk_env_char_t* envarr[])
 				this->setError (HAWK_ENOMEM);
 				return -1;
 			}
-
-			*eq = HAWK_BT('=');
 		#else
 			eq = hawk_find_uchar_in_ucstr(envarr[count], HAWK_UT('='));
 			if (eq == HAWK_NULL || eq == envarr[count]) continue;
 
-			*eq = HAWK_UT('\0');
-
-			kptr = hawk_rtx_duputobcstr(rtx, envarr[count], &klen);
+			kptr = hawk_rtx_duputobchars(rtx, envarr[count], eq - envarr[count], &klen);
 			vptr = hawk_rtx_duputobcstr(rtx, eq + 1, &vlen);
 			if (kptr == HAWK_NULL || vptr == HAWK_NULL)
 			{
@@ -456,8 +453,6 @@ int HawkStd::build_environ (Run* run, hawk_env_char_t* envarr[])
 				this->setError (HAWK_ENOMEM);
 				return -1;
 			}
-
-			*eq = HAWK_UT('=');
 		#endif
 
 			hawk_val_t* tmp = hawk_rtx_makenumorstrvalwithoochars(rtx, vptr, vlen, 1);
@@ -0,0 +1,1037 @@
+/*
+    Copyright (c) 2006-2020 Chung, Hyung-Hwan. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+    IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+    OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+    NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+    THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+    THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Stackful coroutines for hawk::spawn().
+ *
+ * Each coroutine owns a native stack and a value stack of its own. The
+ * global variables live at the bottom of the value stack and they are
+ * copied to the value stack of the coroutine being switched to. The main
+ * flow of the runtime context is a coroutine embedded in the scheduler.
+ *
+ * A coroutine gives up the processor only in hawk_rtx_yield(),
+ * hawk_rtx_join(), hawk_rtx_sleep() and hawk_rtx_waitio(). The latter two
+ * are called by the functions that would block otherwise. The scheduler
+ * polls the handles waited on when there is no coroutine ready to run.
+ */
+
+#include "hawk-prv.h"
+
+#if defined(HAWK_ENABLE_CORO)
+
+#include <ucontext.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+#if defined(HAVE_SYS_MMAN_H)
+#	include <sys/mman.h>
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#	define CORO_ASAN
+#elif defined(__has_feature)
+#	if __has_feature(address_sanitizer)
+#		define CORO_ASAN
+#	endif
+#endif
+#if defined(CORO_ASAN)
+#	include <sanitizer/common_interface_defs.h>
+#endif
+
+#if defined(HAVE_MMAP) && defined(MAP_ANONYMOUS)
+#	define CORO_MMAP_STACK
+#endif
+
+#define CORO_CSTACK_SIZE (1024 * 1024)
+#define CORO_GUARD_SIZE (64 * 1024) /* multiple of any usual page size */
+#define CORO_POLL_INTERVAL 64 /* poll waiting coroutines every this many switches */
+
+enum coro_wait_t
+{
+	CORO_WAIT_NONE,
+	CORO_WAIT_READY, /* in the ready queue */
+	CORO_WAIT_IO,
+	CORO_WAIT_SLEEP,
+	CORO_WAIT_JOIN
+};
+
+typedef struct coro_t coro_t;
+typedef struct coro_sched_t coro_sched_t;
+typedef struct coro_res_t coro_res_t;
+
+/* return value of a finished coroutine kept until it is joined */
+struct coro_res_t
+{
+	coro_res_t* next;
+	hawk_int_t id;
+	hawk_val_t* val;
+};
+
+struct coro_t
+{
+	coro_sched_t* sched;
+	hawk_int_t id;
+	int started;
+
+	/* link in the list of live coroutines */
+	coro_t* all_prev;
+	coro_t* all_next;
+
+	/* link in the ready queue, the waiting list or the dead list */
+	coro_t* prev;
+	coro_t* next;
+
+	ucontext_t uc;
+	void* cstk;
+	hawk_oow_t cstk_size;
+#if defined(CORO_ASAN)
+	void* asan_fake;
+	const void* asan_bottom;
+	size_t asan_size;
+#endif
+
+	/* execution state swapped in and out of the runtime context */
+	struct
+	{
+		hawk_stack_seg_t stack;
+		hawk_oow_t stack_top;
+		hawk_oow_t stack_base;
+		hawk_exec_stack_t* exec_stack;
+		hawk_oow_t exec_stack_size;
+		hawk_oow_t exec_stack_limit;
+		hawk_nde_blk_t* active_block;
+		hawk_oow_t depth_block;
+		hawk_oow_t depth_expr;
+		int exit_level;
+		hawk_val_t** forin_ptr;
+		hawk_oow_t forin_size;
+		hawk_oow_t forin_capa;
+		hawk_ooecs_t lineg;
+		hawk_becs_t linegb;
+	} flow;
+
+	/* function to run */
+	hawk_fun_t* fun;
+	hawk_val_t** args;
+	hawk_oow_t nargs;
+
+	/* what the coroutine is waiting for */
+	struct
+	{
+		int type;
+		int events;
+		hawk_intptr_t handle;
+		hawk_int_t id;
+		int timed;
+		hawk_ntime_t until;
+	} w;
+};
+
+struct coro_sched_t
+{
+	hawk_rtx_t* rtx;
+	coro_t main;
+	coro_t* current;
+	coro_t* switched_from;
+	coro_t* all; /* live spawned coroutines */
+	hawk_oow_t count; /* number of live spawned coroutines */
+	hawk_int_t last_id;
+
+	struct
+	{
+		coro_t* head;
+		coro_t* tail;
+	} ready;
+	coro_t* waiting;
+	coro_t* dead;
+	coro_res_t* results;
+	hawk_oow_t tick;
+
+	int cancel;  /* the runtime context is being closed */
+	int exiting; /* 1 if exit is called in a coroutine, 2 after the main flow has been told */
+	int failed;  /* a coroutine has failed with the error in errinf */
+	hawk_errinf_t errinf;
+
+	struct pollfd* pfd;
+	coro_t** pfc;
+	hawk_oow_t pfd_capa;
+};
+
+/* ------------------------------------------------------------------------ */
+
+static void get_mono_time (hawk_ntime_t* t)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	{
+		t->sec = ts.tv_sec;
+		t->nsec = ts.tv_nsec;
+		return;
+	}
+#endif
+	hawk_get_ntime(t);
+}
+
+static void* alloc_cstack (hawk_rtx_t* rtx, hawk_oow_t size)
+{
+#if defined(CORO_MMAP_STACK)
+	void* ptr;
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	#if defined(MAP_NORESERVE)
+	flags |= MAP_NORESERVE;
+	#endif
+	#if defined(MAP_STACK)
+	flags |= MAP_STACK;
+	#endif
+
+	ptr = mmap(HAWK_NULL, size + CORO_GUARD_SIZE, PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (ptr == MAP_FAILED)
+	{
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, hawk_syserr_to_errnum(errno));
+		return HAWK_NULL;
+	}
+
+	/* the stack grows down. make the lowest part inaccessible to catch an overflow */
+	mprotect(ptr, CORO_GUARD_SIZE, PROT_NONE);
+	return (hawk_uint8_t*)ptr + CORO_GUARD_SIZE;
+#else
+	return hawk_rtx_allocmem(rtx, size);
+#endif
+}
+
+static void free_cstack (hawk_rtx_t* rtx, void* ptr, hawk_oow_t size)
+{
+#if defined(CORO_MMAP_STACK)
+	munmap((hawk_uint8_t*)ptr - CORO_GUARD_SIZE, size + CORO_GUARD_SIZE);
+#else
+	hawk_rtx_freemem(rtx, ptr);
+#endif
+}
+
+/* ------------------------------------------------------------------------ */
+
+static void enqueue_ready (coro_sched_t* sched, coro_t* c)
+{
+	c->w.type = CORO_WAIT_READY;
+	c->next = HAWK_NULL;
+	c->prev = sched->ready.tail;
+	if (sched->ready.tail) sched->ready.tail->next = c;
+	else sched->ready.head = c;
+	sched->ready.tail = c;
+}
+
+static void link_waiting (coro_sched_t* sched, coro_t* c, int type)
+{
+	c->w.type = type;
+	c->prev = HAWK_NULL;
+	c->next = sched->waiting;
+	if (sched->waiting) sched->waiting->prev = c;
+	sched->waiting = c;
+}
+
+/* take a coroutine off the ready queue or the waiting list */
+static void unlink_coro (coro_sched_t* sched, coro_t* c)
+{
+	if (c->w.type == CORO_WAIT_NONE) return;
+
+	if (c->prev) c->prev->next = c->next;
+	else if (c->w.type == CORO_WAIT_READY) sched->ready.head = c->next;
+	else sched->waiting = c->next;
+
+	if (c->next) c->next->prev = c->prev;
+	else if (c->w.type == CORO_WAIT_READY) sched->ready.tail = c->prev;
+
+	c->prev = HAWK_NULL;
+	c->next = HAWK_NULL;
+	c->w.type = CORO_WAIT_NONE;
+}
+
+static void wake_coro (coro_sched_t* sched, coro_t* c)
+{
+	if (c->w.type == CORO_WAIT_READY) return;
+	unlink_coro (sched, c);
+	enqueue_ready (sched, c);
+}
+
+static coro_t* find_coro (coro_sched_t* sched, hawk_int_t id)
+{
+	coro_t* c;
+	for (c = sched->all; c; c = c->all_next)
+	{
+		if (c->id == id) return c;
+	}
+	return HAWK_NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static void save_flow (hawk_rtx_t* rtx, coro_t* c)
+{
+	c->flow.stack = rtx->stack;
+	c->flow.stack_top = rtx->stack_top;
+	c->flow.stack_base = rtx->stack_base;
+	c->flow.exec_stack = rtx->exec_stack;
+	c->flow.exec_stack_size = rtx->exec_stack_size;
+	c->flow.exec_stack_limit = rtx->exec_stack_limit;
+	c->flow.active_block = rtx->active_block;
+	c->flow.depth_block = rtx->depth.block;
+	c->flow.depth_expr = rtx->depth.expr;
+	c->flow.exit_level = rtx->exit_level;
+	c->flow.forin_ptr = rtx->forin.ptr;
+	c->flow.forin_size = rtx->forin.size;
+	c->flow.forin_capa = rtx->forin.capa;
+	c->flow.lineg = rtx->inrec.lineg;
+	c->flow.linegb = rtx->inrec.linegb;
+}
+
+static void load_flow (hawk_rtx_t* rtx, coro_t* c)
+{
+	rtx->stack = c->flow.stack;
+	rtx->stack_top = c->flow.stack_top;
+	rtx->stack_base = c->flow.stack_base;
+	rtx->exec_stack = c->flow.exec_stack;
+	rtx->exec_stack_size = c->flow.exec_stack_size;
+	rtx->exec_stack_limit = c->flow.exec_stack_limit;
+	rtx->active_block = c->flow.active_block;
+	rtx->depth.block = c->flow.depth_block;
+	rtx->depth.expr = c->flow.depth_expr;
+	rtx->exit_level = c->flow.exit_level;
+	rtx->forin.ptr = c->flow.forin_ptr;
+	rtx->forin.size = c->flow.forin_size;
+	rtx->forin.capa = c->flow.forin_capa;
+	rtx->inrec.lineg = c->flow.lineg;
+	rtx->inrec.linegb = c->flow.linegb;
+}
+
+static void release_args (hawk_rtx_t* rtx, coro_t* c)
+{
+	if (c->args)
+	{
+		while (c->nargs > 0) hawk_rtx_refdownval(rtx, c->args[--c->nargs]);
+		hawk_rtx_freemem(rtx, c->args);
+		c->args = HAWK_NULL;
+	}
+}
+
+static void free_coro (hawk_rtx_t* rtx, coro_t* c)
+{
+	hawk_oow_t ngbls = rtx->hawk->tree.ngbls;
+
+	release_args (rtx, c);
+
+	/* the slots above the globals hold the bottom stack frame only.
+	 * the global slots are not owned by this coroutine */
+	HAWK_ASSERT(c->flow.stack_top == ngbls + 4);
+	hawk_rtx_refdownval (rtx, HAWK_STACK_SEG_SLOT(&c->flow.stack, ngbls + 2));
+	hawk_rtx_freestack (rtx, &c->flow.stack);
+
+	if (c->flow.exec_stack) hawk_rtx_freemem(rtx, c->flow.exec_stack);
+	if (c->flow.forin_ptr)
+	{
+		while (c->flow.forin_size > 0) hawk_rtx_refdownval(rtx, c->flow.forin_ptr[--c->flow.forin_size]);
+		hawk_rtx_freemem (rtx, c->flow.forin_ptr);
+	}
+	hawk_becs_fini (&c->flow.linegb);
+	hawk_ooecs_fini (&c->flow.lineg);
+
+	free_cstack (rtx, c->cstk, c->cstk_size);
+	hawk_rtx_freemem (rtx, c);
+}
+
+static void reap_dead (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	while (sched->dead)
+	{
+		coro_t* c = sched->dead;
+		HAWK_ASSERT(c != sched->current);
+		sched->dead = c->next;
+		free_coro (rtx, c);
+	}
+}
+
+static void switch_to (hawk_rtx_t* rtx, coro_sched_t* sched, coro_t* to, int dying)
+{
+	coro_t* from = sched->current;
+	hawk_oow_t i;
+
+	save_flow (rtx, from);
+	for (i = 0; i < rtx->hawk->tree.ngbls; i++)
+	{
+		HAWK_STACK_SEG_SLOT(&to->flow.stack, i) = HAWK_STACK_SEG_SLOT(&from->flow.stack, i);
+	}
+	load_flow (rtx, to);
+	sched->current = to;
+	sched->switched_from = from;
+
+#if defined(CORO_ASAN)
+	__sanitizer_start_switch_fiber((dying? HAWK_NULL: &from->asan_fake), to->asan_bottom, to->asan_size);
+	swapcontext (&from->uc, &to->uc);
+	__sanitizer_finish_switch_fiber(from->asan_fake, HAWK_NULL, HAWK_NULL);
+#else
+	swapcontext (&from->uc, &to->uc);
+#endif
+
+	reap_dead (rtx, sched);
+}
+
+/* ------------------------------------------------------------------------ */
+
+static int poll_waiting (hawk_rtx_t* rtx, coro_sched_t* sched, int block)
+{
+	coro_t* c, * next;
+	hawk_oow_t npfds, i;
+	hawk_ntime_t until, now;
+	int timed, tmout, n;
+
+	npfds = 0;
+	timed = 0;
+	HAWK_CLEAR_NTIME (&until);
+	for (c = sched->waiting; c; c = c->next)
+	{
+		if (c->w.type == CORO_WAIT_IO) npfds++;
+		if (c->w.timed && (!timed || HAWK_CMP_NTIME(&c->w.until, &until) < 0))
+		{
+			until = c->w.until;
+			timed = 1;
+		}
+	}
+
+	if (npfds <= 0 && !timed)
+	{
+		if (!block) return 0;
+		hawk_rtx_seterrbfmt(rtx, HAWK_NULL, HAWK_ESTATE, "deadlock - no coroutine can run");
+		return -1;
+	}
+
+	if (npfds > sched->pfd_capa)
+	{
+		struct pollfd* tmp;
+		coro_t** tmp2;
+		hawk_oow_t newcapa;
+
+		newcapa = HAWK_ALIGN_POW2(npfds, 64);
+		tmp = (struct pollfd*)hawk_rtx_reallocmem(rtx, sched->pfd, newcapa * HAWK_SIZEOF(*tmp));
+		if (HAWK_UNLIKELY(!tmp)) return -1;
+		sched->pfd = tmp;
+		tmp2 = (coro_t**)hawk_rtx_reallocmem(rtx, sched->pfc, newcapa * HAWK_SIZEOF(*tmp2));
+		if (HAWK_UNLIKELY(!tmp2)) return -1;
+		sched->pfc = tmp2;
+		sched->pfd_capa = newcapa;
+	}
+
+	i = 0;
+	for (c = sched->waiting; c; c = c->next)
+	{
+		if (c->w.type == CORO_WAIT_IO)
+		{
+			sched->pfd[i].fd = (int)c->w.handle;
+			sched->pfd[i].events = 0;
+			if (c->w.events & HAWK_RTX_WAITIO_IN) sched->pfd[i].events |= POLLIN;
+			if (c->w.events & HAWK_RTX_WAITIO_OUT) sched->pfd[i].events |= POLLOUT;
+			sched->pfd[i].revents = 0;
+			sched->pfc[i] = c;
+			i++;
+		}
+	}
+
+	if (!block) tmout = 0;
+	else if (!timed) tmout = -1;
+	else
+	{
+		hawk_ntime_t diff;
+		get_mono_time (&now);
+		if (HAWK_CMP_NTIME(&until, &now) <= 0) tmout = 0;
+		else
+		{
+			HAWK_SUB_NTIME (&diff, &until, &now);
+			/* round up not to wake up before the deadline */
+			tmout = (diff.sec >= HAWK_TYPE_MAX(int) / 1000)? HAWK_TYPE_MAX(int): (int)(diff.sec * 1000 + (diff.nsec + 999999) / 1000000);
+		}
+	}
+
+	n = poll(sched->pfd, npfds, tmout);
+	if (n <= -1)
+	{
+		if (errno == EINTR) return 0;
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, hawk_syserr_to_errnum(errno));
+		return -1;
+	}
+
+	for (i = 0; n > 0 && i < npfds; i++)
+	{
+		if (sched->pfd[i].revents)
+		{
+			wake_coro (sched, sched->pfc[i]);
+			n--;
+		}
+	}
+
+	if (timed)
+	{
+		get_mono_time (&now);
+		for (c = sched->waiting; c; c = next)
+		{
+			next = c->next;
+			if (c->w.timed && HAWK_CMP_NTIME(&c->w.until, &now) <= 0) wake_coro (sched, c);
+		}
+	}
+
+	return 0;
+}
+
+static coro_t* pick_next (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	coro_t* c;
+
+	/* give the waiting coroutines a chance once in a while
+	 * even if the ready queue never gets empty */
+	if (sched->waiting && sched->ready.head && (++sched->tick % CORO_POLL_INTERVAL) == 0 &&
+	    poll_waiting(rtx, sched, 0) <= -1) return HAWK_NULL;
+
+	while (!sched->ready.head)
+	{
+		if (hawk_rtx_ishalt(rtx))
+		{
+			/* stop waiting as the program is being halted */
+			hawk_rtx_seterrnum (rtx, HAWK_NULL, HAWK_ENOERR);
+			return HAWK_NULL;
+		}
+		if (poll_waiting(rtx, sched, 1) <= -1) return HAWK_NULL;
+	}
+
+	c = sched->ready.head;
+	unlink_coro (sched, c);
+	return c;
+}
+
+/* check why the current coroutine has been resumed */
+static int check_resumed (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	coro_t* cur = sched->current;
+
+	if (cur == &sched->main)
+	{
+		if (sched->failed)
+		{
+			/* a coroutine has failed. the main flow takes over its error */
+			sched->failed = 0;
+			hawk_rtx_seterrinf (rtx, &sched->errinf);
+			return -1;
+		}
+		if (sched->exiting == 1)
+		{
+			/* exit in a coroutine. unwind the main flow with no error set */
+			sched->exiting = 2;
+			hawk_rtx_seterrnum (rtx, HAWK_NULL, HAWK_ENOERR);
+			return -1;
+		}
+	}
+	else if (sched->cancel || sched->exiting)
+	{
+		/* abort the coroutine. a caller treating the failure softly
+		 * must not keep it running */
+		rtx->exit_level = EXIT_ABORT;
+		hawk_rtx_seterrnum (rtx, HAWK_NULL, HAWK_ENOERR);
+		return -1;
+	}
+
+	if (hawk_rtx_ishalt(rtx))
+	{
+		hawk_rtx_seterrnum (rtx, HAWK_NULL, HAWK_ENOERR);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* let another coroutine run after the current coroutine has been put
+ * into the ready queue or the waiting list */
+static int suspend (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	coro_t* cur = sched->current;
+	coro_t* next;
+
+	if (cur != &sched->main && (sched->cancel || sched->exiting))
+	{
+		/* a coroutine being unwound must not wait again */
+		unlink_coro (sched, cur);
+		rtx->exit_level = EXIT_ABORT;
+		hawk_rtx_seterrnum (rtx, HAWK_NULL, HAWK_ENOERR);
+		return -1;
+	}
+
+	next = pick_next(rtx, sched);
+	if (!next)
+	{
+		unlink_coro (sched, cur);
+		return -1;
+	}
+
+	if (next != cur) switch_to (rtx, sched, next, 0);
+	return check_resumed(rtx, sched);
+}
+
+static void wake_joiners (coro_sched_t* sched, coro_t* dead)
+{
+	coro_t* c, * next;
+
+	for (c = sched->waiting; c; c = next)
+	{
+		next = c->next;
+		if (c->w.type == CORO_WAIT_JOIN &&
+		    (c->w.id == dead->id || (c->w.id == 0 && sched->count <= (c == &sched->main? 0: 1)))) wake_coro (sched, c);
+	}
+}
+
+static void finish_coro (hawk_rtx_t* rtx, coro_sched_t* sched, coro_t* c)
+{
+	if (c->all_prev) c->all_prev->all_next = c->all_next;
+	else sched->all = c->all_next;
+	if (c->all_next) c->all_next->all_prev = c->all_prev;
+	sched->count--;
+
+	wake_joiners (sched, c);
+
+	c->next = sched->dead;
+	sched->dead = c;
+}
+
+static int keep_result (hawk_rtx_t* rtx, coro_sched_t* sched, coro_t* c, hawk_val_t* v)
+{
+	coro_res_t* r;
+
+	r = (coro_res_t*)hawk_rtx_allocmem(rtx, HAWK_SIZEOF(*r));
+	if (HAWK_UNLIKELY(!r)) return -1;
+	r->id = c->id;
+	r->val = v;
+	hawk_rtx_refupval (rtx, v);
+	r->next = sched->results;
+	sched->results = r;
+	return 0;
+}
+
+static hawk_val_t* take_result (coro_sched_t* sched, hawk_int_t id)
+{
+	coro_res_t* r, ** pp;
+	hawk_val_t* v;
+
+	for (pp = &sched->results; (r = *pp); pp = &r->next)
+	{
+		if (r->id == id)
+		{
+			*pp = r->next;
+			v = r->val;
+			hawk_rtx_freemem (sched->rtx, r);
+			return v;
+		}
+	}
+
+	return HAWK_NULL;
+}
+
+static void drop_results (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	while (sched->results)
+	{
+		coro_res_t* r = sched->results;
+		sched->results = r->next;
+		hawk_rtx_refdownval (rtx, r->val);
+		hawk_rtx_freemem (rtx, r);
+	}
+}
+
+static void fail_to_main (hawk_rtx_t* rtx, coro_sched_t* sched)
+{
+	if (!sched->failed)
+	{
+		hawk_rtx_geterrinf (rtx, &sched->errinf);
+		sched->failed = 1;
+	}
+	wake_coro (sched, &sched->main);
+}
+
+static void coro_entry (unsigned int hi, unsigned int lo)
+{
+	coro_t* c = (coro_t*)(((hawk_uintptr_t)hi << 16 << 16) | (hawk_uintptr_t)lo);
+	coro_sched_t* sched = c->sched;
+	hawk_rtx_t* rtx = sched->rtx;
+	coro_t* next;
+
+#if defined(CORO_ASAN)
+	/* this records the bounds of the main stack on the first switch */
+	__sanitizer_finish_switch_fiber(HAWK_NULL, &sched->switched_from->asan_bottom, &sched->switched_from->asan_size);
+#endif
+	reap_dead (rtx, sched);
+
+	c->started = 1;
+	if (!sched->cancel && !sched->exiting)
+	{
+		hawk_val_t* v;
+
+		v = hawk_rtx_callfun(rtx, c->fun, c->args, c->nargs);
+		if (v)
+		{
+			/* keep the return value for hawk_rtx_join(). nil is
+			 * what a joiner gets without it */
+			if (v != hawk_val_nil && keep_result(rtx, sched, c, v) <= -1) fail_to_main (rtx, sched);
+			hawk_rtx_refdownval (rtx, v);
+		}
+		else if (hawk_rtx_geterrnum(rtx) != HAWK_ENOERR && !sched->cancel && !sched->exiting)
+		{
+			/* an error in a coroutine aborts the program as it does in the main flow */
+			fail_to_main (rtx, sched);
+		}
+
+		if (rtx->exit_level >= EXIT_GLOBAL && !sched->cancel && !sched->exiting)
+		{
+			/* exit in a coroutine ends the program. hand over the exit
+			 * value to the main flow which unwinds as if it has called exit */
+			hawk_val_t** retv = (hawk_val_t**)&HAWK_STACK_SEG_SLOT(&sched->main.flow.stack, rtx->hawk->tree.ngbls + 2);
+			hawk_rtx_refdownval (rtx, *retv);
+			*retv = HAWK_RTX_STACK_RETVAL_GBL(rtx);
+			HAWK_RTX_STACK_RETVAL_GBL(rtx) = hawk_val_nil;
+			sched->main.flow.exit_level = rtx->exit_level;
+			sched->exiting = 1;
+			wake_coro (sched, &sched->main);
+		}
+	}
+
+	release_args (rtx, c);
+	finish_coro (rtx, sched, c);
+
+	if (sched->cancel)
+	{
+		next = &sched->main;
+	}
+	else
+	{
+		next = pick_next(rtx, sched);
+		if (!next)
+		{
+			/* nothing can run any more. fail the main flow */
+			fail_to_main (rtx, sched);
+			next = &sched->main;
+			unlink_coro (sched, next);
+		}
+	}
+
+	switch_to (rtx, sched, next, 1);
+	/* never reached */
+}
+
+static coro_sched_t* get_sched (hawk_rtx_t* rtx)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+
+	if (!sched)
+	{
+		sched = (coro_sched_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*sched));
+		if (HAWK_UNLIKELY(!sched)) return HAWK_NULL;
+		sched->rtx = rtx;
+		sched->main.sched = sched;
+		sched->current = &sched->main;
+		rtx->coro = sched;
+	}
+
+	return sched;
+}
+
+static int make_context (coro_t* c)
+{
+	/* kept apart from hawk_rtx_spawn() so that no local variable of
+	 * the caller stays live across getcontext() */
+	hawk_uintptr_t cp;
+
+	if (getcontext(&c->uc) <= -1) return -1;
+
+	c->uc.uc_stack.ss_sp = c->cstk;
+	c->uc.uc_stack.ss_size = c->cstk_size;
+	c->uc.uc_link = HAWK_NULL;
+	/* makecontext() passes int arguments only. split the pointer */
+	cp = (hawk_uintptr_t)c;
+	makecontext (&c->uc, (void(*)(void))coro_entry, 2, (unsigned int)(cp >> 16 >> 16), (unsigned int)(cp & 0xFFFFFFFFu));
+	return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
+hawk_int_t hawk_rtx_spawn (hawk_rtx_t* rtx, hawk_fun_t* fun, hawk_val_t* args[], hawk_oow_t nargs)
+{
+	coro_sched_t* sched;
+	coro_t* c;
+	hawk_oow_t ngbls, i;
+
+	if (nargs > fun->nargs && !fun->variadic)
+	{
+		hawk_rtx_seterrfmt(rtx, HAWK_NULL, HAWK_EARGTM, HAWK_T("too many arguments to '%.*js'"), fun->name.len, fun->name.ptr);
+		return -1;
+	}
+
+	sched = get_sched(rtx);
+	if (HAWK_UNLIKELY(!sched)) return -1;
+
+	if (sched->cancel)
+	{
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_EPERM);
+		return -1;
+	}
+
+	c = (coro_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*c));
+	if (HAWK_UNLIKELY(!c)) return -1;
+
+	c->sched = sched;
+
+	/* lay the globals and a bottom stack frame in the same way as
+	 * prepare_globals() and hawk_rtx_loop() do. exit stores its value
+	 * into the return value slot of the bottom frame */
+	ngbls = rtx->hawk->tree.ngbls;
+	if (HAWK_UNLIKELY(hawk_rtx_growstack(rtx, &c->flow.stack, ngbls + 4) <= -1)) goto oops;
+	HAWK_STACK_SEG_SLOT(&c->flow.stack, ngbls + 0) = (void*)0;
+	HAWK_STACK_SEG_SLOT(&c->flow.stack, ngbls + 1) = (void*)ngbls;
+	HAWK_STACK_SEG_SLOT(&c->flow.stack, ngbls + 2) = hawk_val_nil;
+	HAWK_STACK_SEG_SLOT(&c->flow.stack, ngbls + 3) = (void*)0;
+	c->flow.stack_base = ngbls;
+	c->flow.stack_top = ngbls + 4;
+	c->flow.active_block = rtx->active_block;
+
+	if (HAWK_UNLIKELY(hawk_ooecs_init(&c->flow.lineg, hawk_rtx_getgem(rtx), 64) <= -1)) goto oops;
+	if (HAWK_UNLIKELY(hawk_becs_init(&c->flow.linegb, hawk_rtx_getgem(rtx), 64) <= -1))
+	{
+		hawk_ooecs_fini (&c->flow.lineg);
+		goto oops;
+	}
+
+	if (nargs > 0)
+	{
+		c->args = (hawk_val_t**)hawk_rtx_allocmem(rtx, nargs * HAWK_SIZEOF(*c->args));
+		if (HAWK_UNLIKELY(!c->args)) goto oops_2;
+		for (i = 0; i < nargs; i++)
+		{
+			c->args[i] = args[i];
+			hawk_rtx_refupval (rtx, args[i]);
+		}
+		c->nargs = nargs;
+	}
+	c->fun = fun;
+
+	c->cstk_size = CORO_CSTACK_SIZE;
+	c->cstk = alloc_cstack(rtx, c->cstk_size);
+	if (HAWK_UNLIKELY(!c->cstk)) goto oops_2;
+#if defined(CORO_ASAN)
+	c->asan_bottom = c->cstk;
+	c->asan_size = c->cstk_size;
+#endif
+
+	if (make_context(c) <= -1)
+	{
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, hawk_syserr_to_errnum(errno));
+		free_cstack (rtx, c->cstk, c->cstk_size);
+		goto oops_2;
+	}
+
+	c->id = ++sched->last_id;
+	c->all_next = sched->all;
+	if (sched->all) sched->all->all_prev = c;
+	sched->all = c;
+	sched->count++;
+
+	enqueue_ready (sched, c);
+	return c->id;
+
+oops_2:
+	release_args (rtx, c);
+	hawk_becs_fini (&c->flow.linegb);
+	hawk_ooecs_fini (&c->flow.lineg);
+oops:
+	hawk_rtx_freestack (rtx, &c->flow.stack);
+	hawk_rtx_freemem (rtx, c);
+	return -1;
+}
+
+int hawk_rtx_yield (hawk_rtx_t* rtx)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+
+	if (!sched || sched->count <= 0) return 0;
+
+	if (sched->waiting && poll_waiting(rtx, sched, 0) <= -1) return -1;
+	enqueue_ready (sched, sched->current);
+	return suspend(rtx, sched);
+}
+
+int hawk_rtx_join (hawk_rtx_t* rtx, hawk_int_t id, hawk_val_t** retv)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+
+	if (retv) *retv = hawk_val_nil;
+	if (!sched) return 0;
+
+	if (id == sched->current->id && id != 0)
+	{
+		hawk_rtx_seterrbfmt(rtx, HAWK_NULL, HAWK_EINVAL, "unable to join the calling coroutine itself");
+		return -1;
+	}
+
+	while (id > 0? (find_coro(sched, id) != HAWK_NULL): (sched->count > (sched->current == &sched->main? 0: 1)))
+	{
+		sched->current->w.id = id;
+		sched->current->w.timed = 0;
+		link_waiting (sched, sched->current, CORO_WAIT_JOIN);
+		if (suspend(rtx, sched) <= -1) return -1;
+	}
+
+	if (id > 0)
+	{
+		hawk_val_t* v = take_result(sched, id);
+		if (v)
+		{
+			/* hand over the reference held by the result */
+			if (retv) *retv = v;
+			else hawk_rtx_refdownval (rtx, v);
+		}
+	}
+	else if (sched->current == &sched->main)
+	{
+		/* no coroutine is left to be joined by id */
+		drop_results (rtx, sched);
+	}
+
+	return 0;
+}
+
+int hawk_rtx_waitio (hawk_rtx_t* rtx, hawk_intptr_t handle, int events, const hawk_ntime_t* tmout)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+	struct pollfd pfd;
+	coro_t* cur;
+
+	if (!sched || sched->count <= 0) return 0;
+
+	/* don't switch if the handle is ready already */
+	pfd.fd = (int)handle;
+	pfd.events = 0;
+	if (events & HAWK_RTX_WAITIO_IN) pfd.events |= POLLIN;
+	if (events & HAWK_RTX_WAITIO_OUT) pfd.events |= POLLOUT;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) > 0 || (tmout && !HAWK_IS_POS_NTIME(tmout))) return 1;
+
+	cur = sched->current;
+	cur->w.handle = handle;
+	cur->w.events = events;
+	cur->w.timed = 0;
+	if (tmout)
+	{
+		get_mono_time (&cur->w.until);
+		HAWK_ADD_NTIME (&cur->w.until, &cur->w.until, tmout);
+		cur->w.timed = 1;
+	}
+	link_waiting (sched, cur, CORO_WAIT_IO);
+	if (suspend(rtx, sched) <= -1) return -1;
+
+	return 1;
+}
+
+int hawk_rtx_sleep (hawk_rtx_t* rtx, const hawk_ntime_t* dur)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+	coro_t* cur;
+
+	if (!sched || sched->count <= 0) return 0;
+
+	if (!HAWK_IS_POS_NTIME(dur)) return (hawk_rtx_yield(rtx) <= -1)? -1: 1;
+
+	cur = sched->current;
+	get_mono_time (&cur->w.until);
+	HAWK_ADD_NTIME (&cur->w.until, &cur->w.until, dur);
+	cur->w.timed = 1;
+	link_waiting (sched, cur, CORO_WAIT_SLEEP);
+	if (suspend(rtx, sched) <= -1) return -1;
+
+	return 1;
+}
+
+void hawk_rtx_finicoros (hawk_rtx_t* rtx)
+{
+	coro_sched_t* sched = (coro_sched_t*)rtx->coro;
+
+	if (!sched) return;
+
+	HAWK_ASSERT(sched->current == &sched->main);
+
+	/* resume the coroutines still alive for them to unwind. every
+	 * attempt to wait fails while the cancellation is in progress. */
+	sched->cancel = 1;
+	while (sched->all)
+	{
+		coro_t* c = sched->all;
+
+		unlink_coro (sched, c);
+		if (c->started) switch_to (rtx, sched, c, 0);
+		else finish_coro (rtx, sched, c);
+		reap_dead (rtx, sched);
+	}
+
+	drop_results (rtx, sched);
+	if (sched->pfc) hawk_rtx_freemem(rtx, sched->pfc);
+	if (sched->pfd) hawk_rtx_freemem(rtx, sched->pfd);
+	hawk_rtx_freemem (rtx, sched);
+	rtx->coro = HAWK_NULL;
+}
+
+#else
+
+hawk_int_t hawk_rtx_spawn (hawk_rtx_t* rtx, hawk_fun_t* fun, hawk_val_t* args[], hawk_oow_t nargs)
+{
+	hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_ENOIMPL);
+	return -1;
+}
+
+int hawk_rtx_yield (hawk_rtx_t* rtx)
+{
+	return 0;
+}
+
+int hawk_rtx_join (hawk_rtx_t* rtx, hawk_int_t id, hawk_val_t** retv)
+{
+	if (retv) *retv = hawk_val_nil;
+	return 0;
+}
+
+int hawk_rtx_waitio (hawk_rtx_t* rtx, hawk_intptr_t handle, int events, const hawk_ntime_t* tmout)
+{
+	return 0;
+}
+
+int hawk_rtx_sleep (hawk_rtx_t* rtx, const hawk_ntime_t* dur)
+{
+	return 0;
+}
+
+void hawk_rtx_finicoros (hawk_rtx_t* rtx)
+{
+}
+
+#endif
@@ -2368,6 +2368,199 @@ static HAWK_INLINE int asort_compare_ud (const void* x1, const void* x2, void* c
 	return 0;
 }
 
+/* the number of items from which sorting is done with multiple threads */
+#define ASORT_PSORT_THRESHOLD 100000
+
+struct asort_fkey_t
+{
+	hawk_flt_t key;
+	hawk_val_t* val;
+};
+
+struct asort_skey_t
+{
+	hawk_uint64_t prefix; /* first few characters packed for quick comparison */
+	const hawk_ooch_t* ptr;
+	hawk_oow_t len;
+	hawk_val_t* val;
+};
+
+static int asort_compare_fkey (const void* x1, const void* x2, void* ctx)
+{
+	hawk_flt_t k1 = ((const struct asort_fkey_t*)x1)->key;
+	hawk_flt_t k2 = ((const struct asort_fkey_t*)x2)->key;
+	return (k1 > k2)? 1: ((k1 < k2)? -1: 0);
+}
+
+static int asort_compare_skey (const void* x1, const void* x2, void* ctx)
+{
+	const struct asort_skey_t* k1 = (const struct asort_skey_t*)x1;
+	const struct asort_skey_t* k2 = (const struct asort_skey_t*)x2;
+	if (k1->prefix != k2->prefix) return (k1->prefix > k2->prefix)? 1: -1;
+	return hawk_comp_oochars(k1->ptr, k1->len, k2->ptr, k2->len, *(int*)ctx);
+}
+
+static HAWK_INLINE hawk_uint64_t asort_make_prefix (const hawk_ooch_t* ptr, hawk_oow_t len, int ignorecase)
+{
+	/* pack the leading characters in the big-endian order such that
+	 * comparing prefixes gives the same result as hawk_comp_oochars()
+	 * unless they are equal */
+	hawk_uint64_t p = 0;
+	hawk_oow_t i;
+	hawk_oochu_t c;
+
+	for (i = 0; i < 64 / (HAWK_SIZEOF(hawk_ooch_t) * 8); i++)
+	{
+		c = (i >= len)? 0: ignorecase? (hawk_oochu_t)hawk_to_ooch_lower(ptr[i]): (hawk_oochu_t)ptr[i];
+		p = (p << (HAWK_SIZEOF(hawk_ooch_t) * 8)) | c;
+	}
+
+	return p;
+}
+
+static HAWK_INLINE int asort_get_num (hawk_rtx_t* rtx, hawk_val_t* v, hawk_int_t* l, hawk_flt_t* r)
+{
+	switch (HAWK_RTX_GETVALTYPE(rtx, v))
+	{
+		case HAWK_VAL_INT:
+			*l = HAWK_RTX_GETINTFROMVAL(rtx, v);
+			return 0;
+
+		case HAWK_VAL_FLT:
+			*r = ((hawk_val_flt_t*)v)->val;
+			return 1;
+
+		default:
+			/* a numeric string. convert it the way comparison does */
+			HAWK_ASSERT(HAWK_RTX_GETVALTYPE(rtx, v) == HAWK_VAL_STR && v->v_nstr > 0);
+			return hawk_rtx_strvaltonum(rtx, (hawk_val_str_t*)v, l, r);
+	}
+}
+
+static int asort_sort_fast (hawk_rtx_t* rtx, hawk_val_t** va, hawk_oow_t n)
+{
+	/* sort the values without going through hawk_rtx_cmpval() for each
+	 * comparison if all of them are numbers(including numeric strings) or
+	 * all of them are plain strings. the keys are extracted to an array
+	 * and sorted with a specialized routine. it returns 1 if sorted, 0 if
+	 * the values are not eligible, -1 on failure. */
+	hawk_oow_t i, nint = 0, nflt = 0, nstr = 0;
+	hawk_val_t* v;
+	hawk_int_t l;
+	hawk_flt_t r;
+
+	for (i = 0; i < n; i++)
+	{
+		v = va[i];
+		switch (HAWK_RTX_GETVALTYPE(rtx, v))
+		{
+			case HAWK_VAL_INT:
+				nint++;
+				break;
+
+			case HAWK_VAL_FLT:
+				if (((hawk_val_flt_t*)v)->val != ((hawk_val_flt_t*)v)->val) return 0; /* NaN */
+				nflt++;
+				break;
+
+			case HAWK_VAL_STR:
+				if (v->v_nstr == 1) nint++;
+				else if (v->v_nstr == 2) nflt++;
+				else nstr++;
+				break;
+
+			default:
+				return 0;
+		}
+	}
+
+	if (nstr > 0)
+	{
+		struct asort_skey_t* sk;
+		int ignorecase = rtx->gbl.ignorecase;
+
+		if (nstr < n) return 0; /* mixture of strings and numbers */
+
+		sk = (struct asort_skey_t*)hawk_rtx_allocmem(rtx, n * HAWK_SIZEOF(*sk) * ((n >= ASORT_PSORT_THRESHOLD)? 2: 1));
+		if (HAWK_UNLIKELY(!sk)) return -1;
+
+		for (i = 0; i < n; i++)
+		{
+			hawk_val_str_t* sv = (hawk_val_str_t*)va[i];
+			sk[i].ptr = sv->val.ptr;
+			sk[i].len = sv->val.len;
+			sk[i].prefix = asort_make_prefix(sv->val.ptr, sv->val.len, ignorecase);
+			sk[i].val = va[i];
+		}
+
+		if (n >= ASORT_PSORT_THRESHOLD) hawk_psort(sk, n, HAWK_SIZEOF(*sk), asort_compare_skey, &ignorecase, sk + n, 0);
+		else hawk_qsort(sk, n, HAWK_SIZEOF(*sk), asort_compare_skey, &ignorecase);
+
+		for (i = 0; i < n; i++) va[i] = sk[i].val;
+		hawk_rtx_freemem(rtx, sk);
+		return 1;
+	}
+
+	if (nflt == 0)
+	{
+		hawk_sort_intkey_t* ik;
+
+		ik = (hawk_sort_intkey_t*)hawk_rtx_allocmem(rtx, n * 2 * HAWK_SIZEOF(*ik));
+		if (HAWK_UNLIKELY(!ik)) return -1;
+
+		for (i = 0; i < n; i++)
+		{
+			if (asort_get_num(rtx, va[i], &l, &r) != 0)
+			{
+				hawk_rtx_freemem(rtx, ik);
+				return 0;
+			}
+			ik[i].key = l;
+			ik[i].ptr = va[i];
+		}
+
+		hawk_rsort_intkeys(ik, n, ik + n);
+
+		for (i = 0; i < n; i++) va[i] = (hawk_val_t*)ik[i].ptr;
+		hawk_rtx_freemem(rtx, ik);
+		return 1;
+	}
+	else
+	{
+		struct asort_fkey_t* fk;
+
+		fk = (struct asort_fkey_t*)hawk_rtx_allocmem(rtx, n * HAWK_SIZEOF(*fk) * ((n >= ASORT_PSORT_THRESHOLD)? 2: 1));
+		if (HAWK_UNLIKELY(!fk)) return -1;
+
+		for (i = 0; i < n; i++)
+		{
+			int x = asort_get_num(rtx, va[i], &l, &r);
+			if (x == 0)
+			{
+				/* an integer compared against a floating-point number
+				 * is converted to a floating-point number. give up if
+				 * the conversion is not exact to keep integer ordering */
+				r = (hawk_flt_t)l;
+				if ((hawk_int_t)r != l) x = -1;
+			}
+			if (x <= -1 || r != r)
+			{
+				hawk_rtx_freemem(rtx, fk);
+				return 0;
+			}
+			fk[i].key = r;
+			fk[i].val = va[i];
+		}
+
+		if (n >= ASORT_PSORT_THRESHOLD) hawk_psort(fk, n, HAWK_SIZEOF(*fk), asort_compare_fkey, HAWK_NULL, fk + n, 0);
+		else hawk_qsort(fk, n, HAWK_SIZEOF(*fk), asort_compare_fkey, HAWK_NULL);
+
+		for (i = 0; i < n; i++) va[i] = fk[i].val;
+		hawk_rtx_freemem(rtx, fk);
+		return 1;
+	}
+}
+
 static HAWK_INLINE int __fnc_asort (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi, int sort_keys)
 {
 	/*
@@ -2494,7 +2687,8 @@ val_map:
 		}
 		else
 		{
-			x = hawk_qsortx(va, msz, HAWK_SIZEOF(*va), asort_compare, rtx);
+			x = asort_sort_fast(rtx, va, msz);
+			if (x == 0) x = hawk_qsortx(va, msz, HAWK_SIZEOF(*va), asort_compare, rtx);
 		}
 
 		if (x <= -1 || !(rrv = hawk_rtx_makemapval(rtx)))
@@ -2580,7 +2774,8 @@ val_arr:
 		}
 		else
 		{
-			x = hawk_qsortx(va, msz, HAWK_SIZEOF(*va), asort_compare, rtx);
+			x = asort_sort_fast(rtx, va, msz);
+			if (x == 0) x = hawk_qsortx(va, msz, HAWK_SIZEOF(*va), asort_compare, rtx);
 		}
 
 		if (x <= -1 || !(rrv = hawk_rtx_makearrval(rtx, -1)))
@@ -62,6 +62,13 @@ typedef struct hawk_tree_t hawk_tree_t;
  */
 #define HAWK_ENABLE_FUN_AS_VALUE
 
+/* hawk::spawn() switches native stacks between coroutines */
+#if defined(HAVE_UCONTEXT_H) && defined(HAVE_GETCONTEXT) && \
+    defined(HAVE_MAKECONTEXT) && defined(HAVE_SWAPCONTEXT) && \
+    defined(HAVE_POLL_H)
+#define HAWK_ENABLE_CORO
+#endif
+
 #if defined(HAWK_ATOMIC_EXCHANGE) && \
     defined(HAWK_ATOMIC_FETCH_OR) && \
     defined(HAWK_ATOMIC_LOAD) && \
@@ -92,6 +99,12 @@ typedef struct hawk_tree_t hawk_tree_t;
 #define HAWK_STR_CACHE_BLOCK_UNIT (16)
 #define HAWK_STR_CACHE_BLOCK_SIZE (128)
 
+/* value slab configuration. a value not larger than
+ * HAWK_VAL_SLAB_CLASS_UNIT * HAWK_VAL_SLAB_NUM_CLASSES bytes is allocated
+ * from the slab of its size class. */
+#define HAWK_VAL_SLAB_NUM_CLASSES (10)
+#define HAWK_VAL_SLAB_CLASS_UNIT (16)
+
 /* byte string cache configuration */
 #define HAWK_MBS_CACHE_NUM_BLOCKS (16)
 #define HAWK_MBS_CACHE_BLOCK_UNIT (16)
@@ -113,6 +126,10 @@ typedef struct hawk_tree_t hawk_tree_t;
 #	define HAWK_MAX_RTX_STACK_LIMIT ((hawk_oow_t)1 << (HAWK_SIZEOF_VOID_P * 4))
 #endif
 
+/* number of entries in the cache of map lookups by a constant key.
+ * it must be a power of 2 */
+#define HAWK_RTX_IMC_SIZE (64)
+
 /* Don't forget to grow HAWK_IDX_BUF_SIZE if hawk_int_t is very large */
 #if (HAWK_SIZEOF_INT_T <= 16) /* 128 bits */
 #	define HAWK_IDX_BUF_SIZE 64
@@ -201,6 +218,17 @@ typedef struct hawk_tree_t hawk_tree_t;
 
 #endif
 
+/* a source stream read by hawk_parse(). hawk_savetree() records the list
+ * for the sources to be checked against a saved tree */
+typedef struct hawk_tree_src_t hawk_tree_src_t;
+struct hawk_tree_src_t
+{
+	hawk_tree_src_t* next;
+	const hawk_ooch_t* path; /* HAWK_NULL for a string or the standard input */
+	hawk_oow_t hash; /* hash of the text read from the stream */
+	int top; /* 1 for a top-level stream, 0 for an included one */
+};
+
 struct hawk_tree_t
 {
 	hawk_oow_t ngbls; /* total number of globals */
@@ -222,6 +250,8 @@ struct hawk_tree_t
 	hawk_chain_t* chain_tail;
 	hawk_oow_t chain_size; /* number of nodes in the chain */
 
+	hawk_tree_src_t* srcs; /* source streams in the order of first reading */
+	hawk_tree_src_t* srcs_tail;
 	int ok;
 };
 
@@ -275,6 +305,7 @@ struct hawk_t
 		hawk_oow_t rtx_stack_limit;
 		hawk_oow_t log_mask;
 		hawk_oow_t log_maxcapa;
+		hawk_oow_t rtx_gc_budget;
 	} opt;
 
 	/* some temporary workspace */
@@ -338,6 +369,10 @@ struct hawk_t
 		/* maximum number of local variables */
 		hawk_oow_t nlcls_max;
 
+		/* non-zero while parsing a function body where a call
+		 * in the return statement can reuse the function's frame */
+		int tailcall;
+
 		/* some data to find if an expression is
 		 * enclosed in parentheses or not.
 		 * see parse_primary_lparen() and parse_print() in parse.c
@@ -448,6 +483,18 @@ struct hawk_exec_stack_t
 
 typedef struct hawk_exec_stack_t hawk_exec_stack_t;
 
+/* a map lookup by a constant key remembered for the key node */
+struct hawk_rtx_imc_t
+{
+	const hawk_nde_t* nde;
+	hawk_map_t* map;
+	hawk_oow_t rev; /* revision of the map at the time of lookup */
+	hawk_oow_t serial; /* serial number of the map value owning the map */
+	hawk_map_pair_t* pair; /* HAWK_NULL if the key is not found */
+};
+
+typedef struct hawk_rtx_imc_t hawk_rtx_imc_t;
+
 struct hawk_rtx_t
 {
 	HAWK_RTX_HDR;
@@ -457,7 +504,7 @@ struct hawk_rtx_t
 	hawk_oow_t named_slot_count;
 	hawk_oow_t named_slot_capa;
 
-	void** stack;
+	hawk_stack_seg_t stack;
 	hawk_oow_t stack_top;
 	hawk_oow_t stack_base;
 	hawk_oow_t stack_limit;
@@ -470,8 +517,6 @@ struct hawk_rtx_t
 	int exit_level;
 	int init_called;
 
-	hawk_val_ref_t* rcache[128];
-	hawk_oow_t rcache_count;
 
 #if defined(HAWK_ENABLE_STR_CACHE)
 	hawk_val_str_t* str_cache[HAWK_STR_CACHE_NUM_BLOCKS][HAWK_STR_CACHE_BLOCK_SIZE];
@@ -489,6 +534,9 @@ struct hawk_rtx_t
 		hawk_val_chunk_t* ichunk;
 		hawk_val_flt_t* rfree;
 		hawk_val_chunk_t* rchunk;
+		void* sfree[HAWK_VAL_SLAB_NUM_CLASSES];
+		hawk_val_chunk_t* schunk;
+		hawk_rtx_alloc_stat_t stat;
 	} vmgr;
 
 	struct
@@ -512,6 +560,10 @@ struct hawk_rtx_t
 		/* lists of values under gc management */
 		hawk_gch_t g[HAWK_GC_NUM_GENS];
 
+		/* values of the oldest generation that survived the incremental
+		 * collections of the current round */
+		hawk_gch_t swept;
+
 		/*
 		 * Pressure imposed on each generation before gc is triggered
 		 *  pressure[0] - number of allocation attempt since the last gc
@@ -521,11 +573,31 @@ struct hawk_rtx_t
 
 		/* threshold to trigger generational collection. */
 		hawk_oow_t threshold[HAWK_GC_NUM_GENS];
+
+		/* maximum number of values to pick for an automatic collection.
+		 * 0 for collecting the entire generation at once */
+		hawk_oow_t budget;
+
+		/* collection statistics per generation */
+		hawk_rtx_gc_stat_t stat[HAWK_GC_NUM_GENS];
+
+		/* automatic collection is held off while this is positive */
+		int paused;
 	} gc;
 
 	hawk_nde_blk_t* active_block;
 	hawk_uint8_t* pattern_range_state;
 
+	/* json parser kept for hawk_rtx_makejsonvalwithoochars() */
+	void* json;
+
+	/* coroutine scheduler created by hawk_rtx_spawn() */
+	void* coro;
+
+	/* profile data collected while prof_on is set. see prof.c */
+	void* prof;
+	int prof_on;
+
 	struct
 	{
 		hawk_ooch_t buf[1024];
@@ -561,6 +633,7 @@ struct hawk_rtx_t
 		hawk_int8_t stripstrspc;
 		hawk_int8_t numstrdetect;
 		hawk_int8_t pipecloexec;
+		hawk_int8_t jsonl; /* RS is @jsonl */
 
 		hawk_int_t nr;
 		hawk_int_t fnr;
@@ -629,6 +702,23 @@ struct hawk_rtx_t
 		hawk_oow_t capa;
 	} forin; /* keys for for (x in y) ... */
 
+	struct
+	{
+		hawk_fun_t* fun; /* function to run in the current frame. see run_return() */
+		hawk_nde_fncall_t* call;
+		hawk_val_t** ptr; /* arguments evaluated for fun */
+		hawk_oow_t size;
+		hawk_oow_t capa;
+	} tail;
+
+	/* the parse tree is shared by runtimes and stays read-only.
+	 * lookups by a constant key are cached here. see eval_indexed() */
+	struct
+	{
+		hawk_rtx_imc_t* slot; /* HAWK_RTX_IMC_SIZE entries allocated on demand */
+		hawk_oow_t serial; /* serial number given to the last map value made */
+	} imc;
+
 #define HAWK_SIG_WORD_BITS (HAWK_SIZEOF_UINTPTR_T * 8)
 #define HAWK_SIG_WORD_COUNT ((HAWK_NSIG + HAWK_SIG_WORD_BITS - 1) / HAWK_SIG_WORD_BITS)
 
@@ -665,22 +755,35 @@ struct hawk_mod_data_t
 };
 
 
-#define HAWK_RTX_STACK_AT(rtx,n) ((rtx)->stack[(rtx)->stack_base+(n)])
+#define HAWK_RTX_STACK_SEG_BITS (8)
+#define HAWK_RTX_STACK_SEG_SIZE ((hawk_oow_t)1 << HAWK_RTX_STACK_SEG_BITS)
+#define HAWK_RTX_STACK_SEG_MASK (HAWK_RTX_STACK_SEG_SIZE - 1)
+#define HAWK_STACK_SEG_SLOT(stack,n) ((stack)->ptr[(n) >> HAWK_RTX_STACK_SEG_BITS][(n) & HAWK_RTX_STACK_SEG_MASK])
+#define HAWK_RTX_STACK_SLOT(rtx,n) HAWK_STACK_SEG_SLOT(&(rtx)->stack,n)
+
+#define HAWK_RTX_STACK_AT(rtx,n) HAWK_RTX_STACK_SLOT(rtx,(rtx)->stack_base+(n))
 #define HAWK_RTX_STACK_NARGS(rtx) HAWK_RTX_STACK_AT(rtx,3)
 #define HAWK_RTX_STACK_ARG(rtx,n) HAWK_RTX_STACK_AT(rtx,3+1+(n))
 #define HAWK_RTX_STACK_LCL(rtx,n) HAWK_RTX_STACK_AT(rtx,3+(hawk_oow_t)HAWK_RTX_STACK_NARGS(rtx)+1+(n))
 #define HAWK_RTX_STACK_RETVAL(rtx) HAWK_RTX_STACK_AT(rtx,2)
-#define HAWK_RTX_STACK_GBL(rtx,n) ((rtx)->stack[(n)])
+#define HAWK_RTX_STACK_GBL(rtx,n) HAWK_RTX_STACK_SLOT(rtx,n)
 #define HAWK_RTX_STACK_NAMED(rtx,n) ((rtx)->named_slots[(n)])
-#define HAWK_RTX_STACK_RETVAL_GBL(rtx) ((rtx)->stack[(rtx)->hawk->tree.ngbls+2])
+#define HAWK_RTX_STACK_RETVAL_GBL(rtx) HAWK_RTX_STACK_SLOT(rtx,(rtx)->hawk->tree.ngbls+2)
 
 #define HAWK_RTX_STACK_AVAIL(rtx) ((rtx)->stack_limit - (rtx)->stack_top)
 
+/* allocate the segments for n slots above the stack top. check
+ * HAWK_RTX_STACK_AVAIL() against the stack limit before this */
+#define HAWK_RTX_STACK_RESERVE(rtx,n) \
+	((((rtx)->stack.size << HAWK_RTX_STACK_SEG_BITS) - (rtx)->stack_top >= (n))? 0: \
+	 hawk_rtx_growstack(rtx, &(rtx)->stack, (rtx)->stack_top + (n)))
+
 #if defined(HAWK_HAVE_INLINE)
 static HAWK_INLINE void HAWK_RTX_STACK_PUSH (hawk_rtx_t* rtx, hawk_val_t* val)
 {
 	/*HAWK_ASSERT (rtx->stack_top < rtx->stack_limit);*/
-	rtx->stack[rtx->stack_top++] = val;
+	HAWK_RTX_STACK_SLOT(rtx, rtx->stack_top) = val;
+	rtx->stack_top++;
 }
 
 static HAWK_INLINE void HAWK_RTX_STACK_POP (hawk_rtx_t* rtx)
@@ -689,7 +792,7 @@ static HAWK_INLINE void HAWK_RTX_STACK_POP (hawk_rtx_t* rtx)
 	rtx->stack_top--;
 }
 #else
-#define HAWK_RTX_STACK_PUSH(rtx,val) ((rtx)->stack[(rtx)->stack_top++] = val)
+#define HAWK_RTX_STACK_PUSH(rtx,val) (HAWK_RTX_STACK_SLOT(rtx,(rtx)->stack_top) = val, (rtx)->stack_top++)
 #define HAWK_RTX_STACK_POP(rtx) ((rtx)->stack_top--)
 #endif
 
@@ -285,6 +285,17 @@ typedef int (*hawk_sort_comperx_t) (
 	int*        cv
 );
 
+/**
+ * The hawk_sort_intkey_t type defines an item sorted by hawk_rsort_intkeys().
+ * \a ptr is the data associated with the key.
+ */
+struct hawk_sort_intkey_t
+{
+	hawk_int_t key;
+	void*      ptr;
+};
+typedef struct hawk_sort_intkey_t hawk_sort_intkey_t;
+
 
 
 /* =========================================================================
@@ -1178,6 +1189,36 @@ HAWK_EXPORT int hawk_qsortx (
 	void*               ctx
 );
 
+/**
+ * The hawk_rsort_intkeys() function sorts \a nmemb integer keys in the
+ * ascending order with the radix sort. The sort is stable. \a tmp must
+ * point to a buffer that can hold \a nmemb items.
+ */
+HAWK_EXPORT void hawk_rsort_intkeys (
+	hawk_sort_intkey_t* base,
+	hawk_oow_t          nmemb,
+	hawk_sort_intkey_t* tmp
+);
+
+/**
+ * The hawk_psort() function sorts an array with multiple threads.
+ * It sorts \a nthreads chunks of the array in parallel and merges them.
+ * \a comper must not have side effects as it's called from multiple
+ * threads at the same time. \a tmp must point to a buffer as large as
+ * the array. If \a nthreads is 0, it uses as many threads as the
+ * number of online processors. It falls back to hawk_qsort() if threads
+ * are not supported.
+ */
+HAWK_EXPORT void hawk_psort (
+	void*              base,
+	hawk_oow_t         nmemb,
+	hawk_oow_t         size,
+	hawk_sort_comper_t comper,
+	void*              ctx,
+	void*              tmp,
+	hawk_oow_t         nthreads
+);
+
 /* =========================================================================
  * TIME
  * ========================================================================= */
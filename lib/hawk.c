@@ -216,6 +216,7 @@ int hawk_init (hawk_t* hawk, hawk_mmgr_t* mmgr, hawk_cmgr_t* cmgr, const hawk_pr
 	hawk->opt.rtx_stack_limit = HAWK_DFL_RTX_STACK_LIMIT;
 	hawk->opt.log_mask = HAWK_LOG_ALL_LEVELS  | HAWK_LOG_ALL_TYPES;
 	hawk->opt.log_maxcapa = HAWK_DFL_LOG_MAXCAPA;
+	hawk->opt.rtx_gc_budget = 0;
 
 	hawk->log.capa = HAWK_ALIGN_POW2(1, HAWK_LOG_CAPA_ALIGN);
 	hawk->log.ptr = hawk_allocmem(hawk, (hawk->log.capa + 1) * HAWK_SIZEOF(*hawk->log.ptr));
@@ -463,6 +464,7 @@ void hawk_clear (hawk_t* hawk)
 	hawk->parse.param_base = 0;
 
 	hawk->parse.nlcls_max = 0;
+	hawk->parse.tailcall = 0;
 	hawk->parse.depth.block = 0;
 	hawk->parse.depth.loop = 0;
 	hawk->parse.depth.expr = 0;
@@ -524,6 +526,14 @@ void hawk_clear (hawk_t* hawk)
 	hawk->tree.chain_tail = HAWK_NULL;
 	hawk->tree.chain_size = 0;
 
+	while (hawk->tree.srcs)
+	{
+		hawk_tree_src_t* next = hawk->tree.srcs->next;
+		hawk_freemem(hawk, hawk->tree.srcs);
+		hawk->tree.srcs = next;
+	}
+	hawk->tree.srcs_tail = HAWK_NULL;
+
 	/* this table must not be cleared here as there can be a reference
 	 * to an entry of this table from errinf.loc.file when hawk_parse()
 	 * failed. this table is cleared in hawk_parse().
@@ -614,6 +624,10 @@ int hawk_setopt (hawk_t* hawk, hawk_opt_t id, const void* value)
 		case HAWK_OPT_LOG_MAXCAPA:
 			hawk->opt.log_maxcapa = *(hawk_oow_t*)value;
 			return 0;
+
+		case HAWK_OPT_RTX_GC_BUDGET:
+			hawk->opt.rtx_gc_budget = *(const hawk_oow_t*)value;
+			return 0;
 	}
 
 	hawk_seterrnum(hawk, HAWK_NULL, HAWK_EINVAL);
@@ -660,6 +674,10 @@ int hawk_getopt (hawk_t* hawk, hawk_opt_t id, void* value)
 			*(hawk_oow_t*)value = hawk->opt.log_maxcapa;
 			return 0;
 
+		case HAWK_OPT_RTX_GC_BUDGET:
+			*(hawk_oow_t*)value = hawk->opt.rtx_gc_budget;
+			return 0;
+
 	};
 
 	hawk_seterrnum(hawk, HAWK_NULL, HAWK_EINVAL);
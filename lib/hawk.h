@@ -1324,7 +1324,12 @@ enum hawk_opt_t
 
 	HAWK_OPT_RTX_STACK_LIMIT,
 	HAWK_OPT_LOG_MASK,
-	HAWK_OPT_LOG_MAXCAPA
+	HAWK_OPT_LOG_MAXCAPA,
+
+	/** default maximum number of values picked by an automatic garbage
+	 *  collection of a runtime context. 0 for collecting an entire
+	 *  generation at once. See hawk_rtx_setgcbudget(). */
+	HAWK_OPT_RTX_GC_BUDGET
 };
 typedef enum hawk_opt_t hawk_opt_t;
 
@@ -1522,12 +1527,13 @@ enum hawk_gbl_id_t
 	HAWK_GBL_STRIPRECSPC,
 	HAWK_GBL_STRIPSTRSPC,
 	HAWK_GBL_SUBSEP,
+	HAWK_GBL_JSONREC,
 
 	/* these are not not the actual IDs and are used internally only
 	 * Make sure you update these values properly if you add more
 	 * ID definitions, however */
 	HAWK_MIN_GBL_ID = HAWK_GBL_CONVFMT,
-	HAWK_MAX_GBL_ID = HAWK_GBL_SUBSEP
+	HAWK_MAX_GBL_ID = HAWK_GBL_JSONREC
 };
 typedef enum hawk_gbl_id_t hawk_gbl_id_t;
 
@@ -2247,6 +2253,59 @@ HAWK_EXPORT int hawk_parsestd (
 	hawk_parsestd_t* out
 );
 
+/**
+ * The hawk_savetree() function writes the program parsed by hawk_parse()
+ * to a memory block in the binary form that hawk_loadtree() accepts.
+ * The data can be loaded only by the same build of the library.
+ * The caller must free the memory block returned with hawk_freemem().
+ * \return pointer to the memory block on success, #HAWK_NULL on failure.
+ */
+HAWK_EXPORT void* hawk_savetree (
+	hawk_t*     hawk, /**< hawk */
+	hawk_oow_t* len   /**< number of bytes in the memory block returned */
+);
+
+/**
+ * The hawk_loadtree() function restores the program saved with
+ * hawk_savetree() in place of parsing source script. The globals added
+ * with hawk_addgbl() and the modules loadable must be the same as when
+ * the program was saved. It doesn't check if the source files have
+ * changed since. See hawk_loadtreestd().
+ * \return 0 on success, -1 on failure.
+ */
+HAWK_EXPORT int hawk_loadtree (
+	hawk_t*     hawk, /**< hawk */
+	const void* ptr,  /**< data produced by hawk_savetree() */
+	hawk_oow_t  len   /**< number of bytes in the data */
+);
+
+/**
+ * The hawk_istree() function checks if the data given begins with
+ * the header written by hawk_savetree().
+ */
+HAWK_EXPORT int hawk_istree (
+	const void* ptr,
+	hawk_oow_t  len
+);
+
+/**
+ * The hawk_loadtreestd() function loads the program saved with
+ * hawk_savetree() like hawk_loadtree() and checks the source files
+ * recorded in it against their current contents. The top-level files
+ * are read with \a cmgr, or with the default encoding if it is #HAWK_NULL.
+ * If any of them has changed, the top-level source files recorded are
+ * parsed again in place of the saved program. A file that can't be read
+ * is not checked so that the saved program runs without the sources.
+ * \return 0 if the saved program is loaded, 1 if the sources are parsed
+ *         again, -1 on failure.
+ */
+HAWK_EXPORT int hawk_loadtreestd (
+	hawk_t*      hawk, /**< hawk */
+	const void*  ptr,  /**< data produced by hawk_savetree() */
+	hawk_oow_t   len,  /**< number of bytes in the data */
+	hawk_cmgr_t* cmgr  /**< encoding of the top-level source files */
+);
+
 /**
  * The hawk_isvalidident() function determines if a given string is
  * a valid identifier.
@@ -2614,6 +2673,18 @@ HAWK_EXPORT void hawk_rtx_close (
 	hawk_rtx_t* rtx /**< runtime context */
 );
 
+/**
+ * The hawk_rtx_reset() function brings a runtime context that is not
+ * running back to the state right after hawk_rtx_open() so that it can
+ * run the program again. It closes the pending I/O streams, cancels the
+ * coroutines and resets the global variables. The data kept by the
+ * modules for the context is not cleared.
+ * \return 0 on success, -1 on failure
+ */
+HAWK_EXPORT int hawk_rtx_reset (
+	hawk_rtx_t* rtx /**< runtime context */
+);
+
 #if defined(HAWK_HAVE_INLINE)
 static HAWK_INLINE hawk_t* hawk_rtx_gethawk (hawk_rtx_t* rtx) { return ((hawk_rtx_alt_t*)rtx)->hawk; }
 static HAWK_INLINE void* hawk_rtx_getxtn (hawk_rtx_t* rtx) { return (void*)((hawk_uint8_t*)rtx + ((hawk_rtx_alt_t*)rtx)->instsize_); }
@@ -2871,6 +2942,73 @@ HAWK_EXPORT int hawk_rtx_raisesig (
 	int         sig
 );
 
+#define HAWK_RTX_WAITIO_IN  (1 << 0)
+#define HAWK_RTX_WAITIO_OUT (1 << 1)
+
+/**
+ * The hawk_rtx_spawn() function creates a coroutine that calls the function
+ * \a fun with the arguments given. The coroutine starts running when the
+ * caller gives up the processor with hawk_rtx_yield(), hawk_rtx_join(),
+ * hawk_rtx_sleep() or hawk_rtx_waitio().
+ * \return coroutine id greater than 0 on success, -1 on failure
+ */
+HAWK_EXPORT hawk_int_t hawk_rtx_spawn (
+	hawk_rtx_t*  rtx,     /**< runtime context */
+	hawk_fun_t*  fun,     /**< function */
+	hawk_val_t*  args[],  /**< arguments to the function */
+	hawk_oow_t   nargs    /**< the number of arguments */
+);
+
+/**
+ * The hawk_rtx_yield() function lets other coroutines run.
+ * \return 0 on success, -1 if the caller must unwind
+ */
+HAWK_EXPORT int hawk_rtx_yield (
+	hawk_rtx_t*  rtx
+);
+
+/**
+ * The hawk_rtx_join() function waits until the coroutine of the id \a id
+ * finishes. It waits for all other coroutines if \a id is 0.
+ * If \a retv is not #HAWK_NULL, it is set to the return value of the
+ * coroutine joined by id, or to nil otherwise. The caller must call
+ * hawk_rtx_refdownval() on it when done. The return value of a
+ * coroutine is kept until it is joined by id or until the main flow
+ * joins all coroutines.
+ * \return 0 on success, -1 if the caller must unwind
+ */
+HAWK_EXPORT int hawk_rtx_join (
+	hawk_rtx_t*  rtx,
+	hawk_int_t   id,
+	hawk_val_t** retv
+);
+
+/**
+ * The hawk_rtx_waitio() function lets other coroutines run until the
+ * system handle \a handle becomes ready for the events given or the time
+ * specified in \a tmout elapses. A function that would block on the handle
+ * should call it before the blocking operation.
+ * \return 1 if it has waited, 0 if there is no coroutine and the caller
+ *         should block as usual, -1 if the caller must unwind
+ */
+HAWK_EXPORT int hawk_rtx_waitio (
+	hawk_rtx_t*         rtx,
+	hawk_intptr_t       handle,
+	int                 events, /**< bitwise-ORed of HAWK_RTX_WAITIO_IN and HAWK_RTX_WAITIO_OUT */
+	const hawk_ntime_t* tmout   /**< #HAWK_NULL for no timeout */
+);
+
+/**
+ * The hawk_rtx_sleep() function lets other coroutines run for the
+ * duration given.
+ * \return 1 if it has slept, 0 if there is no coroutine and the caller
+ *         should sleep as usual, -1 if the caller must unwind
+ */
+HAWK_EXPORT int hawk_rtx_sleep (
+	hawk_rtx_t*         rtx,
+	const hawk_ntime_t* dur
+);
+
 /**
  * The hawk_rtx_getrio() function copies runtime I/O handlers
  * to the memory buffer pointed to by \a rio.
@@ -3642,6 +3780,19 @@ HAWK_EXPORT hawk_val_t* hawk_rtx_makebobval (
 	hawk_oow_t        len
 );
 
+/**
+ * The hawk_rtx_makejsonvalwithoochars() function parses a JSON text and
+ * creates a value out of it. An object becomes a map and an array becomes
+ * an array value. The parser is kept in the runtime context and reused
+ * in the subsequent calls.
+ * \return value on success, #HAWK_NULL on failure
+ */
+HAWK_EXPORT hawk_val_t* hawk_rtx_makejsonvalwithoochars (
+	hawk_rtx_t*        rtx,
+	const hawk_ooch_t* ptr,
+	hawk_oow_t         len
+);
+
 /**
  * The hawk_rtx_isstaticval() function determines if a value is static.
  * A static value is allocated once and reused until a runtime context @ rtx
@@ -3723,6 +3874,138 @@ HAWK_EXPORT int hawk_rtx_gc (
 	int         gen
 );
 
+#define HAWK_RTX_GC_PAUSE_HIST_SIZE (6)
+
+/**
+ * The hawk_rtx_gc_stat_t type defines the collection statistics of
+ * a generation. The pause times are in microseconds. The pause_hist
+ * array counts the collections whose pause time falls under 10us,
+ * 100us, 1ms, 10ms, 100ms and the rest respectively.
+ */
+struct hawk_rtx_gc_stat_t
+{
+	hawk_oow_t collections; /**< number of collections performed */
+	hawk_oow_t scanned;     /**< number of values scanned */
+	hawk_oow_t freed;       /**< number of unreachable values freed */
+	hawk_oow_t pause_total;
+	hawk_oow_t pause_max;
+	hawk_oow_t pause_hist[HAWK_RTX_GC_PAUSE_HIST_SIZE];
+};
+typedef struct hawk_rtx_gc_stat_t hawk_rtx_gc_stat_t;
+
+/**
+ * The hawk_rtx_getgcstat() function returns the collection statistics
+ * of the generation \a gen.
+ */
+HAWK_EXPORT const hawk_rtx_gc_stat_t* hawk_rtx_getgcstat (
+	hawk_rtx_t* rtx,
+	int         gen
+);
+
+HAWK_EXPORT hawk_oow_t hawk_rtx_getgcbudget (
+	hawk_rtx_t* rtx
+);
+
+/**
+ * The hawk_rtx_setgcbudget() function sets the maximum number of values
+ * an automatic garbage collection picks from a generation. The values
+ * reachable from the picked values are examined together so that a
+ * reference cycle is never split. The rest of the generation is left
+ * for later collections, which bounds the pause of a single collection.
+ * The budget of 0 makes a collection process an entire generation.
+ * An explicit collection with hawk_rtx_gc() is not affected.
+ */
+HAWK_EXPORT void hawk_rtx_setgcbudget (
+	hawk_rtx_t* rtx,
+	hawk_oow_t  budget
+);
+
+/**
+ * The hawk_rtx_alloc_stat_t type defines the value allocation statistics
+ * of a runtime context. A value is either taken from a slab or allocated
+ * with hawk_rtx_allocmem(). A slab is filled with a single allocation of
+ * a chunk when it runs out of slots.
+ */
+struct hawk_rtx_alloc_stat_t
+{
+	hawk_oow_t slab_allocs; /**< number of values taken from slabs */
+	hawk_oow_t slab_chunks; /**< number of chunks allocated for slabs */
+	hawk_oow_t cache_hits;  /**< number of values reused from the string caches */
+	hawk_oow_t heap_allocs; /**< number of values allocated individually */
+};
+typedef struct hawk_rtx_alloc_stat_t hawk_rtx_alloc_stat_t;
+
+/**
+ * The hawk_rtx_getallocstat() function returns the value allocation
+ * statistics of a runtime context.
+ */
+HAWK_EXPORT const hawk_rtx_alloc_stat_t* hawk_rtx_getallocstat (
+	hawk_rtx_t* rtx
+);
+
+/**
+ * The hawk_rtx_opt_t type defines the options of a runtime context.
+ */
+enum hawk_rtx_opt_t
+{
+	/** profiling switch. an int value. non-zero to start collecting
+	 *  the execution profile and 0 to stop. See hawk_rtx_dumpprof(). */
+	HAWK_RTX_OPT_PROFILE
+};
+typedef enum hawk_rtx_opt_t hawk_rtx_opt_t;
+
+/**
+ * The hawk_rtx_setopt() function sets the value of an option
+ * specified by \a id to the value pointed to by \a value.
+ * \return 0 on success, -1 on failure
+ */
+HAWK_EXPORT int hawk_rtx_setopt (
+	hawk_rtx_t*    rtx,
+	hawk_rtx_opt_t id,
+	const void*    value
+);
+
+/**
+ * The hawk_rtx_getopt() function gets the value of an option
+ * specified by \a id into the buffer pointed to by \a value.
+ * \return 0 on success, -1 on failure
+ */
+HAWK_EXPORT int hawk_rtx_getopt (
+	hawk_rtx_t*    rtx,
+	hawk_rtx_opt_t id,
+	void*          value
+);
+
+/**
+ * The hawk_rtx_prof_fmt_t type defines the output formats of
+ * hawk_rtx_dumpprof().
+ */
+enum hawk_rtx_prof_fmt_t
+{
+	/** call counts, inclusive and exclusive time and value allocations of
+	 *  each function, BEGIN, END and pattern-action block and source line
+	 *  sorted by the exclusive time */
+	HAWK_RTX_PROF_REPORT,
+
+	/** call paths with the exclusive time in microseconds, one per line,
+	 *  in the folded format accepted by flame graph tools */
+	HAWK_RTX_PROF_FOLDED
+};
+typedef enum hawk_rtx_prof_fmt_t hawk_rtx_prof_fmt_t;
+
+/**
+ * The hawk_rtx_dumpprof() function formats the profile collected while
+ * #HAWK_RTX_OPT_PROFILE is on. The text is empty if profiling has never
+ * been turned on. The caller must free the text returned with
+ * hawk_rtx_freemem().
+ * \return pointer to the text on success, #HAWK_NULL on failure.
+ */
+HAWK_EXPORT hawk_bch_t* hawk_rtx_dumpprof (
+	hawk_rtx_t*         rtx,
+	hawk_rtx_prof_fmt_t fmt,
+	hawk_oow_t*         len  /**< length of the text returned. may be #HAWK_NULL */
+);
+
 /**
  * The hawk_rtx_valtobool() function converts a value \a val to a boolean
  * value.
@@ -103,7 +103,7 @@ static HAWK_INLINE_ALWAYS pair_t* alloc_pair (hawk_htb_t* htb, void* kptr, hawk_
 	else
 	{
 		VPTR(n) = vcop(htb, vptr, vlen);
-		if (VPTR(n) != HAWK_NULL)
+		if (VPTR(n) == HAWK_NULL)
 		{
 			if (htb->style->freeer[HAWK_HTB_KEY] != HAWK_NULL)
 				htb->style->freeer[HAWK_HTB_KEY](htb, KPTR(n), KLEN(n));
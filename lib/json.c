@@ -27,6 +27,21 @@
 
 #define HAWK_JSON_TOKEN_NAME_ALIGN (64)
 
+#if defined(__SSE2__) && (HAWK_SIZEOF_OOCH_T == 1 || HAWK_SIZEOF_OOCH_T == 2 || HAWK_SIZEOF_OOCH_T == 4)
+#	include <emmintrin.h>
+#	define HAWK_JSON_USE_SSE2
+#	if (HAWK_SIZEOF_OOCH_T == 1)
+#		define JSON_SSE2_SET1(c) _mm_set1_epi8(c)
+#		define JSON_SSE2_CMPEQ(a,b) _mm_cmpeq_epi8(a,b)
+#	elif (HAWK_SIZEOF_OOCH_T == 2)
+#		define JSON_SSE2_SET1(c) _mm_set1_epi16(c)
+#		define JSON_SSE2_CMPEQ(a,b) _mm_cmpeq_epi16(a,b)
+#	else
+#		define JSON_SSE2_SET1(c) _mm_set1_epi32(c)
+#		define JSON_SSE2_CMPEQ(a,b) _mm_cmpeq_epi32(a,b)
+#	endif
+#endif
+
 /* ========================================================================= */
 
 static void clear_token (hawk_json_t* json)
@@ -59,7 +74,7 @@ static int add_chars_to_token (hawk_json_t* json, const hawk_ooch_t* ptr, hawk_o
 {
 	hawk_oow_t i;
 
-	if (json->tok_capa - json->tok.len > len)
+	if (json->tok.len + len > json->tok_capa)
 	{
 		hawk_ooch_t* tmp;
 		hawk_oow_t newcapa;
@@ -696,6 +711,63 @@ start_over:
 
 /* ========================================================================= */
 
+/* find the first double quote or backslash in a string value. SSE2 checks
+ * a whole register of characters at a time for both before the remaining
+ * characters are checked one by one. */
+static HAWK_INLINE const hawk_ooch_t* find_string_stopper (const hawk_ooch_t* ptr, const hawk_ooch_t* end)
+{
+#if defined(HAWK_JSON_USE_SSE2)
+	const __m128i q = JSON_SSE2_SET1('\"');
+	const __m128i bs = JSON_SSE2_SET1('\\');
+
+	while (end - ptr >= (hawk_ooi_t)(16 / HAWK_SIZEOF_OOCH_T))
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)ptr);
+		if (_mm_movemask_epi8(_mm_or_si128(JSON_SSE2_CMPEQ(v, q), JSON_SSE2_CMPEQ(v, bs)))) break;
+		ptr += 16 / HAWK_SIZEOF_OOCH_T;
+	}
+#endif
+
+	while (ptr < end && *ptr != '\"' && *ptr != '\\') ptr++;
+	return ptr;
+}
+
+/* consume a run of characters that don't change the parser state in one go.
+ * string contents and digits are appended to the token at once and blanks
+ * between values are skipped. it returns the number of characters consumed
+ * and 0 if the next character must go through handle_char(). */
+static hawk_oow_t feed_json_span (hawk_json_t* json, const hawk_ooch_t* ptr, const hawk_ooch_t* end)
+{
+	const hawk_ooch_t* p;
+
+	switch (json->state_stack->state)
+	{
+		case HAWK_JSON_STATE_IN_STRING_VALUE:
+			if (json->state_stack->u.sv.escaped) return 0;
+			p = find_string_stopper(ptr, end);
+			break;
+
+		case HAWK_JSON_STATE_IN_NUMERIC_VALUE:
+			if (json->tok.len <= 0) return 0; /* let handle_char() take the sign */
+			for (p = ptr; p < end && hawk_is_ooch_digit(*p); p++) /* nothing */;
+			break;
+
+		case HAWK_JSON_STATE_START:
+		case HAWK_JSON_STATE_IN_ARRAY:
+		case HAWK_JSON_STATE_IN_DIC:
+			for (p = ptr; p < end && hawk_is_ooch_space(*p); p++) /* nothing */;
+			return p - ptr;
+
+		default:
+			return 0;
+	}
+
+	if (p > ptr && add_chars_to_token(json, ptr, p - ptr) <= -1) return (hawk_oow_t)-1;
+	return p - ptr;
+}
+
+/* ========================================================================= */
+
 static int feed_json_data_b (hawk_json_t* json, const hawk_bch_t* data, hawk_oow_t len, hawk_oow_t* xlen)
 {
 	const hawk_bch_t* ptr;
@@ -731,6 +803,16 @@ static int feed_json_data_b (hawk_json_t* json, const hawk_bch_t* data, hawk_oow
 		ptr += n;
 		c = uc;
 	#else
+		hawk_oow_t n;
+
+		n = feed_json_span(json, ptr, end);
+		if (n == (hawk_oow_t)-1) goto oops;
+		if (n > 0)
+		{
+			ptr += n;
+			continue;
+		}
+
 		c = *ptr++;
 	#endif
 
@@ -762,6 +844,16 @@ static int feed_json_data_u (hawk_json_t* json, const hawk_uch_t* data, hawk_oow
 		hawk_ooci_t c;
 
 	#if defined(HAWK_OOCH_IS_UCH)
+		hawk_oow_t n;
+
+		n = feed_json_span(json, ptr, end);
+		if (n == (hawk_oow_t)-1) goto oops;
+		if (n > 0)
+		{
+			ptr += n;
+			continue;
+		}
+
 		c = *ptr++;
 		/* handle a single character */
 		if (handle_char(json, c) <= -1) goto oops;
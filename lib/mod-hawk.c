@@ -59,6 +59,7 @@ static hawk_oow_t push_args_from_stack (hawk_rtx_t* rtx, const hawk_loc_t* call_
 		hawk_rtx_seterrnum(rtx, call_loc, HAWK_ESTACK);
 		return (hawk_oow_t)-1;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, pasf->end_index - pasf->start_index + 1) <= -1)) return (hawk_oow_t)-1;
 
 	org_stack_base = rtx->stack_base;
 	for (i = pasf->start_index, j = 0; i <= pasf->end_index; i++, j++)
@@ -188,6 +189,61 @@ static int fnc_call (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	return 0;
 }
 
+/*
+ * function worker(id, n) { while (n-- > 0) { print id, n; hawk::yield(); } }
+ * BEGIN { hawk::spawn(worker, "a", 3); hawk::spawn(worker, "b", 3); hawk::join(); }
+ */
+static int fnc_spawn (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_fun_t* fun;
+	hawk_oow_t nargs, i;
+	hawk_val_t* args[16], ** argp;
+	hawk_int_t id;
+
+	fun = hawk_rtx_valtofun(rtx, hawk_rtx_getarg(rtx, 0));
+	if (!fun) return -1; /* hard failure */
+
+	nargs = hawk_rtx_getnargs(rtx) - 1;
+	argp = args;
+	if (nargs > HAWK_COUNTOF(args))
+	{
+		argp = (hawk_val_t**)hawk_rtx_allocmem(rtx, nargs * HAWK_SIZEOF(*argp));
+		if (HAWK_UNLIKELY(!argp)) return -1;
+	}
+	for (i = 0; i < nargs; i++) argp[i] = hawk_rtx_getarg(rtx, i + 1);
+
+	id = hawk_rtx_spawn(rtx, fun, argp, nargs);
+	if (argp != args) hawk_rtx_freemem(rtx, argp);
+	if (id <= -1) return -1; /* hard failure */
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, id));
+	return 0;
+}
+
+static int fnc_yield (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	/* the failure indicates an error in another coroutine or
+	 * the program termination. let the caller unwind */
+	if (hawk_rtx_yield(rtx) <= -1) return -1;
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, 0));
+	return 0;
+}
+
+static int fnc_join (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_int_t id = 0;
+	hawk_val_t* v;
+
+	if (hawk_rtx_getnargs(rtx) >= 1 && hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 0), &id) <= -1) return -1;
+	if (id < 0) id = 0;
+	if (hawk_rtx_join(rtx, id, &v) <= -1) return -1;
+
+	/* the return value of the coroutine joined by id. 0 for all */
+	hawk_rtx_setretval(rtx, (id > 0? v: hawk_rtx_makeintval_inline(rtx, 0)));
+	hawk_rtx_refdownval(rtx, v);
+	return 0;
+}
+
 /* hawk::function_exists("xxxx");
  * hawk::function_exists("sys::getpid") */
 static int fnc_function_exists (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
@@ -262,6 +318,9 @@ static int fnc_cmgr_exists (hawk_rtx_t* rtx, const hawk_fnc_info_t*  fi)
    hawk::gc();
    hawk::gc_get_threshold(gen)
    hawk::gc_set_threshold(gen, threshold)
+   hawk::gc_get_budget()
+   hawk::gc_set_budget(budget)
+   hawk::gc_stats(gen)
    hawk::GC_NUM_GENS
  */
 
@@ -337,6 +396,124 @@ static int fnc_gc_set_threshold (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	return 0;
 }
 
+static int fnc_gc_get_budget (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_int_t budget = 0;
+
+#if defined(HAWK_ENABLE_GC)
+	budget = hawk_rtx_getgcbudget(rtx);
+	if (budget >= HAWK_INT_MAX) budget = HAWK_INT_MAX;
+#endif
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, budget));
+	return 0;
+}
+
+static int fnc_gc_set_budget (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_int_t budget = 0;
+
+#if defined(HAWK_ENABLE_GC)
+	if (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 0), &budget) <= -1) budget = -1;
+
+	if (budget >= 0)
+	{
+		hawk_rtx_setgcbudget(rtx, budget); /* update */
+	}
+	else
+	{
+		budget = hawk_rtx_getgcbudget(rtx); /* no update. but retrieve the existing value */
+	}
+	if (budget >= HAWK_INT_MAX) budget = HAWK_INT_MAX;
+#endif
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, budget));
+	return 0;
+}
+
+static int fnc_gc_stats (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_int_t gen;
+	hawk_rtx_gc_stat_t st;
+	hawk_val_map_data_t md[5];
+	hawk_val_t* map, * hist, * tmp;
+	hawk_oow_t i;
+
+	if (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 0), &gen) <= -1) gen = 0;
+	if (gen < 0) gen = 0;
+	else if (gen >= HAWK_COUNTOF(rtx->gc.g)) gen = HAWK_COUNTOF(rtx->gc.g) - 1;
+
+#if defined(HAWK_ENABLE_GC)
+	st = *hawk_rtx_getgcstat(rtx, gen);
+#else
+	HAWK_MEMSET(&st, 0, HAWK_SIZEOF(st));
+#endif
+
+	HAWK_MEMSET(md, 0, HAWK_SIZEOF(md));
+
+	md[0].key.ptr = HAWK_T("collections");
+	md[0].key.len = 11;
+	md[0].type = HAWK_VAL_MAP_DATA_INT;
+	md[0].type_size = HAWK_SIZEOF(st.collections);
+	md[0].vptr = &st.collections;
+
+	md[1].key.ptr = HAWK_T("scanned");
+	md[1].key.len = 7;
+	md[1].type = HAWK_VAL_MAP_DATA_INT;
+	md[1].type_size = HAWK_SIZEOF(st.scanned);
+	md[1].vptr = &st.scanned;
+
+	md[2].key.ptr = HAWK_T("freed");
+	md[2].key.len = 5;
+	md[2].type = HAWK_VAL_MAP_DATA_INT;
+	md[2].type_size = HAWK_SIZEOF(st.freed);
+	md[2].vptr = &st.freed;
+
+	md[3].key.ptr = HAWK_T("pause_total");
+	md[3].key.len = 11;
+	md[3].type = HAWK_VAL_MAP_DATA_INT;
+	md[3].type_size = HAWK_SIZEOF(st.pause_total);
+	md[3].vptr = &st.pause_total;
+
+	md[4].key.ptr = HAWK_T("pause_max");
+	md[4].key.len = 9;
+	md[4].type = HAWK_VAL_MAP_DATA_INT;
+	md[4].type_size = HAWK_SIZEOF(st.pause_max);
+	md[4].vptr = &st.pause_max;
+
+	map = hawk_rtx_makemapvalwithdata(rtx, md, HAWK_COUNTOF(md));
+	if (HAWK_UNLIKELY(!map)) return -1;
+	hawk_rtx_refupval(rtx, map);
+
+	/* pause_hist[1] .. pause_hist[HAWK_RTX_GC_PAUSE_HIST_SIZE] */
+	hist = hawk_rtx_makearrval(rtx, HAWK_COUNTOF(st.pause_hist) + 1);
+	if (HAWK_UNLIKELY(!hist)) goto oops;
+	if (HAWK_UNLIKELY(!hawk_rtx_setmapvalfld(rtx, map, HAWK_T("pause_hist"), 10, hist)))
+	{
+		hawk_rtx_freeval(rtx, hist, 0);
+		goto oops;
+	}
+
+	for (i = 0; i < HAWK_COUNTOF(st.pause_hist); i++)
+	{
+		tmp = hawk_rtx_makeintval(rtx, (st.pause_hist[i] >= HAWK_INT_MAX? HAWK_INT_MAX: st.pause_hist[i]));
+		if (HAWK_UNLIKELY(!tmp)) goto oops;
+		if (HAWK_UNLIKELY(!hawk_rtx_setarrvalfld(rtx, hist, i + 1, tmp)))
+		{
+			hawk_rtx_freeval(rtx, tmp, 0);
+			goto oops;
+		}
+	}
+
+	hawk_rtx_setretval(rtx, map);
+	hawk_rtx_refdownval(rtx, map);
+	return 0;
+
+oops:
+	hawk_rtx_refdownval(rtx, map);
+	return -1;
+}
+
 static int fnc_gcrefs (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	hawk_val_t* a0;
@@ -347,6 +524,50 @@ static int fnc_gcrefs (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 /* -------------------------------------------------------------------------- */
 
+static int fnc_alloc_stats (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_rtx_alloc_stat_t st;
+	hawk_val_map_data_t md[4];
+	hawk_val_t* map;
+
+	/* take a copy as making the map below changes the statistics */
+	st = *hawk_rtx_getallocstat(rtx);
+
+	HAWK_MEMSET(md, 0, HAWK_SIZEOF(md));
+
+	md[0].key.ptr = HAWK_T("slab_allocs");
+	md[0].key.len = 11;
+	md[0].type = HAWK_VAL_MAP_DATA_INT;
+	md[0].type_size = HAWK_SIZEOF(st.slab_allocs);
+	md[0].vptr = &st.slab_allocs;
+
+	md[1].key.ptr = HAWK_T("slab_chunks");
+	md[1].key.len = 11;
+	md[1].type = HAWK_VAL_MAP_DATA_INT;
+	md[1].type_size = HAWK_SIZEOF(st.slab_chunks);
+	md[1].vptr = &st.slab_chunks;
+
+	md[2].key.ptr = HAWK_T("cache_hits");
+	md[2].key.len = 10;
+	md[2].type = HAWK_VAL_MAP_DATA_INT;
+	md[2].type_size = HAWK_SIZEOF(st.cache_hits);
+	md[2].vptr = &st.cache_hits;
+
+	md[3].key.ptr = HAWK_T("heap_allocs");
+	md[3].key.len = 11;
+	md[3].type = HAWK_VAL_MAP_DATA_INT;
+	md[3].type_size = HAWK_SIZEOF(st.heap_allocs);
+	md[3].vptr = &st.heap_allocs;
+
+	map = hawk_rtx_makemapvalwithdata(rtx, md, HAWK_COUNTOF(md));
+	if (HAWK_UNLIKELY(!map)) return -1;
+
+	hawk_rtx_setretval(rtx, map);
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
 static int fnc_size (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	/* similar to length, but it returns the ubound + 1 for the array */
@@ -430,6 +651,59 @@ static int fnc_map (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	return 0;
 }
 
+static int fnc_clone (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_val_t* a0, * tmp;
+
+	/*
+	 * BEGIN {
+	 *   @local a, b;
+	 *   a["x"] = 10;
+	 *   b = hawk::clone(a);
+	 *   b["x"] = 20; ## a["x"] stays 10
+	 * }
+	 */
+	a0 = hawk_rtx_getarg(rtx, 0);
+	switch (HAWK_RTX_GETVALTYPE(rtx, a0))
+	{
+		case HAWK_VAL_MAP:
+			/* no copying until either map is changed */
+			tmp = hawk_rtx_clonemapval(rtx, a0);
+			if (HAWK_UNLIKELY(!tmp)) return -1;
+			break;
+
+		case HAWK_VAL_ARR:
+		{
+			hawk_arr_t* arr;
+			hawk_oow_t size, i;
+
+			arr = ((hawk_val_arr_t*)a0)->arr;
+			size = HAWK_ARR_SIZE(arr);
+
+			tmp = hawk_rtx_makearrval(rtx, ((size > 0)? size: -1));
+			if (HAWK_UNLIKELY(!tmp)) return -1;
+
+			for (i = 0; i < size; i++)
+			{
+				if (HAWK_ARR_SLOT(arr, i) && HAWK_UNLIKELY(hawk_rtx_setarrvalfld(rtx, tmp, i, (hawk_val_t*)HAWK_ARR_DPTR(arr, i)) == HAWK_NULL))
+				{
+					hawk_rtx_freeval(rtx, tmp, 0);
+					return -1;
+				}
+			}
+			break;
+		}
+
+		default:
+			/* other values are never changed in place */
+			tmp = a0;
+			break;
+	}
+
+	hawk_rtx_setretval(rtx, tmp);
+	return 0;
+}
+
 /* -------------------------------------------------------------------------- */
 
 static int fnc_isnil (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
@@ -534,32 +808,305 @@ static int fnc_hash (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 /* -------------------------------------------------------------------------- */
 
+/*
+	hawk::topk(a, k [, cmp]) returns an array of the k greatest values
+	in a map or an array, the greatest first. the optional comparator
+	works like the one for asort(). only k values are kept in a bounded
+	min-heap while scanning the container, so the work is O(n log k)
+	without copying every value around for a full sort.
+
+	@local x, i;
+	x = hawk::topk(counts, 10);
+	for (i = 1; i <= length(x); i++) print x[i];
+*/
+
+struct topk_t
+{
+	hawk_rtx_t* rtx;
+	hawk_fun_t* fun;
+	hawk_val_t** heap;
+	hawk_oow_t size;
+	hawk_oow_t capa;
+};
+typedef struct topk_t topk_t;
+
+static int topk_compare (topk_t* tk, hawk_val_t* v1, hawk_val_t* v2, int* cv)
+{
+	if (tk->fun)
+	{
+		hawk_val_t* r, * args[2];
+		hawk_int_t rv;
+		int n;
+
+		args[0] = v1;
+		args[1] = v2;
+		r = hawk_rtx_callfun(tk->rtx, tk->fun, args, 2);
+		if (HAWK_UNLIKELY(!r)) return -1;
+		n = hawk_rtx_valtoint(tk->rtx, r, &rv);
+		hawk_rtx_refdownval(tk->rtx, r);
+		if (HAWK_UNLIKELY(n <= -1)) return -1;
+		*cv = (rv > 0)? 1: (rv < 0)? -1: 0;
+		return 0;
+	}
+
+	return hawk_rtx_cmpval(tk->rtx, v1, v2, cv);
+}
+
+static int topk_sift_down (topk_t* tk, hawk_oow_t n, hawk_oow_t i)
+{
+	while (1)
+	{
+		hawk_oow_t l, r, m;
+		hawk_val_t* tmp;
+		int x;
+
+		l = i * 2 + 1;
+		if (l >= n) break;
+
+		m = l;
+		r = l + 1;
+		if (r < n)
+		{
+			if (HAWK_UNLIKELY(topk_compare(tk, tk->heap[r], tk->heap[l], &x) <= -1)) return -1;
+			if (x < 0) m = r;
+		}
+
+		if (HAWK_UNLIKELY(topk_compare(tk, tk->heap[m], tk->heap[i], &x) <= -1)) return -1;
+		if (x >= 0) break;
+
+		tmp = tk->heap[m];
+		tk->heap[m] = tk->heap[i];
+		tk->heap[i] = tmp;
+		i = m;
+	}
+
+	return 0;
+}
+
+static int topk_add (topk_t* tk, hawk_val_t* v)
+{
+	if (tk->size < tk->capa)
+	{
+		hawk_oow_t i, p;
+		int x;
+
+		/* sift up the new value */
+		hawk_rtx_refupval(tk->rtx, v);
+		i = tk->size++;
+		tk->heap[i] = v;
+		while (i > 0)
+		{
+			p = (i - 1) / 2;
+			if (HAWK_UNLIKELY(topk_compare(tk, tk->heap[i], tk->heap[p], &x) <= -1)) return -1;
+			if (x >= 0) break;
+			tk->heap[i] = tk->heap[p];
+			tk->heap[p] = v;
+			i = p;
+		}
+	}
+	else
+	{
+		int x;
+
+		/* replace the smallest kept if the new value is greater */
+		if (HAWK_UNLIKELY(topk_compare(tk, v, tk->heap[0], &x) <= -1)) return -1;
+		if (x <= 0) return 0;
+
+		hawk_rtx_refupval(tk->rtx, v);
+		hawk_rtx_refdownval(tk->rtx, tk->heap[0]);
+		tk->heap[0] = v;
+		if (HAWK_UNLIKELY(topk_sift_down(tk, tk->size, 0) <= -1)) return -1;
+	}
+
+	return 0;
+}
+
+static int fnc_topk (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	hawk_val_t* a0, * r;
+	hawk_val_type_t a0_type;
+	hawk_int_t k;
+	hawk_oow_t i, n, msz, nva = 0;
+	hawk_val_t** va = HAWK_NULL;
+	topk_t tk;
+	int ret = -1;
+
+	HAWK_MEMSET(&tk, 0, HAWK_SIZEOF(tk));
+	tk.rtx = rtx;
+
+	a0 = hawk_rtx_getarg(rtx, 0);
+	a0_type = HAWK_RTX_GETVALTYPE(rtx, a0);
+	if (a0_type != HAWK_VAL_MAP && a0_type != HAWK_VAL_ARR && a0_type != HAWK_VAL_NIL)
+	{
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_ENOTIDXACC);
+		return -1;
+	}
+
+	if (hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 1), &k) <= -1) return -1;
+	if (k < 0) k = 0;
+
+	if (hawk_rtx_getnargs(rtx) >= 3)
+	{
+		tk.fun = hawk_rtx_valtofun(rtx, hawk_rtx_getarg(rtx, 2));
+		if (HAWK_UNLIKELY(!tk.fun))
+		{
+			if (hawk_rtx_geterrnum(rtx) == HAWK_EINVAL)
+				hawk_rtx_seterrfmt(rtx, HAWK_NULL, HAWK_EINVAL, HAWK_T("comparator not a function"));
+			return -1;
+		}
+
+		if (tk.fun->nargs < 2)
+		{
+			hawk_rtx_seterrfmt(rtx, HAWK_NULL, HAWK_EINVAL, HAWK_T("%.*js not accepting 2 arguments"), tk.fun->name.len, tk.fun->name.ptr);
+			return -1;
+		}
+	}
+
+	msz = (a0_type == HAWK_VAL_MAP)? hawk_map_getsize(((hawk_val_map_t*)a0)->map):
+	      (a0_type == HAWK_VAL_ARR)? HAWK_ARR_TALLY(((hawk_val_arr_t*)a0)->arr): 0;
+	if ((hawk_oow_t)k > msz) k = msz;
+
+	r = hawk_rtx_makearrval(rtx, ((k > 0)? k: -1));
+	if (HAWK_UNLIKELY(!r)) return -1;
+	hawk_rtx_refupval(rtx, r);
+	if (k <= 0) goto done;
+
+	tk.capa = k;
+	tk.heap = (hawk_val_t**)hawk_rtx_allocmem(rtx, tk.capa * HAWK_SIZEOF(*tk.heap));
+	if (HAWK_UNLIKELY(!tk.heap)) goto oops;
+
+	if (tk.fun)
+	{
+		/* the comparator may change the container. take a snapshot of
+		 * the values before scanning them */
+		va = (hawk_val_t**)hawk_rtx_allocmem(rtx, msz * HAWK_SIZEOF(*va));
+		if (HAWK_UNLIKELY(!va)) goto oops;
+	}
+
+	if (a0_type == HAWK_VAL_MAP)
+	{
+		hawk_val_map_itr_t itr;
+		hawk_val_map_itr_t* iptr;
+
+		iptr = hawk_rtx_getfirstmapvalitr(rtx, a0, &itr);
+		while (iptr)
+		{
+			hawk_val_t* v = (hawk_val_t*)HAWK_VAL_MAP_ITR_VAL(iptr);
+			if (va)
+			{
+				va[nva++] = v;
+				hawk_rtx_refupval(rtx, v);
+			}
+			else if (HAWK_UNLIKELY(topk_add(&tk, v) <= -1)) goto oops;
+			iptr = hawk_rtx_getnextmapvalitr(rtx, a0, &itr);
+		}
+	}
+	else
+	{
+		hawk_arr_t* arr = ((hawk_val_arr_t*)a0)->arr;
+		for (i = 0; i < HAWK_ARR_SIZE(arr); i++)
+		{
+			hawk_val_t* v;
+			if (!HAWK_ARR_SLOT(arr, i)) continue;
+			v = (hawk_val_t*)HAWK_ARR_DPTR(arr, i);
+			if (va)
+			{
+				va[nva++] = v;
+				hawk_rtx_refupval(rtx, v);
+			}
+			else if (HAWK_UNLIKELY(topk_add(&tk, v) <= -1)) goto oops;
+		}
+	}
+
+	if (va)
+	{
+		for (i = 0; i < nva; i++)
+		{
+			if (HAWK_UNLIKELY(topk_add(&tk, va[i]) <= -1)) goto oops;
+		}
+	}
+
+	/* pop the smallest to the back one by one. the heap ends up
+	 * holding the values in the descending order */
+	n = tk.size;
+	while (n > 1)
+	{
+		hawk_val_t* tmp;
+		n--;
+		tmp = tk.heap[0];
+		tk.heap[0] = tk.heap[n];
+		tk.heap[n] = tmp;
+		if (HAWK_UNLIKELY(topk_sift_down(&tk, n, 0) <= -1)) goto oops;
+	}
+
+	for (i = 0; i < tk.size; i++)
+	{
+		if (HAWK_UNLIKELY(!hawk_rtx_setarrvalfld(rtx, r, i + 1, tk.heap[i]))) goto oops;
+	}
+
+done:
+	ret = 0;
+
+oops:
+	if (va)
+	{
+		while (nva > 0) hawk_rtx_refdownval(rtx, va[--nva]);
+		hawk_rtx_freemem(rtx, va);
+	}
+	if (tk.heap)
+	{
+		for (i = 0; i < tk.size; i++) hawk_rtx_refdownval(rtx, tk.heap[i]);
+		hawk_rtx_freemem(rtx, tk.heap);
+	}
+
+	if (ret <= -1)
+	{
+		hawk_rtx_refdownval(rtx, r);
+		return -1;
+	}
+
+	hawk_rtx_refdownval_nofree(rtx, r);
+	hawk_rtx_setretval(rtx, r);
+	return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
 #define A_MAX HAWK_TYPE_MAX(hawk_oow_t)
 
 static hawk_mod_fnc_tab_t fnctab[] =
 {
 	/* keep this table sorted for binary search in query(). */
+	{ HAWK_T("alloc_stats"),      { { 0, 0,     HAWK_NULL     },  fnc_alloc_stats,           0 } },
 	{ HAWK_T("array"),            { { 0, A_MAX, HAWK_NULL     },  fnc_array,                 0 } },
 	{ HAWK_T("bool"),             { { 1, 1,     HAWK_NULL     },  fnc_bool,                  0 } },
 	{ HAWK_T("call"),             { { 1, A_MAX, HAWK_T("vR")  },  fnc_call,                  0 } },
+	{ HAWK_T("clone"),            { { 1, 1,     HAWK_NULL     },  fnc_clone,                 0 } },
 	{ HAWK_T("cmgr_exists"),      { { 1, 1,     HAWK_NULL     },  fnc_cmgr_exists,           0 } },
 	{ HAWK_T("function_exists"),  { { 1, 1,     HAWK_NULL     },  fnc_function_exists,       0 } },
 	{ HAWK_T("gc"),               { { 0, 1,     HAWK_NULL     },  fnc_gc,                    0 } },
+	{ HAWK_T("gc_get_budget"),    { { 0, 0,     HAWK_NULL     },  fnc_gc_get_budget,         0 } },
 	{ HAWK_T("gc_get_pressure"),  { { 1, 1,     HAWK_NULL     },  fnc_gc_get_pressure,       0 } },
 	{ HAWK_T("gc_get_threshold"), { { 1, 1,     HAWK_NULL     },  fnc_gc_get_threshold,      0 } },
+	{ HAWK_T("gc_set_budget"),    { { 1, 1,     HAWK_NULL     },  fnc_gc_set_budget,         0 } },
 	{ HAWK_T("gc_set_threshold"), { { 2, 2,     HAWK_NULL     },  fnc_gc_set_threshold,      0 } },
+	{ HAWK_T("gc_stats"),         { { 1, 1,     HAWK_NULL     },  fnc_gc_stats,              0 } },
 	{ HAWK_T("gcrefs"),           { { 1, 1,     HAWK_NULL     },  fnc_gcrefs,                0 } },
 	{ HAWK_T("hash"),             { { 1, 1,     HAWK_NULL     },  fnc_hash,                  0 } },
 	{ HAWK_T("int"),              { { 1, 1,     HAWK_NULL     },  hawk_fnc_int,              0 } },
 	{ HAWK_T("isarray"),          { { 1, 1,     HAWK_NULL     },  fnc_isarr,                 0 } },
 	{ HAWK_T("ismap"),            { { 1, 1,     HAWK_NULL     },  fnc_ismap,                 0 } },
 	{ HAWK_T("isnil"),            { { 1, 1,     HAWK_NULL     },  fnc_isnil,                 0 } },
+	{ HAWK_T("join"),             { { 0, 1,     HAWK_NULL     },  fnc_join,                  0 } },
 	{ HAWK_T("length"),           { { 1, 1,     HAWK_NULL     },  fnc_length,                0 } },
 	{ HAWK_T("map"),              { { 0, A_MAX, HAWK_NULL     },  fnc_map,                   0 } },
 	{ HAWK_T("modlibdirs"),       { { 0, 0,     HAWK_NULL     },  fnc_modlibdirs,            0 } },
 	{ HAWK_T("size"),             { { 1, 1,     HAWK_NULL     },  fnc_size,                  0 } },
+	{ HAWK_T("spawn"),            { { 1, A_MAX, HAWK_NULL     },  fnc_spawn,                 0 } },
+	{ HAWK_T("topk"),             { { 2, 3,     HAWK_NULL     },  fnc_topk,                  0 } },
 	{ HAWK_T("type"),             { { 1, 1,     HAWK_NULL     },  fnc_type,                  0 } },
-	{ HAWK_T("typename"),         { { 1, 1,     HAWK_NULL     },  fnc_typename,              0 } }
+	{ HAWK_T("typename"),         { { 1, 1,     HAWK_NULL     },  fnc_typename,              0 } },
+	{ HAWK_T("yield"),            { { 0, 0,     HAWK_NULL     },  fnc_yield,                 0 } }
 };
 
 static hawk_mod_int_tab_t inttab[] =
@@ -55,7 +55,21 @@
 #		endif
 #	endif
 
+#	if defined(USE_EPOLL) && defined(HAVE_LINUX_IO_URING_H) && (defined(__GNUC__) || defined(__clang__))
+#		include <linux/io_uring.h>
+#		include <sys/mman.h>
+#		if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_FEAT_EXT_ARG)
+#			define USE_IO_URING
+#		endif
+#	endif
+#	if defined(HAVE_POLL_H)
+#		include <poll.h>
+#	endif
+
 #	include <sys/socket.h>
+#	if defined(HAVE_SYS_SENDFILE_H)
+#		include <sys/sendfile.h>
+#	endif
 
 #	define ENABLE_TERMIOS
 #	include <termios.h>
@@ -140,6 +154,9 @@ typedef struct rtx_data_t rtx_data_t;
 
 struct mod_ctx_t
 {
+	/* runtime contexts running over the same hawk object in multiple
+	 * threads add, find and remove their data at the same time */
+	hawk_mtx_t mtx;
 	hawk_rbt_t* rtxtab;
 };
 typedef struct mod_ctx_t mod_ctx_t;
@@ -169,7 +186,11 @@ typedef enum sys_node_data_type_t sys_node_data_type_t;
 
 enum sys_node_data_flag_t
 {
-	SYS_NODE_DATA_FLAG_IN_MUX = (1 << 0)
+	SYS_NODE_DATA_FLAG_IN_MUX = (1 << 0),
+
+	/* used while sys::waitonmux() performs queued operations without io_uring */
+	SYS_NODE_DATA_FLAG_MUX_RD_DONE = (1 << 1),
+	SYS_NODE_DATA_FLAG_MUX_WR_DONE = (1 << 2)
 };
 typedef enum sys_node_data_flag_t sys_node_data_flag_t;
 
@@ -180,20 +201,88 @@ struct sys_node_data_file_t
 	void* mux; /* if SYS_NODE_DATA_FLAG_IN_MUX is set, this is set to a valid pointer. it is of the void* type since sys_node_t is not available yet. */
 	void* x_prev;
 	void* x_next;
+	void* opmux; /* the multiplexer holding the operations queued on this node if op_count is not 0 */
+	hawk_oow_t op_count;
 };
 typedef struct sys_node_data_file_t sys_node_data_file_t;
 
+enum mux_op_type_t
+{
+	MUX_OP_READ,
+	MUX_OP_WRITE,
+	MUX_OP_ACCEPT
+};
+typedef enum mux_op_type_t mux_op_type_t;
+
+/* an operation queued with sys::readonmux(), sys::writeonmux() or sys::acceptonmux().
+ * it stays with the multiplexer until the completion is collected by sys::waitonmux()
+ * and is released by the next call to sys::waitonmux(). */
+typedef struct mux_op_t mux_op_t;
+struct mux_op_t
+{
+	mux_op_type_t type;
+	int flags;
+	void* node; /* HAWK_NULL if the node has been closed while the operation is outstanding */
+	hawk_int_t result;
+	mux_op_t* prev;
+	mux_op_t* next;
+	hawk_oow_t len;
+	hawk_bch_t buf[1];
+};
+
+#if defined(USE_IO_URING)
+struct mux_uring_t
+{
+	int fd;
+	unsigned int sq_entries;
+	unsigned int sq_tail; /* local tail not yet published to the kernel */
+	unsigned int* sq_khead;
+	unsigned int* sq_ktail;
+	unsigned int* sq_kmask;
+	unsigned int* sq_karray;
+	unsigned int* cq_khead;
+	unsigned int* cq_ktail;
+	unsigned int* cq_kmask;
+	struct io_uring_cqe* cqes;
+	struct io_uring_sqe* sqes;
+	void* sq_ptr;
+	hawk_oow_t sq_size;
+	void* cq_ptr;
+	hawk_oow_t cq_size;
+	hawk_oow_t sqes_size;
+	int epoll_armed;
+};
+typedef struct mux_uring_t mux_uring_t;
+#endif
+
 struct sys_node_data_mux_t
 {
 #if defined(USE_EPOLL)
 	int fd;
 	struct epoll_event* x_evt;
+#endif
+#if defined(USE_IO_URING)
+	mux_uring_t* uring; /* HAWK_NULL if the operations are carried out over epoll */
 #endif
 	void* x_first;
 	void* x_last;
 	hawk_oow_t x_count;
 	hawk_oow_t x_evt_max;
 	hawk_oow_t x_evt_count;
+
+	/* outstanding operations */
+	mux_op_t* op_first;
+	mux_op_t* op_last;
+	hawk_oow_t op_count;
+
+	/* operations completed by the last sys::waitonmux() */
+	mux_op_t** x_cpl;
+	hawk_oow_t x_cpl_max;
+	hawk_oow_t x_cpl_count;
+#if defined(HAVE_POLL_H)
+	struct pollfd* x_pfd;
+	hawk_oow_t x_pfd_max;
+#endif
 };
 typedef struct sys_node_data_mux_t sys_node_data_mux_t;
 
@@ -276,13 +365,23 @@ enum mux_evt_code_t
 	MUX_EVT_IN  = EPOLLIN,
 	MUX_EVT_OUT = EPOLLOUT,
 	MUX_EVT_ERR = EPOLLERR,
-	MUX_EVT_HUP = EPOLLHUP
+	MUX_EVT_HUP = EPOLLHUP,
 #else
 	MUX_EVT_IN  = (1 << 0),
 	MUX_EVT_OUT = (1 << 1),
 	MUX_EVT_ERR = (1 << 2),
-	MUX_EVT_HUP = (1 << 3)
+	MUX_EVT_HUP = (1 << 3),
 #endif
+
+	/* completion of a queued operation. these don't overlap with the epoll bits */
+	MUX_EVT_READ   = (1 << 16),
+	MUX_EVT_WRITE  = (1 << 17),
+	MUX_EVT_ACCEPT = (1 << 18)
+};
+
+enum mux_open_flag_t
+{
+	MUX_URING = (1 << 0)
 };
 
 /* ------------------------------------------------------------------------ */
@@ -385,6 +484,7 @@ static sys_node_t* new_sys_node_fd (hawk_rtx_t* rtx, sys_list_t* list, int fd)
 
 	node->ctx.type = SYS_NODE_DATA_TYPE_FILE;
 	node->ctx.flags = 0;
+	HAWK_MEMSET (&node->ctx.u.file, 0, HAWK_SIZEOF(node->ctx.u.file)); /* a node may be recycled */
 	node->ctx.u.file.fd = fd;
 	return node;
 }
@@ -411,6 +511,7 @@ static sys_node_t* new_sys_node_mux (hawk_rtx_t* rtx, sys_list_t* list, int fd)
 
 	node->ctx.type = SYS_NODE_DATA_TYPE_MUX;
 	node->ctx.flags = 0;
+	HAWK_MEMSET (&node->ctx.u.mux, 0, HAWK_SIZEOF(node->ctx.u.mux)); /* a node may be recycled */
 #if defined(USE_EPOLL)
 	node->ctx.u.mux.fd = fd;
 #endif
@@ -504,12 +605,425 @@ static void purge_mux_members (hawk_rtx_t* rtx, sys_node_t* mux_node)
 	}
 }
 
+/* ------------------------------------------------------------------------ */
+
+/*
+ * a multiplexer opened with sys::MUX_URING carries out the operations queued with
+ * sys::readonmux(), sys::writeonmux() and sys::acceptonmux() over io_uring. all the
+ * operations queued are submitted in a single system call by sys::waitonmux() and
+ * their completions are returned together with the readiness events of the members
+ * added with sys::addtomux(). the epoll descriptor is polled through the ring for
+ * the latter. without io_uring, sys::waitonmux() polls the descriptors of the queued
+ * operations and performs the operations ready itself.
+ */
+
+#if defined(USE_IO_URING)
+
+#define MUX_URING_ENTRIES 256
+#define MUX_URING_TAG_EPOLL  ((__u64)1)
+#define MUX_URING_TAG_IGNORE ((__u64)2)
+
+static int uring_enter (mux_uring_t* ur, unsigned int min_complete, unsigned int flags, void* arg, hawk_oow_t argsz)
+{
+	unsigned int to_submit;
+
+	/* publish the entries filled since the last call */
+	__atomic_store_n (ur->sq_ktail, ur->sq_tail, __ATOMIC_RELEASE);
+	to_submit = ur->sq_tail - __atomic_load_n(ur->sq_khead, __ATOMIC_ACQUIRE);
+	return (int)syscall(__NR_io_uring_enter, ur->fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static struct io_uring_sqe* get_uring_sqe (mux_uring_t* ur)
+{
+	struct io_uring_sqe* sqe;
+	unsigned int index;
+
+	if (ur->sq_tail - __atomic_load_n(ur->sq_khead, __ATOMIC_ACQUIRE) >= ur->sq_entries)
+	{
+		/* the submission queue is full. push the entries to the kernel */
+		if (uring_enter(ur, 0, 0, HAWK_NULL, 0) <= -1) return HAWK_NULL;
+	}
+
+	index = ur->sq_tail & *ur->sq_kmask;
+	sqe = &ur->sqes[index];
+	HAWK_MEMSET (sqe, 0, HAWK_SIZEOF(*sqe));
+	ur->sq_karray[index] = index;
+	ur->sq_tail++;
+	return sqe;
+}
+
+static void close_uring (hawk_rtx_t* rtx, mux_uring_t* ur)
+{
+	if (ur->sqes) munmap (ur->sqes, ur->sqes_size);
+	if (ur->cq_ptr && ur->cq_ptr != ur->sq_ptr) munmap (ur->cq_ptr, ur->cq_size);
+	if (ur->sq_ptr) munmap (ur->sq_ptr, ur->sq_size);
+	close (ur->fd);
+	hawk_rtx_freemem (rtx, ur);
+}
+
+static mux_uring_t* open_uring (hawk_rtx_t* rtx)
+{
+	struct io_uring_params p;
+	mux_uring_t* ur;
+	void* ptr;
+	int fd;
+
+	HAWK_MEMSET (&p, 0, HAWK_SIZEOF(p));
+	fd = (int)syscall(__NR_io_uring_setup, MUX_URING_ENTRIES, &p);
+	if (fd <= -1) return HAWK_NULL;
+
+	/* sys::waitonmux() needs a timed wait without an extra timeout entry and
+	 * sys::readonmux() and the like can queue more than the completion queue holds */
+	if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_NODROP))
+	{
+		close (fd);
+		return HAWK_NULL;
+	}
+
+	ur = (mux_uring_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*ur));
+	if (!ur)
+	{
+		close (fd);
+		return HAWK_NULL;
+	}
+	ur->fd = fd;
+
+	ur->sq_size = p.sq_off.array + p.sq_entries * HAWK_SIZEOF(unsigned int);
+	ur->cq_size = p.cq_off.cqes + p.cq_entries * HAWK_SIZEOF(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		if (ur->cq_size > ur->sq_size) ur->sq_size = ur->cq_size;
+		ur->cq_size = ur->sq_size;
+	}
+
+	ptr = mmap(HAWK_NULL, ur->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	if (ptr == MAP_FAILED) goto oops;
+	ur->sq_ptr = ptr;
+
+	if (p.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		ur->cq_ptr = ur->sq_ptr;
+	}
+	else
+	{
+		ptr = mmap(HAWK_NULL, ur->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (ptr == MAP_FAILED) goto oops;
+		ur->cq_ptr = ptr;
+	}
+
+	ur->sqes_size = p.sq_entries * HAWK_SIZEOF(struct io_uring_sqe);
+	ptr = mmap(HAWK_NULL, ur->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (ptr == MAP_FAILED) goto oops;
+	ur->sqes = (struct io_uring_sqe*)ptr;
+
+	ur->sq_entries = p.sq_entries;
+	ur->sq_khead = (unsigned int*)((hawk_uint8_t*)ur->sq_ptr + p.sq_off.head);
+	ur->sq_ktail = (unsigned int*)((hawk_uint8_t*)ur->sq_ptr + p.sq_off.tail);
+	ur->sq_kmask = (unsigned int*)((hawk_uint8_t*)ur->sq_ptr + p.sq_off.ring_mask);
+	ur->sq_karray = (unsigned int*)((hawk_uint8_t*)ur->sq_ptr + p.sq_off.array);
+	ur->sq_tail = *ur->sq_ktail;
+	ur->cq_khead = (unsigned int*)((hawk_uint8_t*)ur->cq_ptr + p.cq_off.head);
+	ur->cq_ktail = (unsigned int*)((hawk_uint8_t*)ur->cq_ptr + p.cq_off.tail);
+	ur->cq_kmask = (unsigned int*)((hawk_uint8_t*)ur->cq_ptr + p.cq_off.ring_mask);
+	ur->cqes = (struct io_uring_cqe*)((hawk_uint8_t*)ur->cq_ptr + p.cq_off.cqes);
+	return ur;
+
+oops:
+	close_uring (rtx, ur);
+	return HAWK_NULL;
+}
+
+static void prep_uring_op (struct io_uring_sqe* sqe, mux_op_t* op, int fd)
+{
+	switch (op->type)
+	{
+		case MUX_OP_READ:
+			sqe->opcode = IORING_OP_READ;
+			sqe->addr = (__u64)(hawk_uintptr_t)op->buf;
+			sqe->len = op->len;
+			sqe->off = (__u64)-1; /* use the current file position */
+			break;
+
+		case MUX_OP_WRITE:
+			sqe->opcode = IORING_OP_WRITE;
+			sqe->addr = (__u64)(hawk_uintptr_t)op->buf;
+			sqe->len = op->len;
+			sqe->off = (__u64)-1;
+			break;
+
+		case MUX_OP_ACCEPT:
+			sqe->opcode = IORING_OP_ACCEPT;
+			sqe->accept_flags = op->flags;
+			break;
+	}
+	sqe->fd = fd;
+	sqe->user_data = (__u64)(hawk_uintptr_t)op;
+}
+
+static int cancel_uring_op (mux_uring_t* ur, mux_op_t* op)
+{
+	struct io_uring_sqe* sqe;
+
+	sqe = get_uring_sqe(ur);
+	if (!sqe) return -1;
+
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = (__u64)(hawk_uintptr_t)op;
+	sqe->user_data = MUX_URING_TAG_IGNORE;
+	return 0;
+}
+#endif
+
+static void unlink_mux_op (sys_node_data_mux_t* mux_data, mux_op_t* op)
+{
+	if (op->prev) op->prev->next = op->next;
+	else mux_data->op_first = op->next;
+	if (op->next) op->next->prev = op->prev;
+	else mux_data->op_last = op->prev;
+	mux_data->op_count--;
+}
+
+static void release_mux_op (hawk_rtx_t* rtx, mux_op_t* op)
+{
+	if (op->node)
+	{
+		sys_node_t* node = (sys_node_t*)op->node;
+		HAWK_ASSERT(node->ctx.u.file.op_count > 0);
+		if (--node->ctx.u.file.op_count == 0) node->ctx.u.file.opmux = HAWK_NULL;
+	}
+	hawk_rtx_freemem (rtx, op);
+}
+
+static void release_mux_cpl (hawk_rtx_t* rtx, sys_node_data_mux_t* mux_data)
+{
+	hawk_oow_t i;
+	for (i = 0; i < mux_data->x_cpl_count; i++) release_mux_op (rtx, mux_data->x_cpl[i]);
+	mux_data->x_cpl_count = 0;
+}
+
+/* move a finished operation from the outstanding list to the completion list.
+ * res is the result of the system call or a negated errno value */
+static void complete_mux_op (hawk_rtx_t* rtx, sys_list_t* sys_list, sys_node_data_mux_t* mux_data, mux_op_t* op, hawk_int_t res)
+{
+	unlink_mux_op (mux_data, op);
+
+	if (!op->node)
+	{
+		/* the node has gone while the operation was outstanding */
+		if (op->type == MUX_OP_ACCEPT && res >= 0) close (res);
+		hawk_rtx_freemem (rtx, op);
+		return;
+	}
+
+	if (res < 0)
+	{
+		op->result = ERRNUM_TO_RC(hawk_syserr_to_errnum(-res));
+	}
+	else if (op->type == MUX_OP_ACCEPT)
+	{
+		sys_node_t* new_node;
+
+		new_node = new_sys_node_fd(rtx, sys_list, (int)res);
+		if (new_node)
+		{
+			new_node->ctx.type = SYS_NODE_DATA_TYPE_SCK;
+			op->result = new_node->id;
+		}
+		else
+		{
+			close (res);
+			op->result = ERRNUM_TO_RC(hawk_rtx_geterrnum(rtx));
+		}
+	}
+	else
+	{
+		op->result = res;
+	}
+
+	HAWK_ASSERT(mux_data->x_cpl_count < mux_data->x_cpl_max);
+	mux_data->x_cpl[mux_data->x_cpl_count++] = op;
+}
+
+#if defined(USE_IO_URING)
+static void reap_uring (hawk_rtx_t* rtx, sys_list_t* sys_list, sys_node_data_mux_t* mux_data)
+{
+	mux_uring_t* ur = mux_data->uring;
+	unsigned int head, tail;
+
+	head = *ur->cq_khead;
+	tail = __atomic_load_n(ur->cq_ktail, __ATOMIC_ACQUIRE);
+	while (head != tail)
+	{
+		struct io_uring_cqe* cqe = &ur->cqes[head & *ur->cq_kmask];
+
+		if (cqe->user_data == MUX_URING_TAG_EPOLL)
+		{
+			int n;
+
+			ur->epoll_armed = 0;
+			if (mux_data->x_evt_max > 0)
+			{
+				n = epoll_wait(mux_data->fd, mux_data->x_evt, mux_data->x_evt_max, 0);
+				if (n > 0) mux_data->x_evt_count = n;
+			}
+		}
+		else if (cqe->user_data != MUX_URING_TAG_IGNORE)
+		{
+			complete_mux_op (rtx, sys_list, mux_data, (mux_op_t*)(hawk_uintptr_t)cqe->user_data, cqe->res);
+		}
+
+		head++;
+	}
+	__atomic_store_n (ur->cq_khead, head, __ATOMIC_RELEASE);
+}
+#endif
+
+#if defined(HAVE_POLL_H)
+static hawk_int_t perform_mux_op (mux_op_t* op, int fd)
+{
+	hawk_int_t n;
+
+	switch (op->type)
+	{
+		case MUX_OP_READ:
+			n = read(fd, op->buf, op->len);
+			break;
+
+		case MUX_OP_WRITE:
+			n = write(fd, op->buf, op->len);
+			break;
+
+		case MUX_OP_ACCEPT:
+		#if defined(HAVE_ACCEPT4)
+			n = accept4(fd, HAWK_NULL, HAWK_NULL, op->flags);
+		#else
+			n = accept(fd, HAWK_NULL, HAWK_NULL);
+		#endif
+			break;
+
+		default:
+			errno = EINVAL;
+			n = -1;
+			break;
+	}
+
+	return (n <= -1)? -(hawk_int_t)errno: n;
+}
+#endif
+
+/* called when a file or socket node goes away with operations outstanding */
+static void cancel_mux_ops (hawk_rtx_t* rtx, sys_node_t* node)
+{
+	sys_node_t* mux_node = (sys_node_t*)node->ctx.u.file.opmux;
+	sys_node_data_mux_t* mux_data = &mux_node->ctx.u.mux;
+	mux_op_t* op, * next;
+	hawk_oow_t i;
+
+	/* the completions returned by the last sys::waitonmux() can't be retrieved any more */
+	for (i = 0; i < mux_data->x_cpl_count; i++)
+	{
+		if (mux_data->x_cpl[i]->node == node) mux_data->x_cpl[i]->node = HAWK_NULL;
+	}
+
+	for (op = mux_data->op_first; op; op = next)
+	{
+		next = op->next;
+		if (op->node != node) continue;
+
+		op->node = HAWK_NULL;
+	#if defined(USE_IO_URING)
+		if (mux_data->uring)
+		{
+			/* the kernel owns the buffer until the completion arrives. the operation
+			 * is freed when the completion is reaped. */
+			cancel_uring_op (mux_data->uring, op);
+			continue;
+		}
+	#endif
+		unlink_mux_op (mux_data, op);
+		hawk_rtx_freemem (rtx, op);
+	}
+
+#if defined(USE_IO_URING)
+	/* submit the entries before the descriptor is closed and its number is reused */
+	if (mux_data->uring) uring_enter (mux_data->uring, 0, 0, HAWK_NULL, 0);
+#endif
+
+	node->ctx.u.file.op_count = 0;
+	node->ctx.u.file.opmux = HAWK_NULL;
+}
+
+/* called when a multiplexer is closed */
+static void purge_mux_ops (hawk_rtx_t* rtx, sys_node_t* mux_node)
+{
+	sys_node_data_mux_t* mux_data = &mux_node->ctx.u.mux;
+	mux_op_t* op, * next;
+
+	release_mux_cpl (rtx, mux_data);
+
+	for (op = mux_data->op_first; op; op = op->next)
+	{
+		if (op->node)
+		{
+			sys_node_t* node = (sys_node_t*)op->node;
+			if (--node->ctx.u.file.op_count == 0) node->ctx.u.file.opmux = HAWK_NULL;
+			op->node = HAWK_NULL;
+		}
+	}
+
+#if defined(USE_IO_URING)
+	if (mux_data->uring)
+	{
+		for (op = mux_data->op_first; op; op = op->next) cancel_uring_op (mux_data->uring, op);
+
+		/* wait for the cancelled operations to finish as the kernel may still write to their buffers */
+		while (mux_data->op_count > 0)
+		{
+			if (uring_enter(mux_data->uring, 1, IORING_ENTER_GETEVENTS, HAWK_NULL, 0) <= -1 && errno != EINTR) break;
+			reap_uring (rtx, HAWK_NULL, mux_data);
+		}
+
+		close_uring (rtx, mux_data->uring);
+		mux_data->uring = HAWK_NULL;
+
+		/* if the wait failed, the remaining operations are abandoned rather than freed */
+		mux_data->op_first = mux_data->op_last = HAWK_NULL;
+		mux_data->op_count = 0;
+	}
+#endif
+
+	for (op = mux_data->op_first; op; op = next)
+	{
+		next = op->next;
+		hawk_rtx_freemem (rtx, op);
+	}
+	mux_data->op_first = mux_data->op_last = HAWK_NULL;
+	mux_data->op_count = 0;
+
+	if (mux_data->x_cpl)
+	{
+		hawk_rtx_freemem (rtx, mux_data->x_cpl);
+		mux_data->x_cpl = HAWK_NULL;
+	}
+	mux_data->x_cpl_max = 0;
+#if defined(HAVE_POLL_H)
+	if (mux_data->x_pfd)
+	{
+		hawk_rtx_freemem (rtx, mux_data->x_pfd);
+		mux_data->x_pfd = HAWK_NULL;
+	}
+	mux_data->x_pfd_max = 0;
+#endif
+}
+
 static void free_sys_node (hawk_rtx_t* rtx, sys_list_t* list, sys_node_t* node)
 {
 	switch (node->ctx.type)
 	{
 		case SYS_NODE_DATA_TYPE_FILE:
 		case SYS_NODE_DATA_TYPE_SCK:
+			if (node->ctx.u.file.op_count > 0) cancel_mux_ops(rtx, node);
 			if (node->ctx.u.file.fd >= 0)
 			{
 				del_from_mux(rtx, node);
@@ -532,6 +1046,7 @@ static void free_sys_node (hawk_rtx_t* rtx, sys_list_t* list, sys_node_t* node)
 			{
 				/* TODO: delete all member FILE and SCK from mux */
 				purge_mux_members(rtx, node);
+				purge_mux_ops(rtx, node);
 				close(node->ctx.u.mux.fd);
 				node->ctx.u.mux.fd = -1;
 
@@ -553,11 +1068,16 @@ static void free_sys_node (hawk_rtx_t* rtx, sys_list_t* list, sys_node_t* node)
 
 static HAWK_INLINE rtx_data_t* rtx_to_data (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
-        mod_ctx_t* mctx = (mod_ctx_t*)fi->mod->ctx;
-        hawk_rbt_pair_t* pair;
-        pair = hawk_rbt_search(mctx->rtxtab, &rtx, HAWK_SIZEOF(rtx));
-        HAWK_ASSERT(pair != HAWK_NULL);
-        return (rtx_data_t*)HAWK_RBT_VPTR(pair);
+	mod_ctx_t* mctx = (mod_ctx_t*)fi->mod->ctx;
+	hawk_rbt_pair_t* pair;
+
+	/* the pair found stays at the same address until the runtime context
+	 * is finalized. it's safe to use the data outside the lock */
+	hawk_mtx_lock(&mctx->mtx, HAWK_NULL);
+	pair = hawk_rbt_search(mctx->rtxtab, &rtx, HAWK_SIZEOF(rtx));
+	hawk_mtx_unlock(&mctx->mtx);
+	HAWK_ASSERT(pair != HAWK_NULL);
+	return (rtx_data_t*)HAWK_RBT_VPTR(pair);
 }
 
 static HAWK_INLINE sys_list_t* rtx_to_sys_list (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
@@ -602,6 +1122,19 @@ static sys_node_t* get_sys_list_node_with_arg (hawk_rtx_t* rtx, sys_list_t* sys_
 	return sys_node;
 }
 
+/* let other coroutines run until the handle in the first argument gets
+ * ready. the node is looked up again as another coroutine may have closed
+ * it in the meantime. -1 is a hard failure that the caller must return */
+static int wait_on_sys_node (hawk_rtx_t* rtx, sys_list_t* sys_list, sys_node_t** sys_node, int node_type, int events, hawk_int_t* rx)
+{
+	int n;
+
+	n = hawk_rtx_waitio(rtx, (*sys_node)->ctx.u.file.fd, events, HAWK_NULL);
+	if (n <= -1) return -1;
+	if (n >= 1) *sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), node_type, rx);
+	return 0;
+}
+
 /* ------------------------------------------------------------------------ */
 
 static int fnc_errmsg (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
@@ -770,6 +1303,8 @@ static int fnc_read (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 	sys_list = rtx_to_sys_list(rtx, fi);
 	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (sys_node && sys_list->ctx.readbuf_len <= 0 &&
+	    wait_on_sys_node(rtx, sys_list, &sys_node, SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, HAWK_RTX_WAITIO_IN, &rx) <= -1) return -1;
 	if (sys_node)
 	{
 		if (hawk_rtx_getnargs(rtx) >= 3 && (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 2), &reqsize) <= -1 || reqsize <= 0)) reqsize = 8192;
@@ -898,6 +1433,7 @@ static int fnc_write (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 	sys_list = rtx_to_sys_list(rtx, fi);
 	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (sys_node && wait_on_sys_node(rtx, sys_list, &sys_node, SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, HAWK_RTX_WAITIO_OUT, &rx) <= -1) return -1;
 	if (sys_node)
 	{
 		hawk_bch_t* dptr;
@@ -937,6 +1473,192 @@ static int fnc_write (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 /* ------------------------------------------------------------------------ */
 
+/*
+ * sendfile(), splice() and copy_file_range() move data between two handles
+ * inside the kernel without bringing it into a hawk value. where a system
+ * call is not available, sendfile() and copy_file_range() fall back to a
+ * read/write loop over a small stack buffer.
+ *
+	in = sys::open("/etc/fstab", sys::O_RDONLY);
+	out = sys::open("/tmp/fstab.copy", sys::O_WRONLY | sys::O_CREAT | sys::O_TRUNC);
+	while ((n = sys::copy_file_range(in, out, 65536)) > 0) total += n;
+	sys::close (out);
+	sys::close (in);
+ */
+
+static hawk_ooi_t copy_fd_data (int in_fd, hawk_int_t* in_off, int out_fd, hawk_oow_t count)
+{
+	hawk_bch_t buf[8192];
+	hawk_ooi_t total = 0;
+
+	while (count > 0)
+	{
+		hawk_ooi_t n, w, x;
+
+		n = (count > HAWK_SIZEOF(buf))? HAWK_SIZEOF(buf): count;
+		n = in_off? pread(in_fd, buf, n, (off_t)*in_off): read(in_fd, buf, n);
+		if (n <= -1) return (total > 0)? total: -1;
+		if (n == 0) break; /* end of input */
+
+		for (w = 0; w < n; w += x)
+		{
+			x = write(out_fd, &buf[w], n - w);
+			if (x <= -1)
+			{
+				/* the bytes read but not written are lost unless the input
+				 * position is rewound. an explicit offset is not affected */
+				if (!in_off && w < n) lseek(in_fd, (off_t)(w - n), SEEK_CUR);
+				total += w;
+				return (total > 0)? total: -1;
+			}
+		}
+
+		total += n;
+		count -= n;
+		if (in_off) *in_off += n;
+	}
+
+	return total;
+}
+
+static HAWK_INLINE hawk_oow_t get_transfer_count (hawk_rtx_t* rtx, hawk_val_t* a)
+{
+	hawk_int_t count;
+	if (hawk_rtx_valtoint_inline(rtx, a, &count) <= -1 || count < 0) return 0;
+	if (count > HAWK_TYPE_MAX(hawk_ooi_t)) count = HAWK_TYPE_MAX(hawk_ooi_t);
+	return (hawk_oow_t)count;
+}
+
+/*
+ * sys::sendfile(out, in, count[, offset]) sends up to count bytes from a file
+ * to a file or a socket. the bytes are read from the given offset without
+ * changing the file position of in if offset is given. it returns the number
+ * of bytes sent, 0 at the end of the input, or a negative error code.
+ */
+static int fnc_sendfile (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sys_list_t* sys_list;
+	sys_node_t* out_node, * in_node;
+	hawk_int_t rx;
+
+	sys_list = rtx_to_sys_list(rtx, fi);
+	out_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (out_node)
+	{
+		in_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 1), SYS_NODE_DATA_TYPE_FILE, &rx);
+		if (in_node)
+		{
+			hawk_oow_t count;
+			hawk_int_t offset = -1;
+
+			count = get_transfer_count(rtx, hawk_rtx_getarg(rtx, 2));
+			if (hawk_rtx_getnargs(rtx) >= 4 && (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 3), &offset) <= -1 || offset < 0))
+			{
+				rx = set_error_on_sys_list(rtx, sys_list, HAWK_EINVAL, HAWK_T("invalid offset"));
+				goto done;
+			}
+
+		#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+			{
+				off_t off = (off_t)offset;
+				rx = sendfile(out_node->ctx.u.file.fd, in_node->ctx.u.file.fd, (offset >= 0? &off: HAWK_NULL), count);
+				if (rx <= -1 && (errno == EINVAL || errno == ENOSYS))
+				{
+					/* the descriptors are not supported by sendfile(). a pipe
+					 * or a file system without mmap support as the input */
+					rx = copy_fd_data(in_node->ctx.u.file.fd, (offset >= 0? &offset: HAWK_NULL), out_node->ctx.u.file.fd, count);
+				}
+			}
+		#else
+			rx = copy_fd_data(in_node->ctx.u.file.fd, (offset >= 0? &offset: HAWK_NULL), out_node->ctx.u.file.fd, count);
+		#endif
+			if (rx <= -1) rx = set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_T("unable to send file"));
+		}
+	}
+
+done:
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, rx));
+	return 0;
+}
+
+/*
+ * sys::splice(in, out, count[, flags]) moves up to count bytes between two
+ * handles where at least one of them is a pipe. flags is a combination of
+ * sys::SPLICE_F_MOVE, sys::SPLICE_F_NONBLOCK and sys::SPLICE_F_MORE.
+ */
+static int fnc_splice (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sys_list_t* sys_list;
+	sys_node_t* in_node, * out_node;
+	hawk_int_t rx;
+
+	sys_list = rtx_to_sys_list(rtx, fi);
+	in_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (in_node)
+	{
+		out_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 1), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+		if (out_node)
+		{
+		#if defined(HAVE_SPLICE)
+			hawk_oow_t count;
+			hawk_int_t flags = 0;
+
+			count = get_transfer_count(rtx, hawk_rtx_getarg(rtx, 2));
+			if (hawk_rtx_getnargs(rtx) >= 4 && hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 3), &flags) <= -1) flags = 0;
+
+			rx = splice(in_node->ctx.u.file.fd, HAWK_NULL, out_node->ctx.u.file.fd, HAWK_NULL, count, (unsigned int)flags);
+			if (rx <= -1) rx = set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_T("unable to splice"));
+		#else
+			rx = set_error_on_sys_list(rtx, sys_list, HAWK_ENOIMPL, HAWK_NULL);
+		#endif
+		}
+	}
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, rx));
+	return 0;
+}
+
+/*
+ * sys::copy_file_range(in, out, count) copies up to count bytes from a file
+ * to another at their current file positions.
+ */
+static int fnc_copy_file_range (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sys_list_t* sys_list;
+	sys_node_t* in_node, * out_node;
+	hawk_int_t rx;
+
+	sys_list = rtx_to_sys_list(rtx, fi);
+	in_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE, &rx);
+	if (in_node)
+	{
+		out_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 1), SYS_NODE_DATA_TYPE_FILE, &rx);
+		if (out_node)
+		{
+			hawk_oow_t count;
+
+			count = get_transfer_count(rtx, hawk_rtx_getarg(rtx, 2));
+		#if defined(HAVE_COPY_FILE_RANGE)
+			rx = copy_file_range(in_node->ctx.u.file.fd, HAWK_NULL, out_node->ctx.u.file.fd, HAWK_NULL, count, 0);
+			if (rx <= -1 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+			{
+				/* older kernels refuse to copy across file systems and
+				 * some file systems don't support it at all */
+				rx = copy_fd_data(in_node->ctx.u.file.fd, HAWK_NULL, out_node->ctx.u.file.fd, count);
+			}
+		#else
+			rx = copy_fd_data(in_node->ctx.u.file.fd, HAWK_NULL, out_node->ctx.u.file.fd, count);
+		#endif
+			if (rx <= -1) rx = set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_T("unable to copy file range"));
+		}
+	}
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, rx));
+	return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
 /*
 	a = sys::open("/etc/inittab", sys::O_RDONLY);
 	x = sys::open("/etc/fstab", sys::O_RDONLY);
@@ -1016,6 +1738,7 @@ static int fnc_dup (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 				/* dup2 or dup3 closes the descriptor sys_node2_.ctx.u.file.fd implicitly
 				 * if it's registered in muxtipler, unregister it as well */
 				del_from_mux(rtx, sys_node2);
+				if (sys_node2->ctx.u.file.op_count > 0) cancel_mux_ops(rtx, sys_node2);
 				sys_node2->ctx.u.file.fd = fd;
 				sys_node2->ctx.type = sys_node->ctx.type;
 				rx = sys_node2->id;
@@ -2718,6 +3441,15 @@ static int fnc_sleep (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 		goto done;
 	}
 
+	/* other coroutines run while this one sleeps */
+	rx = hawk_rtx_sleep(rtx, &nt);
+	if (rx <= -1) return -1;
+	if (rx >= 1)
+	{
+		rx = 0;
+		goto done;
+	}
+
 #if defined(_WIN32)
 	Sleep (HAWK_SECNSEC_TO_MSEC(nt.sec, nt.nsec));
 	rx = 0;
@@ -3920,10 +4652,11 @@ static int fnc_openmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	sys_list_t* sys_list;
 	sys_node_t* sys_node = HAWK_NULL;
-	hawk_int_t rx;
+	hawk_int_t rx, flags = 0;
 	int fd;
 
 	sys_list = rtx_to_sys_list(rtx, fi);
+	if (hawk_rtx_getnargs(rtx) >= 1 && (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 0), &flags) <= -1 || flags < 0)) flags = 0;
 
 #if defined(USE_EPOLL)
 	#if defined(HAVE_EPOLL_CREATE1) && defined(EPOLL_CLOEXEC)
@@ -3948,6 +4681,10 @@ static int fnc_openmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 		sys_node = new_sys_node_mux(rtx, sys_list, fd);
 		if (sys_node)
 		{
+		#if defined(USE_IO_URING)
+			/* fall back to epoll silently if io_uring is not available on the running kernel */
+			if (flags & MUX_URING) sys_node->ctx.u.mux.uring = open_uring(rtx);
+		#endif
 			rx = sys_node->id;
 		}
 		else
@@ -4131,6 +4868,260 @@ static int fnc_modinmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 #endif
 }
 
+/*
+ * sys::readonmux(mux, fd[, size]), sys::writeonmux(mux, fd, data) and
+ * sys::acceptonmux(mux, sck[, flags]) queue an operation on a multiplexer.
+ * the operation is carried out by the next sys::waitonmux() and its
+ * completion is retrieved with sys::getmuxevt() with the data attached.
+
+	mx = sys::openmux(sys::MUX_URING);
+	sys::acceptonmux(mx, s);
+	while ((n = sys::waitonmux(mx, -1)) >= 0)
+	{
+		for (i = 0; i < n; i++)
+		{
+			if (sys::getmuxevt(mx, i, fd, evt, data) <= -1) continue;
+			if (evt & sys::MUX_EVT_ERR) { sys::close(fd); continue; }
+			if (evt & sys::MUX_EVT_ACCEPT) { sys::readonmux(mx, data); sys::acceptonmux(mx, fd); }
+			else if (evt & sys::MUX_EVT_READ)
+			{
+				if (length(data) <= 0) sys::close(fd);
+				else sys::writeonmux(mx, fd, data);
+			}
+			else if (evt & sys::MUX_EVT_WRITE) sys::readonmux(mx, fd);
+		}
+	}
+ */
+static int queue_mux_op_for_fnc (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi, mux_op_type_t type)
+{
+	sys_list_t* sys_list;
+	sys_node_t* sys_node, * sys_node2;
+	hawk_int_t rx = ERRNUM_TO_RC(HAWK_ENOERR);
+
+	sys_list = rtx_to_sys_list(rtx, fi);
+	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_MUX, &rx);
+	if (sys_node)
+	{
+		sys_node2 = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 1), (type == MUX_OP_ACCEPT? SYS_NODE_DATA_TYPE_SCK: SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK), &rx);
+		if (sys_node2)
+		{
+		#if defined(USE_IO_URING) || defined(HAVE_POLL_H)
+			sys_node_data_mux_t* mux_data = &sys_node->ctx.u.mux;
+			hawk_bch_t* dptr = HAWK_NULL;
+			hawk_oow_t dlen = 0;
+			hawk_int_t reqsize = 8192, flags = 0;
+			hawk_val_t* a2;
+			mux_op_t* op;
+
+			if (sys_node2->ctx.u.file.op_count > 0 && sys_node2->ctx.u.file.opmux != sys_node)
+			{
+				/* like sys::addtomux(), a descriptor is served by a single multiplexer */
+				rx = set_error_on_sys_list(rtx, sys_list, HAWK_EPERM, HAWK_T("busy in another mux"));
+				goto done;
+			}
+
+			switch (type)
+			{
+				case MUX_OP_READ:
+					if (hawk_rtx_getnargs(rtx) >= 3 && (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 2), &reqsize) <= -1 || reqsize <= 0)) reqsize = 8192;
+					if (reqsize > HAWK_INT_MAX) reqsize = HAWK_INT_MAX;
+					dlen = reqsize;
+					break;
+
+				case MUX_OP_WRITE:
+					a2 = hawk_rtx_getarg(rtx, 2);
+					dptr = hawk_rtx_getvalbcstr(rtx, a2, &dlen);
+					if (!dptr)
+					{
+						rx = copy_error_to_sys_list(rtx, sys_list);
+						goto done;
+					}
+					break;
+
+				case MUX_OP_ACCEPT:
+					if (hawk_rtx_getnargs(rtx) >= 3 && (hawk_rtx_valtoint_inline(rtx, hawk_rtx_getarg(rtx, 2), &flags) <= -1 || flags < 0)) flags = 0;
+					break;
+			}
+
+			op = (mux_op_t*)hawk_rtx_allocmem(rtx, HAWK_OFFSETOF(mux_op_t, buf) + dlen + 1);
+			if (!op)
+			{
+				if (dptr) hawk_rtx_freevalbcstr(rtx, a2, dptr);
+				rx = copy_error_to_sys_list(rtx, sys_list);
+				goto done;
+			}
+
+			op->type = type;
+			op->flags = (int)flags;
+			op->node = sys_node2;
+			op->result = 0;
+			op->len = dlen;
+			if (dptr)
+			{
+				HAWK_MEMCPY (op->buf, dptr, dlen);
+				hawk_rtx_freevalbcstr(rtx, a2, dptr);
+			}
+
+		#if defined(USE_IO_URING)
+			if (mux_data->uring)
+			{
+				struct io_uring_sqe* sqe;
+
+				/* the entry is submitted to the kernel by sys::waitonmux() */
+				sqe = get_uring_sqe(mux_data->uring);
+				if (!sqe)
+				{
+					rx = set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_NULL);
+					hawk_rtx_freemem(rtx, op);
+					goto done;
+				}
+				prep_uring_op (sqe, op, sys_node2->ctx.u.file.fd);
+			}
+		#endif
+
+			op->next = HAWK_NULL;
+			op->prev = mux_data->op_last;
+			if (mux_data->op_last) mux_data->op_last->next = op;
+			else mux_data->op_first = op;
+			mux_data->op_last = op;
+			mux_data->op_count++;
+
+			sys_node2->ctx.u.file.opmux = sys_node;
+			sys_node2->ctx.u.file.op_count++;
+		#else
+			rx = set_error_on_sys_list(rtx, sys_list, HAWK_ENOIMPL, HAWK_NULL);
+			goto done;
+		#endif
+		}
+	}
+
+done:
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval_inline(rtx, rx));
+	return 0;
+}
+
+static int fnc_readonmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	return queue_mux_op_for_fnc(rtx, fi, MUX_OP_READ);
+}
+
+static int fnc_writeonmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	return queue_mux_op_for_fnc(rtx, fi, MUX_OP_WRITE);
+}
+
+static int fnc_acceptonmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	return queue_mux_op_for_fnc(rtx, fi, MUX_OP_ACCEPT);
+}
+
+#if defined(USE_IO_URING)
+static hawk_int_t wait_on_uring (hawk_rtx_t* rtx, sys_list_t* sys_list, sys_node_t* mux_node, const hawk_ntime_t* tmout)
+{
+	sys_node_data_mux_t* mux_data = &mux_node->ctx.u.mux;
+	mux_uring_t* ur = mux_data->uring;
+	struct io_uring_getevents_arg arg;
+	struct __kernel_timespec ts;
+
+	if (mux_data->x_count > 0 && !ur->epoll_armed)
+	{
+		/* get notified through the ring when a member added with sys::addtomux() gets ready */
+		struct io_uring_sqe* sqe;
+
+		sqe = get_uring_sqe(ur);
+		if (!sqe) return set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_NULL);
+		sqe->opcode = IORING_OP_POLL_ADD;
+		sqe->fd = mux_data->fd;
+		sqe->poll_events = POLLIN;
+		sqe->user_data = MUX_URING_TAG_EPOLL;
+		ur->epoll_armed = 1;
+	}
+
+	HAWK_MEMSET (&arg, 0, HAWK_SIZEOF(arg));
+	if (tmout->sec >= 0 && tmout->nsec >= 0)
+	{
+		ts.tv_sec = tmout->sec;
+		ts.tv_nsec = tmout->nsec;
+		arg.ts = (__u64)(hawk_uintptr_t)&ts;
+	}
+
+	/* submit all the queued entries and wait for a completion in one go */
+	if (uring_enter(ur, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, HAWK_SIZEOF(arg)) <= -1 && errno != ETIME)
+	{
+		return set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_NULL);
+	}
+
+	reap_uring (rtx, sys_list, mux_data);
+	return mux_data->x_evt_count + mux_data->x_cpl_count;
+}
+#endif
+
+#if defined(HAVE_POLL_H)
+static hawk_int_t wait_on_poll (hawk_rtx_t* rtx, sys_list_t* sys_list, sys_node_t* mux_node, const hawk_ntime_t* tmout)
+{
+	sys_node_data_mux_t* mux_data = &mux_node->ctx.u.mux;
+	mux_op_t* op, * next;
+	hawk_oow_t i, npfds;
+	int n;
+
+	npfds = mux_data->op_count + 1;
+	if (mux_data->x_pfd_max < npfds)
+	{
+		struct pollfd* tmp;
+
+		tmp = hawk_rtx_reallocmem(rtx, mux_data->x_pfd, HAWK_SIZEOF(*tmp) * HAWK_ALIGN(npfds, 64));
+		if (!tmp) return copy_error_to_sys_list(rtx, sys_list);
+
+		mux_data->x_pfd_max = HAWK_ALIGN(npfds, 64);
+		mux_data->x_pfd = tmp;
+	}
+
+	/* the epoll descriptor gets readable when a member added with sys::addtomux() is ready */
+	mux_data->x_pfd[0].fd = mux_data->fd;
+	mux_data->x_pfd[0].events = POLLIN;
+	mux_data->x_pfd[0].revents = 0;
+	for (op = mux_data->op_first, i = 1; op; op = op->next, i++)
+	{
+		mux_data->x_pfd[i].fd = ((sys_node_t*)op->node)->ctx.u.file.fd;
+		mux_data->x_pfd[i].events = (op->type == MUX_OP_WRITE)? POLLOUT: POLLIN;
+		mux_data->x_pfd[i].revents = 0;
+	}
+
+	n = poll(mux_data->x_pfd, npfds, HAWK_SECNSEC_TO_MSEC(tmout->sec, tmout->nsec));
+	if (n <= -1) return set_error_on_sys_list_with_errno(rtx, sys_list, HAWK_NULL);
+
+	for (op = mux_data->op_first, i = 1; op; op = next, i++)
+	{
+		sys_node_t* node = (sys_node_t*)op->node;
+		int done_flag;
+
+		next = op->next;
+		if (!mux_data->x_pfd[i].revents) continue;
+
+		/* readiness covers a single operation in each direction. the
+		 * rest wait for the next call not to block */
+		done_flag = (op->type == MUX_OP_WRITE)? SYS_NODE_DATA_FLAG_MUX_WR_DONE: SYS_NODE_DATA_FLAG_MUX_RD_DONE;
+		if (node->ctx.flags & done_flag) continue;
+		node->ctx.flags |= done_flag;
+
+		complete_mux_op (rtx, sys_list, mux_data, op, perform_mux_op(op, node->ctx.u.file.fd));
+	}
+
+	for (i = 0; i < mux_data->x_cpl_count; i++)
+	{
+		((sys_node_t*)mux_data->x_cpl[i]->node)->ctx.flags &= ~(SYS_NODE_DATA_FLAG_MUX_RD_DONE | SYS_NODE_DATA_FLAG_MUX_WR_DONE);
+	}
+
+	if (mux_data->x_pfd[0].revents && mux_data->x_evt_max > 0)
+	{
+		n = epoll_wait(mux_data->fd, mux_data->x_evt, mux_data->x_evt_max, 0);
+		if (n > 0) mux_data->x_evt_count = n;
+	}
+
+	return mux_data->x_evt_count + mux_data->x_cpl_count;
+}
+#endif
+
 static int fnc_waitonmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 #if defined(USE_EPOLL)
@@ -4148,23 +5139,74 @@ static int fnc_waitonmux (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 		if (val_to_ntime(rtx, hawk_rtx_getarg(rtx, 1), &tmout) <= -1 || tmout.sec <= -1) { tmout.sec = 0; tmout.nsec = HAWK_MSEC_TO_NSEC(-1); }
 
-		if (mux_data->x_evt_max < mux_data->x_count)
+		if (mux_data->x_evt_max < mux_data->x_count || mux_data->x_evt_max <= 0)
 		{
 			struct epoll_event* tmp;
 
-			tmp = hawk_rtx_reallocmem(rtx, mux_data->x_evt, HAWK_SIZEOF(*tmp) * HAWK_ALIGN(mux_data->x_count, 64));
+			/* epoll_wait() rejects an empty array even if there are no members */
+			tmp = hawk_rtx_reallocmem(rtx, mux_data->x_evt, HAWK_SIZEOF(*tmp) * HAWK_ALIGN(mux_data->x_count + 1, 64));
 			if (!tmp)
 			{
 				rx = copy_error_to_sys_list(rtx, sys_list);
 				goto done;
 			}
 
-			mux_data->x_evt_max = HAWK_ALIGN(mux_data->x_count, 64);
+			mux_data->x_evt_max = HAWK_ALIGN(mux_data->x_count + 1, 64);
 			mux_data->x_evt = tmp;
 		}
 
 		/* once this function is called, invalid the exising event data regardless of success or failure */
 		mux_data->x_evt_count = 0;
+		release_mux_cpl (rtx, mux_data);
+
+		if (mux_data->op_count > 0)
+		{
+			if (mux_data->x_cpl_max < mux_data->op_count)
+			{
+				mux_op_t** tmp;
+
+				tmp = hawk_rtx_reallocmem(rtx, mux_data->x_cpl, HAWK_SIZEOF(*tmp) * HAWK_ALIGN(mux_data->op_count, 64));
+				if (!tmp)
+				{
+					rx = copy_error_to_sys_list(rtx, sys_list);
+					goto done;
+				}
+
+				mux_data->x_cpl_max = HAWK_ALIGN(mux_data->op_count, 64);
+				mux_data->x_cpl = tmp;
+			}
+		}
+
+	#if defined(USE_IO_URING)
+		if (mux_data->uring)
+		{
+			rx = wait_on_uring(rtx, sys_list, sys_node, &tmout);
+			goto done;
+		}
+	#endif
+	#if defined(HAVE_POLL_H)
+		if (mux_data->op_count > 0)
+		{
+			rx = wait_on_poll(rtx, sys_list, sys_node, &tmout);
+			goto done;
+		}
+	#endif
+
+		if (tmout.sec != 0 || tmout.nsec != 0)
+		{
+			/* let other coroutines run while no member is ready. the mux may
+			 * get closed in the meantime */
+			int n;
+			n = hawk_rtx_waitio(rtx, mux_data->fd, HAWK_RTX_WAITIO_IN, (tmout.sec <= -1 || tmout.nsec <= -1)? HAWK_NULL: &tmout);
+			if (n <= -1) return -1;
+			if (n >= 1)
+			{
+				sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_MUX, &rx);
+				if (!sys_node) goto done;
+				mux_data = &sys_node->ctx.u.mux;
+				tmout.sec = 0; tmout.nsec = 0;
+			}
+		}
 
 		if ((rx = epoll_wait(sys_node->ctx.u.mux.fd, mux_data->x_evt, mux_data->x_evt_max, HAWK_SECNSEC_TO_MSEC(tmout.sec, tmout.nsec))) <= -1)
 		{
@@ -4210,13 +5252,51 @@ static int fnc_getmuxevt (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 			goto done;
 		}
 
-		if (index < 0 || index >= mux_data->x_evt_count)
+		if (index < 0 || index >= mux_data->x_evt_count + mux_data->x_cpl_count)
 		{
 			/* invalid index */
 			rx = set_error_on_sys_list(rtx, sys_list, HAWK_EINVAL, HAWK_NULL);
 			goto done;
 		}
 
+		if (index >= mux_data->x_evt_count)
+		{
+			/* the completion of an operation queued with sys::readonmux() and the like */
+			mux_op_t* op = mux_data->x_cpl[index - mux_data->x_evt_count];
+			hawk_int_t evt;
+			hawk_val_t* v;
+
+			file_node = (sys_node_t*)op->node;
+			if (!file_node)
+			{
+				rx = set_error_on_sys_list(rtx, sys_list, HAWK_ENOENT, HAWK_NULL);
+				goto done;
+			}
+
+			evt = (op->type == MUX_OP_READ)? MUX_EVT_READ: (op->type == MUX_OP_WRITE)? MUX_EVT_WRITE: MUX_EVT_ACCEPT;
+			if (op->result < 0) evt |= MUX_EVT_ERR;
+
+			x = hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 2), hawk_rtx_makeintval_inline(rtx, file_node->id));
+			if (x <= -1) goto fail;
+			x = hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 3), hawk_rtx_makeintval_inline(rtx, evt));
+			if (x <= -1) goto fail;
+
+			if (hawk_rtx_getnargs(rtx) >= 5)
+			{
+				/* the bytes read, the number of bytes written, the handle accepted or an error code */
+				v = (op->type == MUX_OP_READ && op->result >= 0)?
+					hawk_rtx_makembsvalwithbchars(rtx, op->buf, op->result):
+					hawk_rtx_makeintval_inline(rtx, op->result);
+				if (!v) goto fail;
+
+				hawk_rtx_refupval_inline (rtx, v);
+				x = hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 4), v);
+				hawk_rtx_refdownval_inline (rtx, v);
+				if (x <= -1) goto fail;
+			}
+			goto done;
+		}
+
 		file_node = mux_data->x_evt[index].data.ptr;
 		if (!file_node)
 		{
@@ -4379,6 +5459,7 @@ static int fnc_recvfrom (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 	sys_list = rtx_to_sys_list(rtx, fi);
 	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (sys_node && wait_on_sys_node(rtx, sys_list, &sys_node, SYS_NODE_DATA_TYPE_FILE | SYS_NODE_DATA_TYPE_SCK, HAWK_RTX_WAITIO_IN, &rx) <= -1) return -1;
 	if (sys_node)
 	{
 		hawk_skad_t skad;
@@ -4474,6 +5555,7 @@ static int fnc_sendto (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 	sys_list = rtx_to_sys_list(rtx, fi);
 	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (sys_node && wait_on_sys_node(rtx, sys_list, &sys_node, SYS_NODE_DATA_TYPE_SCK, HAWK_RTX_WAITIO_OUT, &rx) <= -1) return -1;
 	if (sys_node)
 	{
 		hawk_bch_t* dptr;
@@ -4622,6 +5704,7 @@ static int fnc_accept (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 	sys_list = rtx_to_sys_list(rtx, fi);
 	sys_node = get_sys_list_node_with_arg(rtx, sys_list, hawk_rtx_getarg(rtx, 0), SYS_NODE_DATA_TYPE_SCK, &rx);
+	if (sys_node && wait_on_sys_node(rtx, sys_list, &sys_node, SYS_NODE_DATA_TYPE_SCK, HAWK_RTX_WAITIO_IN, &rx) <= -1) return -1;
 	if (sys_node)
 	{
 		hawk_skad_t skad;
@@ -6234,6 +7317,7 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("WIFSIGNALED"), { { 1, 1, HAWK_NULL       }, fnc_wifsignaled, 0  } },
 	{ HAWK_T("WTERMSIG"),    { { 1, 1, HAWK_NULL       }, fnc_wtermsig,    0  } },
 	{ HAWK_T("accept"),      { { 1, 3, HAWK_T("vvr")   }, fnc_accept,      0  } },
+	{ HAWK_T("acceptonmux"), { { 2, 3, HAWK_NULL       }, fnc_acceptonmux, 0  } },
 	{ HAWK_T("addtomux"),    { { 3, 3, HAWK_NULL       }, fnc_addtomux,    0  } },
 	{ HAWK_T("basename"),    { { 1, 1, HAWK_NULL       }, fnc_basename,    0  } },
 	{ HAWK_T("bind"),        { { 2, 2, HAWK_NULL       }, fnc_bind,        0  } },
@@ -6244,6 +7328,7 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("closelog"),    { { 0, 0, HAWK_NULL       }, fnc_closelog,    0  } },
 	{ HAWK_T("closemux"),    { { 1, 1, HAWK_NULL       }, fnc_closemux,    0  } },
 	{ HAWK_T("connect"),     { { 2, 2, HAWK_NULL       }, fnc_connect,     0  } },
+	{ HAWK_T("copy_file_range"), { { 3, 3, HAWK_NULL   }, fnc_copy_file_range, 0 } },
 	{ HAWK_T("delfrommux"),  { { 2, 2, HAWK_NULL       }, fnc_delfrommux,  0  } },
 	{ HAWK_T("dirname"),     { { 1, 1, HAWK_NULL       }, fnc_dirname,     0  } },
 	{ HAWK_T("dup"),         { { 1, 3, HAWK_NULL       }, fnc_dup,         0  } },
@@ -6259,7 +7344,7 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("geteuid"),     { { 0, 0, HAWK_NULL       }, fnc_geteuid,     0  } },
 	{ HAWK_T("getgid"),      { { 0, 0, HAWK_NULL       }, fnc_getgid,      0  } },
 	{ HAWK_T("getifcfg"),    { { 3, 3, HAWK_T("vvr")   }, fnc_getifcfg,    0  } },
-	{ HAWK_T("getmuxevt"),   { { 4, 4, HAWK_T("vvrr")  }, fnc_getmuxevt,   0  } },
+	{ HAWK_T("getmuxevt"),   { { 4, 5, HAWK_T("vvrrr") }, fnc_getmuxevt,   0  } },
 	{ HAWK_T("getnwifcfg"),  { { 3, 3, HAWK_T("vvr")   }, fnc_getifcfg,    0  } }, /* backward compatibility */
 	{ HAWK_T("getpgid"),     { { 0, 0, HAWK_NULL       }, fnc_getpgid,     0  } },
 	{ HAWK_T("getpid"),      { { 0, 0, HAWK_NULL       }, fnc_getpid,      0  } },
@@ -6276,15 +7361,17 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("opendir"),     { { 1, 2, HAWK_NULL       }, fnc_opendir,     0  } },
 	{ HAWK_T("openfd"),      { { 1, 1, HAWK_NULL       }, fnc_openfd,      0  } },
 	{ HAWK_T("openlog"),     { { 3, 3, HAWK_NULL       }, fnc_openlog,     0  } },
-	{ HAWK_T("openmux"),     { { 0, 0, HAWK_NULL       }, fnc_openmux,     0  } },
+	{ HAWK_T("openmux"),     { { 0, 1, HAWK_NULL       }, fnc_openmux,     0  } },
 	{ HAWK_T("pack"),        { { 2, A_MAX, HAWK_T("rv")}, fnc_pack,        0 } },
 	{ HAWK_T("pipe"),        { { 2, 3, HAWK_T("rrv")   }, fnc_pipe,        0  } },
 	{ HAWK_T("raise"),       { { 1, 1, HAWK_NULL       }, fnc_raise,       0  } },
 	{ HAWK_T("read"),        { { 2, 4, HAWK_T("vrvv")  }, fnc_read,        0  } },
 	{ HAWK_T("readdir"),     { { 2, 2, HAWK_T("vr")    }, fnc_readdir,     0  } },
+	{ HAWK_T("readonmux"),   { { 2, 3, HAWK_NULL       }, fnc_readonmux,   0  } },
 	{ HAWK_T("recvfrom"),    { { 2, 4, HAWK_T("vrvr")  }, fnc_recvfrom,    0  } },
 	{ HAWK_T("resetdir"),    { { 2, 2, HAWK_NULL       }, fnc_resetdir,    0  } },
 	{ HAWK_T("rmdir"),       { { 1, 1, HAWK_NULL       }, fnc_rmdir,       0  } },
+	{ HAWK_T("sendfile"),    { { 3, 4, HAWK_NULL       }, fnc_sendfile,    0  } },
 	{ HAWK_T("sendto"),      { { 2, 3, HAWK_NULL       }, fnc_sendto,      0  } },
 	{ HAWK_T("setsockopt"),  { { 4, 4, HAWK_NULL       }, fnc_setsockopt,  0  } },
 	{ HAWK_T("settime"),     { { 1, 1, HAWK_NULL       }, fnc_settime,     0  } },
@@ -6293,6 +7380,7 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("sleep"),       { { 1, 1, HAWK_NULL       }, fnc_sleep,       0  } },
 	{ HAWK_T("sockaddrdom"), { { 1, 1, HAWK_NULL       }, fnc_sockaddrdom, 0  } },
 	{ HAWK_T("socket"),      { { 3, 3, HAWK_NULL       }, fnc_socket,      0  } },
+	{ HAWK_T("splice"),      { { 3, 4, HAWK_NULL       }, fnc_splice,      0  } },
 	{ HAWK_T("stat"),        { { 2, 2, HAWK_T("vr")    }, fnc_stat,        0  } },
 	{ HAWK_T("strftime"),    { { 2, 3, HAWK_NULL       }, fnc_strftime,    0  } },
 	{ HAWK_T("symlink"),     { { 2, 2, HAWK_NULL       }, fnc_symlink,     0  } },
@@ -6308,7 +7396,8 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("wait"),        { { 1, 3, HAWK_T("vrv")   }, fnc_wait,        0  } },
 	{ HAWK_T("waitonmux"),   { { 2, 2, HAWK_T("vv")    }, fnc_waitonmux,   0  } },
 	{ HAWK_T("write"),       { { 2, 4, HAWK_NULL       }, fnc_write,       0  } },
-	{ HAWK_T("writelog"),    { { 2, 2, HAWK_NULL       }, fnc_writelog,    0  } }
+	{ HAWK_T("writelog"),    { { 2, 2, HAWK_NULL       }, fnc_writelog,    0  } },
+	{ HAWK_T("writeonmux"),  { { 3, 3, HAWK_NULL       }, fnc_writeonmux,  0  } }
 };
 
 #if !defined(SIGHUP)
@@ -6420,10 +7509,15 @@ static hawk_mod_int_tab_t inttab[] =
 	{ HAWK_T("LOG_PRI_WARNING"),    { LOG_WARNING } },
 #endif
 
+	{ HAWK_T("MUX_EVT_ACCEPT"), { MUX_EVT_ACCEPT } },
 	{ HAWK_T("MUX_EVT_ERR"),  { MUX_EVT_ERR } },
 	{ HAWK_T("MUX_EVT_HUP"),  { MUX_EVT_HUP } },
 	{ HAWK_T("MUX_EVT_IN"),   { MUX_EVT_IN } },
 	{ HAWK_T("MUX_EVT_OUT"),  { MUX_EVT_OUT } },
+	{ HAWK_T("MUX_EVT_READ"), { MUX_EVT_READ } },
+	{ HAWK_T("MUX_EVT_WRITE"), { MUX_EVT_WRITE } },
+
+	{ HAWK_T("MUX_URING"),    { MUX_URING } },
 
 	{ HAWK_T("NWIFCFG_IN4"),  { HAWK_IFCFG_IN4 } }, /* for backward compatibility */
 	{ HAWK_T("NWIFCFG_IN6"),  { HAWK_IFCFG_IN6 } }, /* for backward compatibility */
@@ -6557,6 +7651,22 @@ static hawk_mod_int_tab_t inttab[] =
 	{ HAWK_T("SO_SNDBUF"),       { SO_SNDBUF } },
 	{ HAWK_T("SO_SNDTIMEO"),     { SO_SNDTIMEO } },
 
+#if defined(SPLICE_F_MORE)
+	{ HAWK_T("SPLICE_F_MORE"),     { SPLICE_F_MORE } },
+#else
+	{ HAWK_T("SPLICE_F_MORE"),     { 0 } },
+#endif
+#if defined(SPLICE_F_MOVE)
+	{ HAWK_T("SPLICE_F_MOVE"),     { SPLICE_F_MOVE } },
+#else
+	{ HAWK_T("SPLICE_F_MOVE"),     { 0 } },
+#endif
+#if defined(SPLICE_F_NONBLOCK)
+	{ HAWK_T("SPLICE_F_NONBLOCK"), { SPLICE_F_NONBLOCK } },
+#else
+	{ HAWK_T("SPLICE_F_NONBLOCK"), { 0 } },
+#endif
+
 	{ HAWK_T("STRFTIME_UTC"),    { STRFTIME_UTC } },
 
 #if defined(VDISCARD)
@@ -6837,7 +7947,9 @@ static int init (hawk_mod_t* mod, hawk_rtx_t* rtx)
 	hawk_rbt_pair_t* pair;
 
 	HAWK_MEMSET (&rd, 0, HAWK_SIZEOF(rd));
+	hawk_mtx_lock(&mctx->mtx, HAWK_NULL);
 	pair = hawk_rbt_insert(mctx->rtxtab, &rtx, HAWK_SIZEOF(rtx), &rd, HAWK_SIZEOF(rd));
+	hawk_mtx_unlock(&mctx->mtx);
 	if (HAWK_UNLIKELY(!pair)) return -1;
 
 	rdp = (rtx_data_t*)HAWK_RBT_VPTR(pair);
@@ -6904,7 +8016,9 @@ static void fini (hawk_mod_t* mod, hawk_rtx_t* rtx)
 	hawk_rbt_pair_t* pair;
 
 	/* garbage clean-up */
+	hawk_mtx_lock(&mctx->mtx, HAWK_NULL);
 	pair = hawk_rbt_search(mctx->rtxtab, &rtx, HAWK_SIZEOF(rtx));
+	hawk_mtx_unlock(&mctx->mtx);
 	if (pair)
 	{
 		rtx_data_t* rdp;
@@ -6924,7 +8038,9 @@ static void fini (hawk_mod_t* mod, hawk_rtx_t* rtx)
 
 		__fini_sys_list(rtx, &rdp->sys_list);
 
+		hawk_mtx_lock(&mctx->mtx, HAWK_NULL);
 		hawk_rbt_delete(mctx->rtxtab, &rtx, HAWK_SIZEOF(rtx));
+		hawk_mtx_unlock(&mctx->mtx);
 	}
 }
 
@@ -6934,6 +8050,7 @@ static void unload (hawk_mod_t* mod, hawk_t* hawk)
 
 	HAWK_ASSERT(HAWK_RBT_SIZE(mctx->rtxtab) == 0);
 	hawk_rbt_close(mctx->rtxtab);
+	hawk_mtx_fini(&mctx->mtx);
 
 	hawk_freemem(hawk, mctx);
 }
@@ -6952,9 +8069,16 @@ int hawk_mod_sys (hawk_mod_t* mod, hawk_t* hawk)
 	mctx = (mod_ctx_t*)hawk_callocmem(hawk, HAWK_SIZEOF(mod_ctx_t));
 	if (HAWK_UNLIKELY(!mctx)) return -1;
 
+	if (HAWK_UNLIKELY(hawk_mtx_init(&mctx->mtx, hawk_getgem(hawk), 0) <= -1))
+	{
+		hawk_freemem(hawk, mctx);
+		return -1;
+	}
+
 	rbt = hawk_rbt_open(hawk_getgem(hawk), 0, 1, 1);
 	if (HAWK_UNLIKELY(!rbt))
 	{
+		hawk_mtx_fini(&mctx->mtx);
 		hawk_freemem(hawk, mctx);
 		return -1;
 	}
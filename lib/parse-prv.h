@@ -40,6 +40,7 @@ enum hawk_kwid_t
 	HAWK_KWID_XNIL, /* @nil */
 	HAWK_KWID_XPRAGMA, /* @pragma */
 	HAWK_KWID_XRESET, /* @reset */
+	HAWK_KWID_XSORTED, /* @sorted */
 	HAWK_KWID_XTRUE, /* @true */
 	HAWK_KWID_BEGIN,
 	HAWK_KWID_END,
@@ -122,6 +123,10 @@ void hawk_clearsionames (
 	hawk_t* hawk
 );
 
+void hawk_adjustgbls (
+	hawk_t* hawk
+);
+
 hawk_mod_t* hawk_querymodulewithname (
 	hawk_t*            hawk,
 	const hawk_ooch_t* name,
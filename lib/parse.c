@@ -141,6 +141,7 @@ enum tok_t
 	TOK_XLOCAL,
 	TOK_XPRAGMA,
 	TOK_XRESET,
+	TOK_XSORTED,
 	TOK_XTRUE,
 
 	/* === normal reserved words === */
@@ -228,7 +229,6 @@ typedef enum nde_hard_bool_t nde_hard_bool_t;
 
 
 static int parse_progunit (hawk_t* hawk);
-static void adjust_static_globals (hawk_t* hawk);
 static hawk_oow_t find_global (hawk_t* hawk, const hawk_oocs_t* name);
 static hawk_t* collect_globals (hawk_t* hawk, nde_chain_t* init, int is_const);
 static hawk_t* collect_locals (hawk_t* hawk, hawk_oow_t nlcls, int flags, nde_chain_t* init, int is_const);
@@ -329,6 +329,7 @@ static kwent_t kwtab[] =
 	{ { HAWK_T("@nil"),           4 }, TOK_XNIL,          0 },
 	{ { HAWK_T("@pragma"),        7 }, TOK_XPRAGMA,       0 },
 	{ { HAWK_T("@reset"),         6 }, TOK_XRESET,        0 },
+	{ { HAWK_T("@sorted"),        7 }, TOK_XSORTED,       0 },
 	{ { HAWK_T("@true"),          5 }, TOK_XTRUE,         0 },
 	{ { HAWK_T("BEGIN"),          5 }, TOK_BEGIN,         HAWK_PABLOCK },
 	{ { HAWK_T("END"),            3 }, TOK_END,           HAWK_PABLOCK },
@@ -429,7 +430,10 @@ static global_t gtab[] =
 
 	{ HAWK_T("STRIPSTRSPC"),  11, 0 },
 
-	{ HAWK_T("SUBSEP"),       6,  0 }
+	{ HAWK_T("SUBSEP"),       6,  0 },
+
+	/* current input record parsed as a JSON value when RS is @jsonl */
+	{ HAWK_T("JSONREC"),      7,  HAWK_PABLOCK }
 };
 
 #define GET_CHAR(hawk) \
@@ -535,6 +539,34 @@ static HAWK_INLINE int is_nospace_lparen (hawk_t* hawk)
 	        hawk->tok.loc.colm == hawk->ptok.loc.colm + tok_len_for_nospace(&hawk->ptok));
 }
 
+static int hash_source (hawk_t* hawk, const hawk_ooch_t* ptr, hawk_oow_t len)
+{
+	/* hash the text read from each source stream including the included
+	 * files. hawk_savetree() records them for the sources to be checked */
+	hawk_sio_arg_t* inp = hawk->sio.inp;
+	int top = (inp == &hawk->sio.arg);
+	hawk_tree_src_t* src;
+
+	/* a stream may be read again after an included file ends */
+	for (src = hawk->tree.srcs; src; src = src->next)
+	{
+		if (src->path == inp->path && src->top == top) goto found;
+	}
+
+	src = (hawk_tree_src_t*)hawk_callocmem(hawk, HAWK_SIZEOF(*src));
+	if (HAWK_UNLIKELY(!src)) return -1;
+	src->path = inp->path;
+	src->hash = HAWK_HASH_INIT;
+	src->top = top;
+	if (hawk->tree.srcs_tail) hawk->tree.srcs_tail->next = src;
+	else hawk->tree.srcs = src;
+	hawk->tree.srcs_tail = src;
+
+found:
+	HAWK_HASH_MORE_VPTL(src->hash, ptr, len, const hawk_ooch_t);
+	return 0;
+}
+
 static int get_char (hawk_t* hawk)
 {
 	hawk_ooi_t n;
@@ -566,6 +598,8 @@ static int get_char (hawk_t* hawk)
 
 		hawk->sio.inp->b.pos = 0;
 		hawk->sio.inp->b.len = n;
+
+		if (hash_source(hawk, hawk->sio.inp->b.buf, n) <= -1) return -1;
 	}
 
 	if (hawk->sio.inp->last.c == HAWK_T('\n'))
@@ -622,7 +656,7 @@ static int parse (hawk_t* hawk)
 		return -1;
 	}
 
-	adjust_static_globals(hawk);
+	hawk_adjustgbls(hawk);
 
 	/* get the first character and the first token */
 	if (get_char(hawk) <= -1 || get_token(hawk)) goto oops;
@@ -1665,6 +1699,7 @@ static hawk_nde_t* parse_function (hawk_t* hawk, int named)
 {
 	hawk_oocs_t name = { HAWK_NULL, 0 };
 	hawk_oocs_t saved_fun_name;
+	int saved_tailcall;
 	hawk_nde_t* body = HAWK_NULL;
 	hawk_fun_t* fun = HAWK_NULL;
 	hawk_ooi_t org_fun_level;
@@ -1920,12 +1955,18 @@ static hawk_nde_t* parse_function (hawk_t* hawk, int named)
 	saved_fun_name = hawk->tree.cur_fun;
 	hawk->tree.cur_fun = name;
 
+	/* the frame can't be reused for a tail call if the caller
+	 * expects the reference parameters to be copied back from it */
+	saved_tailcall = hawk->parse.tailcall;
+	hawk->parse.tailcall = !has_ref_arg;
+
 	/* actual function body */
 	xloc = hawk->ptok.loc;
 	body = parse_block_dc(hawk, &xloc, 1);
 
 	/* clear the current function name remembered */
 	hawk->tree.cur_fun = saved_fun_name;
+	hawk->parse.tailcall = saved_tailcall;
 
 	if (!body) goto oops;
 
@@ -2441,7 +2482,7 @@ int hawk_initgbls (hawk_t* hawk)
 	return 0;
 }
 
-static void adjust_static_globals (hawk_t* hawk)
+void hawk_adjustgbls (hawk_t* hawk)
 {
 	int id;
 
@@ -3660,6 +3701,14 @@ static hawk_nde_t* parse_for (hawk_t* hawk, const hawk_loc_t* xloc)
 	hawk_nde_forin_t* nde_forin;
 	hawk_nde_for_t* nde_for;
 	hawk_loc_t ploc;
+	int sorted = 0;
+
+	if (MATCH(hawk,TOK_XSORTED))
+	{
+		/* for @sorted (k in a) - visit the keys in the sorted order */
+		sorted = 1;
+		if (get_token(hawk) <= -1) return HAWK_NULL;
+	}
 
 	if (!MATCH(hawk,TOK_LPAREN))
 	{
@@ -3712,6 +3761,7 @@ static hawk_nde_t* parse_for (hawk_t* hawk, const hawk_loc_t* xloc)
 			nde_forin->loc = *xloc;
 			nde_forin->test = init;
 			nde_forin->body = body;
+			nde_forin->sorted = sorted;
 
 			return (hawk_nde_t*)nde_forin;
 		}
@@ -3723,6 +3773,13 @@ static hawk_nde_t* parse_for (hawk_t* hawk, const hawk_loc_t* xloc)
 		}
 	}
 
+	if (sorted)
+	{
+		/* @sorted is allowed for the for-in loop only */
+		hawk_seterrnum(hawk, xloc, HAWK_EKWIN);
+		goto oops;
+	}
+
 	do
 	{
 		if (get_token(hawk) <= -1)  goto oops;
@@ -3976,6 +4033,7 @@ static hawk_nde_t* parse_return (hawk_t* hawk, const hawk_loc_t* xloc)
 	}
 
 	nde->val = val;
+	nde->tail = (val && val->type == HAWK_NDE_FNCALL_FUN && hawk->parse.tailcall);
 	return (hawk_nde_t*)nde;
 }
 
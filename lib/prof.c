@@ -0,0 +1,550 @@
+/*
+    Copyright (c) 2006-2020 Chung, Hyung-Hwan. All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+    1. Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright
+       notice, this list of conditions and the following disclaimer in the
+       documentation and/or other materials provided with the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE AUTHOR "AS IS" AND ANY EXPRESS OR
+    IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+    OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+    IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+    NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+    THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+    THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Profiler for hawk_rtx_setopt(HAWK_RTX_OPT_PROFILE).
+ *
+ * The runtime calls hawk_rtx_enterprof() and hawk_rtx_leaveprof() around
+ * user function calls, BEGIN, END and pattern-action blocks and each step
+ * of statement execution only while rtx->prof_on is set. The functions and
+ * the blocks form the call stack kept here. The statements are tracked on
+ * a separate stack such that the time of a line doesn't reduce the
+ * exclusive time of the function it belongs to.
+ *
+ * The exclusive figures of a frame exclude those of the frames entered
+ * while it's active. The inclusive figures of a recursive function are
+ * added up by the outermost call only. The allocations are the values
+ * counted in hawk_rtx_getallocstat().
+ */
+
+#include "hawk-prv.h"
+
+#if defined(HAVE_CLOCK_GETTIME)
+#	include <time.h>
+#endif
+
+typedef struct prof_ent_t prof_ent_t;
+struct prof_ent_t
+{
+	int kind;
+	const void* key;
+	hawk_loc_t loc;
+
+	hawk_oow_t calls;
+	hawk_oow_t active; /* number of frames of this entry on the stack */
+	hawk_uintmax_t incl_ns;
+	hawk_uintmax_t excl_ns;
+	hawk_uintmax_t incl_allocs;
+	hawk_uintmax_t excl_allocs;
+
+	prof_ent_t* link; /* next in the hash bucket */
+};
+
+/* a node in the tree of call paths for the folded output */
+typedef struct prof_node_t prof_node_t;
+struct prof_node_t
+{
+	prof_ent_t* ent;
+	prof_node_t* parent;
+	prof_node_t* child;
+	prof_node_t* sibling;
+	hawk_uintmax_t excl_ns;
+};
+
+typedef struct prof_frame_t prof_frame_t;
+struct prof_frame_t
+{
+	prof_ent_t* ent; /* HAWK_NULL if it couldn't be allocated */
+	prof_node_t* node;
+	hawk_uintmax_t start_ns;
+	hawk_uintmax_t child_ns;
+	hawk_uintmax_t start_allocs;
+	hawk_uintmax_t child_allocs;
+};
+
+typedef struct prof_stack_t prof_stack_t;
+struct prof_stack_t
+{
+	prof_frame_t* ptr;
+	hawk_oow_t size;
+	hawk_oow_t capa;
+	hawk_oow_t lost; /* frames not pushed for lack of memory */
+};
+
+typedef struct prof_t prof_t;
+struct prof_t
+{
+	hawk_mmgr_t* mmgr;
+
+	prof_ent_t** bucket;
+	hawk_oow_t nbuckets;
+	hawk_oow_t nents;
+
+	prof_node_t root;
+
+	prof_stack_t call; /* functions and blocks */
+	prof_stack_t line; /* statements */
+
+	hawk_uintmax_t total_ns;
+};
+
+/* ------------------------------------------------------------------------ */
+
+static HAWK_INLINE hawk_uintmax_t get_ns (void)
+{
+	hawk_ntime_t t;
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) return (hawk_uintmax_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+	hawk_get_ntime(&t);
+	return (hawk_uintmax_t)t.sec * 1000000000 + t.nsec;
+}
+
+static HAWK_INLINE hawk_uintmax_t get_allocs (hawk_rtx_t* rtx)
+{
+	return (hawk_uintmax_t)rtx->vmgr.stat.slab_allocs + rtx->vmgr.stat.heap_allocs + rtx->vmgr.stat.cache_hits;
+}
+
+static HAWK_INLINE hawk_oow_t hash_key (int kind, const void* key, hawk_oow_t line)
+{
+	return ((hawk_oow_t)key >> 3) ^ (line * 31) ^ kind;
+}
+
+static prof_ent_t* get_ent (prof_t* prof, int kind, const void* key, const hawk_loc_t* loc)
+{
+	hawk_oow_t line, h;
+	prof_ent_t* ent;
+
+	/* a line is identified by the file name pointer and the line number.
+	 * the others are identified by the tree node or the function */
+	line = (kind == HAWK_RTX_PROF_LINE)? loc->line: 0;
+	h = hash_key(kind, key, line);
+
+	for (ent = prof->bucket[h % prof->nbuckets]; ent; ent = ent->link)
+	{
+		if (ent->key == key && ent->kind == kind && (kind != HAWK_RTX_PROF_LINE || ent->loc.line == line)) return ent;
+	}
+
+	if (prof->nents >= prof->nbuckets)
+	{
+		prof_ent_t** nb;
+		hawk_oow_t nnb, i;
+
+		nnb = prof->nbuckets * 2;
+		nb = (prof_ent_t**)HAWK_MMGR_ALLOC(prof->mmgr, nnb * HAWK_SIZEOF(*nb));
+		if (nb)
+		{
+			HAWK_MEMSET(nb, 0, nnb * HAWK_SIZEOF(*nb));
+			for (i = 0; i < prof->nbuckets; i++)
+			{
+				while ((ent = prof->bucket[i]))
+				{
+					hawk_oow_t b;
+					prof->bucket[i] = ent->link;
+					b = hash_key(ent->kind, ent->key, (ent->kind == HAWK_RTX_PROF_LINE? ent->loc.line: 0)) % nnb;
+					ent->link = nb[b];
+					nb[b] = ent;
+				}
+			}
+			HAWK_MMGR_FREE(prof->mmgr, prof->bucket);
+			prof->bucket = nb;
+			prof->nbuckets = nnb;
+		}
+		/* keep going with the old buckets if the new ones are not available */
+	}
+
+	ent = (prof_ent_t*)HAWK_MMGR_ALLOC(prof->mmgr, HAWK_SIZEOF(*ent));
+	if (HAWK_UNLIKELY(!ent)) return HAWK_NULL;
+
+	HAWK_MEMSET(ent, 0, HAWK_SIZEOF(*ent));
+	ent->kind = kind;
+	ent->key = key;
+	ent->loc = *loc;
+	ent->link = prof->bucket[h % prof->nbuckets];
+	prof->bucket[h % prof->nbuckets] = ent;
+	prof->nents++;
+	return ent;
+}
+
+static prof_node_t* get_node (prof_t* prof, prof_node_t* parent, prof_ent_t* ent)
+{
+	prof_node_t* node;
+
+	for (node = parent->child; node; node = node->sibling)
+	{
+		if (node->ent == ent) return node;
+	}
+
+	node = (prof_node_t*)HAWK_MMGR_ALLOC(prof->mmgr, HAWK_SIZEOF(*node));
+	if (HAWK_UNLIKELY(!node)) return HAWK_NULL;
+
+	HAWK_MEMSET(node, 0, HAWK_SIZEOF(*node));
+	node->ent = ent;
+	node->parent = parent;
+	node->sibling = parent->child;
+	parent->child = node;
+	return node;
+}
+
+static void free_nodes (prof_t* prof, prof_node_t* node)
+{
+	while (node)
+	{
+		prof_node_t* next = node->sibling;
+		free_nodes(prof, node->child);
+		HAWK_MMGR_FREE(prof->mmgr, node);
+		node = next;
+	}
+}
+
+/* ------------------------------------------------------------------------ */
+
+int hawk_rtx_startprof (hawk_rtx_t* rtx)
+{
+	prof_t* prof = (prof_t*)rtx->prof;
+
+	if (!prof)
+	{
+		prof = (prof_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*prof));
+		if (HAWK_UNLIKELY(!prof)) return -1;
+
+		prof->mmgr = hawk_rtx_getmmgr(rtx);
+		prof->nbuckets = 256;
+		prof->bucket = (prof_ent_t**)hawk_rtx_callocmem(rtx, prof->nbuckets * HAWK_SIZEOF(*prof->bucket));
+		if (HAWK_UNLIKELY(!prof->bucket))
+		{
+			hawk_rtx_freemem(rtx, prof);
+			return -1;
+		}
+
+		rtx->prof = prof;
+	}
+
+	/* the frames left over from the previous session are discarded */
+	prof->call.size = 0;
+	prof->call.lost = 0;
+	prof->line.size = 0;
+	prof->line.lost = 0;
+	rtx->prof_on = 1;
+	return 0;
+}
+
+void hawk_rtx_stopprof (hawk_rtx_t* rtx)
+{
+	rtx->prof_on = 0;
+}
+
+void hawk_rtx_finiprof (hawk_rtx_t* rtx)
+{
+	prof_t* prof = (prof_t*)rtx->prof;
+	hawk_oow_t i;
+
+	rtx->prof_on = 0;
+	if (!prof) return;
+
+	for (i = 0; i < prof->nbuckets; i++)
+	{
+		prof_ent_t* ent;
+		while ((ent = prof->bucket[i]))
+		{
+			prof->bucket[i] = ent->link;
+			HAWK_MMGR_FREE(prof->mmgr, ent);
+		}
+	}
+	free_nodes(prof, prof->root.child);
+
+	HAWK_MMGR_FREE(prof->mmgr, prof->bucket);
+	if (prof->call.ptr) HAWK_MMGR_FREE(prof->mmgr, prof->call.ptr);
+	if (prof->line.ptr) HAWK_MMGR_FREE(prof->mmgr, prof->line.ptr);
+	HAWK_MMGR_FREE(prof->mmgr, prof);
+	rtx->prof = HAWK_NULL;
+}
+
+void hawk_rtx_enterprof (hawk_rtx_t* rtx, int kind, const void* key, const hawk_loc_t* loc, int count)
+{
+	prof_t* prof = (prof_t*)rtx->prof;
+	prof_stack_t* stack;
+	prof_frame_t* frame;
+	prof_ent_t* ent;
+
+	/* no error is reported from here not to disturb the execution.
+	 * the figures are lost if memory is not available */
+	stack = (kind == HAWK_RTX_PROF_LINE)? &prof->line: &prof->call;
+	if (stack->lost > 0 || stack->size >= stack->capa)
+	{
+		prof_frame_t* tmp;
+		hawk_oow_t newcapa;
+
+		newcapa = stack->capa + 64;
+		tmp = stack->lost > 0? HAWK_NULL: (prof_frame_t*)HAWK_MMGR_REALLOC(prof->mmgr, stack->ptr, newcapa * HAWK_SIZEOF(*tmp));
+		if (!tmp)
+		{
+			stack->lost++;
+			return;
+		}
+		stack->ptr = tmp;
+		stack->capa = newcapa;
+	}
+
+	ent = get_ent(prof, kind, key, loc);
+	frame = &stack->ptr[stack->size++];
+	frame->ent = ent;
+	frame->node = HAWK_NULL;
+	if (ent)
+	{
+		if (count) ent->calls++;
+		ent->active++;
+		if (kind != HAWK_RTX_PROF_LINE)
+		{
+			prof_node_t* parent = (stack->size > 1)? stack->ptr[stack->size - 2].node: &prof->root;
+			if (parent) frame->node = get_node(prof, parent, ent);
+		}
+	}
+	frame->child_ns = 0;
+	frame->child_allocs = 0;
+	frame->start_allocs = get_allocs(rtx);
+	frame->start_ns = get_ns();
+}
+
+void hawk_rtx_leaveprof (hawk_rtx_t* rtx, int kind)
+{
+	prof_t* prof = (prof_t*)rtx->prof;
+	prof_stack_t* stack;
+	prof_frame_t* frame;
+	hawk_uintmax_t incl_ns, incl_allocs;
+
+	incl_ns = get_ns();
+
+	stack = (kind == HAWK_RTX_PROF_LINE)? &prof->line: &prof->call;
+	if (stack->lost > 0)
+	{
+		stack->lost--;
+		return;
+	}
+	/* the stack can be empty if profiling has started in the middle */
+	if (stack->size <= 0) return;
+
+	frame = &stack->ptr[--stack->size];
+	incl_ns -= frame->start_ns;
+	incl_allocs = get_allocs(rtx) - frame->start_allocs;
+
+	if (frame->ent)
+	{
+		prof_ent_t* ent = frame->ent;
+		if (--ent->active == 0)
+		{
+			ent->incl_ns += incl_ns;
+			ent->incl_allocs += incl_allocs;
+		}
+		ent->excl_ns += incl_ns - frame->child_ns;
+		ent->excl_allocs += incl_allocs - frame->child_allocs;
+	}
+	if (frame->node) frame->node->excl_ns += incl_ns - frame->child_ns;
+
+	if (stack->size > 0)
+	{
+		stack->ptr[stack->size - 1].child_ns += incl_ns;
+		stack->ptr[stack->size - 1].child_allocs += incl_allocs;
+	}
+	else if (kind != HAWK_RTX_PROF_LINE)
+	{
+		prof->total_ns += incl_ns;
+	}
+}
+
+/* ------------------------------------------------------------------------ */
+
+static int cmp_ent (const void* ptr1, const void* ptr2, void* ctx)
+{
+	const prof_ent_t* e1 = *(const prof_ent_t**)ptr1;
+	const prof_ent_t* e2 = *(const prof_ent_t**)ptr2;
+
+	if (e1->excl_ns != e2->excl_ns) return (e1->excl_ns > e2->excl_ns)? -1: 1;
+	if (e1->calls != e2->calls) return (e1->calls > e2->calls)? -1: 1;
+	if (e1->loc.line != e2->loc.line) return (e1->loc.line < e2->loc.line)? -1: 1;
+	return 0;
+}
+
+static const hawk_bch_t* kind_name[] =
+{
+	"@global",
+	"BEGIN",
+	"END",
+	"pattern",
+	"function",
+	"line"
+};
+
+static int put_name (hawk_becs_t* out, prof_ent_t* ent, int folded)
+{
+	const hawk_ooch_t* file;
+	hawk_oow_t i, start;
+
+	file = ent->loc.file? ent->loc.file: HAWK_T("-");
+	start = HAWK_BECS_LEN(out);
+
+	if (ent->kind == HAWK_RTX_PROF_FUN && ((hawk_fun_t*)ent->key)->name.ptr && ((hawk_fun_t*)ent->key)->name.len > 0)
+	{
+		hawk_fun_t* fun = (hawk_fun_t*)ent->key;
+		if (hawk_becs_fcat(out, "%.*js", fun->name.len, fun->name.ptr) == (hawk_oow_t)-1) return -1;
+		if (!folded && hawk_becs_fcat(out, " (%js:%zu)", file, ent->loc.line) == (hawk_oow_t)-1) return -1;
+	}
+	else if (ent->kind == HAWK_RTX_PROF_LINE)
+	{
+		if (hawk_becs_fcat(out, "%js:%zu", file, ent->loc.line) == (hawk_oow_t)-1) return -1;
+	}
+	else
+	{
+		/* blocks and function literals have no names */
+		if (hawk_becs_fcat(out, (folded? "%hs@%js:%zu": "%hs (%js:%zu)"), kind_name[ent->kind], file, ent->loc.line) == (hawk_oow_t)-1) return -1;
+	}
+
+	if (folded)
+	{
+		/* a frame in the folded format can't contain a semicolon or a space */
+		for (i = start; i < HAWK_BECS_LEN(out); i++)
+		{
+			if (HAWK_BECS_CHAR(out, i) == ';' || HAWK_BECS_CHAR(out, i) == ' ') HAWK_BECS_CHAR(out, i) = '_';
+		}
+	}
+
+	return 0;
+}
+
+static int put_ms (hawk_becs_t* out, hawk_uintmax_t ns)
+{
+	hawk_uintmax_t us = ns / 1000;
+	return hawk_becs_fcat(out, " %10ju.%03ju", us / 1000, us % 1000) == (hawk_oow_t)-1? -1: 0;
+}
+
+static int dump_report (prof_t* prof, hawk_becs_t* out, prof_ent_t** ents, hawk_oow_t nents)
+{
+	hawk_oow_t i;
+	int pass;
+
+	if (hawk_becs_fcat(out, "# total %ju.%03ju ms\n", prof->total_ns / 1000000, (prof->total_ns / 1000) % 1000) == (hawk_oow_t)-1) return -1;
+
+	/* functions and blocks first, lines next */
+	for (pass = 0; pass < 2; pass++)
+	{
+		if (hawk_becs_fcat(out, "\n%hs\n%10hs %14hs %14hs %12hs %12hs  %hs\n",
+			(pass == 0? "# functions and blocks": "# lines"),
+			"calls", "incl(ms)", "excl(ms)", "incl-allocs", "excl-allocs", (pass == 0? "name": "location")) == (hawk_oow_t)-1) return -1;
+
+		for (i = 0; i < nents; i++)
+		{
+			prof_ent_t* ent = ents[i];
+
+			if ((ent->kind == HAWK_RTX_PROF_LINE) != pass) continue;
+			if (hawk_becs_fcat(out, "%10zu    ", ent->calls) == (hawk_oow_t)-1 ||
+			    put_ms(out, ent->incl_ns) <= -1 || put_ms(out, ent->excl_ns) <= -1 ||
+			    hawk_becs_fcat(out, " %12ju %12ju  ", ent->incl_allocs, ent->excl_allocs) == (hawk_oow_t)-1 ||
+			    put_name(out, ent, 0) <= -1 ||
+			    hawk_becs_ccat(out, '\n') == (hawk_oow_t)-1) return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int dump_folded (prof_t* prof, hawk_becs_t* out, prof_node_t* node)
+{
+	for (; node; node = node->sibling)
+	{
+		if (node->excl_ns >= 1000)
+		{
+			prof_node_t* path[256];
+			hawk_oow_t depth = 0, i;
+			prof_node_t* p;
+
+			/* collect the path up to the root. the outer part of
+			 * an extremely deep path is cut off */
+			for (p = node; p != &prof->root && depth < HAWK_COUNTOF(path); p = p->parent) path[depth++] = p;
+
+			for (i = depth; i > 0; i--)
+			{
+				if (put_name(out, path[i - 1]->ent, 1) <= -1 ||
+				    hawk_becs_ccat(out, (i > 1? ';': ' ')) == (hawk_oow_t)-1) return -1;
+			}
+
+			/* the value is the exclusive time in microseconds */
+			if (hawk_becs_fcat(out, "%ju\n", node->excl_ns / 1000) == (hawk_oow_t)-1) return -1;
+		}
+
+		if (dump_folded(prof, out, node->child) <= -1) return -1;
+	}
+
+	return 0;
+}
+
+hawk_bch_t* hawk_rtx_dumpprof (hawk_rtx_t* rtx, hawk_rtx_prof_fmt_t fmt, hawk_oow_t* len)
+{
+	prof_t* prof = (prof_t*)rtx->prof;
+	hawk_becs_t* out;
+	prof_ent_t** ents = HAWK_NULL;
+	hawk_bch_t* ptr;
+	int n;
+
+	out = hawk_becs_open(hawk_rtx_getgem(rtx), 0, 1024);
+	if (HAWK_UNLIKELY(!out)) return HAWK_NULL;
+
+	n = 0;
+	if (prof)
+	{
+		if (fmt == HAWK_RTX_PROF_FOLDED)
+		{
+			n = dump_folded(prof, out, prof->root.child);
+		}
+		else
+		{
+			hawk_oow_t i, j;
+
+			ents = (prof_ent_t**)hawk_rtx_allocmem(rtx, (prof->nents + 1) * HAWK_SIZEOF(*ents));
+			if (HAWK_UNLIKELY(!ents)) goto oops;
+
+			for (i = 0, j = 0; i < prof->nbuckets; i++)
+			{
+				prof_ent_t* ent;
+				for (ent = prof->bucket[i]; ent; ent = ent->link) ents[j++] = ent;
+			}
+			HAWK_ASSERT(j == prof->nents);
+
+			hawk_qsort(ents, j, HAWK_SIZEOF(*ents), cmp_ent, HAWK_NULL);
+			n = dump_report(prof, out, ents, j);
+			hawk_rtx_freemem(rtx, ents);
+		}
+	}
+	if (n <= -1) goto oops;
+
+	if (len) *len = HAWK_BECS_LEN(out);
+	ptr = hawk_becs_yieldptr(out, 0);
+	hawk_becs_close(out);
+	return ptr;
+
+oops:
+	hawk_becs_close(out);
+	return HAWK_NULL;
+}
@@ -108,7 +108,7 @@ static HAWK_INLINE_ALWAYS hawk_rbt_pair_t* alloc_pair (
 	else
 	{
 		VPTR(pair) = vcop(rbt, vptr, vlen);
-		if (VPTR(pair) != HAWK_NULL)
+		if (VPTR(pair) == HAWK_NULL)
 		{
 			if (rbt->style->freeer[HAWK_RBT_KEY])
 				rbt->style->freeer[HAWK_RBT_KEY](rbt, KPTR(pair), KLEN(pair));
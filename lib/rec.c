@@ -44,7 +44,9 @@ int hawk_rtx_setrec (hawk_rtx_t* rtx, hawk_oow_t idx, const hawk_oocs_t* str, in
 			if (hawk_ooecs_ncpy(&rtx->inrec.line, str->ptr, str->len) == (hawk_oow_t)-1) goto oops;
 		}
 
-		if (split_record(rtx, prefer_number) <= -1) goto oops;
+		/* a JSON Lines record is accessed via JSONREC. the fields are
+		 * left empty instead of splitting every record for nothing */
+		if (!rtx->gbl.jsonl && split_record(rtx, prefer_number) <= -1) goto oops;
 
 		v = prefer_number? hawk_rtx_makenumorstrvalwithoochars(rtx, HAWK_OOECS_PTR(&rtx->inrec.line), HAWK_OOECS_LEN(&rtx->inrec.line), 0):  /* number or string */
 		                   hawk_rtx_makenstrvalwithoochars(rtx, HAWK_OOECS_PTR(&rtx->inrec.line), HAWK_OOECS_LEN(&rtx->inrec.line));  /* str with nstr flag */
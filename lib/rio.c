@@ -404,7 +404,13 @@ int hawk_rtx_readio (hawk_rtx_t* rtx, hawk_in_type_t in_type, const hawk_ooch_t*
 	fs = hawk_rtx_getgbl(rtx, HAWK_GBL_FS);
 	hawk_rtx_refupval_inline(rtx, fs);
 
-	if (resolve_rs(rtx, rs, &rrs) <= -1) /* TODO: resolve it upon assignment for optimization? */
+	if (rtx->gbl.jsonl)
+	{
+		/* a JSON Lines record ends at a newline */
+		rrs.ptr = HAWK_NULL;
+		rrs.len = 0;
+	}
+	else if (resolve_rs(rtx, rs, &rrs) <= -1) /* TODO: resolve it upon assignment for optimization? */
 	{
 		hawk_rtx_refdownval_inline(rtx, rs);
 		return -1;
@@ -794,7 +800,12 @@ int hawk_rtx_readiobytes (hawk_rtx_t* rtx, hawk_in_type_t in_type, const hawk_oo
 	bfs = hawk_rtx_getgbl(rtx, HAWK_GBL_FS);
 	hawk_rtx_refupval_inline(rtx, bfs);
 
-	if (resolve_brs(rtx, brs, &rrs) <= -1)
+	if (rtx->gbl.jsonl)
+	{
+		rrs.ptr = HAWK_NULL;
+		rrs.len = 0;
+	}
+	else if (resolve_brs(rtx, brs, &rrs) <= -1)
 	{
 		hawk_rtx_refdownval_inline(rtx, brs);
 		return -1;
@@ -25,6 +25,17 @@
 #ifndef _HAWK_RUN_PRV_H_
 #define _HAWK_RUN_PRV_H_
 
+enum exit_level_t
+{
+	EXIT_NONE,
+	EXIT_BREAK,
+	EXIT_CONTINUE,
+	EXIT_FUNCTION,
+	EXIT_NEXT,
+	EXIT_GLOBAL,
+	EXIT_ABORT
+};
+
 enum hawk_assop_type_t
 {
 	/* if you change this, you have to change assop_str in tree.c.
@@ -105,6 +116,18 @@ enum hawk_incop_type_t
 	HAWK_INCOP_MINUS
 };
 
+/* the value stack is made of segments of HAWK_RTX_STACK_SEG_SIZE slots.
+ * a segment is allocated when the stack grows into it and never moves,
+ * which keeps the slot addresses held in reference values valid */
+struct hawk_stack_seg_t
+{
+	void*** ptr; /* segment table */
+	hawk_oow_t size; /* number of segments allocated */
+	hawk_oow_t capa; /* capacity of the segment table */
+};
+
+typedef struct hawk_stack_seg_t hawk_stack_seg_t;
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -155,6 +178,58 @@ int hawk_rtx_setsighandler (
 	hawk_fun_t* fun
 );
 
+void hawk_rtx_finicoros (
+	hawk_rtx_t* rtx
+);
+
+int hawk_rtx_growstack (
+	hawk_rtx_t*       rtx,
+	hawk_stack_seg_t* stack,
+	hawk_oow_t        size
+);
+
+void hawk_rtx_freestack (
+	hawk_rtx_t*       rtx,
+	hawk_stack_seg_t* stack
+);
+
+/* what hawk_rtx_enterprof() is called for. the profiler in prof.c
+ * names the blocks in this order */
+enum hawk_rtx_prof_kind_t
+{
+	HAWK_RTX_PROF_INIT,
+	HAWK_RTX_PROF_BEGIN,
+	HAWK_RTX_PROF_END,
+	HAWK_RTX_PROF_PACT,
+	HAWK_RTX_PROF_FUN,
+	HAWK_RTX_PROF_LINE
+};
+
+int hawk_rtx_startprof (
+	hawk_rtx_t* rtx
+);
+
+void hawk_rtx_stopprof (
+	hawk_rtx_t* rtx
+);
+
+void hawk_rtx_finiprof (
+	hawk_rtx_t* rtx
+);
+
+void hawk_rtx_enterprof (
+	hawk_rtx_t*       rtx,
+	int               kind,
+	const void*       key,
+	const hawk_loc_t* loc,
+	int               count
+);
+
+void hawk_rtx_leaveprof (
+	hawk_rtx_t* rtx,
+	int         kind
+);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -23,6 +23,7 @@
  */
 
 #include "hawk-prv.h"
+#include <hawk-json.h>
 
 #if defined(HAWK_ATOMIC_CAS_BOOL) && defined(HAWK_ATOMIC_LOAD) &&  defined(HAWK_ATOMIC_STORE)
 #define ATOMIC_EVAL_MODSYM
@@ -33,17 +34,6 @@
 #define DEF_BUF_CAPA (256)
 #define HAWK_RTX_STACK_INCREMENT (512)
 
-enum exit_level_t
-{
-	EXIT_NONE,
-	EXIT_BREAK,
-	EXIT_CONTINUE,
-	EXIT_FUNCTION,
-	EXIT_NEXT,
-	EXIT_GLOBAL,
-	EXIT_ABORT
-};
-
 enum cmp_op_t
 {
 	CMP_OP_NONE = 0,
@@ -103,7 +93,10 @@ static int init_rtx (hawk_rtx_t* rtx, hawk_t* hawk, hawk_rio_cbs_t* rio);
 static void fini_rtx (hawk_rtx_t* rtx, int fini_globals);
 
 static int init_globals (hawk_rtx_t* rtx);
+static int defaultify_globals (hawk_rtx_t* rtx);
 static void refdown_globals (hawk_rtx_t* rtx, int pop);
+static void drop_tail_call (hawk_rtx_t* rtx);
+static int update_fnr (hawk_rtx_t* rtx, hawk_int_t fnr, hawk_int_t nr);
 
 static int run_pblocks (hawk_rtx_t* rtx);
 static int run_pblock_chain (hawk_rtx_t* rtx, hawk_chain_t* cha);
@@ -334,7 +327,7 @@ static int set_global (hawk_rtx_t* rtx, int idx, hawk_nde_var_t* var, hawk_val_t
 
 	if (vtype == HAWK_VAL_MAP || vtype == HAWK_VAL_ARR)
 	{
-		if (idx >= HAWK_MIN_GBL_ID && idx <= HAWK_MAX_GBL_ID)
+		if (idx >= HAWK_MIN_GBL_ID && idx <= HAWK_MAX_GBL_ID && idx != HAWK_GBL_JSONREC)
 		{
 			/* short-circuit check block to prevent the basic built-in
 			 * variables from being assigned a map. if you happen to add
@@ -614,7 +607,11 @@ static int set_global (hawk_rtx_t* rtx, int idx, hawk_nde_var_t* var, hawk_val_t
 				rtx->gbl.rs[1] = HAWK_NULL;
 			}
 
-			if (rss.len > 1)
+			/* @jsonl splits records at a newline and parses each of them
+			 * as a JSON value into JSONREC. see read_record() */
+			rtx->gbl.jsonl = (hawk_comp_oochars_oocstr(rss.ptr, rss.len, HAWK_T("@jsonl"), 0) == 0);
+
+			if (rss.len > 1 && !rtx->gbl.jsonl)
 			{
 				hawk_tre_t* rex, * irex;
 
@@ -1211,6 +1208,10 @@ void hawk_rtx_close (hawk_rtx_t* rtx)
 	hawk_rtx_ecb_t* ecb, * ecb_next;
 	struct module_fini_ctx_t mfc;
 
+	/* unwind the coroutines left suspended before anything is torn down */
+	hawk_rtx_finicoros (rtx);
+	hawk_rtx_finiprof (rtx);
+
 	/* call fini() over the runtime loaded/inited modules */
 	mfc.limit = 0;
 	mfc.count = 0;
@@ -1250,6 +1251,62 @@ void hawk_rtx_close (hawk_rtx_t* rtx)
 	hawk_freemem(hawk_rtx_gethawk(rtx), rtx);
 }
 
+int hawk_rtx_reset (hawk_rtx_t* rtx)
+{
+	hawk_oow_t i;
+
+	/* the context must not be running */
+	HAWK_ASSERT(rtx->stack_base == 0);
+	HAWK_ASSERT(rtx->stack_top == rtx->hawk->tree.ngbls);
+
+	hawk_rtx_finicoros (rtx);
+	hawk_rtx_clearallios (rtx);
+	hawk_rtx_clrrec (rtx, 0);
+
+	/* drop the global variables without going through set_global()
+	 * and restore the states cached by it to the initial values. */
+	refdown_globals (rtx, 0);
+	if (rtx->gbl.rs[0])
+	{
+		hawk_rtx_freerex(rtx, rtx->gbl.rs[0], rtx->gbl.rs[1]);
+		rtx->gbl.rs[0] = HAWK_NULL;
+		rtx->gbl.rs[1] = HAWK_NULL;
+	}
+	if (rtx->gbl.fs[0])
+	{
+		hawk_rtx_freerex(rtx, rtx->gbl.fs[0], rtx->gbl.fs[1]);
+		rtx->gbl.fs[0] = HAWK_NULL;
+		rtx->gbl.fs[1] = HAWK_NULL;
+	}
+	rtx->gbl.ignorecase = 0;
+	rtx->gbl.numstrdetect = -1;
+	rtx->gbl.pipecloexec = -1;
+	rtx->gbl.striprecspc = -1;
+	rtx->gbl.stripstrspc = -1;
+	rtx->gbl.jsonl = 0;
+
+	if (hawk_rtx_setgbl(rtx, HAWK_GBL_NF, HAWK_VAL_ZERO) <= -1 ||
+	    update_fnr(rtx, 0, 0) <= -1 || defaultify_globals(rtx) <= -1) return -1;
+
+	for (i = 0; i < rtx->named_slot_count; i++)
+	{
+		hawk_rtx_refdownval_inline(rtx, rtx->named_slots[i]);
+		rtx->named_slots[i] = hawk_val_nil;
+	}
+
+	if (rtx->pattern_range_state)
+		HAWK_MEMSET(rtx->pattern_range_state, 0, rtx->hawk->tree.chain_size * HAWK_SIZEOF(hawk_oob_t));
+
+	rtx->exit_level = EXIT_NONE;
+	CLRERR(rtx);
+
+#if defined(HAWK_ENABLE_GC)
+	/* collect the cycles left over by the last use */
+	hawk_rtx_gc(rtx, HAWK_RTX_GC_GEN_FULL);
+#endif
+	return 0;
+}
+
 void hawk_rtx_halt (hawk_rtx_t* rtx)
 {
 	rtx->exit_level = EXIT_ABORT;
@@ -1260,6 +1317,33 @@ int hawk_rtx_ishalt (hawk_rtx_t* rtx)
 	return (rtx->exit_level == EXIT_ABORT || rtx->hawk->haltall);
 }
 
+int hawk_rtx_setopt (hawk_rtx_t* rtx, hawk_rtx_opt_t id, const void* value)
+{
+	switch (id)
+	{
+		case HAWK_RTX_OPT_PROFILE:
+			if (*(const int*)value) return hawk_rtx_startprof(rtx);
+			hawk_rtx_stopprof (rtx);
+			return 0;
+	}
+
+	hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_EINVAL);
+	return -1;
+}
+
+int hawk_rtx_getopt (hawk_rtx_t* rtx, hawk_rtx_opt_t id, void* value)
+{
+	switch (id)
+	{
+		case HAWK_RTX_OPT_PROFILE:
+			*(int*)value = rtx->prof_on;
+			return 0;
+	}
+
+	hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_EINVAL);
+	return -1;
+}
+
 void hawk_rtx_getrio (hawk_rtx_t* rtx, hawk_rio_cbs_t* rio)
 {
 	rio->pipe = rtx->rio.handler[HAWK_RIO_PIPE];
@@ -1324,8 +1408,7 @@ static int init_rtx (hawk_rtx_t* rtx, hawk_t* hawk, hawk_rio_cbs_t* rio)
 
 	stack_limit = hawk->parse.pragma.rtx_stack_limit > 0? hawk->parse.pragma.rtx_stack_limit: hawk->opt.rtx_stack_limit;
 	if (stack_limit < HAWK_MIN_RTX_STACK_LIMIT) stack_limit = HAWK_MIN_RTX_STACK_LIMIT;
-	rtx->stack = hawk_rtx_allocmem(rtx, stack_limit * HAWK_SIZEOF(void*));
-	if (HAWK_UNLIKELY(!rtx->stack)) goto oops_0;
+	/* the stack segments are allocated as the stack grows up to the limit */
 	rtx->stack_top = 0;
 	rtx->stack_base = 0;
 	rtx->stack_limit = stack_limit;
@@ -1336,6 +1419,9 @@ static int init_rtx (hawk_rtx_t* rtx, hawk_t* hawk, hawk_rio_cbs_t* rio)
 	rtx->vmgr.ifree = HAWK_NULL;
 	rtx->vmgr.rchunk = HAWK_NULL;
 	rtx->vmgr.rfree = HAWK_NULL;
+	rtx->vmgr.schunk = HAWK_NULL;
+	HAWK_MEMSET(rtx->vmgr.sfree, 0, HAWK_SIZEOF(rtx->vmgr.sfree));
+	HAWK_MEMSET(&rtx->vmgr.stat, 0, HAWK_SIZEOF(rtx->vmgr.stat));
 
 	for (i = 0; i < HAWK_COUNTOF(rtx->gc.g); i++)
 	{
@@ -1350,6 +1436,11 @@ static int init_rtx (hawk_rtx_t* rtx, hawk_t* hawk, hawk_rio_cbs_t* rio)
 	}
 
 	rtx->gc.pressure[i] = 0; /* pressure is larger than other elements by 1 in size */
+	rtx->gc.swept.gc_next = &rtx->gc.swept;
+	rtx->gc.swept.gc_prev = &rtx->gc.swept;
+	rtx->gc.budget = hawk->opt.rtx_gc_budget;
+	HAWK_MEMSET(rtx->gc.stat, 0, HAWK_SIZEOF(rtx->gc.stat));
+	rtx->gc.paused = 0;
 
 	rtx->inrec.buf_pos = 0;
 	rtx->inrec.buf_len = 0;
@@ -1431,6 +1522,8 @@ static int init_rtx (hawk_rtx_t* rtx, hawk_t* hawk, hawk_rio_cbs_t* rio)
 	rtx->gbl.pipecloexec = -1; /* means 'not set' */
 	rtx->gbl.striprecspc = -1; /* means 'not set' */
 	rtx->gbl.stripstrspc = -1; /* means 'not set' */
+	rtx->gbl.jsonl = 0;
+	rtx->json = HAWK_NULL;
 
 	return 0;
 
@@ -1470,11 +1563,50 @@ oops_2:
 	hawk_ooecs_fini(&rtx->inrec.line);
 oops_1:
 	if (rtx->exec_stack) hawk_rtx_freemem(rtx, rtx->exec_stack);
-	hawk_rtx_freemem(rtx, rtx->stack);
-oops_0:
+	hawk_rtx_freestack(rtx, &rtx->stack);
 	return -1;
 }
 
+int hawk_rtx_growstack (hawk_rtx_t* rtx, hawk_stack_seg_t* stack, hawk_oow_t size)
+{
+	/* allocate segments until the stack can hold 'size' slots */
+	while ((stack->size << HAWK_RTX_STACK_SEG_BITS) < size)
+	{
+		void** seg;
+
+		if (stack->size >= stack->capa)
+		{
+			void*** tmp;
+			hawk_oow_t newcapa;
+
+			newcapa = HAWK_ALIGN_POW2(stack->size + 1, 16);
+			tmp = (void***)hawk_rtx_reallocmem(rtx, stack->ptr, newcapa * HAWK_SIZEOF(*tmp));
+			if (HAWK_UNLIKELY(!tmp)) return -1;
+
+			stack->ptr = tmp;
+			stack->capa = newcapa;
+		}
+
+		seg = (void**)hawk_rtx_allocmem(rtx, HAWK_RTX_STACK_SEG_SIZE * HAWK_SIZEOF(*seg));
+		if (HAWK_UNLIKELY(!seg)) return -1;
+
+		stack->ptr[stack->size++] = seg;
+	}
+
+	return 0;
+}
+
+void hawk_rtx_freestack (hawk_rtx_t* rtx, hawk_stack_seg_t* stack)
+{
+	while (stack->size > 0) hawk_rtx_freemem(rtx, stack->ptr[--stack->size]);
+	if (stack->ptr)
+	{
+		hawk_rtx_freemem(rtx, stack->ptr);
+		stack->ptr = HAWK_NULL;
+		stack->capa = 0;
+	}
+}
+
 static void fini_rtx (hawk_rtx_t* rtx, int fini_globals)
 {
 #if !defined(HAWK_ENABLE_ATOMIC_SIG)
@@ -1496,12 +1628,32 @@ static void fini_rtx (hawk_rtx_t* rtx, int fini_globals)
 		rtx->forin.capa = 0;
 	}
 
+	if (rtx->tail.ptr)
+	{
+		drop_tail_call(rtx);
+		hawk_rtx_freemem(rtx, rtx->tail.ptr);
+		rtx->tail.ptr = HAWK_NULL;
+		rtx->tail.capa = 0;
+	}
+
+	if (rtx->imc.slot)
+	{
+		hawk_rtx_freemem(rtx, rtx->imc.slot);
+		rtx->imc.slot = HAWK_NULL;
+	}
+
 	HAWK_ASSERT(rtx->modtab != HAWK_NULL);
 	hawk_rbt_close(rtx->modtab);
 
 	if (rtx->pattern_range_state)
 		hawk_rtx_freemem(rtx, rtx->pattern_range_state);
 
+	if (rtx->json)
+	{
+		hawk_json_close((hawk_json_t*)rtx->json);
+		rtx->json = HAWK_NULL;
+	}
+
 	/* close all pending io's */
 	/* TODO: what if this operation fails? */
 	hawk_rtx_clearallios(rtx);
@@ -1596,12 +1748,11 @@ static void fini_rtx (hawk_rtx_t* rtx, int fini_globals)
 	if (fini_globals) refdown_globals(rtx, 1);
 
 	/* destroy the stack if necessary */
-	if (rtx->stack)
+	if (rtx->stack.ptr)
 	{
 		HAWK_ASSERT(rtx->stack_top == 0);
 
-		hawk_rtx_freemem(rtx, rtx->stack);
-		rtx->stack = HAWK_NULL;
+		hawk_rtx_freestack(rtx, &rtx->stack);
 		rtx->stack_top = 0;
 		rtx->stack_base = 0;
 		rtx->stack_limit = 0;
@@ -1637,12 +1788,6 @@ static void fini_rtx (hawk_rtx_t* rtx, int fini_globals)
 #endif
 
 	/* destroy values in free list */
-	while (rtx->rcache_count > 0)
-	{
-		hawk_val_ref_t* tmp = rtx->rcache[--rtx->rcache_count];
-		hawk_rtx_freeval(rtx, (hawk_val_t*)tmp, 0);
-	}
-
 #if defined(HAWK_ENABLE_STR_CACHE)
 	{
 		int i;
@@ -1673,8 +1818,11 @@ static void fini_rtx (hawk_rtx_t* rtx, int fini_globals)
 
 	hawk_rtx_freevalchunk(rtx, rtx->vmgr.ichunk);
 	hawk_rtx_freevalchunk(rtx, rtx->vmgr.rchunk);
+	hawk_rtx_freevalchunk(rtx, rtx->vmgr.schunk);
 	rtx->vmgr.ichunk = HAWK_NULL;
 	rtx->vmgr.rchunk = HAWK_NULL;
+	rtx->vmgr.schunk = HAWK_NULL;
+	HAWK_MEMSET(rtx->vmgr.sfree, 0, HAWK_SIZEOF(rtx->vmgr.sfree));
 }
 
 hawk_mod_t* hawk_rtx_querymodulewithoocs (hawk_rtx_t* rtx, const hawk_oocs_t* name, hawk_mod_sym_t* sym, int flags)
@@ -1775,6 +1923,41 @@ oops:
 	return n;
 }
 
+static int is_blank_record (const hawk_ooecs_t* buf)
+{
+	hawk_oow_t i;
+	for (i = 0; i < HAWK_OOECS_LEN(buf); i++)
+	{
+		if (!hawk_is_ooch_space(HAWK_OOECS_CHAR(buf, i))) return 0;
+	}
+	return 1;
+}
+
+static int update_jsonrec (hawk_rtx_t* rtx, const hawk_oocs_t* line)
+{
+	hawk_val_t* v, * old;
+
+	v = hawk_rtx_makejsonvalwithoochars(rtx, line->ptr, line->len);
+	if (HAWK_UNLIKELY(!v))
+	{
+		/* a malformed record doesn't stop the input. JSONREC becomes
+		 * nil for the record and the error is logged */
+		if (hawk_rtx_geterrnum(rtx) == HAWK_ENOMEM) return -1;
+		hawk_logfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_RTX | HAWK_LOG_WARN | HAWK_LOG_STDERR,
+			HAWK_T("invalid JSON record %zu - %js\n"), (hawk_oow_t)(rtx->gbl.nr + 1), hawk_rtx_geterrmsg(rtx));
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_ENOERR);
+		v = hawk_val_nil;
+	}
+
+	/* store it directly as a record can be a scalar value
+	 * after a map or vice versa */
+	old = HAWK_RTX_STACK_GBL(rtx, HAWK_GBL_JSONREC);
+	hawk_rtx_refupval(rtx, v);
+	hawk_rtx_refdownval(rtx, old);
+	HAWK_RTX_STACK_GBL(rtx, HAWK_GBL_JSONREC) = v;
+	return 0;
+}
+
 /*
  * create global variables into the runtime stack
  * each variable is initialized to nil or zero.
@@ -1793,6 +1976,7 @@ static int prepare_globals (hawk_rtx_t* rtx)
 			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, ngbls);
 		return -1;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, ngbls) <= -1)) return -1;
 
 	saved_stack_top = rtx->stack_top;
 
@@ -1928,6 +2112,7 @@ static void capture_retval_on_exit (void* arg)
 static int run_blocks_for_bpae_loop (hawk_rtx_t* rtx, hawk_nde_t* blk_head, int top_exit_level, int ret)
 {
 	hawk_nde_t* nde;
+	int n;
 
 	/* top_exit_level
 	 *   init/BEGIN - not called if `exit[EXIT_GLOBAL]` has been called
@@ -1941,7 +2126,17 @@ static int run_blocks_for_bpae_loop (hawk_rtx_t* rtx, hawk_nde_t* blk_head, int
 
 		rtx->active_block = blk;
 		rtx->exit_level = EXIT_NONE;
-		if (run_block(rtx, blk) <= -1) ret = -1;
+		if (HAWK_UNLIKELY(rtx->prof_on))
+		{
+			int kind = (blk_head == rtx->hawk->tree.init)? HAWK_RTX_PROF_INIT:
+			           (blk_head == rtx->hawk->tree.begin)? HAWK_RTX_PROF_BEGIN: HAWK_RTX_PROF_END;
+			hawk_rtx_enterprof (rtx, kind, blk, &blk->loc, 1);
+			n = run_block(rtx, blk);
+			hawk_rtx_leaveprof (rtx, kind);
+		}
+		else n = run_block(rtx, blk);
+
+		if (n <= -1) ret = -1;
 		else if (top_exit_level == EXIT_ABORT && rtx->exit_level >= EXIT_GLOBAL)
 		{
 			/* top_exit_level is EXIT_ABORT for END bloacks.
@@ -2055,6 +2250,7 @@ hawk_val_t* hawk_rtx_loop (hawk_rtx_t* rtx)
 			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit);
 		return HAWK_NULL;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, 4) <= -1)) return HAWK_NULL;
 
 	saved_stack_top = rtx->stack_top; 	/* remember the current stack top */
 	HAWK_RTX_STACK_PUSH(rtx, (void*)rtx->stack_base); /* push the current stack base */
@@ -2070,8 +2266,8 @@ hawk_val_t* hawk_rtx_loop (hawk_rtx_t* rtx)
 
 	/* exit the stack frame */
 	HAWK_ASSERT((rtx->stack_top - rtx->stack_base) == 4); /* at this point, the current stack frame should have the 4 entries pushed above */
-	rtx->stack_top = (hawk_oow_t)rtx->stack[rtx->stack_base + 1];
-	rtx->stack_base = (hawk_oow_t)rtx->stack[rtx->stack_base + 0];
+	rtx->stack_top = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 1);
+	rtx->stack_base = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 0);
 
 	/* reset the exit level */
 	rtx->exit_level = EXIT_NONE;
@@ -2216,6 +2412,15 @@ hawk_val_t* hawk_rtx_callfun (hawk_rtx_t* rtx, hawk_fun_t* fun, hawk_val_t* args
 			hawk_val_t* retv;
 
 			/* prepare the stack frame in the same way as hawk_rtx_loop() + run_bpae_loop() */
+			if (HAWK_UNLIKELY(HAWK_RTX_STACK_AVAIL(rtx) < 4))
+			{
+				hawk_rtx_seterrbfmt(rtx, HAWK_NULL, HAWK_ESTACK,
+					"stack full(avail=%zu, limit=%zu) in preparing call frame",
+					HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit);
+				return HAWK_NULL;
+			}
+			if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, 4) <= -1)) return HAWK_NULL;
+
 			saved_stack_top = rtx->stack_top; 	/* remember the current stack top */
 			HAWK_RTX_STACK_PUSH(rtx, (void*)rtx->stack_base); /* push the current stack base */
 			HAWK_RTX_STACK_PUSH(rtx, (void*)saved_stack_top); /* push the current stack top before push the current stack base */
@@ -2241,8 +2446,8 @@ hawk_val_t* hawk_rtx_callfun (hawk_rtx_t* rtx, hawk_fun_t* fun, hawk_val_t* args
 
 			/* exit the stack frame */
 			HAWK_ASSERT((rtx->stack_top - rtx->stack_base) == 4); /* at this point, the current stack frame should have the 4 entries pushed above */
-			rtx->stack_top = (hawk_oow_t)rtx->stack[rtx->stack_base + 1];
-			rtx->stack_base = (hawk_oow_t)rtx->stack[rtx->stack_base + 0];
+			rtx->stack_top = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 1);
+			rtx->stack_base = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 0);
 
 			if (ret <= -1) return HAWK_NULL;
 			if (rtx->exit_level >= EXIT_GLOBAL)
@@ -2488,7 +2693,15 @@ static int run_pblock_chain (hawk_rtx_t* rtx, hawk_chain_t* chain)
 			break;
 		}
 
-		if (run_pblock(rtx, chain, bno) <= -1) return -1;
+		if (HAWK_UNLIKELY(rtx->prof_on))
+		{
+			int n;
+			hawk_rtx_enterprof (rtx, HAWK_RTX_PROF_PACT, chain, (chain->pattern? &chain->pattern->loc: &chain->action->loc), 1);
+			n = run_pblock(rtx, chain, bno);
+			hawk_rtx_leaveprof (rtx, HAWK_RTX_PROF_PACT);
+			if (n <= -1) return -1;
+		}
+		else if (run_pblock(rtx, chain, bno) <= -1) return -1;
 
 		chain = chain->next;
 		bno++;
@@ -2622,6 +2835,7 @@ static HAWK_INLINE int run_block0 (hawk_rtx_t* rtx, hawk_nde_blk_t* nde)
 				HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, tmp);
 			return -1;
 		}
+		if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, tmp) <= -1)) return -1;
 
 		do
 		{
@@ -3079,6 +3293,11 @@ static int enter_block_iterative (hawk_rtx_t* rtx, hawk_nde_blk_t* nde)
 				HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, tmp);
 			return -1;
 		}
+		if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, tmp) <= -1))
+		{
+			rtx->depth.block--;
+			return -1;
+		}
 
 		do
 		{
@@ -3279,7 +3498,14 @@ static int run_statement (hawk_rtx_t* rtx, hawk_nde_t* nde)
 	{
 		if (!pop_exec_stack(rtx, &es)) break;
 
-		xret = run_statement0(rtx, &es);
+		if (HAWK_UNLIKELY(rtx->prof_on))
+		{
+			/* a statement resumed after its children count as a single execution */
+			hawk_rtx_enterprof (rtx, HAWK_RTX_PROF_LINE, es.nde->loc.file, &es.nde->loc, es.state == EXEC_STATE_ENTER);
+			xret = run_statement0(rtx, &es);
+			hawk_rtx_leaveprof (rtx, HAWK_RTX_PROF_LINE);
+		}
+		else xret = run_statement0(rtx, &es);
 		if (xret <= -1)
 		{
 			unwind_exec_stack(rtx, base);
@@ -3616,6 +3842,77 @@ static int run_for (hawk_rtx_t* rtx, int state, hawk_nde_for_t* nde)
 	return 0;
 }
 
+/* the keys collected for 'for @sorted (k in a)' are kept in a min-heap
+ * laid out backward from the top of the region on the forin stack so that
+ * the smallest key popped off can be placed at the front of the region
+ * where the loop index points. heap element i lives at top[-i]. the keys
+ * are ordered lazily - a loop broken early doesn't pay for a full sort. */
+static int sift_forin_heap (hawk_rtx_t* rtx, hawk_val_t** top, hawk_oow_t n, hawk_oow_t i)
+{
+	while (1)
+	{
+		hawk_oow_t l, r, m;
+		hawk_val_t* tmp;
+		int x;
+
+		l = i * 2 + 1;
+		if (l >= n) break;
+
+		m = l;
+		r = l + 1;
+		if (r < n)
+		{
+			if (HAWK_UNLIKELY(hawk_rtx_cmpval(rtx, *(top - r), *(top - l), &x) <= -1)) return -1;
+			if (x < 0) m = r;
+		}
+
+		if (HAWK_UNLIKELY(hawk_rtx_cmpval(rtx, *(top - m), *(top - i), &x) <= -1)) return -1;
+		if (x >= 0) break;
+
+		tmp = *(top - m);
+		*(top - m) = *(top - i);
+		*(top - i) = tmp;
+		i = m;
+	}
+
+	return 0;
+}
+
+static int make_forin_heap (hawk_rtx_t* rtx, hawk_oow_t base)
+{
+	hawk_oow_t n, i;
+	hawk_val_t** top;
+
+	n = rtx->forin.size - base;
+	if (n <= 1) return 0;
+
+	top = &rtx->forin.ptr[rtx->forin.size - 1];
+	i = n / 2;
+	while (i > 0)
+	{
+		if (HAWK_UNLIKELY(sift_forin_heap(rtx, top, n, --i) <= -1)) return -1;
+	}
+
+	return 0;
+}
+
+static int pop_forin_heap (hawk_rtx_t* rtx, hawk_oow_t iv)
+{
+	hawk_oow_t n;
+	hawk_val_t** top, * tmp;
+
+	/* move the smallest key to the slot at iv */
+	n = rtx->forin.size - iv;
+	if (n <= 1) return 0;
+
+	top = &rtx->forin.ptr[rtx->forin.size - 1];
+	tmp = *top;
+	*top = rtx->forin.ptr[iv];
+	rtx->forin.ptr[iv] = tmp;
+
+	return sift_forin_heap(rtx, top, n - 1, 0);
+}
+
 static int run_forin (hawk_rtx_t* rtx, const hawk_exec_stack_t* es, hawk_nde_forin_t* nde)
 {
 	hawk_nde_exp_t* test;
@@ -3632,6 +3929,11 @@ static int run_forin (hawk_rtx_t* rtx, const hawk_exec_stack_t* es, hawk_nde_for
 	if (es->state == EXEC_STATE_FORIN_STEP)
 	{
 		if (es->iv >= rtx->forin.size) return 0;
+		if (nde->sorted && HAWK_UNLIKELY(pop_forin_heap(rtx, es->iv) <= -1))
+		{
+			ADJERR_LOC(rtx, &test->left->loc);
+			return -1;
+		}
 		if (HAWK_UNLIKELY(!do_assignment(rtx, test->left, rtx->forin.ptr[es->iv], 0))) return -1;
 		if (push_exec_stack3(rtx, EXEC_STATE_FORIN_BODY_DONE, (hawk_nde_t*)nde, es->iv + 1, es->base) <= -1 ||
 		    push_exec_stack(rtx, EXEC_STATE_ENTER, nde->body) <= -1) return -1;
@@ -3715,6 +4017,12 @@ static int run_forin (hawk_rtx_t* rtx, const hawk_exec_stack_t* es, hawk_nde_for
 
 				pair = hawk_map_getnextpair(map, &itr);
 			}
+
+			if (nde->sorted && HAWK_UNLIKELY(make_forin_heap(rtx, old_forin_size) <= -1))
+			{
+				ADJERR_LOC(rtx, &test->left->loc);
+				goto oops;
+			}
 			break;
 		}
 
@@ -3761,6 +4069,14 @@ static int run_forin (hawk_rtx_t* rtx, const hawk_exec_stack_t* es, hawk_nde_for
 					hawk_rtx_refupval_inline(rtx, tmp);
 				}
 			}
+
+			/* the indices are collected in the ascending order. but the
+			 * step pops the keys off the heap for a sorted loop */
+			if (nde->sorted && HAWK_UNLIKELY(make_forin_heap(rtx, old_forin_size) <= -1))
+			{
+				ADJERR_LOC(rtx, &test->left->loc);
+				goto oops;
+			}
 			break;
 		}
 
@@ -3800,8 +4116,123 @@ static int run_continue (hawk_rtx_t* rtx, hawk_nde_continue_t* nde)
 	return 0;
 }
 
+static void drop_tail_call (hawk_rtx_t* rtx)
+{
+	while (rtx->tail.size > 0)
+	{
+		hawk_rtx_refdownval_inline(rtx, rtx->tail.ptr[--rtx->tail.size]);
+	}
+	rtx->tail.fun = HAWK_NULL;
+}
+
+static int set_tail_call (hawk_rtx_t* rtx, hawk_nde_fncall_t* call, hawk_fun_t* fun)
+{
+	hawk_oow_t saved_stack_top, i;
+	pafn_t pafn;
+
+	/* evaluate the arguments on top of the stack as usual. the evaluation
+	 * can involve other calls with their own tail calls using rtx->tail */
+	saved_stack_top = rtx->stack_top;
+	pafn.args = call->args;
+	pafn.nargs = call->nargs;
+	pafn.argspec = HAWK_NULL;
+	if (push_arg_from_nde(rtx, &call->loc, &pafn) == (hawk_oow_t)-1) goto oops;
+
+	if (rtx->tail.capa < call->nargs)
+	{
+		hawk_val_t** tmp;
+		hawk_oow_t newcapa;
+
+		newcapa = HAWK_ALIGN_POW2(call->nargs, 16);
+		tmp = hawk_rtx_reallocmem(rtx, rtx->tail.ptr, newcapa * HAWK_SIZEOF(*tmp));
+		if (HAWK_UNLIKELY(!tmp)) goto oops;
+
+		rtx->tail.ptr = tmp;
+		rtx->tail.capa = newcapa;
+	}
+
+	/* move the arguments off the stack. the reference counts
+	 * incremented by push_arg_from_nde() go with them */
+	for (i = 0; i < call->nargs; i++) rtx->tail.ptr[i] = HAWK_RTX_STACK_SLOT(rtx, saved_stack_top + i);
+	rtx->tail.size = call->nargs;
+	rtx->stack_top = saved_stack_top;
+
+	rtx->tail.fun = fun;
+	rtx->tail.call = call;
+	return 0;
+
+oops:
+	while (rtx->stack_top > saved_stack_top)
+	{
+		hawk_rtx_refdownval_inline(rtx, HAWK_RTX_STACK_SLOT(rtx, rtx->stack_top - 1));
+		HAWK_RTX_STACK_POP(rtx);
+	}
+	ADJERR_LOC(rtx, &call->loc);
+	return -1;
+}
+
+static int enter_tail_call (hawk_rtx_t* rtx, hawk_fun_t** fun)
+{
+	hawk_nde_fncall_t* call = rtx->tail.call;
+	hawk_oow_t nargs, i;
+
+	/* replace the arguments in the current frame with the arguments
+	 * for the tail call. the local variables of the function left
+	 * have been popped off by run_block() already */
+	nargs = (hawk_oow_t)HAWK_RTX_STACK_NARGS(rtx);
+	HAWK_ASSERT(rtx->stack_top == rtx->stack_base + 4 + nargs);
+	for (i = 0; i < nargs; i++) hawk_rtx_refdownval_inline(rtx, HAWK_RTX_STACK_ARG(rtx, i));
+	rtx->stack_top = rtx->stack_base + 4;
+
+	nargs = (rtx->tail.fun->nargs > rtx->tail.size)? rtx->tail.fun->nargs: rtx->tail.size;
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_AVAIL(rtx) < nargs))
+	{
+		hawk_rtx_seterrbfmt(rtx, &call->loc, HAWK_ESTACK,
+			"stack full(avail=%zu, limit=%zu) for call frame with %zu arguments",
+			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, call->nargs);
+		goto oops;
+	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, nargs) <= -1)) goto oops;
+
+	for (i = 0; i < rtx->tail.size; i++) HAWK_RTX_STACK_PUSH(rtx, rtx->tail.ptr[i]);
+	for (; i < nargs; i++) HAWK_RTX_STACK_PUSH(rtx, hawk_val_nil);
+	HAWK_RTX_STACK_NARGS(rtx) = (void*)nargs;
+
+	*fun = rtx->tail.fun;
+	rtx->tail.fun = HAWK_NULL;
+	rtx->tail.size = 0;
+	rtx->exit_level = EXIT_NONE;
+	return 0;
+
+oops:
+	HAWK_RTX_STACK_NARGS(rtx) = (void*)0;
+	drop_tail_call(rtx);
+	return -1;
+}
+
 static int run_return (hawk_rtx_t* rtx, hawk_nde_return_t* nde)
 {
+	if (nde->tail)
+	{
+		hawk_nde_fncall_t* call = (hawk_nde_fncall_t*)nde->val;
+		hawk_fun_t* fun;
+
+		/* the parser marks a call to a user function in the return statement
+		 * if the current frame can be reused. leave the current function
+		 * with the arguments evaluated and let hawk_rtx_evalcall() run the
+		 * callee in the same frame. a callee with reference parameters is
+		 * called normally as it updates the arguments in the caller's frame. */
+		fun = resolve_fncall_fun(rtx, call);
+		if (HAWK_UNLIKELY(!fun)) return -1;
+
+		if (!fun->hasrefarg)
+		{
+			if (set_tail_call(rtx, call, fun) <= -1) return -1;
+			rtx->exit_level = EXIT_FUNCTION;
+			return 0;
+		}
+	}
+
 	if (nde->val)
 	{
 		hawk_val_t* val;
@@ -4128,6 +4559,7 @@ static HAWK_INLINE int delete_indexed (hawk_rtx_t* rtx, hawk_val_t* vv, hawk_nde
 		len = HAWK_COUNTOF(idxbuf);
 		str = idxnde_to_str(rtx, var->idx, idxbuf, &len, &remidx, HAWK_NULL);
 		if (HAWK_UNLIKELY(!str)) goto oops;
+		if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, vv) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 		map = ((hawk_val_map_t*)vv)->map;
 	}
 	else
@@ -4164,6 +4596,7 @@ static HAWK_INLINE int delete_indexed (hawk_rtx_t* rtx, hawk_val_t* vv, hawk_nde
 				len = HAWK_COUNTOF(idxbuf);
 				str = idxnde_to_str(rtx, remidx, idxbuf, &len, &remidx, HAWK_NULL);
 				if (HAWK_UNLIKELY(!str)) goto oops;
+				if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, vv) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 				map = ((hawk_val_map_t*)vv)->map;
 				break;
 
@@ -4256,6 +4689,7 @@ static int run_delete (hawk_rtx_t* rtx, hawk_nde_delete_t* nde)
 				  print typename(a), length(a);
 				}
 				*/
+				if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, val) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 				hawk_map_clear(((hawk_val_map_t*)val)->map);
 			}
 			break;
@@ -5281,6 +5715,7 @@ static hawk_val_t* do_assignment_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var,
 				len = HAWK_COUNTOF(idxbuf);
 				str = idxnde_to_str(rtx, var->idx, idxbuf, &len, &remidx, HAWK_NULL);
 				if (HAWK_UNLIKELY(!str)) goto oops;
+				if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, vv) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 				map = ((hawk_val_map_t*)vv)->map;
 			}
 			else
@@ -5316,6 +5751,7 @@ static hawk_val_t* do_assignment_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var,
 						len = HAWK_COUNTOF(idxbuf);
 						str = idxnde_to_str(rtx, remidx, idxbuf, &len, &remidx, HAWK_NULL);
 						if (HAWK_UNLIKELY(!str)) goto oops;
+						if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, vv) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 						map = ((hawk_val_map_t*)vv)->map;
 						break;
 
@@ -5967,12 +6403,7 @@ static HAWK_INLINE int __cmp_bool_str (hawk_rtx_t* rtx, hawk_val_t* left, hawk_v
 		hawk_int_t ll;
 		hawk_flt_t rr;
 
-		n = hawk_oochars_to_num(
-			HAWK_OOCHARS_TO_NUM_MAKE_OPTION(1, 0, HAWK_RTX_IS_STRIPSTRSPC_ON(rtx), 0),
-			((hawk_val_str_t*)right)->val.ptr,
-			((hawk_val_str_t*)right)->val.len,
-			&ll, &rr
-		);
+		n = hawk_rtx_strvaltonum(rtx, (hawk_val_str_t*)right, &ll, &rr);
 
 		if (n == 0)
 		{
@@ -6293,12 +6724,7 @@ static HAWK_INLINE int __cmp_int_str (hawk_rtx_t* rtx, hawk_val_t* left, hawk_va
 		hawk_int_t ll, v1;
 		hawk_flt_t rr;
 
-		n = hawk_oochars_to_num(
-			HAWK_OOCHARS_TO_NUM_MAKE_OPTION(1, 0, HAWK_RTX_IS_STRIPSTRSPC_ON(rtx), 0),
-			((hawk_val_str_t*)right)->val.ptr,
-			((hawk_val_str_t*)right)->val.len,
-			&ll, &rr
-		);
+		n = hawk_rtx_strvaltonum(rtx, (hawk_val_str_t*)right, &ll, &rr);
 
 		v1 = HAWK_RTX_GETINTFROMVAL(rtx, left);
 		if (n == 0)
@@ -6433,8 +6859,15 @@ static HAWK_INLINE int __cmp_flt_str (hawk_rtx_t* rtx, hawk_val_t* left, hawk_va
 	if ((hawk->opt.trait & HAWK_NCMPONSTR) || right->v_nstr /*> 0*/)
 	{
 		const hawk_ooch_t* end;
+		hawk_int_t ll;
 		hawk_flt_t rr;
 
+		if (hawk_rtx_strvaltonum(rtx, (hawk_val_str_t*)right, &ll, &rr) == 1)
+		{
+			return (((hawk_val_flt_t*)left)->val > rr)? 1:
+			       (((hawk_val_flt_t*)left)->val < rr)? -1: 0;
+		}
+
 		rr = hawk_oochars_to_flt(((hawk_val_str_t*)right)->val.ptr, ((hawk_val_str_t*)right)->val.len, &end, HAWK_RTX_IS_STRIPSTRSPC_ON(rtx));
 		if (end == ((hawk_val_str_t*)right)->val.ptr + ((hawk_val_str_t*)right)->val.len)
 		{
@@ -6545,7 +6978,9 @@ static HAWK_INLINE int __cmp_str_flt (hawk_rtx_t* rtx, hawk_val_t* left, hawk_va
 static HAWK_INLINE int __cmp_str_str (hawk_rtx_t* rtx, hawk_val_t* left, hawk_val_t* right, cmp_op_t op_hint)
 {
 	hawk_val_str_t* ls, * rs;
-	int stripspc;
+	hawk_int_t ll, rl;
+	hawk_flt_t lr, rr;
+	int lt, rt;
 
 	ls = (hawk_val_str_t*)left;
 	rs = (hawk_val_str_t*)right;
@@ -6556,62 +6991,39 @@ static HAWK_INLINE int __cmp_str_str (hawk_rtx_t* rtx, hawk_val_t* left, hawk_va
 		return hawk_comp_oochars(ls->val.ptr, ls->val.len, rs->val.ptr, rs->val.len, rtx->gbl.ignorecase);
 	}
 
-	stripspc = HAWK_RTX_IS_STRIPSTRSPC_ON(rtx);
-
-	if (ls->v_nstr == 1)
+	/* both are numeric strings */
+	lt = hawk_rtx_strvaltonum(rtx, ls, &ll, &lr);
+	rt = hawk_rtx_strvaltonum(rtx, rs, &rl, &rr);
+	if (HAWK_UNLIKELY(lt <= -1 || rt <= -1))
 	{
-		hawk_int_t ll;
-
-		ll = hawk_oochars_to_int(ls->val.ptr, ls->val.len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(stripspc, stripspc, 0), HAWK_NULL, HAWK_NULL);
+		/* the space stripping option has changed since the values were made */
+		return hawk_comp_oochars(ls->val.ptr, ls->val.len, rs->val.ptr, rs->val.len, rtx->gbl.ignorecase);
+	}
 
-		if (rs->v_nstr == 1)
+	if (lt == 0)
+	{
+		if (rt == 0)
 		{
-			hawk_int_t rr;
-
-			rr = hawk_oochars_to_int(rs->val.ptr, rs->val.len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(stripspc, stripspc, 0), HAWK_NULL, HAWK_NULL);
-
-			return (ll > rr)? 1:
-			       (ll < rr)? -1: 0;
+			return (ll > rl)? 1:
+			       (ll < rl)? -1: 0;
 		}
 		else
 		{
-			hawk_flt_t rr;
-
-			HAWK_ASSERT(rs->v_nstr == 2);
-
-			rr = hawk_oochars_to_flt(rs->val.ptr, rs->val.len, HAWK_NULL, stripspc);
-
 			return (ll > rr)? 1:
 			       (ll < rr)? -1: 0;
 		}
 	}
 	else
 	{
-		hawk_flt_t ll;
-
-		HAWK_ASSERT(ls->v_nstr == 2);
-
-		ll = hawk_oochars_to_flt(ls->val.ptr, ls->val.len, HAWK_NULL, stripspc);
-
-		if (rs->v_nstr == 1)
+		if (rt == 0)
 		{
-			hawk_int_t rr;
-
-			rr = hawk_oochars_to_int(rs->val.ptr, rs->val.len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(stripspc, stripspc, 0), HAWK_NULL, HAWK_NULL);
-
-			return (ll > rr)? 1:
-			       (ll < rr)? -1: 0;
+			return (lr > rl)? 1:
+			       (lr < rl)? -1: 0;
 		}
 		else
 		{
-			hawk_flt_t rr;
-
-			HAWK_ASSERT(rs->v_nstr == 2);
-
-			rr = hawk_oochars_to_flt(rs->val.ptr, rs->val.len, HAWK_NULL, stripspc);
-
-			return (ll > rr)? 1:
-			       (ll < rr)? -1: 0;
+			return (lr > rr)? 1:
+			       (lr < rr)? -1: 0;
 		}
 	}
 }
@@ -8323,6 +8735,7 @@ hawk_val_t* hawk_rtx_evalcall (
 			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, call->nargs);
 		return HAWK_NULL;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, stack_req) <= -1)) return HAWK_NULL;
 
 	HAWK_RTX_STACK_PUSH(rtx, (void*)rtx->stack_base);
 	HAWK_RTX_STACK_PUSH(rtx, (void*)saved_stack_top);
@@ -8359,8 +8772,27 @@ hawk_val_t* hawk_rtx_evalcall (
 	if (fun)
 	{
 		/* normal hawk function */
-		HAWK_ASSERT(fun->body->type == HAWK_NDE_BLK);
-		n = run_block(rtx, (hawk_nde_blk_t*)fun->body);
+		while (1)
+		{
+			HAWK_ASSERT(fun->body->type == HAWK_NDE_BLK);
+			if (HAWK_UNLIKELY(rtx->prof_on))
+			{
+				hawk_rtx_enterprof (rtx, HAWK_RTX_PROF_FUN, fun, &fun->body->loc, 1);
+				n = run_block(rtx, (hawk_nde_blk_t*)fun->body);
+				hawk_rtx_leaveprof (rtx, HAWK_RTX_PROF_FUN);
+			}
+			else n = run_block(rtx, (hawk_nde_blk_t*)fun->body);
+
+			/* run the function called in the return statement in this frame */
+			if (HAWK_LIKELY(!rtx->tail.fun)) break;
+			if (n <= -1 || rtx->exit_level != EXIT_FUNCTION)
+			{
+				drop_tail_call(rtx);
+				break;
+			}
+			n = enter_tail_call(rtx, &fun);
+			if (n <= -1) break;
+		}
 	}
 	else
 	{
@@ -8398,7 +8830,7 @@ hawk_val_t* hawk_rtx_evalcall (
 		if (call->args)
 		{
 			hawk_oow_t cur_stack_base = rtx->stack_base;
-			hawk_oow_t prev_stack_base = (hawk_oow_t)rtx->stack[rtx->stack_base + 0];
+			hawk_oow_t prev_stack_base = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 0);
 			hawk_nde_t* p = call->args;
 
 			if (fun->hasrefarg) /* just for optimization */
@@ -8497,7 +8929,7 @@ hawk_val_t* hawk_rtx_evalcall (
 						else
 						{
 							/* original arguments are in another stack frame */
-							v = rtx->stack[call->arg_base + i]; /* UGLY */
+							v = HAWK_RTX_STACK_SLOT(rtx, call->arg_base + i); /* UGLY */
 							if (HAWK_RTX_GETVALTYPE(rtx, v) == HAWK_VAL_REF)
 							{
 								if (HAWK_UNLIKELY(hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)v, av) <= -1))
@@ -8577,8 +9009,8 @@ hawk_val_t* hawk_rtx_evalcall (
 		hawk_rtx_refdownval_nofree_inline(rtx, v);
 	}
 
-	rtx->stack_top =  (hawk_oow_t)rtx->stack[rtx->stack_base + 1];
-	rtx->stack_base = (hawk_oow_t)rtx->stack[rtx->stack_base + 0];
+	rtx->stack_top =  (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 1);
+	rtx->stack_base = (hawk_oow_t)HAWK_RTX_STACK_SLOT(rtx, rtx->stack_base + 0);
 
 	if (rtx->exit_level == EXIT_FUNCTION) rtx->exit_level = EXIT_NONE;
 
@@ -8592,7 +9024,7 @@ oops_making_stack_frame:
 	{
 		/* call hawk_rtx_refdownval_inline() for all arguments.
 		 * it is safe because nil or quickint is immune to excessive hawk_rtx_refdownval_inline() calls */
-		hawk_rtx_refdownval_inline(rtx, rtx->stack[rtx->stack_top - 1]);
+		hawk_rtx_refdownval_inline(rtx, HAWK_RTX_STACK_SLOT(rtx, rtx->stack_top - 1));
 		HAWK_RTX_STACK_POP(rtx);
 	}
 	HAWK_ASSERT(rtx->stack_top - saved_stack_top == 4);
@@ -8621,6 +9053,7 @@ static hawk_oow_t push_arg_from_vals (hawk_rtx_t* rtx, const hawk_loc_t* call_lo
 			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, pafv->nargs);
 		return (hawk_oow_t)-1;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, pafv->nargs) <= -1)) return (hawk_oow_t)-1;
 
 	for (nargs = 0; nargs < pafv->nargs; nargs++)
 	{
@@ -8665,6 +9098,7 @@ static hawk_oow_t push_arg_from_nde (hawk_rtx_t* rtx, const hawk_loc_t* call_loc
 			HAWK_RTX_STACK_AVAIL(rtx), rtx->stack_limit, pafn->nargs);
 		return (hawk_oow_t)-1;
 	}
+	if (HAWK_UNLIKELY(HAWK_RTX_STACK_RESERVE(rtx, pafn->nargs) <= -1)) return (hawk_oow_t)-1;
 
 	/* in practice, this function gets NULL for a user-defined function regardless of its actual spec.
 	 * it may get a non-NULL arg_spec for builtin/module functions */
@@ -8822,6 +9256,7 @@ static hawk_val_t** get_reference_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 			len = HAWK_COUNTOF(idxbuf);
 			str = idxnde_to_str(rtx, var->idx, idxbuf, &len, &remidx, HAWK_NULL);
 			if (HAWK_UNLIKELY(!str)) goto oops;
+			if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, v) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 			map = ((hawk_val_map_t*)v)->map;
 			break;
 
@@ -8862,6 +9297,7 @@ static hawk_val_t** get_reference_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 				len = HAWK_COUNTOF(idxbuf);
 				str = idxnde_to_str(rtx, remidx, idxbuf, &len, &remidx, HAWK_NULL);
 				if (HAWK_UNLIKELY(!str)) goto oops;
+				if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, v) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 				map = ((hawk_val_map_t*)v)->map;
 				break;
 
@@ -9224,6 +9660,46 @@ static hawk_val_t* eval_arg (hawk_rtx_t* rtx, hawk_nde_t* nde)
 	return HAWK_RTX_STACK_ARG(rtx, ((hawk_nde_var_t*)nde)->id.idxa);
 }
 
+static hawk_val_t* search_map_by_const_key (hawk_rtx_t* rtx, hawk_map_t* map, hawk_nde_str_t* key)
+{
+	hawk_rtx_imc_t* ic;
+	hawk_map_pair_t* pair;
+	hawk_oow_t serial;
+
+	if (HAWK_UNLIKELY(!rtx->imc.slot))
+	{
+		rtx->imc.slot = hawk_rtx_callocmem(rtx, HAWK_RTX_IMC_SIZE * HAWK_SIZEOF(*rtx->imc.slot));
+		if (HAWK_UNLIKELY(!rtx->imc.slot))
+		{
+			/* not fatal. search without the cache */
+			pair = hawk_map_search(map, key->ptr, key->len);
+			return pair? (hawk_val_t*)HAWK_MAP_VPTR(pair): hawk_val_nil;
+		}
+	}
+
+	/* the pair found is valid until the map changes its revision
+	 * by insertion or deletion. the serial number of the owning map
+	 * value protects the cached entry from another map allocated at
+	 * the address of a freed map */
+	serial = HAWK_MAPVAL_SERIAL(HAWK_MAPVAL_TABOWNER(map));
+	ic = &rtx->imc.slot[((hawk_oow_t)key / HAWK_SIZEOF(*key)) & (HAWK_RTX_IMC_SIZE - 1)];
+	if (ic->nde == (hawk_nde_t*)key && ic->map == map && ic->rev == HAWK_MAP_REV(map) && ic->serial == serial)
+	{
+		pair = ic->pair;
+	}
+	else
+	{
+		pair = hawk_map_search(map, key->ptr, key->len);
+		ic->nde = (hawk_nde_t*)key;
+		ic->map = map;
+		ic->rev = HAWK_MAP_REV(map);
+		ic->serial = serial;
+		ic->pair = pair;
+	}
+
+	return pair? (hawk_val_t*)HAWK_MAP_VPTR(pair): hawk_val_nil;
+}
+
 static hawk_val_t* eval_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 {
 	hawk_map_t* map; /* containing map */
@@ -9254,6 +9730,12 @@ static hawk_val_t* eval_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 
 		case HAWK_VAL_MAP:
 		init_val_map:
+			if (var->idx->type == HAWK_NDE_STR && !var->idx->next)
+			{
+				/* a single string literal like cfg["timeout"] */
+				return search_map_by_const_key(rtx, ((hawk_val_map_t*)v)->map, (hawk_nde_str_t*)var->idx);
+			}
+
 			len = HAWK_COUNTOF(idxbuf);
 			str = idxnde_to_str(rtx, var->idx, idxbuf, &len, &remidx, HAWK_NULL);
 			if (HAWK_UNLIKELY(!str)) goto oops;
@@ -9275,6 +9757,7 @@ static hawk_val_t* eval_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 	while (remidx)
 	{
 		hawk_val_type_t container_vtype;
+		hawk_val_t* container = v;
 
 		if (vtype == HAWK_VAL_MAP)
 		{
@@ -9312,6 +9795,9 @@ static hawk_val_t* eval_indexed (hawk_rtx_t* rtx, hawk_nde_var_t* var)
 				{
 					if (container_vtype == HAWK_VAL_MAP)
 					{
+						/* reading a clone mustn't change the table shared with the source */
+						if (HAWK_UNLIKELY(HAWK_RTX_UNSHAREMAPVAL(rtx, container) <= -1)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
+						map = ((hawk_val_map_t*)container)->map;
 						v = assign_newmapval_in_map(rtx, map, str, len);
 						if (HAWK_UNLIKELY(!v)) { ADJERR_LOC(rtx, &var->loc); goto oops; }
 						vtype = HAWK_VAL_MAP;
@@ -9462,6 +9948,7 @@ read_console_again:
 		if (p->in_type == HAWK_IN_CONSOLE)
 		{
 			HAWK_ASSERT(p->in == HAWK_NULL);
+			if (rtx->gbl.jsonl && !p->var && is_blank_record(buf)) goto read_console_again;
 			if (rtx->nrflt.limit > 0)
 			{
 				/* record filter based on record number(NR) */
@@ -9477,6 +9964,12 @@ read_console_again:
 
 		if (!p->var)
 		{
+			if (p->in_type == HAWK_IN_CONSOLE && rtx->gbl.jsonl && update_jsonrec(rtx, HAWK_OOECS_OOCS(buf)) <= -1)
+			{
+				ADJERR_LOC(rtx, &nde->loc);
+				goto oops;
+			}
+
 			/* set $0 with the input value */
 			x = hawk_rtx_setrec(rtx, 0, HAWK_OOECS_OOCS(buf), 1);
 			if (x <= -1) goto oops;
@@ -9693,6 +10186,9 @@ read_again:
 		return 0;
 	}
 
+	/* a blank line is not counted as a record in the JSON Lines input */
+	if (rtx->gbl.jsonl && is_blank_record(buf)) goto read_again;
+
 	if (rtx->nrflt.limit > 0)
 	{
 		if (((rtx->gbl.nr / rtx->nrflt.limit) % rtx->nrflt.size) != rtx->nrflt.rank)
@@ -9702,12 +10198,115 @@ read_again:
 		}
 	}
 
+	if (rtx->gbl.jsonl && update_jsonrec(rtx, HAWK_OOECS_OOCS(buf)) <= -1) return -1;
+
 	if (hawk_rtx_setrec(rtx, 0, HAWK_OOECS_OOCS(buf), 1) <= -1 ||
 	    update_fnr(rtx, rtx->gbl.fnr + 1, rtx->gbl.nr + 1) <= -1) return -1;
 
 	return 1;
 }
 
+static hawk_ooch_t* multidim_idxnde_to_str (hawk_rtx_t* rtx, hawk_nde_t* nde, hawk_ooch_t* buf, hawk_oow_t* len, hawk_nde_t** remidx, hawk_int_t* firstidxint)
+{
+	/* join the indices with SUBSEP in the fixed-size buffer if given.
+	 * switch to a dynamic string when the buffer gets full. a typical
+	 * key like [i,j] fits in the buffer and needs no allocation */
+	hawk_ooecs_t idxstr;
+	hawk_oocs_t tmp;
+	hawk_rtx_valtostr_out_t out;
+	hawk_nde_t* xnde;
+	hawk_val_t* idx;
+	hawk_oow_t blen = 0, seplen;
+	int dyn = 0;
+
+	if (!buf)
+	{
+		if (hawk_ooecs_init(&idxstr, hawk_rtx_getgem(rtx), DEF_BUF_CAPA) <= -1)
+		{
+			ADJERR_LOC(rtx, &nde->loc);
+			return HAWK_NULL;
+		}
+		dyn = 1;
+	}
+
+	xnde = nde;
+#if defined(HAWK_ENABLE_GC)
+	while (nde && nde->type != HAWK_NDE_NULL)
+#else
+	while (nde)
+#endif
+	{
+		idx = eval_expression(rtx, nde);
+		if (HAWK_UNLIKELY(!idx))
+		{
+			if (dyn) hawk_ooecs_fini(&idxstr);
+			return HAWK_NULL;
+		}
+
+		hawk_rtx_refupval_inline(rtx, idx);
+
+		if (firstidxint && xnde == nde)
+		{
+			if (hawk_rtx_valtoint_inline(rtx, idx, firstidxint) <= -1) goto oops;
+		}
+
+		seplen = (xnde == nde)? 0: rtx->gbl.subsep.len;
+
+		if (!dyn)
+		{
+			if (blen + seplen < *len)
+			{
+				out.type = HAWK_RTX_VALTOSTR_CPLCPY;
+				out.u.cplcpy.ptr = &buf[blen + seplen];
+				out.u.cplcpy.len = *len - blen - seplen;
+				if (hawk_rtx_valtostr(rtx, idx, &out) >= 0)
+				{
+					if (seplen > 0) hawk_copy_oochars(&buf[blen], rtx->gbl.subsep.ptr, seplen);
+					blen += seplen + out.u.cplcpy.len;
+
+					hawk_rtx_refdownval_inline(rtx, idx);
+					nde = nde->next;
+					continue;
+				}
+			}
+
+			/* carry on with what has been built in a dynamic string */
+			if (hawk_ooecs_init(&idxstr, hawk_rtx_getgem(rtx), DEF_BUF_CAPA) <= -1) goto oops;
+			dyn = 1;
+			if (hawk_ooecs_ncat(&idxstr, buf, blen) == (hawk_oow_t)-1) goto oops;
+		}
+
+		if (seplen > 0 && hawk_ooecs_ncat(&idxstr, rtx->gbl.subsep.ptr, seplen) == (hawk_oow_t)-1) goto oops;
+
+		out.type = HAWK_RTX_VALTOSTR_STRPCAT;
+		out.u.strpcat = &idxstr;
+		if (hawk_rtx_valtostr(rtx, idx, &out) <= -1) goto oops;
+
+		hawk_rtx_refdownval_inline(rtx, idx);
+		nde = nde->next;
+	}
+
+	/* if nde is not HAWK_NULL, it should be of the HAWK_NDE_NULL type */
+	*remidx = nde? nde->next: nde;
+
+	if (!dyn)
+	{
+		*len = blen;
+		return buf;
+	}
+
+	hawk_ooecs_yield(&idxstr, &tmp, 0);
+	hawk_ooecs_fini(&idxstr);
+	*len = tmp.len;
+	return tmp.ptr;
+
+oops:
+	hawk_rtx_refdownval_inline(rtx, idx);
+	if (dyn) hawk_ooecs_fini(&idxstr);
+	ADJERR_LOC(rtx, &nde->loc);
+	return HAWK_NULL;
+}
+
 static hawk_ooch_t* idxnde_to_str (hawk_rtx_t* rtx, hawk_nde_t* nde, hawk_ooch_t* buf, hawk_oow_t* len, hawk_nde_t** remidx, hawk_int_t* firstidxint)
 {
 	hawk_ooch_t* str;
@@ -9775,78 +10374,8 @@ static hawk_ooch_t* idxnde_to_str (hawk_rtx_t* rtx, hawk_nde_t* nde, hawk_ooch_t
 	else
 	{
 		/* multidimensional index - e.g. [1,2,3] */
-		hawk_ooecs_t idxstr;
-		hawk_oocs_t tmp;
-		hawk_rtx_valtostr_out_t out;
-		hawk_nde_t* xnde;
-		int first = 1;
-
-		out.type = HAWK_RTX_VALTOSTR_STRPCAT;
-		out.u.strpcat = &idxstr;
-
-		if (hawk_ooecs_init(&idxstr, hawk_rtx_getgem(rtx), DEF_BUF_CAPA) <= -1)
-		{
-			ADJERR_LOC(rtx, &nde->loc);
-			return HAWK_NULL;
-		}
-
-		xnde = nde;
-#if defined(HAWK_ENABLE_GC)
-		while (nde && nde->type != HAWK_NDE_NULL)
-#else
-		while (nde)
-#endif
-		{
-			idx = eval_expression(rtx, nde);
-			if (HAWK_UNLIKELY(!idx))
-			{
-				hawk_ooecs_fini(&idxstr);
-				return HAWK_NULL;
-			}
-
-			hawk_rtx_refupval_inline(rtx, idx);
-
-			if (firstidxint && first)
-			{
-				if (hawk_rtx_valtoint_inline(rtx, idx, &idxint) <= -1)
-				{
-					hawk_rtx_refdownval_inline(rtx, idx);
-					hawk_ooecs_fini(&idxstr);
-					ADJERR_LOC(rtx, &nde->loc);
-					return HAWK_NULL;
-				}
-
-				first = 0;
-			}
-
-			if (xnde != nde && hawk_ooecs_ncat(&idxstr, rtx->gbl.subsep.ptr, rtx->gbl.subsep.len) == (hawk_oow_t)-1)
-			{
-				hawk_rtx_refdownval_inline(rtx, idx);
-				hawk_ooecs_fini(&idxstr);
-				ADJERR_LOC(rtx, &nde->loc);
-				return HAWK_NULL;
-			}
-
-			if (hawk_rtx_valtostr(rtx, idx, &out) <= -1)
-			{
-				hawk_rtx_refdownval_inline(rtx, idx);
-				hawk_ooecs_fini(&idxstr);
-				ADJERR_LOC(rtx, &nde->loc);
-				return HAWK_NULL;
-			}
-
-			hawk_rtx_refdownval_inline(rtx, idx);
-			nde = nde->next;
-		}
-
-		hawk_ooecs_yield(&idxstr, &tmp, 0);
-		str = tmp.ptr;
-		*len = tmp.len;
-
-		hawk_ooecs_fini(&idxstr);
-
-		/* if nde is not HAWK_NULL, it should be of the HAWK_NDE_NULL type */
-		*remidx = nde? nde->next: nde;
+		str = multidim_idxnde_to_str(rtx, nde, buf, len, remidx, (firstidxint? &idxint: HAWK_NULL));
+		if (HAWK_UNLIKELY(!str)) return HAWK_NULL;
 	}
 
 	if (firstidxint) *firstidxint = idxint;
@@ -1917,6 +1917,87 @@ int hawk_parsestd (hawk_t* hawk, hawk_parsestd_t in[], hawk_parsestd_t* out)
 	return n;
 }
 
+static int hash_source_file (hawk_t* hawk, const hawk_ooch_t* path, hawk_cmgr_t* cmgr, hawk_oow_t* hash)
+{
+	hawk_sio_t* sio;
+	hawk_ooch_t buf[1024];
+	hawk_ooi_t n;
+	hawk_oow_t hv = HAWK_HASH_INIT;
+
+	/* read the file the same way as sf_in() does for the parser */
+	sio = open_sio(hawk, path, HAWK_SIO_READ | HAWK_SIO_IGNOREECERR);
+	if (!sio) return -1;
+	if (cmgr) hawk_sio_setcmgr(sio, cmgr);
+
+	while ((n = hawk_sio_getoochars(sio, buf, HAWK_COUNTOF(buf))) > 0)
+	{
+		HAWK_HASH_MORE_VPTL(hv, buf, n, hawk_ooch_t);
+	}
+	hawk_sio_close(sio);
+	if (n <= -1) return -1;
+
+	*hash = hv;
+	return 0;
+}
+
+int hawk_loadtreestd (hawk_t* hawk, const void* ptr, hawk_oow_t len, hawk_cmgr_t* cmgr)
+{
+	hawk_tree_src_t* src;
+	hawk_parsestd_t* psin;
+	hawk_oow_t hv, ntops, i;
+	int n;
+
+	if (hawk_loadtree(hawk, ptr, len) <= -1) return -1;
+
+	ntops = 0;
+	for (src = hawk->tree.srcs; src; src = src->next)
+	{
+		if (src->top) ntops++;
+		/* a string, the standard input and a file that can't be read are
+		 * not checked. the saved program runs without the source files */
+		if (!src->path || hash_source_file(hawk, src->path, (src->top? cmgr: HAWK_NULL), &hv) <= -1) continue;
+		if (hv != src->hash) goto stale;
+	}
+
+	return 0;
+
+stale:
+	/* parse the top-level sources again. the paths are copied as
+	 * hawk_parse() clears the source names held in the tree */
+	psin = (hawk_parsestd_t*)hawk_callocmem(hawk, HAWK_SIZEOF(*psin) * (ntops + 1));
+	if (HAWK_UNLIKELY(!psin)) return -1;
+
+	for (i = 0, src = hawk->tree.srcs; src; src = src->next)
+	{
+		if (!src->top) continue;
+		if (!src->path)
+		{
+			hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "unable to parse changed sources - source not a file");
+			n = -1;
+			goto done;
+		}
+
+		psin[i].u.file.path = hawk_dupoocstr(hawk, src->path, HAWK_NULL);
+		if (HAWK_UNLIKELY(!psin[i].u.file.path))
+		{
+			n = -1;
+			goto done;
+		}
+		psin[i].u.file.cmgr = cmgr;
+		psin[i].type = HAWK_PARSESTD_FILE;
+		i++;
+	}
+	psin[i].type = HAWK_PARSESTD_NULL;
+
+	n = hawk_parsestd(hawk, psin, HAWK_NULL);
+	if (n >= 0) n = 1;
+
+done:
+	for (i = 0; i < ntops && psin[i].type == HAWK_PARSESTD_FILE; i++) hawk_freemem(hawk, (hawk_ooch_t*)psin[i].u.file.path);
+	hawk_freemem(hawk, psin);
+	return n;
+}
+
 static int check_var_assign (hawk_rtx_t* rtx, const hawk_ooch_t* str)
 {
 	hawk_ooch_t* eq, * dstr;
@@ -2155,6 +2236,15 @@ static hawk_ooi_t pio_handler_open (hawk_rtx_t* rtx, hawk_rio_arg_t* riod)
 	return 1;
 }
 
+static int wait_on_pio_out (hawk_rtx_t* rtx, hawk_pio_t* pio)
+{
+	/* let other coroutines run until the child produces something.
+	 * no wait is needed if the buffer still holds unread data */
+	hawk_tio_t* tio = pio->pin[HAWK_PIO_OUT].tio;
+	if (tio && tio->inbuf_cur < tio->inbuf_len) return 0;
+	return hawk_rtx_waitio(rtx, (hawk_intptr_t)HAWK_PIO_HANDLE(pio, HAWK_PIO_OUT), HAWK_RTX_WAITIO_IN, HAWK_NULL);
+}
+
 static hawk_ooi_t pio_handler_rest (hawk_rtx_t* rtx, hawk_rio_cmd_t cmd, hawk_rio_arg_t* riod, void* data, hawk_oow_t size)
 {
 	switch (cmd)
@@ -2188,9 +2278,11 @@ static hawk_ooi_t pio_handler_rest (hawk_rtx_t* rtx, hawk_rio_cmd_t cmd, hawk_ri
 		}
 
 		case HAWK_RIO_CMD_READ:
+			if (wait_on_pio_out(rtx, (hawk_pio_t*)riod->handle) <= -1) return -1;
 			return hawk_pio_read((hawk_pio_t*)riod->handle, HAWK_PIO_OUT, data, size);
 
 		case HAWK_RIO_CMD_READ_BYTES:
+			if (wait_on_pio_out(rtx, (hawk_pio_t*)riod->handle) <= -1) return -1;
 			return hawk_pio_readbytes((hawk_pio_t*)riod->handle, HAWK_PIO_OUT, data, size);
 
 		case HAWK_RIO_CMD_WRITE:
@@ -353,6 +353,7 @@ struct hawk_nde_forin_t
 	HAWK_NDE_HDR;
 	hawk_nde_t* test;
 	hawk_nde_t* body;
+	int sorted; /* for @sorted (k in a) */
 };
 
 /* HAWK_NDE_BREAK */
@@ -372,6 +373,7 @@ struct hawk_nde_return_t
 {
 	HAWK_NDE_HDR;
 	hawk_nde_t* val; /* optional (no return code if HAWK_NULL) */
+	int tail; /* val is a user function call that can reuse the current frame */
 };
 
 /* HAWK_NDE_EXIT */
@@ -1167,6 +1167,12 @@ static int print_stmt (hawk_t* hawk, hawk_nde_t* p, int depth, int flags)
 			hawk_getkwname(hawk, HAWK_KWID_FOR, &kw);
 			PUT_SRCSTRN(hawk, kw.ptr, kw.len);
 			PUT_SRCSTR(hawk, HAWK_T(" "));
+			if (px->sorted)
+			{
+				hawk_getkwname(hawk, HAWK_KWID_XSORTED, &kw);
+				PUT_SRCSTRN(hawk, kw.ptr, kw.len);
+				PUT_SRCSTR(hawk, HAWK_T(" "));
+			}
 			PRINT_EXPR(hawk, px->test);
 
 			xflags = STMT_FLAG_NO_LEAD_INDENT | STMT_FLAG_NO_ENDING_NL;
@@ -1689,3 +1695,1395 @@ void hawk_clrpt (hawk_t* hawk, hawk_nde_t* tree)
 		p = next;
 	}
 }
+
+/* ------------------------------------------------------------------------ */
+/* binary form of the parse tree.
+ *
+ * hawk_savetree() writes the tree as produced by hawk_parse() and
+ * hawk_loadtree() rebuilds it without going through the parser again.
+ * the data is tied to the build that writes it. the sizes of the basic
+ * types and the byte order are recorded in the header and must match
+ * when it's loaded. the pointers held in the tree are not written out.
+ * the regular expressions are compiled again and the intrinsic and module
+ * functions are looked up by name on loading. the source streams read
+ * are listed with the path and the hash of the text for the caller to
+ * check if the tree is older than the sources. */
+
+#define TREE_VERSION 3
+
+static hawk_uint8_t tree_magic[] = { 0x7F, 'H', 'A', 'W', 'K', 'T', 'R', TREE_VERSION };
+
+static hawk_uint8_t tree_shape[] =
+{
+	HAWK_SIZEOF(hawk_ooch_t),
+	HAWK_SIZEOF(hawk_oow_t),
+	HAWK_SIZEOF(hawk_int_t),
+	HAWK_SIZEOF(hawk_flt_t),
+	HAWK_MAX_GBL_ID,
+	HAWK_NDE_PRINTF
+};
+
+typedef struct tsave_t tsave_t;
+struct tsave_t
+{
+	hawk_t* hawk;
+
+	hawk_uint8_t* ptr;
+	hawk_oow_t len;
+	hawk_oow_t capa;
+
+	/* source file names in the order of appearance */
+	const hawk_ooch_t** files;
+	hawk_oow_t nfiles;
+	hawk_oow_t files_capa;
+};
+
+typedef struct tload_t tload_t;
+struct tload_t
+{
+	hawk_t* hawk;
+
+	const hawk_uint8_t* ptr;
+	const hawk_uint8_t* end;
+
+	hawk_ooch_t** files;
+	hawk_oow_t nfiles;
+	hawk_oow_t files_capa;
+};
+
+static int save_ndes (tsave_t* ts, hawk_nde_t* nde);
+static int load_ndes (tload_t* tl, hawk_nde_t** head);
+
+static int save_bytes (tsave_t* ts, const void* ptr, hawk_oow_t len)
+{
+	if (len > ts->capa - ts->len)
+	{
+		hawk_uint8_t* tmp;
+		hawk_oow_t newcapa;
+
+		newcapa = HAWK_ALIGN_POW2(ts->len + len, 4096);
+		tmp = (hawk_uint8_t*)hawk_reallocmem(ts->hawk, ts->ptr, newcapa);
+		if (HAWK_UNLIKELY(!tmp)) return -1;
+
+		ts->ptr = tmp;
+		ts->capa = newcapa;
+	}
+
+	HAWK_MEMCPY(&ts->ptr[ts->len], ptr, len);
+	ts->len += len;
+	return 0;
+}
+
+static HAWK_INLINE int save_oow (tsave_t* ts, hawk_oow_t v)
+{
+	return save_bytes(ts, &v, HAWK_SIZEOF(v));
+}
+
+static int save_oochars (tsave_t* ts, const hawk_ooch_t* ptr, hawk_oow_t len)
+{
+	/* (hawk_oow_t)-1 for the length tells a null pointer from an empty string */
+	if (!ptr) return save_oow(ts, (hawk_oow_t)-1);
+	if (save_oow(ts, len) <= -1) return -1;
+	return save_bytes(ts, ptr, len * HAWK_SIZEOF(*ptr));
+}
+
+static int save_bchars (tsave_t* ts, const hawk_bch_t* ptr, hawk_oow_t len)
+{
+	if (!ptr) return save_oow(ts, (hawk_oow_t)-1);
+	if (save_oow(ts, len) <= -1) return -1;
+	return save_bytes(ts, ptr, len * HAWK_SIZEOF(*ptr));
+}
+
+static int save_loc (tsave_t* ts, const hawk_loc_t* loc)
+{
+	hawk_oow_t i;
+
+	if (save_oow(ts, loc->line) <= -1 || save_oow(ts, loc->colm) <= -1) return -1;
+	if (!loc->file) return save_oow(ts, 0);
+
+	/* a file name is written in full where it appears first.
+	 * the later occurrences refer to it by its 1-based index */
+	for (i = 0; i < ts->nfiles; i++)
+	{
+		if (ts->files[i] == loc->file) return save_oow(ts, i + 1);
+	}
+
+	if (ts->nfiles >= ts->files_capa)
+	{
+		const hawk_ooch_t** tmp;
+		hawk_oow_t newcapa;
+
+		newcapa = ts->files_capa + 16;
+		tmp = (const hawk_ooch_t**)hawk_reallocmem(ts->hawk, ts->files, newcapa * HAWK_SIZEOF(*tmp));
+		if (HAWK_UNLIKELY(!tmp)) return -1;
+
+		ts->files = tmp;
+		ts->files_capa = newcapa;
+	}
+
+	ts->files[ts->nfiles++] = loc->file;
+	if (save_oow(ts, ts->nfiles) <= -1) return -1;
+	return save_oochars(ts, loc->file, hawk_count_oocstr(loc->file));
+}
+
+static int save_fun (tsave_t* ts, hawk_fun_t* fun)
+{
+	if (save_oow(ts, fun->nargs) <= -1 ||
+	    save_oochars(ts, fun->argspec, fun->argspeclen) <= -1 ||
+	    save_oow(ts, fun->variadic) <= -1 ||
+	    save_oow(ts, fun->hasrefarg) <= -1) return -1;
+	return save_ndes(ts, fun->body);
+}
+
+struct find_modname_t
+{
+	hawk_mod_t* mod;
+	hawk_oocs_t name;
+};
+
+static hawk_rbt_walk_t find_modname (hawk_rbt_t* rbt, hawk_rbt_pair_t* pair, void* ctx)
+{
+	struct find_modname_t* fm = (struct find_modname_t*)ctx;
+	hawk_mod_data_t* md = (hawk_mod_data_t*)HAWK_RBT_VPTR(pair);
+
+	if (&md->mod == fm->mod)
+	{
+		fm->name.ptr = (hawk_ooch_t*)HAWK_RBT_KPTR(pair);
+		fm->name.len = HAWK_RBT_KLEN(pair);
+		return HAWK_RBT_WALK_STOP;
+	}
+	return HAWK_RBT_WALK_FORWARD;
+}
+
+static int save_fnc (tsave_t* ts, hawk_nde_fncall_t* call)
+{
+	struct find_modname_t fm;
+
+	/* the function spec is not written. it is found again by name on loading.
+	 * a module function is recorded with the name of the module as the call
+	 * name may not carry it. e.g. sin() is turned to a call to math::sin */
+	fm.mod = call->u.fnc.info.mod;
+	fm.name.ptr = HAWK_NULL;
+	fm.name.len = 0;
+	if (fm.mod && !(call->u.fnc.flags & HAWK_NDE_FNCALL_FNC_DEFERRED_MODFNC))
+	{
+		hawk_mtx_lock(ts->hawk->modmtx, HAWK_NULL);
+		hawk_rbt_walk(ts->hawk->modtab, find_modname, &fm);
+		hawk_mtx_unlock(ts->hawk->modmtx);
+	}
+
+	if (save_oochars(ts, call->u.fnc.info.name.ptr, call->u.fnc.info.name.len) <= -1 ||
+	    save_oow(ts, call->u.fnc.flags) <= -1) return -1;
+	return save_oochars(ts, fm.name.ptr, fm.name.len);
+}
+
+static int save_nde (tsave_t* ts, hawk_nde_t* p)
+{
+	if (save_oow(ts, p->type) <= -1 || save_loc(ts, &p->loc) <= -1) return -1;
+
+	switch (p->type)
+	{
+		case HAWK_NDE_NULL:
+		case HAWK_NDE_BREAK:
+		case HAWK_NDE_CONTINUE:
+		case HAWK_NDE_NEXT:
+		case HAWK_NDE_XNIL:
+		case HAWK_NDE_XTRUE:
+		case HAWK_NDE_XFALSE:
+		case HAWK_NDE_XARGC:
+		case HAWK_NDE_XARGV:
+			return 0;
+
+		case HAWK_NDE_BLK:
+		{
+			hawk_nde_blk_t* px = (hawk_nde_blk_t*)p;
+			if (save_oow(ts, px->nlcls) <= -1 ||
+			    save_oow(ts, px->org_nlcls) <= -1 ||
+			    save_oow(ts, px->outer_nlcls) <= -1) return -1;
+			return save_ndes(ts, px->body);
+		}
+
+		case HAWK_NDE_IF:
+		{
+			hawk_nde_if_t* px = (hawk_nde_if_t*)p;
+			if (save_ndes(ts, px->test) <= -1 || save_ndes(ts, px->then_part) <= -1) return -1;
+			return save_ndes(ts, px->else_part);
+		}
+
+		case HAWK_NDE_SWITCH:
+		{
+			hawk_nde_switch_t* px = (hawk_nde_switch_t*)p;
+			hawk_nde_t* c;
+			hawk_oow_t i;
+
+			if (save_ndes(ts, px->test) <= -1 || save_ndes(ts, px->case_part) <= -1) return -1;
+
+			/* the default part is one of the case parts. write its position
+			 * in the case chain. 0 if there is no default part */
+			for (i = 1, c = px->case_part; c && c != px->default_part; c = c->next) i++;
+			return save_oow(ts, (c? i: 0));
+		}
+
+		case HAWK_NDE_CASE:
+		{
+			hawk_nde_case_t* px = (hawk_nde_case_t*)p;
+			if (save_ndes(ts, px->val) <= -1) return -1;
+			return save_ndes(ts, px->action);
+		}
+
+		case HAWK_NDE_WHILE:
+		case HAWK_NDE_DOWHILE:
+		{
+			hawk_nde_while_t* px = (hawk_nde_while_t*)p;
+			if (save_ndes(ts, px->test) <= -1) return -1;
+			return save_ndes(ts, px->body);
+		}
+
+		case HAWK_NDE_FOR:
+		{
+			hawk_nde_for_t* px = (hawk_nde_for_t*)p;
+			if (save_ndes(ts, px->init) <= -1 ||
+			    save_ndes(ts, px->test) <= -1 ||
+			    save_ndes(ts, px->incr) <= -1) return -1;
+			return save_ndes(ts, px->body);
+		}
+
+		case HAWK_NDE_FORIN:
+		{
+			hawk_nde_forin_t* px = (hawk_nde_forin_t*)p;
+			if (save_ndes(ts, px->test) <= -1 || save_ndes(ts, px->body) <= -1) return -1;
+			return save_oow(ts, px->sorted);
+		}
+
+		case HAWK_NDE_RETURN:
+		{
+			hawk_nde_return_t* px = (hawk_nde_return_t*)p;
+			if (save_ndes(ts, px->val) <= -1) return -1;
+			return save_oow(ts, px->tail);
+		}
+
+		case HAWK_NDE_EXIT:
+		{
+			hawk_nde_exit_t* px = (hawk_nde_exit_t*)p;
+			if (save_ndes(ts, px->val) <= -1) return -1;
+			return save_oow(ts, px->abort);
+		}
+
+		case HAWK_NDE_NEXTFILE:
+			return save_oow(ts, ((hawk_nde_nextfile_t*)p)->out);
+
+		case HAWK_NDE_DELETE:
+			return save_ndes(ts, ((hawk_nde_delete_t*)p)->var);
+
+		case HAWK_NDE_RESET:
+			return save_ndes(ts, ((hawk_nde_reset_t*)p)->var);
+
+		case HAWK_NDE_PRINT:
+		case HAWK_NDE_PRINTF:
+		{
+			hawk_nde_print_t* px = (hawk_nde_print_t*)p;
+			if (save_ndes(ts, px->args) <= -1 || save_oow(ts, px->out_type) <= -1) return -1;
+			return save_ndes(ts, px->out);
+		}
+
+		case HAWK_NDE_GRP:
+			return save_ndes(ts, ((hawk_nde_grp_t*)p)->body);
+
+		case HAWK_NDE_ASS:
+		{
+			hawk_nde_ass_t* px = (hawk_nde_ass_t*)p;
+			if (save_oow(ts, px->opcode) <= -1 ||
+			    save_ndes(ts, px->left) <= -1 ||
+			    save_ndes(ts, px->right) <= -1) return -1;
+			return save_oow(ts, px->is_init);
+		}
+
+		case HAWK_NDE_EXP_BIN:
+		case HAWK_NDE_EXP_UNR:
+		case HAWK_NDE_EXP_INCPRE:
+		case HAWK_NDE_EXP_INCPST:
+		{
+			hawk_nde_exp_t* px = (hawk_nde_exp_t*)p;
+			if (save_oow(ts, px->opcode) <= -1 || save_ndes(ts, px->left) <= -1) return -1;
+			return save_ndes(ts, px->right);
+		}
+
+		case HAWK_NDE_CND:
+		{
+			hawk_nde_cnd_t* px = (hawk_nde_cnd_t*)p;
+			if (save_ndes(ts, px->test) <= -1 || save_ndes(ts, px->left) <= -1) return -1;
+			return save_ndes(ts, px->right);
+		}
+
+		case HAWK_NDE_FNCALL_FNC:
+		case HAWK_NDE_FNCALL_FUN:
+		case HAWK_NDE_FNCALL_EXPR:
+		{
+			hawk_nde_fncall_t* px = (hawk_nde_fncall_t*)p;
+			int n;
+
+			if (p->type == HAWK_NDE_FNCALL_FNC) n = save_fnc(ts, px);
+			else if (p->type == HAWK_NDE_FNCALL_FUN) n = save_oochars(ts, px->u.fun.name.ptr, px->u.fun.name.len);
+			else n = save_ndes(ts, px->u.expr.callable);
+			if (n <= -1 || save_ndes(ts, px->args) <= -1) return -1;
+			return save_oow(ts, px->nargs);
+		}
+
+		case HAWK_NDE_MODSYM:
+			return save_oochars(ts, ((hawk_nde_modsym_t*)p)->name.ptr, ((hawk_nde_modsym_t*)p)->name.len);
+
+		case HAWK_NDE_CHAR:
+			return save_bytes(ts, &((hawk_nde_char_t*)p)->val, HAWK_SIZEOF(((hawk_nde_char_t*)p)->val));
+
+		case HAWK_NDE_BCHR:
+			return save_bytes(ts, &((hawk_nde_bchr_t*)p)->val, HAWK_SIZEOF(((hawk_nde_bchr_t*)p)->val));
+
+		case HAWK_NDE_INT:
+		{
+			hawk_nde_int_t* px = (hawk_nde_int_t*)p;
+			if (save_bytes(ts, &px->val, HAWK_SIZEOF(px->val)) <= -1) return -1;
+			return save_oochars(ts, px->str, px->len);
+		}
+
+		case HAWK_NDE_FLT:
+		{
+			hawk_nde_flt_t* px = (hawk_nde_flt_t*)p;
+			if (save_bytes(ts, &px->val, HAWK_SIZEOF(px->val)) <= -1) return -1;
+			return save_oochars(ts, px->str, px->len);
+		}
+
+		case HAWK_NDE_STR:
+			return save_oochars(ts, ((hawk_nde_str_t*)p)->ptr, ((hawk_nde_str_t*)p)->len);
+
+		case HAWK_NDE_MBS:
+			return save_bchars(ts, ((hawk_nde_mbs_t*)p)->ptr, ((hawk_nde_mbs_t*)p)->len);
+
+		case HAWK_NDE_REX:
+			return save_oochars(ts, ((hawk_nde_rex_t*)p)->str.ptr, ((hawk_nde_rex_t*)p)->str.len);
+
+		case HAWK_NDE_XARGVIDX:
+			return save_ndes(ts, ((hawk_nde_xargvidx_t*)p)->pos);
+
+		case HAWK_NDE_FUN:
+		{
+			hawk_nde_fun_t* px = (hawk_nde_fun_t*)p;
+			if (save_oochars(ts, px->name.ptr, px->name.len) <= -1) return -1;
+			/* a function literal has no name. its definition goes with the node */
+			return px->name.ptr? 0: save_fun(ts, px->funptr);
+		}
+
+		case HAWK_NDE_NAMED:
+		case HAWK_NDE_GBL:
+		case HAWK_NDE_LCL:
+		case HAWK_NDE_ARG:
+		case HAWK_NDE_NAMEDIDX:
+		case HAWK_NDE_GBLIDX:
+		case HAWK_NDE_LCLIDX:
+		case HAWK_NDE_ARGIDX:
+		{
+			hawk_nde_var_t* px = (hawk_nde_var_t*)p;
+			if (save_oochars(ts, px->id.name.ptr, px->id.name.len) <= -1 ||
+			    save_oow(ts, px->id.idxa) <= -1 ||
+			    save_oow(ts, px->is_const) <= -1) return -1;
+			return save_ndes(ts, px->idx);
+		}
+
+		case HAWK_NDE_POS:
+			return save_ndes(ts, ((hawk_nde_pos_t*)p)->val);
+
+		case HAWK_NDE_GETLINE:
+		{
+			hawk_nde_getline_t* px = (hawk_nde_getline_t*)p;
+			if (save_ndes(ts, px->var) <= -1 ||
+			    save_oow(ts, px->mbs) <= -1 ||
+			    save_oow(ts, px->in_type) <= -1) return -1;
+			return save_ndes(ts, px->in);
+		}
+
+		default:
+			hawk_seterrbfmt(ts->hawk, &p->loc, HAWK_EINTERN, "unable to save node of type %d", (int)p->type);
+			return -1;
+	}
+}
+
+static int save_ndes (tsave_t* ts, hawk_nde_t* nde)
+{
+	hawk_nde_t* p;
+	hawk_oow_t n = 0;
+
+	/* a node chain is written with the number of nodes in front */
+	for (p = nde; p; p = p->next) n++;
+	if (save_oow(ts, n) <= -1) return -1;
+
+	for (p = nde; p; p = p->next)
+	{
+		if (save_nde(ts, p) <= -1) return -1;
+	}
+
+	return 0;
+}
+
+static int save_tree (tsave_t* ts)
+{
+	hawk_t* hawk = ts->hawk;
+	hawk_oow_t i, n;
+	hawk_htb_pair_t* pair;
+	hawk_htb_itr_t itr;
+	hawk_chain_t* chain;
+	hawk_tree_src_t* src;
+	const hawk_ooch_t** named;
+
+	if (save_bytes(ts, tree_magic, HAWK_SIZEOF(tree_magic)) <= -1 ||
+	    save_bytes(ts, tree_shape, HAWK_SIZEOF(tree_shape)) <= -1 ||
+	    save_oow(ts, 1) <= -1) return -1; /* byte order */
+
+	for (n = 0, src = hawk->tree.srcs; src; src = src->next) n++;
+	if (save_oow(ts, n) <= -1) return -1;
+	for (src = hawk->tree.srcs; src; src = src->next)
+	{
+		if (save_oochars(ts, src->path, (src->path? hawk_count_oocstr(src->path): 0)) <= -1 ||
+		    save_oow(ts, src->top) <= -1 ||
+		    save_oow(ts, src->hash) <= -1) return -1;
+	}
+
+	if (save_oow(ts, hawk->parse.pragma.trait) <= -1 ||
+	    save_oow(ts, hawk->parse.pragma.rtx_stack_limit) <= -1 ||
+	    save_oochars(ts, hawk->parse.pragma.entry, hawk_count_oocstr(hawk->parse.pragma.entry)) <= -1) return -1;
+
+	/* the intrinsic globals are fixed. the names of the globals added
+	 * with hawk_addgbl() are written as well as those declared in the
+	 * script for the loader to verify the global slots */
+	if (save_oow(ts, hawk->tree.ngbls_base) <= -1 || save_oow(ts, hawk->tree.ngbls) <= -1) return -1;
+	for (i = HAWK_MAX_GBL_ID + 1; i < hawk->tree.ngbls; i++)
+	{
+		if (save_oochars(ts, HAWK_ARR_DPTR(hawk->parse.gbls, i), HAWK_ARR_DLEN(hawk->parse.gbls, i)) <= -1) return -1;
+	}
+
+	/* named variables in the slot order */
+	n = HAWK_HTB_SIZE(hawk->parse.named);
+	if (save_oow(ts, n) <= -1) return -1;
+	if (n > 0)
+	{
+		named = (const hawk_ooch_t**)hawk_callocmem(hawk, n * HAWK_SIZEOF(*named) * 2);
+		if (HAWK_UNLIKELY(!named)) return -1;
+
+		pair = hawk_htb_getfirstpair(hawk->parse.named, &itr);
+		while (pair)
+		{
+			i = (hawk_oow_t)HAWK_HTB_VPTR(pair);
+			HAWK_ASSERT(i < n);
+			named[i * 2] = (const hawk_ooch_t*)HAWK_HTB_KPTR(pair);
+			named[i * 2 + 1] = (const hawk_ooch_t*)HAWK_HTB_KLEN(pair);
+			pair = hawk_htb_getnextpair(hawk->parse.named, &itr);
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			if (save_oochars(ts, named[i * 2], (hawk_oow_t)named[i * 2 + 1]) <= -1)
+			{
+				hawk_freemem(hawk, named);
+				return -1;
+			}
+		}
+		hawk_freemem(hawk, named);
+	}
+
+	if (save_oow(ts, HAWK_HTB_SIZE(hawk->tree.funs)) <= -1) return -1;
+	pair = hawk_htb_getfirstpair(hawk->tree.funs, &itr);
+	while (pair)
+	{
+		if (save_oochars(ts, HAWK_HTB_KPTR(pair), HAWK_HTB_KLEN(pair)) <= -1 ||
+		    save_fun(ts, (hawk_fun_t*)HAWK_HTB_VPTR(pair)) <= -1) return -1;
+		pair = hawk_htb_getnextpair(hawk->tree.funs, &itr);
+	}
+
+	if (save_ndes(ts, hawk->tree.init) <= -1 ||
+	    save_ndes(ts, hawk->tree.begin) <= -1 ||
+	    save_ndes(ts, hawk->tree.end) <= -1) return -1;
+
+	if (save_oow(ts, hawk->tree.chain_size) <= -1) return -1;
+	for (chain = hawk->tree.chain; chain; chain = chain->next)
+	{
+		if (save_ndes(ts, chain->pattern) <= -1 || save_ndes(ts, chain->action) <= -1) return -1;
+	}
+
+	return 0;
+}
+
+void* hawk_savetree (hawk_t* hawk, hawk_oow_t* len)
+{
+	tsave_t ts;
+	int n;
+
+	HAWK_MEMSET(&ts, 0, HAWK_SIZEOF(ts));
+	ts.hawk = hawk;
+
+	n = save_tree(&ts);
+	if (n >= 0)
+	{
+		/* append the checksum of the data to reject a damaged file */
+		hawk_oow_t hv;
+		HAWK_HASH_VPTL(hv, ts.ptr, ts.len, hawk_uint8_t);
+		n = save_oow(&ts, hv);
+	}
+	if (ts.files) hawk_freemem(hawk, ts.files);
+	if (n <= -1)
+	{
+		if (ts.ptr) hawk_freemem(hawk, ts.ptr);
+		return HAWK_NULL;
+	}
+
+	*len = ts.len;
+	return ts.ptr;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static int load_error (tload_t* tl)
+{
+	hawk_seterrbfmt(tl->hawk, HAWK_NULL, HAWK_EINVAL, "invalid tree data at offset %zu", (hawk_oow_t)(tl->end - tl->ptr));
+	return -1;
+}
+
+static int load_bytes (tload_t* tl, void* ptr, hawk_oow_t len)
+{
+	if (len > (hawk_oow_t)(tl->end - tl->ptr)) return load_error(tl);
+	HAWK_MEMCPY(ptr, tl->ptr, len);
+	tl->ptr += len;
+	return 0;
+}
+
+static HAWK_INLINE int load_oow (tload_t* tl, hawk_oow_t* v)
+{
+	return load_bytes(tl, v, HAWK_SIZEOF(*v));
+}
+
+static int load_int (tload_t* tl, int* v)
+{
+	hawk_oow_t w;
+	if (load_oow(tl, &w) <= -1) return -1;
+	*v = (int)w;
+	return 0;
+}
+
+static int load_chars (tload_t* tl, void** ptr, hawk_oow_t* len, hawk_oow_t unit)
+{
+	hawk_oow_t n;
+	hawk_uint8_t* tmp;
+
+	if (load_oow(tl, &n) <= -1) return -1;
+	if (n == (hawk_oow_t)-1)
+	{
+		*ptr = HAWK_NULL;
+		*len = 0;
+		return 0;
+	}
+	if (n > (hawk_oow_t)(tl->end - tl->ptr) / unit) return load_error(tl);
+
+	/* null-terminated like the strings made by the parser */
+	tmp = (hawk_uint8_t*)hawk_allocmem(tl->hawk, (n + 1) * unit);
+	if (HAWK_UNLIKELY(!tmp)) return -1;
+	HAWK_MEMCPY(tmp, tl->ptr, n * unit);
+	HAWK_MEMSET(&tmp[n * unit], 0, unit);
+	tl->ptr += n * unit;
+
+	*ptr = tmp;
+	*len = n;
+	return 0;
+}
+
+#define load_oochars(tl,ptr,len) load_chars(tl, (void**)(ptr), len, HAWK_SIZEOF(hawk_ooch_t))
+#define load_bchars(tl,ptr,len) load_chars(tl, (void**)(ptr), len, HAWK_SIZEOF(hawk_bch_t))
+
+static int load_loc (tload_t* tl, hawk_loc_t* loc)
+{
+	hawk_oow_t idx;
+
+	if (load_oow(tl, &loc->line) <= -1 || load_oow(tl, &loc->colm) <= -1 || load_oow(tl, &idx) <= -1) return -1;
+
+	if (idx == 0) loc->file = HAWK_NULL;
+	else if (idx <= tl->nfiles) loc->file = tl->files[idx - 1];
+	else if (idx == tl->nfiles + 1)
+	{
+		hawk_ooch_t* name;
+		hawk_oow_t len;
+
+		if (tl->nfiles >= tl->files_capa)
+		{
+			hawk_ooch_t** tmp;
+			hawk_oow_t newcapa;
+
+			newcapa = tl->files_capa + 16;
+			tmp = (hawk_ooch_t**)hawk_reallocmem(tl->hawk, tl->files, newcapa * HAWK_SIZEOF(*tmp));
+			if (HAWK_UNLIKELY(!tmp)) return -1;
+
+			tl->files = tmp;
+			tl->files_capa = newcapa;
+		}
+
+		if (load_oochars(tl, &name, &len) <= -1) return -1;
+		if (!name) return load_error(tl);
+
+		/* the names are kept in the same list as the names of the
+		 * source files given to hawk_parse() */
+		tl->files[tl->nfiles] = hawk_addsionamewithoochars(tl->hawk, name, len);
+		hawk_freemem(tl->hawk, name);
+		if (HAWK_UNLIKELY(!tl->files[tl->nfiles])) return -1;
+		loc->file = tl->files[tl->nfiles++];
+	}
+	else return load_error(tl);
+
+	return 0;
+}
+
+static hawk_fun_t* load_fun (tload_t* tl)
+{
+	hawk_fun_t* fun;
+	hawk_oow_t w;
+
+	fun = (hawk_fun_t*)hawk_callocmem(tl->hawk, HAWK_SIZEOF(*fun));
+	if (HAWK_UNLIKELY(!fun)) return HAWK_NULL;
+
+	if (load_oow(tl, &fun->nargs) <= -1 ||
+	    load_oochars(tl, &fun->argspec, &fun->argspeclen) <= -1) goto oops;
+	if (load_oow(tl, &w) <= -1) goto oops;
+	fun->variadic = !!w;
+	if (load_oow(tl, &w) <= -1) goto oops;
+	fun->hasrefarg = !!w;
+	if (load_ndes(tl, &fun->body) <= -1) goto oops;
+
+	return fun;
+
+oops:
+	if (fun->argspec) hawk_freemem(tl->hawk, fun->argspec);
+	hawk_freemem(tl->hawk, fun);
+	return HAWK_NULL;
+}
+
+static int load_fnc (tload_t* tl, hawk_nde_fncall_t* call)
+{
+	hawk_oocs_t modname;
+	hawk_oow_t flags;
+
+	if (load_oochars(tl, &call->u.fnc.info.name.ptr, &call->u.fnc.info.name.len) <= -1) return -1;
+	if (!call->u.fnc.info.name.ptr) return load_error(tl);
+	if (load_oow(tl, &flags) <= -1) return -1;
+	call->u.fnc.flags = (hawk_uint8_t)flags;
+	if (load_oochars(tl, &modname.ptr, &modname.len) <= -1) return -1;
+
+	if (call->u.fnc.flags & HAWK_NDE_FNCALL_FNC_DEFERRED_MODFNC)
+	{
+		/* resolved at runtime */
+		if (modname.ptr) hawk_freemem(tl->hawk, modname.ptr);
+	}
+	else if (modname.ptr)
+	{
+		hawk_oocs_t full;
+		const hawk_ooch_t* sym;
+		hawk_oow_t symlen;
+		hawk_mod_sym_t msym;
+		hawk_mod_t* mod;
+
+		sym = hawk_find_oochars_in_oochars(call->u.fnc.info.name.ptr, call->u.fnc.info.name.len, HAWK_T("::"), 2, 0);
+		sym = sym? sym + 2: call->u.fnc.info.name.ptr;
+		symlen = call->u.fnc.info.name.len - (sym - call->u.fnc.info.name.ptr);
+
+		/* look up the module symbol by the full name, module::symbol */
+		full.len = modname.len + 2 + symlen;
+		full.ptr = (hawk_ooch_t*)hawk_allocmem(tl->hawk, (full.len + 1) * HAWK_SIZEOF(*full.ptr));
+		if (HAWK_UNLIKELY(!full.ptr))
+		{
+			hawk_freemem(tl->hawk, modname.ptr);
+			return -1;
+		}
+		hawk_copy_oochars_to_oocstr_unlimited(full.ptr, modname.ptr, modname.len);
+		hawk_copy_oochars_to_oocstr_unlimited(&full.ptr[modname.len], HAWK_T("::"), 2);
+		hawk_copy_oochars_to_oocstr_unlimited(&full.ptr[modname.len + 2], sym, symlen);
+		hawk_freemem(tl->hawk, modname.ptr);
+
+		mod = hawk_querymodulewithoocs(tl->hawk, &full, &msym, HAWK_NULL);
+		hawk_freemem(tl->hawk, full.ptr);
+		if (!mod) return -1;
+		if (msym.type != HAWK_MOD_FNC) return load_error(tl);
+
+		call->u.fnc.info.mod = mod;
+		call->u.fnc.spec = msym.u.fnc_;
+	}
+	else
+	{
+		hawk_fnc_t* fnc;
+
+		fnc = hawk_findfncwithoocs(tl->hawk, &call->u.fnc.info.name);
+		if (!fnc)
+		{
+			hawk_seterrbfmt(tl->hawk, &call->loc, HAWK_EFUNNF, "function '%.*js' not found", call->u.fnc.info.name.len, call->u.fnc.info.name.ptr);
+			return -1;
+		}
+
+		call->u.fnc.info.mod = fnc->mod;
+		call->u.fnc.spec = fnc->spec;
+	}
+
+	return 0;
+}
+
+static hawk_oow_t nde_size (int type)
+{
+	switch (type)
+	{
+		case HAWK_NDE_BLK: return HAWK_SIZEOF(hawk_nde_blk_t);
+		case HAWK_NDE_IF: return HAWK_SIZEOF(hawk_nde_if_t);
+		case HAWK_NDE_SWITCH: return HAWK_SIZEOF(hawk_nde_switch_t);
+		case HAWK_NDE_CASE: return HAWK_SIZEOF(hawk_nde_case_t);
+		case HAWK_NDE_WHILE:
+		case HAWK_NDE_DOWHILE: return HAWK_SIZEOF(hawk_nde_while_t);
+		case HAWK_NDE_FOR: return HAWK_SIZEOF(hawk_nde_for_t);
+		case HAWK_NDE_FORIN: return HAWK_SIZEOF(hawk_nde_forin_t);
+		case HAWK_NDE_BREAK: return HAWK_SIZEOF(hawk_nde_break_t);
+		case HAWK_NDE_CONTINUE: return HAWK_SIZEOF(hawk_nde_continue_t);
+		case HAWK_NDE_RETURN: return HAWK_SIZEOF(hawk_nde_return_t);
+		case HAWK_NDE_EXIT: return HAWK_SIZEOF(hawk_nde_exit_t);
+		case HAWK_NDE_NEXT: return HAWK_SIZEOF(hawk_nde_next_t);
+		case HAWK_NDE_NEXTFILE: return HAWK_SIZEOF(hawk_nde_nextfile_t);
+		case HAWK_NDE_DELETE: return HAWK_SIZEOF(hawk_nde_delete_t);
+		case HAWK_NDE_RESET: return HAWK_SIZEOF(hawk_nde_reset_t);
+		case HAWK_NDE_GRP: return HAWK_SIZEOF(hawk_nde_grp_t);
+		case HAWK_NDE_ASS: return HAWK_SIZEOF(hawk_nde_ass_t);
+		case HAWK_NDE_EXP_BIN:
+		case HAWK_NDE_EXP_UNR:
+		case HAWK_NDE_EXP_INCPRE:
+		case HAWK_NDE_EXP_INCPST: return HAWK_SIZEOF(hawk_nde_exp_t);
+		case HAWK_NDE_CND: return HAWK_SIZEOF(hawk_nde_cnd_t);
+		case HAWK_NDE_FNCALL_FNC:
+		case HAWK_NDE_FNCALL_FUN:
+		case HAWK_NDE_FNCALL_EXPR: return HAWK_SIZEOF(hawk_nde_fncall_t);
+		case HAWK_NDE_MODSYM: return HAWK_SIZEOF(hawk_nde_modsym_t);
+		case HAWK_NDE_CHAR: return HAWK_SIZEOF(hawk_nde_char_t);
+		case HAWK_NDE_BCHR: return HAWK_SIZEOF(hawk_nde_bchr_t);
+		case HAWK_NDE_INT: return HAWK_SIZEOF(hawk_nde_int_t);
+		case HAWK_NDE_FLT: return HAWK_SIZEOF(hawk_nde_flt_t);
+		case HAWK_NDE_STR: return HAWK_SIZEOF(hawk_nde_str_t);
+		case HAWK_NDE_MBS: return HAWK_SIZEOF(hawk_nde_mbs_t);
+		case HAWK_NDE_REX: return HAWK_SIZEOF(hawk_nde_rex_t);
+		case HAWK_NDE_XARGVIDX: return HAWK_SIZEOF(hawk_nde_xargvidx_t);
+		case HAWK_NDE_FUN: return HAWK_SIZEOF(hawk_nde_fun_t);
+		case HAWK_NDE_NAMED:
+		case HAWK_NDE_GBL:
+		case HAWK_NDE_LCL:
+		case HAWK_NDE_ARG:
+		case HAWK_NDE_NAMEDIDX:
+		case HAWK_NDE_GBLIDX:
+		case HAWK_NDE_LCLIDX:
+		case HAWK_NDE_ARGIDX: return HAWK_SIZEOF(hawk_nde_var_t);
+		case HAWK_NDE_POS: return HAWK_SIZEOF(hawk_nde_pos_t);
+		case HAWK_NDE_GETLINE: return HAWK_SIZEOF(hawk_nde_getline_t);
+		case HAWK_NDE_PRINT:
+		case HAWK_NDE_PRINTF: return HAWK_SIZEOF(hawk_nde_print_t);
+		default: return HAWK_SIZEOF(hawk_nde_t); /* HAWK_NDE_NULL, HAWK_NDE_XNIL, etc */
+	}
+}
+
+static hawk_nde_t* load_nde (tload_t* tl)
+{
+	hawk_t* hawk = tl->hawk;
+	hawk_oow_t type, w;
+	hawk_loc_t loc;
+	hawk_nde_t* p;
+
+	if (load_oow(tl, &type) <= -1) return HAWK_NULL;
+	if (type > HAWK_NDE_PRINTF)
+	{
+		load_error(tl);
+		return HAWK_NULL;
+	}
+	if (load_loc(tl, &loc) <= -1) return HAWK_NULL;
+
+	p = (hawk_nde_t*)hawk_callocmem(hawk, nde_size(type));
+	if (HAWK_UNLIKELY(!p)) return HAWK_NULL;
+	p->type = (hawk_nde_type_t)type;
+	p->loc = loc;
+
+	/* the children are attached to the node as they are loaded.
+	 * hawk_clrpt() on the node frees what has been loaded on failure */
+	switch (type)
+	{
+		case HAWK_NDE_NULL:
+		case HAWK_NDE_BREAK:
+		case HAWK_NDE_CONTINUE:
+		case HAWK_NDE_NEXT:
+		case HAWK_NDE_XNIL:
+		case HAWK_NDE_XTRUE:
+		case HAWK_NDE_XFALSE:
+		case HAWK_NDE_XARGC:
+		case HAWK_NDE_XARGV:
+			break;
+
+		case HAWK_NDE_BLK:
+		{
+			hawk_nde_blk_t* px = (hawk_nde_blk_t*)p;
+			if (load_oow(tl, &px->nlcls) <= -1 ||
+			    load_oow(tl, &px->org_nlcls) <= -1 ||
+			    load_oow(tl, &px->outer_nlcls) <= -1 ||
+			    load_ndes(tl, &px->body) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_IF:
+		{
+			hawk_nde_if_t* px = (hawk_nde_if_t*)p;
+			if (load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->then_part) <= -1 ||
+			    load_ndes(tl, &px->else_part) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_SWITCH:
+		{
+			hawk_nde_switch_t* px = (hawk_nde_switch_t*)p;
+			hawk_nde_t* c;
+
+			if (load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->case_part) <= -1 ||
+			    load_oow(tl, &w) <= -1) goto oops;
+
+			for (c = px->case_part; c && w > 1; c = c->next) w--;
+			if (w > 0 && !c)
+			{
+				load_error(tl);
+				goto oops;
+			}
+			px->default_part = (w > 0)? c: HAWK_NULL;
+			break;
+		}
+
+		case HAWK_NDE_CASE:
+		{
+			hawk_nde_case_t* px = (hawk_nde_case_t*)p;
+			if (load_ndes(tl, &px->val) <= -1 ||
+			    load_ndes(tl, &px->action) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_WHILE:
+		case HAWK_NDE_DOWHILE:
+		{
+			hawk_nde_while_t* px = (hawk_nde_while_t*)p;
+			if (load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->body) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_FOR:
+		{
+			hawk_nde_for_t* px = (hawk_nde_for_t*)p;
+			if (load_ndes(tl, &px->init) <= -1 ||
+			    load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->incr) <= -1 ||
+			    load_ndes(tl, &px->body) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_FORIN:
+		{
+			hawk_nde_forin_t* px = (hawk_nde_forin_t*)p;
+			if (load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->body) <= -1 ||
+			    load_int(tl, &px->sorted) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_RETURN:
+		{
+			hawk_nde_return_t* px = (hawk_nde_return_t*)p;
+			if (load_ndes(tl, &px->val) <= -1 ||
+			    load_int(tl, &px->tail) <= -1) goto oops;
+			if (px->tail && (!px->val || px->val->type != HAWK_NDE_FNCALL_FUN))
+			{
+				load_error (tl);
+				goto oops;
+			}
+			break;
+		}
+
+		case HAWK_NDE_EXIT:
+		{
+			hawk_nde_exit_t* px = (hawk_nde_exit_t*)p;
+			if (load_ndes(tl, &px->val) <= -1 ||
+			    load_int(tl, &px->abort) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_NEXTFILE:
+			if (load_int(tl, &((hawk_nde_nextfile_t*)p)->out) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_DELETE:
+			if (load_ndes(tl, &((hawk_nde_delete_t*)p)->var) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_RESET:
+			if (load_ndes(tl, &((hawk_nde_reset_t*)p)->var) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_PRINT:
+		case HAWK_NDE_PRINTF:
+		{
+			hawk_nde_print_t* px = (hawk_nde_print_t*)p;
+			if (load_ndes(tl, &px->args) <= -1 ||
+			    load_oow(tl, &w) <= -1 ||
+			    load_ndes(tl, &px->out) <= -1) goto oops;
+			px->out_type = (hawk_out_type_t)w;
+			break;
+		}
+
+		case HAWK_NDE_GRP:
+			if (load_ndes(tl, &((hawk_nde_grp_t*)p)->body) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_ASS:
+		{
+			hawk_nde_ass_t* px = (hawk_nde_ass_t*)p;
+			if (load_int(tl, &px->opcode) <= -1 ||
+			    load_ndes(tl, &px->left) <= -1 ||
+			    load_ndes(tl, &px->right) <= -1 ||
+			    load_oow(tl, &w) <= -1) goto oops;
+			px->is_init = (hawk_uint8_t)w;
+			break;
+		}
+
+		case HAWK_NDE_EXP_BIN:
+		case HAWK_NDE_EXP_UNR:
+		case HAWK_NDE_EXP_INCPRE:
+		case HAWK_NDE_EXP_INCPST:
+		{
+			hawk_nde_exp_t* px = (hawk_nde_exp_t*)p;
+			hawk_nde_t* left, * right;
+
+			/* hawk_clrpt() expects both operands of a binary expression.
+			 * hold them in local variables until both are loaded */
+			if (load_int(tl, &px->opcode) <= -1 || load_ndes(tl, &left) <= -1) goto oops;
+			if (load_ndes(tl, &right) <= -1)
+			{
+				hawk_clrpt(hawk, left);
+				goto oops;
+			}
+			if ((type == HAWK_NDE_EXP_BIN && !right) || !left)
+			{
+				hawk_clrpt(hawk, left);
+				hawk_clrpt(hawk, right);
+				load_error(tl);
+				goto oops;
+			}
+			px->left = left;
+			px->right = right;
+			break;
+		}
+
+		case HAWK_NDE_CND:
+		{
+			hawk_nde_cnd_t* px = (hawk_nde_cnd_t*)p;
+			if (load_ndes(tl, &px->test) <= -1 ||
+			    load_ndes(tl, &px->left) <= -1 ||
+			    load_ndes(tl, &px->right) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_FNCALL_FNC:
+		case HAWK_NDE_FNCALL_FUN:
+		case HAWK_NDE_FNCALL_EXPR:
+		{
+			hawk_nde_fncall_t* px = (hawk_nde_fncall_t*)p;
+			int n;
+
+			if (type == HAWK_NDE_FNCALL_FNC) n = load_fnc(tl, px);
+			else if (type == HAWK_NDE_FNCALL_FUN) n = load_oochars(tl, &px->u.fun.name.ptr, &px->u.fun.name.len);
+			else n = load_ndes(tl, &px->u.expr.callable);
+			if (n <= -1 ||
+			    load_ndes(tl, &px->args) <= -1 ||
+			    load_oow(tl, &px->nargs) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_MODSYM:
+		{
+			hawk_nde_modsym_t* px = (hawk_nde_modsym_t*)p;
+			px->cache_type = -1; /* not cached */
+			if (load_oochars(tl, &px->name.ptr, &px->name.len) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_CHAR:
+			if (load_bytes(tl, &((hawk_nde_char_t*)p)->val, HAWK_SIZEOF(((hawk_nde_char_t*)p)->val)) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_BCHR:
+			if (load_bytes(tl, &((hawk_nde_bchr_t*)p)->val, HAWK_SIZEOF(((hawk_nde_bchr_t*)p)->val)) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_INT:
+		{
+			hawk_nde_int_t* px = (hawk_nde_int_t*)p;
+			if (load_bytes(tl, &px->val, HAWK_SIZEOF(px->val)) <= -1 ||
+			    load_oochars(tl, &px->str, &px->len) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_FLT:
+		{
+			hawk_nde_flt_t* px = (hawk_nde_flt_t*)p;
+			if (load_bytes(tl, &px->val, HAWK_SIZEOF(px->val)) <= -1 ||
+			    load_oochars(tl, &px->str, &px->len) <= -1) goto oops;
+			break;
+		}
+
+		case HAWK_NDE_STR:
+		{
+			hawk_nde_str_t* px = (hawk_nde_str_t*)p;
+			if (load_oochars(tl, &px->ptr, &px->len) <= -1) goto oops;
+			if (!px->ptr) { load_error(tl); goto oops; }
+			break;
+		}
+
+		case HAWK_NDE_MBS:
+		{
+			hawk_nde_mbs_t* px = (hawk_nde_mbs_t*)p;
+			if (load_bchars(tl, &px->ptr, &px->len) <= -1) goto oops;
+			if (!px->ptr) { load_error(tl); goto oops; }
+			break;
+		}
+
+		case HAWK_NDE_REX:
+		{
+			hawk_nde_rex_t* px = (hawk_nde_rex_t*)p;
+			if (load_oochars(tl, &px->str.ptr, &px->str.len) <= -1) goto oops;
+			if (!px->str.ptr) { load_error(tl); goto oops; }
+			if (hawk_buildrex(hawk, px->str.ptr, px->str.len, &px->code[0], &px->code[1]) <= -1)
+			{
+				hawk->gem_.errloc = p->loc;
+				goto oops;
+			}
+			break;
+		}
+
+		case HAWK_NDE_XARGVIDX:
+			if (load_ndes(tl, &((hawk_nde_xargvidx_t*)p)->pos) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_FUN:
+		{
+			hawk_nde_fun_t* px = (hawk_nde_fun_t*)p;
+
+			if (load_oochars(tl, &px->name.ptr, &px->name.len) <= -1) goto oops;
+			if (px->name.ptr)
+			{
+				/* a named function may be defined later. the runtime
+				 * looks it up if it's not found here */
+				hawk_htb_pair_t* pair;
+				pair = hawk_htb_search(hawk->tree.funs, px->name.ptr, px->name.len);
+				if (pair) px->funptr = (hawk_fun_t*)HAWK_HTB_VPTR(pair);
+			}
+			else
+			{
+				/* the function literal is owned by the inline function list */
+				px->funptr = load_fun(tl);
+				if (!px->funptr) goto oops;
+				if (hawk_arr_pushstack(hawk->tree.ifuns, px->funptr, 0) == HAWK_ARR_NIL)
+				{
+					if (px->funptr->argspec) hawk_freemem(hawk, px->funptr->argspec);
+					hawk_clrpt(hawk, px->funptr->body);
+					hawk_freemem(hawk, px->funptr);
+					goto oops;
+				}
+			}
+			break;
+		}
+
+		case HAWK_NDE_NAMED:
+		case HAWK_NDE_GBL:
+		case HAWK_NDE_LCL:
+		case HAWK_NDE_ARG:
+		case HAWK_NDE_NAMEDIDX:
+		case HAWK_NDE_GBLIDX:
+		case HAWK_NDE_LCLIDX:
+		case HAWK_NDE_ARGIDX:
+		{
+			hawk_nde_var_t* px = (hawk_nde_var_t*)p;
+			hawk_nde_t* idx;
+
+			if (load_oochars(tl, &px->id.name.ptr, &px->id.name.len) <= -1) goto oops;
+			if (load_oow(tl, &px->id.idxa) <= -1 || load_oow(tl, &w) <= -1 || load_ndes(tl, &idx) <= -1)
+			{
+				/* hawk_clrpt() checks the index against the variable type */
+				p->type = HAWK_NDE_NAMED;
+				goto oops;
+			}
+			px->is_const = (hawk_uint8_t)w;
+			px->idx = idx;
+			if ((type >= HAWK_NDE_NAMEDIDX) != (idx != HAWK_NULL))
+			{
+				load_error(tl);
+				goto oops;
+			}
+			break;
+		}
+
+		case HAWK_NDE_POS:
+			if (load_ndes(tl, &((hawk_nde_pos_t*)p)->val) <= -1) goto oops;
+			break;
+
+		case HAWK_NDE_GETLINE:
+		{
+			hawk_nde_getline_t* px = (hawk_nde_getline_t*)p;
+			if (load_ndes(tl, &px->var) <= -1 ||
+			    load_int(tl, &px->mbs) <= -1 ||
+			    load_oow(tl, &w) <= -1 ||
+			    load_ndes(tl, &px->in) <= -1) goto oops;
+			px->in_type = (hawk_in_type_t)w;
+			break;
+		}
+	}
+
+	return p;
+
+oops:
+	hawk_clrpt(hawk, p);
+	return HAWK_NULL;
+}
+
+static int load_ndes (tload_t* tl, hawk_nde_t** head)
+{
+	hawk_oow_t n;
+	hawk_nde_t* last = HAWK_NULL;
+
+	*head = HAWK_NULL;
+	if (load_oow(tl, &n) <= -1) return -1;
+
+	while (n > 0)
+	{
+		hawk_nde_t* nde;
+
+		nde = load_nde(tl);
+		if (!nde)
+		{
+			hawk_clrpt(tl->hawk, *head);
+			*head = HAWK_NULL;
+			return -1;
+		}
+
+		if (last) last->next = nde;
+		else *head = nde;
+		last = nde;
+		n--;
+	}
+
+	return 0;
+}
+
+static hawk_nde_t* last_nde (hawk_nde_t* nde)
+{
+	if (nde) while (nde->next) nde = nde->next;
+	return nde;
+}
+
+static int load_tree (tload_t* tl)
+{
+	hawk_t* hawk = tl->hawk;
+	hawk_uint8_t hdr[HAWK_SIZEOF(tree_magic) + HAWK_SIZEOF(tree_shape)];
+	hawk_oow_t i, n, w;
+	hawk_ooch_t* name;
+	hawk_oow_t len;
+
+	if (load_bytes(tl, hdr, HAWK_SIZEOF(hdr)) <= -1) return -1;
+	if (HAWK_MEMCMP(hdr, tree_magic, HAWK_SIZEOF(tree_magic)) != 0 ||
+	    HAWK_MEMCMP(&hdr[HAWK_SIZEOF(tree_magic)], tree_shape, HAWK_SIZEOF(tree_shape)) != 0 ||
+	    load_oow(tl, &w) <= -1 || w != 1)
+	{
+		hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "incompatible tree data");
+		return -1;
+	}
+
+	if (load_oow(tl, &n) <= -1) return -1;
+	for (i = 0; i < n; i++)
+	{
+		hawk_tree_src_t* src;
+
+		if (load_oochars(tl, &name, &len) <= -1) return -1;
+
+		src = (hawk_tree_src_t*)hawk_callocmem(hawk, HAWK_SIZEOF(*src));
+		if (HAWK_UNLIKELY(!src))
+		{
+			if (name) hawk_freemem(hawk, name);
+			return -1;
+		}
+		if (hawk->tree.srcs_tail) hawk->tree.srcs_tail->next = src;
+		else hawk->tree.srcs = src;
+		hawk->tree.srcs_tail = src;
+
+		if (name)
+		{
+			src->path = hawk_addsionamewithoochars(hawk, name, len);
+			hawk_freemem(hawk, name);
+			if (HAWK_UNLIKELY(!src->path)) return -1;
+		}
+		if (load_oow(tl, &w) <= -1) return -1;
+		src->top = (w != 0);
+		if (load_oow(tl, &src->hash) <= -1) return -1;
+	}
+
+	if (load_oow(tl, &w) <= -1) return -1;
+	hawk->parse.pragma.trait = (int)w;
+	if (load_oow(tl, &hawk->parse.pragma.rtx_stack_limit) <= -1) return -1;
+	if (load_oochars(tl, &name, &len) <= -1) return -1;
+	if (!name || len >= HAWK_COUNTOF(hawk->parse.pragma.entry))
+	{
+		if (name) hawk_freemem(hawk, name);
+		return load_error(tl);
+	}
+	hawk_copy_oochars_to_oocstr(hawk->parse.pragma.entry, HAWK_COUNTOF(hawk->parse.pragma.entry), name, len);
+	hawk_freemem(hawk, name);
+
+	/* the globals added with hawk_addgbl() before the script must match */
+	if (load_oow(tl, &w) <= -1 || load_oow(tl, &n) <= -1) return -1;
+	if (w != hawk->tree.ngbls_base || n < w || n > HAWK_MAX_GBLS)
+	{
+		hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "global variables not compatible with tree data");
+		return -1;
+	}
+	for (i = HAWK_MAX_GBL_ID + 1; i < n; i++)
+	{
+		if (load_oochars(tl, &name, &len) <= -1) return -1;
+		if (!name) return load_error(tl);
+
+		if (i < hawk->tree.ngbls_base)
+		{
+			if (hawk_comp_oochars(HAWK_ARR_DPTR(hawk->parse.gbls, i), HAWK_ARR_DLEN(hawk->parse.gbls, i), name, len, 0) != 0)
+			{
+				hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "global variable '%.*js' not compatible with tree data", len, name);
+				hawk_freemem(hawk, name);
+				return -1;
+			}
+		}
+		else if (hawk_arr_insert(hawk->parse.gbls, HAWK_ARR_SIZE(hawk->parse.gbls), name, len) == HAWK_ARR_NIL)
+		{
+			hawk_freemem(hawk, name);
+			return -1;
+		}
+		hawk_freemem(hawk, name);
+	}
+	hawk->tree.ngbls = n;
+
+	if (load_oow(tl, &n) <= -1) return -1;
+	for (i = 0; i < n; i++)
+	{
+		hawk_htb_pair_t* pair;
+
+		if (load_oochars(tl, &name, &len) <= -1) return -1;
+		if (!name) return load_error(tl);
+		pair = hawk_htb_insert(hawk->parse.named, name, len, (void*)i, 0);
+		hawk_freemem(hawk, name);
+		if (!pair) return -1;
+	}
+
+	if (load_oow(tl, &n) <= -1) return -1;
+	for (i = 0; i < n; i++)
+	{
+		hawk_fun_t* fun;
+		hawk_htb_pair_t* pair;
+
+		if (load_oochars(tl, &name, &len) <= -1) return -1;
+		if (!name) return load_error(tl);
+
+		fun = load_fun(tl);
+		if (!fun)
+		{
+			hawk_freemem(hawk, name);
+			return -1;
+		}
+
+		pair = hawk_htb_insert(hawk->tree.funs, name, len, fun, 0);
+		hawk_freemem(hawk, name);
+		if (!pair)
+		{
+			if (fun->argspec) hawk_freemem(hawk, fun->argspec);
+			hawk_clrpt(hawk, fun->body);
+			hawk_freemem(hawk, fun);
+			return -1;
+		}
+
+		/* back-point at the key like parse_function() does */
+		fun->name.ptr = HAWK_HTB_KPTR(pair);
+		fun->name.len = HAWK_HTB_KLEN(pair);
+	}
+
+	if (load_ndes(tl, &hawk->tree.init) <= -1) return -1;
+	hawk->tree.init_tail = last_nde(hawk->tree.init);
+	if (load_ndes(tl, &hawk->tree.begin) <= -1) return -1;
+	hawk->tree.begin_tail = last_nde(hawk->tree.begin);
+	if (load_ndes(tl, &hawk->tree.end) <= -1) return -1;
+	hawk->tree.end_tail = last_nde(hawk->tree.end);
+
+	if (load_oow(tl, &n) <= -1) return -1;
+	for (i = 0; i < n; i++)
+	{
+		hawk_chain_t* chain;
+
+		chain = (hawk_chain_t*)hawk_callocmem(hawk, HAWK_SIZEOF(*chain));
+		if (HAWK_UNLIKELY(!chain)) return -1;
+
+		if (hawk->tree.chain_tail) hawk->tree.chain_tail->next = chain;
+		else hawk->tree.chain = chain;
+		hawk->tree.chain_tail = chain;
+		hawk->tree.chain_size++;
+
+		if (load_ndes(tl, &chain->pattern) <= -1 || load_ndes(tl, &chain->action) <= -1) return -1;
+	}
+
+	if (tl->ptr != tl->end) return load_error(tl);
+	return 0;
+}
+
+int hawk_loadtree (hawk_t* hawk, const void* ptr, hawk_oow_t len)
+{
+	tload_t tl;
+	hawk_oow_t hv, sum;
+	int n;
+
+	if (!hawk_istree(ptr, len) || len < HAWK_SIZEOF(tree_magic) + HAWK_SIZEOF(sum))
+	{
+		hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "invalid tree data");
+		return -1;
+	}
+
+	len -= HAWK_SIZEOF(sum);
+	HAWK_MEMCPY(&sum, (const hawk_uint8_t*)ptr + len, HAWK_SIZEOF(sum));
+	HAWK_HASH_VPTL(hv, ptr, len, const hawk_uint8_t);
+	if (hv != sum)
+	{
+		hawk_seterrbfmt(hawk, HAWK_NULL, HAWK_EINVAL, "tree data corrupted");
+		return -1;
+	}
+
+	HAWK_ASSERT(hawk->parse.depth.loop == 0);
+	HAWK_ASSERT(hawk->parse.depth.expr == 0);
+
+	hawk_clear(hawk);
+	hawk_clearsionames(hawk);
+	hawk_adjustgbls(hawk);
+
+	HAWK_MEMSET(&tl, 0, HAWK_SIZEOF(tl));
+	tl.hawk = hawk;
+	tl.ptr = (const hawk_uint8_t*)ptr;
+	tl.end = tl.ptr + len;
+
+	n = load_tree(&tl);
+	if (tl.files) hawk_freemem(hawk, tl.files);
+
+	/* clear the partially loaded tree on error */
+	if (n <= -1) hawk_clear(hawk);
+	return n;
+}
+
+int hawk_istree (const void* ptr, hawk_oow_t len)
+{
+	return len >= HAWK_SIZEOF(tree_magic) && HAWK_MEMCMP(ptr, tree_magic, HAWK_SIZEOF(tree_magic)) == 0;
+}
@@ -51,7 +51,14 @@
  * SUCH DAMAGE.
  */
 
-#include <hawk-utl.h>
+#include "hawk-prv.h"
+
+#if defined(HAVE_PTHREAD)
+#	include <pthread.h>
+#	if defined(HAVE_UNISTD_H)
+#		include <unistd.h>
+#	endif
+#endif
 
 #define qsort_min(a,b) (((a)<(b))? a: b)
 
@@ -367,6 +374,187 @@ loop:
 	return 0;
 }
 
+/* ------------------------------------------------------------------------ */
+
+void hawk_rsort_intkeys (hawk_sort_intkey_t* base, hawk_oow_t nmemb, hawk_sort_intkey_t* tmp)
+{
+	/* least significant digit radix sort with 8-bit digits.
+	 * flipping the sign bit maps the signed order to the unsigned order */
+	hawk_oow_t count[256], i, pos, shift;
+	hawk_sort_intkey_t* src = base, * dst = tmp, * t;
+	hawk_uint8_t d;
+
+	#define RSORT_FLIP(k) ((hawk_uintmax_t)(k) ^ ((hawk_uintmax_t)1 << (HAWK_SIZEOF(hawk_int_t) * 8 - 1)))
+
+	for (shift = 0; shift < HAWK_SIZEOF(hawk_int_t) * 8; shift += 8)
+	{
+		HAWK_MEMSET(count, 0, HAWK_SIZEOF(count));
+		for (i = 0; i < nmemb; i++) count[(hawk_uint8_t)(RSORT_FLIP(src[i].key) >> shift)]++;
+
+		/* skip the digit shared by all keys */
+		d = (hawk_uint8_t)(RSORT_FLIP(src[0].key) >> shift);
+		if (count[d] == nmemb) continue;
+
+		for (i = 0, pos = 0; i < HAWK_COUNTOF(count); i++)
+		{
+			hawk_oow_t c = count[i];
+			count[i] = pos;
+			pos += c;
+		}
+
+		for (i = 0; i < nmemb; i++) dst[count[(hawk_uint8_t)(RSORT_FLIP(src[i].key) >> shift)]++] = src[i];
+
+		t = src; src = dst; dst = t;
+	}
+
+	#undef RSORT_FLIP
+
+	if (src != base) HAWK_MEMCPY(base, src, nmemb * HAWK_SIZEOF(*base));
+}
+
+/* ------------------------------------------------------------------------ */
+
+#define PSORT_MAX_THREADS 16
+
+typedef struct psort_job_t psort_job_t;
+struct psort_job_t
+{
+	hawk_oob_t* src;
+	hawk_oob_t* dst;
+	hawk_oow_t lo;
+	hawk_oow_t mid;
+	hawk_oow_t hi;
+	hawk_oow_t size;
+	hawk_sort_comper_t comper;
+	void* ctx;
+};
+
+static void* psort_sort_chunk (void* arg)
+{
+	psort_job_t* job = (psort_job_t*)arg;
+	hawk_qsort(job->src + job->lo * job->size, job->hi - job->lo, job->size, job->comper, job->ctx);
+	return HAWK_NULL;
+}
+
+static void* psort_merge_chunks (void* arg)
+{
+	/* merge src[lo..mid) and src[mid..hi) to dst[lo..hi).
+	 * an item from the left run goes first on a tie */
+	psort_job_t* job = (psort_job_t*)arg;
+	hawk_oow_t size = job->size;
+	hawk_oob_t* l = job->src + job->lo * size;
+	hawk_oob_t* le = job->src + job->mid * size;
+	hawk_oob_t* r = le;
+	hawk_oob_t* re = job->src + job->hi * size;
+	hawk_oob_t* d = job->dst + job->lo * size;
+
+	while (l < le && r < re)
+	{
+		if (job->comper(r, l, job->ctx) < 0)
+		{
+			HAWK_MEMCPY(d, r, size);
+			r += size;
+		}
+		else
+		{
+			HAWK_MEMCPY(d, l, size);
+			l += size;
+		}
+		d += size;
+	}
+	if (l < le) HAWK_MEMCPY(d, l, le - l);
+	if (r < re) HAWK_MEMCPY(d, r, re - r);
+	return HAWK_NULL;
+}
+
+static void psort_run_jobs (psort_job_t* job, hawk_oow_t njobs, void* (*handler) (void*))
+{
+#if defined(HAVE_PTHREAD)
+	pthread_t thr[PSORT_MAX_THREADS];
+	int started[PSORT_MAX_THREADS];
+	hawk_oow_t i;
+
+	/* the caller's thread handles the first job */
+	for (i = 1; i < njobs; i++)
+	{
+		started[i] = (pthread_create(&thr[i], HAWK_NULL, handler, &job[i]) == 0);
+		if (!started[i]) handler(&job[i]); /* do it here if a thread can't be created */
+	}
+	handler(&job[0]);
+	for (i = 1; i < njobs; i++)
+	{
+		if (started[i]) pthread_join(thr[i], HAWK_NULL);
+	}
+#else
+	hawk_oow_t i;
+	for (i = 0; i < njobs; i++) handler(&job[i]);
+#endif
+}
+
+void hawk_psort (void* base, hawk_oow_t nmemb, hawk_oow_t size, hawk_sort_comper_t comper, void* ctx, void* tmp, hawk_oow_t nthreads)
+{
+	psort_job_t job[PSORT_MAX_THREADS];
+	hawk_oow_t bound[PSORT_MAX_THREADS + 1];
+	hawk_oow_t nchunks, i, w;
+	hawk_oob_t* src = (hawk_oob_t*)base, * dst = (hawk_oob_t*)tmp, * t;
+
+	if (nthreads <= 0)
+	{
+	#if defined(HAVE_PTHREAD) && defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = (ncpus > 0)? (hawk_oow_t)ncpus: 1;
+	#else
+		nthreads = 1;
+	#endif
+	}
+	if (nthreads > PSORT_MAX_THREADS) nthreads = PSORT_MAX_THREADS;
+	if (nthreads > nmemb / 2) nthreads = nmemb / 2;
+
+	if (nthreads <= 1)
+	{
+		hawk_qsort(base, nmemb, size, comper, ctx);
+		return;
+	}
+
+	/* sort the chunks in parallel */
+	nchunks = nthreads;
+	for (i = 0; i <= nchunks; i++) bound[i] = nmemb * i / nchunks;
+	for (i = 0; i < nchunks; i++)
+	{
+		job[i].src = src;
+		job[i].lo = bound[i];
+		job[i].hi = bound[i + 1];
+		job[i].size = size;
+		job[i].comper = comper;
+		job[i].ctx = ctx;
+	}
+	psort_run_jobs(job, nchunks, psort_sort_chunk);
+
+	/* merge adjacent runs pairwise until a single run remains */
+	for (w = 1; w < nchunks; w *= 2)
+	{
+		hawk_oow_t njobs = 0;
+
+		for (i = 0; i < nchunks; i += w * 2)
+		{
+			job[njobs].src = src;
+			job[njobs].dst = dst;
+			job[njobs].lo = bound[i];
+			job[njobs].mid = bound[(i + w < nchunks)? (i + w): nchunks];
+			job[njobs].hi = bound[(i + w * 2 < nchunks)? (i + w * 2): nchunks];
+			job[njobs].size = size;
+			job[njobs].comper = comper;
+			job[njobs].ctx = ctx;
+			njobs++;
+		}
+		psort_run_jobs(job, njobs, psort_merge_chunks);
+
+		t = src; src = dst; dst = t;
+	}
+
+	if (src != (hawk_oob_t*)base) HAWK_MEMCPY(base, src, nmemb * size);
+}
+
 #if 0
 
 /*
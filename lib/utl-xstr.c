@@ -1102,6 +1102,263 @@ done:
 	return (negative)? -fraction: fraction;
 }
 
+/* ------------------------------------------------------------------------ */
+
+/*
+ * The fast path for plain decimal numbers - [-+]?digits[.digits][(e|E)[-+]?digits].
+ * It returns -2 for anything else including leading/trailing spaces, a radix
+ * prefix, a leading zero in the integer part, too many digits and an exponent
+ * that can't be applied exactly so that the general conversion can handle it.
+ *
+ * The digits are accumulated 8 at a time into a 64-bit integer with SWAR
+ * arithmetic. A floating-point number is produced by a single multiplication
+ * or division only when both the mantissa and the power of 10 are exactly
+ * representable (Clinger's fast path), which makes the result correctly rounded.
+ */
+
+#define NUM_FAST_MAX_DIGITS 19 /* 10^19 - 1 fits in a 64-bit unsigned integer */
+#define NUM_FAST_MAX_MANT ((hawk_uint64_t)1 << 53)
+#define NUM_FAST_MAX_EXP10 22
+#define NUM_FAST_U64(x) ((hawk_uint64_t)(x##ULL))
+
+#if defined(HAWK_HAVE_UINT64_T)
+
+static const hawk_flt_t num_fast_pow10[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* the first character is in the lowest byte of w */
+static HAWK_INLINE int swar_is_8digits (hawk_uint64_t w)
+{
+	return ((w & NUM_FAST_U64(0xF0F0F0F0F0F0F0F0)) |
+	        (((w + NUM_FAST_U64(0x0606060606060606)) & NUM_FAST_U64(0xF0F0F0F0F0F0F0F0)) >> 4)) == NUM_FAST_U64(0x3333333333333333);
+}
+
+static HAWK_INLINE hawk_uint64_t swar_parse_8digits (hawk_uint64_t w)
+{
+	w -= NUM_FAST_U64(0x3030303030303030);
+	w = (w * 10) + (w >> 8);
+	w = (((w & NUM_FAST_U64(0x000000FF000000FF)) * NUM_FAST_U64(0x000F424000000064)) +
+	     (((w >> 16) & NUM_FAST_U64(0x000000FF000000FF)) * NUM_FAST_U64(0x0000271000000001))) >> 32;
+	return w & NUM_FAST_U64(0xFFFFFFFF);
+}
+
+static HAWK_INLINE int swar_load_8uchars (const hawk_uch_t* p, hawk_uint64_t* w)
+{
+	hawk_uint64_t x = 0;
+	hawk_uch_t hi = 0;
+	int i;
+
+	for (i = 0; i < 8; i++)
+	{
+		hi |= p[i];
+		x |= (hawk_uint64_t)(hawk_uint8_t)p[i] << (i * 8);
+	}
+	if (hi & ~(hawk_uch_t)0x7F) return 0; /* a non-ascii character */
+
+	*w = x;
+	return swar_is_8digits(x);
+}
+
+static HAWK_INLINE int swar_load_8bchars (const hawk_bch_t* p, hawk_uint64_t* w)
+{
+	/* compilers turn this into a single load on a little-endian machine */
+	hawk_uint64_t x = 0;
+	int i;
+
+	for (i = 0; i < 8; i++) x |= (hawk_uint64_t)(hawk_uint8_t)p[i] << (i * 8);
+
+	*w = x;
+	return swar_is_8digits(x);
+}
+
+static HAWK_INLINE int num_fast_finish (int negative, hawk_uint64_t m, int ndigits, int nfrac, int is_flt, int exp10, hawk_int_t* l, hawk_flt_t* r)
+{
+	hawk_flt_t f;
+
+	if (ndigits <= 0) return -2;
+
+	if (!is_flt)
+	{
+		if (m > (hawk_uint64_t)HAWK_TYPE_MAX(hawk_int_t)) return -2;
+		*l = negative? -(hawk_int_t)m: (hawk_int_t)m;
+		return 0; /* int */
+	}
+
+	if (m > NUM_FAST_MAX_MANT) return -2;
+	exp10 -= nfrac;
+	if (exp10 < -NUM_FAST_MAX_EXP10 || exp10 > NUM_FAST_MAX_EXP10) return -2;
+
+	f = (hawk_flt_t)m;
+	if (exp10 < 0) f /= num_fast_pow10[-exp10];
+	else f *= num_fast_pow10[exp10];
+	*r = negative? -f: f;
+	return 1; /* flt */
+}
+
+static int uchars_to_num_fast (const hawk_uch_t* ptr, hawk_oow_t len, hawk_int_t* l, hawk_flt_t* r)
+{
+	const hawk_uch_t* p = ptr, * end = ptr + len, * q;
+	hawk_uint64_t m = 0, w;
+	int negative = 0, ndigits, nfrac = 0, is_flt = 0, exp10 = 0;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		p++;
+	}
+
+	/* integer part. a leading zero followed by more characters other than
+	 * a decimal point or an exponent may denote a radix prefix or an octal
+	 * number. leave it to the general conversion */
+	if (p < end && *p == '0' && end - p >= 2 && p[1] != '.' && p[1] != 'e' && p[1] != 'E') return -2;
+
+	q = p;
+	while (end - p >= 8 && (p - q) + 8 <= NUM_FAST_MAX_DIGITS && swar_load_8uchars(p, &w))
+	{
+		m = m * NUM_FAST_U64(100000000) + swar_parse_8digits(w);
+		p += 8;
+	}
+	while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+	{
+		if (p - q >= NUM_FAST_MAX_DIGITS) return -2;
+		m = m * 10 + (*p - '0');
+		p++;
+	}
+	ndigits = (int)(p - q);
+
+	if (p < end && *p == '.')
+	{
+		is_flt = 1;
+		p++;
+
+		q = p;
+		while (end - p >= 8 && ndigits + (p - q) + 8 <= NUM_FAST_MAX_DIGITS && swar_load_8uchars(p, &w))
+		{
+			m = m * NUM_FAST_U64(100000000) + swar_parse_8digits(w);
+			p += 8;
+		}
+		while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+		{
+			if (ndigits + (p - q) >= NUM_FAST_MAX_DIGITS) return -2;
+			m = m * 10 + (*p - '0');
+			p++;
+		}
+		nfrac = (int)(p - q);
+		ndigits += nfrac;
+	}
+
+	if (ndigits > 0 && p < end && (*p == 'e' || *p == 'E'))
+	{
+		int exp_negative = 0;
+
+		is_flt = 1;
+		p++;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			exp_negative = (*p == '-');
+			p++;
+		}
+
+		q = p;
+		while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+		{
+			if (p - q >= 4) return -2;
+			exp10 = exp10 * 10 + (*p - '0');
+			p++;
+		}
+		if (p == q) return -2; /* no exponent digits */
+		if (exp_negative) exp10 = -exp10;
+	}
+
+	if (p < end) return -2;
+	return num_fast_finish(negative, m, ndigits, nfrac, is_flt, exp10, l, r);
+}
+
+static int bchars_to_num_fast (const hawk_bch_t* ptr, hawk_oow_t len, hawk_int_t* l, hawk_flt_t* r)
+{
+	const hawk_bch_t* p = ptr, * end = ptr + len, * q;
+	hawk_uint64_t m = 0, w;
+	int negative = 0, ndigits, nfrac = 0, is_flt = 0, exp10 = 0;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		p++;
+	}
+
+	/* integer part. a leading zero followed by more characters other than
+	 * a decimal point or an exponent may denote a radix prefix or an octal
+	 * number. leave it to the general conversion */
+	if (p < end && *p == '0' && end - p >= 2 && p[1] != '.' && p[1] != 'e' && p[1] != 'E') return -2;
+
+	q = p;
+	while (end - p >= 8 && (p - q) + 8 <= NUM_FAST_MAX_DIGITS && swar_load_8bchars(p, &w))
+	{
+		m = m * NUM_FAST_U64(100000000) + swar_parse_8digits(w);
+		p += 8;
+	}
+	while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+	{
+		if (p - q >= NUM_FAST_MAX_DIGITS) return -2;
+		m = m * 10 + (*p - '0');
+		p++;
+	}
+	ndigits = (int)(p - q);
+
+	if (p < end && *p == '.')
+	{
+		is_flt = 1;
+		p++;
+
+		q = p;
+		while (end - p >= 8 && ndigits + (p - q) + 8 <= NUM_FAST_MAX_DIGITS && swar_load_8bchars(p, &w))
+		{
+			m = m * NUM_FAST_U64(100000000) + swar_parse_8digits(w);
+			p += 8;
+		}
+		while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+		{
+			if (ndigits + (p - q) >= NUM_FAST_MAX_DIGITS) return -2;
+			m = m * 10 + (*p - '0');
+			p++;
+		}
+		nfrac = (int)(p - q);
+		ndigits += nfrac;
+	}
+
+	if (ndigits > 0 && p < end && (*p == 'e' || *p == 'E'))
+	{
+		int exp_negative = 0;
+
+		is_flt = 1;
+		p++;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			exp_negative = (*p == '-');
+			p++;
+		}
+
+		q = p;
+		while (p < end && (hawk_uint32_t)(*p - '0') < 10)
+		{
+			if (p - q >= 4) return -2;
+			exp10 = exp10 * 10 + (*p - '0');
+			p++;
+		}
+		if (p == q) return -2; /* no exponent digits */
+		if (exp_negative) exp10 = -exp10;
+	}
+
+	if (p < end) return -2;
+	return num_fast_finish(negative, m, ndigits, nfrac, is_flt, exp10, l, r);
+}
+
+#endif
+
 int hawk_uchars_to_num (int option, const hawk_uch_t* ptr, hawk_oow_t len, hawk_int_t* l, hawk_flt_t* r)
 {
 	const hawk_uch_t* endptr;
@@ -1113,6 +1370,14 @@ int hawk_uchars_to_num (int option, const hawk_uch_t* ptr, hawk_oow_t len, hawk_
 	int base = HAWK_OOCHARS_TO_NUM_GET_OPTION_BASE(option);
 	int is_sober;
 
+#if defined(HAWK_HAVE_UINT64_T)
+	if (base == 0 || base == 10)
+	{
+		int n = uchars_to_num_fast(ptr, len, l, r);
+		if (n >= 0) return n;
+	}
+#endif
+
 	end = ptr + len;
 	*l = hawk_uchars_to_int(ptr, len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(stripspc,0,base), &endptr, &is_sober);
 	if (endptr < end)
@@ -1171,6 +1436,14 @@ int hawk_bchars_to_num (int option, const hawk_bch_t* ptr, hawk_oow_t len, hawk_
 	int base = HAWK_OOCHARS_TO_NUM_GET_OPTION_BASE(option);
 	int is_sober;
 
+#if defined(HAWK_HAVE_UINT64_T)
+	if (base == 0 || base == 10)
+	{
+		int n = bchars_to_num_fast(ptr, len, l, r);
+		if (n >= 0) return n;
+	}
+#endif
+
 	end = ptr + len;
 	*l = hawk_bchars_to_int(ptr, len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(stripspc,0,base), &endptr, &is_sober);
 	if (endptr < end)
@@ -35,6 +35,7 @@
 typedef struct hawk_val_chunk_t hawk_val_chunk_t;
 typedef struct hawk_val_ichunk_t hawk_val_ichunk_t;
 typedef struct hawk_val_rchunk_t hawk_val_rchunk_t;
+typedef struct hawk_val_schunk_t hawk_val_schunk_t;
 
 struct hawk_val_chunk_t
 {
@@ -59,6 +60,18 @@ struct hawk_val_rchunk_t
 	hawk_val_flt_t slot[HAWK_VAL_CHUNK_SIZE];
 };
 
+/* a slab chunk holds HAWK_VAL_CHUNK_SIZE slots of the same size class.
+ * the slots follow the header whose size is a multiple of twice the
+ * pointer size so that they are aligned for any value structure. */
+struct hawk_val_schunk_t
+{
+	hawk_val_chunk_t* next;
+	/* make sure that it has the same fields as
+	   hawk_val_chunk_t up to this point */
+
+	hawk_oow_t csize; /* slot size */
+};
+
 
 /*
  * if shared objects link a static library, statically defined objects
@@ -214,6 +227,20 @@ void hawk_rtx_freevalchunk (
 	hawk_val_chunk_t* chunk
 );
 
+/**
+ * The hawk_rtx_strvaltonum() function converts a string value to a number
+ * only if the whole string is a valid number. The result is remembered
+ * in the value and returned without scanning the text on the next call.
+ * \return 0 for an integer, 1 for a floating-point number, -1 if the
+ *         string is not a valid number
+ */
+int hawk_rtx_strvaltonum (
+	hawk_rtx_t*           rtx,
+	const hawk_val_str_t* v,
+	hawk_int_t*           l,
+	hawk_flt_t*           r
+);
+
 #if defined(HAWK_HAVE_INLINE)
 static HAWK_INLINE_ALWAYS void hawk_rtx_refupval_inline (hawk_rtx_t* rtx, hawk_val_t* val)
 {
@@ -322,6 +349,49 @@ static HAWK_INLINE int hawk_rtx_valtoint_inline (hawk_rtx_t* rtx, const hawk_val
 #define hawk_rtx_valtoint_inline(rtx, v, l) hawk_rtx_valtoint(rtx, v, l)
 #endif
 
+/* a map value made by hawk_rtx_makemapval() keeps the number of map values
+ * whose map field points to the table embedded in it behind the public
+ * part. a clone shares the table of the source until either side changes it.
+ * the serial number tells the map value from one made earlier at the same
+ * address */
+struct hawk_val_mapx_t
+{
+	hawk_val_map_t m;
+	hawk_oow_t tabrefs;
+	hawk_oow_t serial;
+};
+typedef struct hawk_val_mapx_t hawk_val_mapx_t;
+
+/* the table embedded right after the extended header of a map value and the
+ * map value owning a table. a map value points to its own table unless it's
+ * a clone still sharing the table of another map value */
+#define HAWK_MAPVAL_OWNTAB(val) ((hawk_map_t*)(((hawk_val_mapx_t*)(val)) + 1))
+#define HAWK_MAPVAL_TABOWNER(map) ((hawk_val_map_t*)(((hawk_val_mapx_t*)(map)) - 1))
+#define HAWK_MAPVAL_TABREFS(val) (((hawk_val_mapx_t*)(val))->tabrefs)
+#define HAWK_MAPVAL_SERIAL(val) (((hawk_val_mapx_t*)(val))->serial)
+#define HAWK_MAPVAL_IS_SHARED(val) (HAWK_MAPVAL_TABREFS(HAWK_MAPVAL_TABOWNER(((hawk_val_map_t*)(val))->map)) > 1)
+
+/**
+ * The hawk_rtx_clonemapval() function creates a map value sharing the
+ * table of \a map. The elements are copied when either value is changed
+ * for the first time. The elements themselves are not duplicated.
+ */
+hawk_val_t* hawk_rtx_clonemapval (
+	hawk_rtx_t* rtx,
+	hawk_val_t* map
+);
+
+/**
+ * The hawk_rtx_unsharemapval() function gives \a map a table of its own
+ * if the table is shared with a clone. Call it before changing a map.
+ */
+int hawk_rtx_unsharemapval (
+	hawk_rtx_t* rtx,
+	hawk_val_t* map
+);
+
+#define HAWK_RTX_UNSHAREMAPVAL(rtx, val) (HAWK_UNLIKELY(HAWK_MAPVAL_IS_SHARED(val))? hawk_rtx_unsharemapval(rtx, val): 0)
+
 #if defined(__cplusplus)
 }
 #endif
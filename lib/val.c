@@ -23,6 +23,7 @@
  */
 
 #include "hawk-prv.h"
+#include <hawk-json.h>
 
 #define CHUNKSIZE HAWK_VAL_CHUNK_SIZE
 
@@ -168,8 +169,13 @@ BEGIN {
 
 /*#define DEBUG_GC*/
 
+/* gc_refs of a value not under collection holds the number of the generation
+ * it belongs to. a value under collection has the GCH_TRACING bit set in gc_refs. the lower bits hold the reference
+ * count not accounted for by the values under collection. GCH_MOVED and
+ * GCH_UNREACHABLE have the GCH_TRACING bit set too */
 #define GCH_MOVED HAWK_TYPE_MAX(hawk_uintptr_t)
 #define GCH_UNREACHABLE (GCH_MOVED - 1)
+#define GCH_TRACING ((hawk_uintptr_t)1 << (HAWK_SIZEOF_UINTPTR_T * 8 - 2))
 
 static HAWK_INLINE void gc_chain_gch (hawk_gch_t* list, hawk_gch_t* gch)
 {
@@ -212,19 +218,60 @@ static HAWK_INLINE void gc_unchain_val (hawk_val_t* v)
 	gc_unchain_gch(hawk_val_to_gch(v));
 }
 
-static void gc_trace_refs (hawk_gch_t* list)
+/* a map or an array holding no other map or array can't be part of
+ * a reference cycle. such a container is kept out of the generation
+ * lists(untracked) until a map or an array is inserted into it. an
+ * untracked gc header is linked to itself. */
+static HAWK_INLINE int gc_is_tracked_gch (hawk_gch_t* gch)
+{
+	return gch->gc_next != gch;
+}
+
+static HAWK_INLINE void gc_untrack_gch (hawk_gch_t* gch)
+{
+	gch->gc_prev = gch;
+	gch->gc_next = gch;
+	gch->gc_refs = 0;
+}
+
+static HAWK_INLINE void gc_track_val (hawk_rtx_t* rtx, hawk_val_t* v)
+{
+	hawk_gch_t* gch = hawk_val_to_gch(v);
+	if (!gc_is_tracked_gch(gch))
+	{
+		gc_chain_gch(&rtx->gc.g[0], gch);
+		gch->gc_refs = 0;
+	#if defined(DEBUG_GC)
+		hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR, "[GC] TRACKED GCH %p\n", gch);
+	#endif
+	}
+}
+
+static HAWK_INLINE int gc_is_tracked_val (hawk_val_t* v)
+{
+	return HAWK_VTR_IS_POINTER(v) && v->v_gc && gc_is_tracked_gch(hawk_val_to_gch(v));
+}
+
+static HAWK_INLINE int gc_is_traced_val (hawk_val_t* v)
+{
+	return gc_is_tracked_val(v) && (hawk_val_to_gch(v)->gc_refs & GCH_TRACING);
+}
+
+static hawk_oow_t gc_trace_refs (hawk_gch_t* list)
 {
 	hawk_gch_t* gch;
 	hawk_val_t* v, * iv;
 	hawk_map_itr_t itr;
 	hawk_map_pair_t* pair;
+	hawk_oow_t count = 0;
 
 	/* phase 1 - copy the reference count field from the value header to the gc header */
 	gch = list->gc_next;
 	while (gch != list)
 	{
-		gch->gc_refs = hawk_gch_to_val(gch)->v_refs;
+		gch->gc_refs = hawk_gch_to_val(gch)->v_refs | GCH_TRACING;
 		gch = gch->gc_next;
+		count++;
 	}
 
 	/* phase 2 - decrement the reference count in the gc header whenever a reference is found */
@@ -237,13 +284,23 @@ static void gc_trace_refs (hawk_gch_t* list)
 		{
 			hawk_map_t* map;
 
-			map = ((hawk_val_map_t*)v)->map;
+			/* the embedded table is traced via its owner only. a clone refers to the owner */
+			if (((hawk_val_map_t*)v)->map != HAWK_MAPVAL_OWNTAB(v))
+			{
+				iv = (hawk_val_t*)HAWK_MAPVAL_TABOWNER(((hawk_val_map_t*)v)->map);
+				if (gc_is_traced_val(iv))
+				{
+					hawk_val_to_gch(iv)->gc_refs--;
+				}
+			}
+
+			map = HAWK_MAPVAL_OWNTAB(v);
 			hawk_init_map_itr(&itr, 0);
 			pair = hawk_map_getfirstpair(map, &itr);
 			while (pair)
 			{
 				iv = (hawk_val_t*)HAWK_MAP_VPTR(pair);
-				if (HAWK_VTR_IS_POINTER(iv) && iv->v_gc)
+				if (gc_is_traced_val(iv))
 				{
 					hawk_val_to_gch(iv)->gc_refs--;
 				}
@@ -264,7 +321,7 @@ static void gc_trace_refs (hawk_gch_t* list)
 				if (HAWK_ARR_SLOT(arr, i))
 				{
 					iv = (hawk_val_t*)HAWK_ARR_DPTR(arr, i);
-					if (HAWK_VTR_IS_POINTER(iv) && iv->v_gc)
+					if (gc_is_traced_val(iv))
 					{
 						hawk_val_to_gch(iv)->gc_refs--;
 					}
@@ -274,6 +331,8 @@ static void gc_trace_refs (hawk_gch_t* list)
 
 		gch = gch->gc_next;
 	}
+
+	return count;
 }
 
 static void gc_dump_refs (hawk_rtx_t* rtx, hawk_gch_t* list)
@@ -290,19 +349,21 @@ static void gc_dump_refs (hawk_rtx_t* rtx, hawk_gch_t* list)
 	hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR, "[GC] dumped %ju values\n", count);
 }
 
-static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list)
+static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list, hawk_oow_t newgen)
 {
 	hawk_gch_t* gch, * tmp;
 	hawk_val_t* v, * iv;
 	hawk_map_itr_t itr;
 	hawk_map_pair_t* pair;
+	int has_gc_child;
 
 	gch = list->gc_next;
 	while (gch != list)
 	{
 		tmp = gch->gc_next;
-		if (gch->gc_refs > 0)
+		if (gch->gc_refs != GCH_TRACING)
 		{
+			/* referenced by a value not under collection */
 			gc_unchain_gch(gch);
 			gc_chain_gch(reachable_list, gch);
 			gch->gc_refs = GCH_MOVED;
@@ -314,13 +375,26 @@ static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list)
 	while (gch != reachable_list)
 	{
 		v = hawk_gch_to_val(gch);
+		has_gc_child = 0;
 
 		if (v->v_type == HAWK_VAL_MAP)
 		{
 			hawk_map_t* map;
 
+			if (((hawk_val_map_t*)v)->map != HAWK_MAPVAL_OWNTAB(v))
+			{
+				has_gc_child = 1;
+				tmp = hawk_val_to_gch((hawk_val_t*)HAWK_MAPVAL_TABOWNER(((hawk_val_map_t*)v)->map));
+				if (gc_is_tracked_gch(tmp) && (tmp->gc_refs & GCH_TRACING) && tmp->gc_refs != GCH_MOVED)
+				{
+					gc_unchain_gch(tmp);
+					gc_chain_gch(reachable_list, tmp);
+					tmp->gc_refs = GCH_MOVED;
+				}
+			}
+
 			/* the key part is a string. don't care. but if a generic value is allowed as a key, this should change... */
-			map = ((hawk_val_map_t*)v)->map;
+			map = HAWK_MAPVAL_OWNTAB(v);
 
 			hawk_init_map_itr (&itr, 0);
 			pair = hawk_map_getfirstpair(map, &itr);
@@ -329,8 +403,9 @@ static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list)
 				iv = (hawk_val_t*)HAWK_MAP_VPTR(pair);
 				if (HAWK_VTR_IS_POINTER(iv) && iv->v_gc)
 				{
+					has_gc_child = 1;
 					tmp = hawk_val_to_gch(iv);
-					if (tmp->gc_refs != GCH_MOVED)
+					if (gc_is_tracked_gch(tmp) && (tmp->gc_refs & GCH_TRACING) && tmp->gc_refs != GCH_MOVED)
 					{
 						gc_unchain_gch(tmp);
 						gc_chain_gch(reachable_list, tmp);
@@ -356,8 +431,9 @@ static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list)
 					iv = (hawk_val_t*)HAWK_ARR_DPTR(arr, i);
 					if (HAWK_VTR_IS_POINTER(iv) && iv->v_gc)
 					{
+						has_gc_child = 1;
 						tmp = hawk_val_to_gch(iv);
-						if (tmp->gc_refs != GCH_MOVED)
+						if (gc_is_tracked_gch(tmp) && (tmp->gc_refs & GCH_TRACING) && tmp->gc_refs != GCH_MOVED)
 						{
 							gc_unchain_gch(tmp);
 							gc_chain_gch(reachable_list, tmp);
@@ -368,7 +444,21 @@ static void gc_move_reachables (hawk_gch_t* list, hawk_gch_t* reachable_list)
 			}
 		}
 
-		gch = gch->gc_next;
+		/* the children have been appended at the tail. it's safe to get the next one now */
+		tmp = gch->gc_next;
+		if (!has_gc_child)
+		{
+			/* the container doesn't hold any map or array any more.
+			 * stop tracking it until a map or an array gets inserted */
+			gc_unchain_gch(gch);
+			gc_untrack_gch(gch);
+		}
+		else
+		{
+			/* done with this value in this collection */
+			gch->gc_refs = newgen;
+		}
+		gch = tmp;
 	}
 }
 
@@ -377,9 +467,10 @@ static HAWK_INLINE void gc_free_val (hawk_rtx_t* rtx, hawk_val_t* v)
 	hawk_rtx_freemem(rtx, hawk_val_to_gch(v));
 }
 
-static void gc_free_unreachables (hawk_rtx_t* rtx, hawk_gch_t* list)
+static hawk_oow_t gc_free_unreachables (hawk_rtx_t* rtx, hawk_gch_t* list)
 {
 	hawk_gch_t* gch;
+	hawk_oow_t count = 0;
 
 	/* there might be recursive cross references among unreachable values.
 	 * simple traversal and sequential disposal causes various issues */
@@ -414,50 +505,210 @@ static void gc_free_unreachables (hawk_rtx_t* rtx, hawk_gch_t* list)
 		/* do what hawk_rtx_freeval() would do without HAWK_RTX_FREEVAL_GC_PRESERVE */
 		gc_unchain_gch(gch);
 		gc_free_val(rtx, hawk_gch_to_val(gch));
+		count++;
 	}
+
+	return count;
+}
+
+static HAWK_INLINE void gc_pull_gch (hawk_gch_t* slice, hawk_gch_t* gch)
+{
+	gc_unchain_gch(gch);
+	gc_chain_gch(slice, gch);
+	gch->gc_refs = GCH_TRACING;
 }
 
-static HAWK_INLINE void gc_collect_garbage_in_generation (hawk_rtx_t* rtx, int gen)
+static HAWK_INLINE int gc_pull_child (hawk_gch_t* slice, hawk_val_t* iv, int gen)
 {
-	hawk_oow_t i, newgen;
+	/* a value not under collection has its generation number in gc_refs.
+	 * the comparison fails for a value already in the slice as gc_refs
+	 * has the GCH_TRACING bit set */
+	if (gc_is_tracked_val(iv) && hawk_val_to_gch(iv)->gc_refs <= (hawk_uintptr_t)gen)
+	{
+		gc_pull_gch(slice, hawk_val_to_gch(iv));
+		return 1;
+	}
+	return 0;
+}
+
+static void gc_pick_slice (hawk_rtx_t* rtx, int gen, hawk_gch_t* slice, hawk_oow_t budget)
+{
+	hawk_gch_t* gch, * list;
+	hawk_val_t* v;
+	hawk_map_itr_t itr;
+	hawk_map_pair_t* pair;
+	hawk_oow_t count = 0;
+	int i;
+
+	/* take up to 'budget' values from the heads of the lists of the
+	 * generations under collection, the oldest generation first. the oldest
+	 * values come first in a list as new values are chained at the tail. */
+	for (i = gen; i >= 0 && count < budget; i--)
+	{
+		list = &rtx->gc.g[i];
+		while (count < budget && list->gc_next != list)
+		{
+			gc_pull_gch(slice, list->gc_next);
+			count++;
+		}
+	}
+
+	/* pull in the values reachable from the picked values as long as they
+	 * belong to the generations under collection and the budget allows.
+	 * a cycle going through an older generation or crossing the slice
+	 * boundary is left over to a later slice or a full collection.
+	 * the cycle detection over a subset of values never frees a live value
+	 * as the references from outside the slice keep it reachable. */
+	gch = slice->gc_next;
+	while (gch != slice && count < budget)
+	{
+		v = hawk_gch_to_val(gch);
+
+		if (v->v_type == HAWK_VAL_MAP)
+		{
+			hawk_map_t* map;
+
+			if (((hawk_val_map_t*)v)->map != HAWK_MAPVAL_OWNTAB(v))
+			{
+				count += gc_pull_child(slice, (hawk_val_t*)HAWK_MAPVAL_TABOWNER(((hawk_val_map_t*)v)->map), gen);
+			}
+
+			map = HAWK_MAPVAL_OWNTAB(v);
+			hawk_init_map_itr(&itr, 0);
+			pair = hawk_map_getfirstpair(map, &itr);
+			while (pair && count < budget)
+			{
+				count += gc_pull_child(slice, (hawk_val_t*)HAWK_MAP_VPTR(pair), gen);
+				pair = hawk_map_getnextpair(map, &itr);
+			}
+		}
+		else /* if (v->v_type == HAWK_VAL_ARR) */
+		{
+			hawk_oow_t size, j;
+			hawk_arr_t* arr;
+
+			HAWK_ASSERT(v->v_type == HAWK_VAL_ARR); /* only HAWK_VAL_MAP and HAWK_VAL_ARR */
+
+			arr = ((hawk_val_arr_t*)v)->arr;
+			size = HAWK_ARR_SIZE(arr);
+			for (j = 0; j < size && count < budget; j++)
+			{
+				if (HAWK_ARR_SLOT(arr, j)) count += gc_pull_child(slice, (hawk_val_t*)HAWK_ARR_DPTR(arr, j), gen);
+			}
+		}
+
+		gch = gch->gc_next;
+	}
+}
+
+static void gc_update_stat (hawk_rtx_t* rtx, int gen, hawk_oow_t scanned, hawk_oow_t freed, const hawk_ntime_t* started)
+{
+	hawk_rtx_gc_stat_t* st = &rtx->gc.stat[gen];
+	hawk_ntime_t now;
+	hawk_oow_t usec, i, lim;
+
+	hawk_get_ntime(&now);
+	hawk_sub_ntime(&now, &now, started);
+	usec = (now.sec < 0)? 0: HAWK_SECNSEC_TO_USEC(now.sec, now.nsec);
+
+	st->collections++;
+	st->scanned += scanned;
+	st->freed += freed;
+	st->pause_total += usec;
+	if (usec > st->pause_max) st->pause_max = usec;
+
+	/* bucket i holds pauses shorter than 10^(i+1) microseconds except the last one */
+	for (i = 0, lim = 10; i < HAWK_COUNTOF(st->pause_hist) - 1 && usec >= lim; i++) lim *= 10;
+	st->pause_hist[i]++;
+}
+
+static HAWK_INLINE void gc_collect_garbage_in_generation (hawk_rtx_t* rtx, int gen, hawk_oow_t budget)
+{
+	hawk_oow_t newgen;
+	hawk_oow_t scanned = 0, freed = 0;
+	hawk_ntime_t started;
+	hawk_gch_t reachable, slice, * list, * dst;
+	int i, done = 1;
+
+	hawk_get_ntime(&started);
 
 #if defined(DEBUG_GC)
 	hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR,  "[GC] **started - gen %d**\n", gen);
 #endif
 
 	newgen = (gen < HAWK_COUNTOF(rtx->gc.g) - 1)? (gen + 1): gen;
-	for (i = 0; i < gen; i++)
+
+	if (budget > 0)
 	{
-		gc_move_all_gchs (&rtx->gc.g[i], &rtx->gc.g[gen]);
+		/* incremental collection. collect a part of the generations.
+		 * the rest is left over in the generation lists and is handled
+		 * by subsequent collections */
+		slice.gc_prev = &slice;
+		slice.gc_next = &slice;
+		gc_pick_slice(rtx, gen, &slice, budget);
+		list = &slice;
+
+		/* the survivors of the oldest generation are kept aside until
+		 * the whole generation has been gone through. they would be
+		 * picked again in the same round if chained back to the list */
+		dst = (newgen == gen)? &rtx->gc.swept: &rtx->gc.g[newgen];
 	}
-
-	if (rtx->gc.g[gen].gc_next != &rtx->gc.g[gen])
+	else
 	{
-		hawk_gch_t reachable;
+		if (newgen == gen) gc_move_all_gchs (&rtx->gc.swept, &rtx->gc.g[gen]);
+		for (i = 0; i < gen; i++)
+		{
+			gc_move_all_gchs (&rtx->gc.g[i], &rtx->gc.g[gen]);
+		}
+		list = &rtx->gc.g[gen];
+		dst = &rtx->gc.g[newgen];
+	}
 
-		gc_trace_refs (&rtx->gc.g[gen]);
+	if (list->gc_next != list)
+	{
+		scanned = gc_trace_refs(list);
 
 		reachable.gc_prev = &reachable;
 		reachable.gc_next = &reachable;
-		gc_move_reachables (&rtx->gc.g[gen], &reachable);
+		gc_move_reachables (list, &reachable, newgen);
 
-		/* only unreachables are left in rtx->gc.g[0] */
+		/* only unreachables are left in the list */
 	#if defined(DEBUG_GC)
-	/*gc_dump_refs(rtx, &rtx->gc.g[0]);*/
+	/*gc_dump_refs(rtx, list);*/
 	#endif
-		gc_free_unreachables(rtx, &rtx->gc.g[gen]);
-		HAWK_ASSERT(rtx->gc.g[gen].gc_next == &rtx->gc.g[gen]);
+		freed = gc_free_unreachables(rtx, list);
+		HAWK_ASSERT(list->gc_next == list);
 
-		/* move all reachables back to the main list */
-		gc_move_all_gchs (&reachable, &rtx->gc.g[newgen]);
+		/* move all reachables to the list of the next generation */
+		gc_move_all_gchs (&reachable, dst);
 	}
 
-	/* [NOTE] pressure is greater than other elements by 1 in size.
-	 *        i store the number of collections for gen 0 in pressure[1].
-	 *        so i can avoid some comparison when doing this */
-	rtx->gc.pressure[gen + 1]++; /* number of collections done for gen */
-	rtx->gc.pressure[gen] = 0;   /* reset the number of collections of the previous generation */
-	rtx->gc.pressure[0] = 0; /* reset the number of allocations since last gc. this line is redundant if gen is 0. */
+	if (budget > 0)
+	{
+		for (i = 0; i <= gen; i++)
+		{
+			if (rtx->gc.g[i].gc_next != &rtx->gc.g[i])
+			{
+				done = 0;
+				break;
+			}
+		}
+		if (done && newgen == gen) gc_move_all_gchs (&rtx->gc.swept, &rtx->gc.g[gen]);
+	}
+
+	if (done)
+	{
+		/* [NOTE] pressure is greater than other elements by 1 in size.
+		 *        i store the number of collections for gen 0 in pressure[1].
+		 *        so i can avoid some comparison when doing this */
+		rtx->gc.pressure[gen + 1]++; /* number of collections done for gen */
+		rtx->gc.pressure[gen] = 0;   /* reset the number of collections of the previous generation */
+		rtx->gc.pressure[0] = 0; /* reset the number of allocations since last gc. this line is redundant if gen is 0. */
+	}
+	/* otherwise, the pressure is kept as it is so that the next automatic
+	 * collection continues with the same generations */
+
+	gc_update_stat(rtx, gen, scanned, freed, &started);
 
 #if defined(DEBUG_GC)
 	hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR,  "[GC] **ended**\n");
@@ -474,12 +725,12 @@ static HAWK_INLINE int gc_collect_garbage_auto (hawk_rtx_t* rtx)
 		--i;
 		if (rtx->gc.pressure[i] >= rtx->gc.threshold[i])
 		{
-			gc_collect_garbage_in_generation(rtx, i);
+			gc_collect_garbage_in_generation(rtx, i, rtx->gc.budget);
 			return i;
 		}
 	}
 
-	gc_collect_garbage_in_generation(rtx, 0);
+	gc_collect_garbage_in_generation(rtx, 0, rtx->gc.budget);
 	return 0;
 }
 
@@ -492,18 +743,35 @@ int hawk_rtx_gc (hawk_rtx_t* rtx, int gen)
 	else
 	{
 		if (gen >= HAWK_COUNTOF(rtx->gc.g)) gen = HAWK_COUNTOF(rtx->gc.g) - 1;
-		gc_collect_garbage_in_generation(rtx, gen);
+		gc_collect_garbage_in_generation(rtx, gen, 0);
 		return gen;
 	}
 }
 
+const hawk_rtx_gc_stat_t* hawk_rtx_getgcstat (hawk_rtx_t* rtx, int gen)
+{
+	if (gen < 0) gen = 0;
+	else if (gen >= HAWK_COUNTOF(rtx->gc.stat)) gen = HAWK_COUNTOF(rtx->gc.stat) - 1;
+	return &rtx->gc.stat[gen];
+}
+
+hawk_oow_t hawk_rtx_getgcbudget (hawk_rtx_t* rtx)
+{
+	return rtx->gc.budget;
+}
+
+void hawk_rtx_setgcbudget (hawk_rtx_t* rtx, hawk_oow_t budget)
+{
+	rtx->gc.budget = budget;
+}
+
 
 static HAWK_INLINE hawk_val_t* gc_calloc_val (hawk_rtx_t* rtx, hawk_oow_t size)
 {
 	hawk_gch_t* gch;
 	int gc_gen = 0;
 
-	if (HAWK_UNLIKELY(rtx->gc.pressure[0] >= rtx->gc.threshold[0]))
+	if (HAWK_UNLIKELY(rtx->gc.pressure[0] >= rtx->gc.threshold[0]) && !rtx->gc.paused)
 	{
 		/* invoke generational garbage collection */
 		gc_gen = gc_collect_garbage_auto(rtx);
@@ -579,6 +847,91 @@ hawk_val_t* hawk_rtx_makebchrval (hawk_rtx_t* rtx, hawk_bch_t v)
 	return HAWK_BCHR_TO_VTR((hawk_bchu_t)v);
 }
 
+/* --------------------------------------------------------------------- */
+
+#define SLAB_MAX_SIZE (HAWK_VAL_SLAB_CLASS_UNIT * HAWK_VAL_SLAB_NUM_CLASSES)
+#define SLAB_CLASS(size) (((size) - 1) / HAWK_VAL_SLAB_CLASS_UNIT)
+
+/* a string value allocated by make_str_val() carries the number
+ * converted from the string behind the public part so that repeated
+ * arithmetic on the same value doesn't scan the text again. nv_type
+ * is 0 if not converted yet, 1 for an integer, 2 for a floating-point
+ * number, 3 if the string is not a valid number. nv_strip holds the
+ * space stripping option in effect when the conversion was made.
+ * the static empty string doesn't have this part. */
+struct hawk_val_strx_t
+{
+	hawk_val_str_t s;
+	hawk_uint8_t nv_type;
+	hawk_uint8_t nv_strip;
+	union
+	{
+		hawk_int_t l;
+		hawk_flt_t r;
+	} nv;
+};
+typedef struct hawk_val_strx_t hawk_val_strx_t;
+
+/* the size of a string value with the characters inlined */
+#define STR_VAL_SIZE(len) (HAWK_SIZEOF(hawk_val_strx_t) + (HAWK_ALIGN_POW2(((len) + 1), HAWK_STR_CACHE_BLOCK_UNIT) * HAWK_SIZEOF(hawk_ooch_t)))
+
+static void* alloc_slab_slot (hawk_rtx_t* rtx, hawk_oow_t size)
+{
+	hawk_oow_t cls;
+	void* slot;
+
+	HAWK_ASSERT(size > 0 && size <= SLAB_MAX_SIZE);
+	cls = SLAB_CLASS(size);
+
+	if (!rtx->vmgr.sfree[cls])
+	{
+		hawk_val_schunk_t* c;
+		hawk_oow_t hsize, csize, i;
+		hawk_uint8_t* p;
+
+		hsize = HAWK_ALIGN_POW2(HAWK_SIZEOF(*c), HAWK_SIZEOF(void*) * 2);
+		csize = (cls + 1) * HAWK_VAL_SLAB_CLASS_UNIT;
+
+		c = (hawk_val_schunk_t*)hawk_rtx_allocmem(rtx, hsize + (csize * CHUNKSIZE));
+		if (HAWK_UNLIKELY(!c)) return HAWK_NULL;
+
+		c->next = rtx->vmgr.schunk;
+		c->csize = csize;
+		rtx->vmgr.schunk = (hawk_val_chunk_t*)c;
+		rtx->vmgr.stat.slab_chunks++;
+
+		/* the first word of a free slot points to the next free slot */
+		p = (hawk_uint8_t*)c + hsize;
+		for (i = 0; i < CHUNKSIZE - 1; i++)
+			*(void**)(p + (csize * i)) = p + (csize * (i + 1));
+		*(void**)(p + (csize * i)) = HAWK_NULL;
+
+		rtx->vmgr.sfree[cls] = p;
+	}
+
+	slot = rtx->vmgr.sfree[cls];
+	rtx->vmgr.sfree[cls] = *(void**)slot;
+	rtx->vmgr.stat.slab_allocs++;
+	return slot;
+}
+
+static HAWK_INLINE void free_slab_slot (hawk_rtx_t* rtx, void* slot, hawk_oow_t size)
+{
+	hawk_oow_t cls;
+
+	HAWK_ASSERT(size > 0 && size <= SLAB_MAX_SIZE);
+	cls = SLAB_CLASS(size);
+	*(void**)slot = rtx->vmgr.sfree[cls];
+	rtx->vmgr.sfree[cls] = slot;
+}
+
+const hawk_rtx_alloc_stat_t* hawk_rtx_getallocstat (hawk_rtx_t* rtx)
+{
+	return &rtx->vmgr.stat;
+}
+
+/* --------------------------------------------------------------------- */
+
 hawk_val_t* hawk_rtx_makeintval_full (hawk_rtx_t* rtx, hawk_int_t v)
 {
 	hawk_val_int_t* val;
@@ -601,6 +954,7 @@ hawk_val_t* hawk_rtx_makeintval_full (hawk_rtx_t* rtx, hawk_int_t v)
 		c->next = rtx->vmgr.ichunk;
 		/*run->vmgr.ichunk = c;*/
 		rtx->vmgr.ichunk = (hawk_val_chunk_t*)c;
+		rtx->vmgr.stat.slab_chunks++;
 
 		/*x = (hawk_val_int_t*)(c + 1);
 		for (i = 0; i < CHUNKSIZE-1; i++)
@@ -619,6 +973,7 @@ hawk_val_t* hawk_rtx_makeintval_full (hawk_rtx_t* rtx, hawk_int_t v)
 
 	val = rtx->vmgr.ifree;
 	rtx->vmgr.ifree = (hawk_val_int_t*)val->nde;
+	rtx->vmgr.stat.slab_allocs++;
 
 	val->v_type = HAWK_VAL_INT;
 	val->v_refs = 0;
@@ -653,6 +1008,7 @@ hawk_val_t* hawk_rtx_makefltval (hawk_rtx_t* rtx, hawk_flt_t v)
 
 		c->next = rtx->vmgr.rchunk;
 		rtx->vmgr.rchunk = (hawk_val_chunk_t*)c;
+		rtx->vmgr.stat.slab_chunks++;
 
 		for (i = 0; i < CHUNKSIZE-1; i++)
 			c->slot[i].nde = (hawk_nde_flt_t*)&c->slot[i+1];
@@ -663,6 +1019,7 @@ hawk_val_t* hawk_rtx_makefltval (hawk_rtx_t* rtx, hawk_flt_t v)
 
 	val = rtx->vmgr.rfree;
 	rtx->vmgr.rfree = (hawk_val_flt_t*)val->nde;
+	rtx->vmgr.stat.slab_allocs++;
 
 	val->v_type = HAWK_VAL_FLT;
 	val->v_refs = 0;
@@ -689,6 +1046,14 @@ static HAWK_INLINE hawk_val_t* make_str_val (hawk_rtx_t* rtx, const hawk_ooch_t*
 	if (HAWK_UNLIKELY(len1 <= 0 && len2 <= 0)) return hawk_val_zls;
 	aligned_len = HAWK_ALIGN_POW2((len1 + len2 + 1), HAWK_STR_CACHE_BLOCK_UNIT);
 
+	if (STR_VAL_SIZE(len1 + len2) <= SLAB_MAX_SIZE)
+	{
+		/* a short string comes from a slab with the characters inlined */
+		val = (hawk_val_str_t*)alloc_slab_slot(rtx, STR_VAL_SIZE(len1 + len2));
+		if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+		goto init;
+	}
+
 #if defined(HAWK_ENABLE_STR_CACHE)
 	i = aligned_len / HAWK_STR_CACHE_BLOCK_UNIT;
 	if (i < HAWK_COUNTOF(rtx->str_cache_count))
@@ -696,24 +1061,25 @@ static HAWK_INLINE hawk_val_t* make_str_val (hawk_rtx_t* rtx, const hawk_ooch_t*
 		if (rtx->str_cache_count[i] > 0)
 		{
 			val = rtx->str_cache[i][--rtx->str_cache_count[i]];
+			rtx->vmgr.stat.cache_hits++;
 			goto init;
 		}
 	}
 #endif
 
-	val = (hawk_val_str_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_str_t) + (aligned_len * HAWK_SIZEOF(hawk_ooch_t)));
+	val = (hawk_val_str_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_strx_t) + (aligned_len * HAWK_SIZEOF(hawk_ooch_t)));
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
-#if defined(HAWK_ENABLE_STR_CACHE)
 init:
-#endif
 	val->v_type = HAWK_VAL_STR;
 	val->v_refs = 0;
 	val->v_static = 0;
 	val->v_nstr = 0;
 	val->v_gc = 0;
+	((hawk_val_strx_t*)val)->nv_type = 0;
 	val->val.len = len1 + len2;
-	val->val.ptr = (hawk_ooch_t*)(val + 1);
+	val->val.ptr = (hawk_ooch_t*)((hawk_val_strx_t*)val + 1);
 	if (HAWK_LIKELY(str1)) hawk_copy_oochars_to_oocstr_unlimited(&val->val.ptr[0], str1, len1);
 	if (str2) hawk_copy_oochars_to_oocstr_unlimited(&val->val.ptr[len1], str2, len2);
 	val->val.ptr[val->val.len] = '\0';
@@ -881,6 +1247,16 @@ hawk_val_t* hawk_rtx_makenstrvalwithuchars (hawk_rtx_t* rtx, const hawk_uch_t* p
 		v->v_nstr = x + 1; /* long -> 1, real -> 2 */
 	}
 
+	if (!HAWK_IS_STATICVAL(v))
+	{
+		/* keep the conversion result for later arithmetic and comparison */
+		hawk_val_strx_t* sv = (hawk_val_strx_t*)v;
+		sv->nv_type = (x == 0)? 1: (x >= 1)? 2: 3;
+		sv->nv_strip = HAWK_RTX_IS_STRIPSTRSPC_ON(rtx);
+		if (x == 0) sv->nv.l = l;
+		else if (x >= 1) sv->nv.r = r;
+	}
+
 	return v;
 }
 
@@ -903,6 +1279,16 @@ hawk_val_t* hawk_rtx_makenstrvalwithbchars (hawk_rtx_t* rtx, const hawk_bch_t* p
 		v->v_nstr = x + 1; /* long -> 1, real -> 2 */
 	}
 
+	if (!HAWK_IS_STATICVAL(v))
+	{
+		/* keep the conversion result for later arithmetic and comparison */
+		hawk_val_strx_t* sv = (hawk_val_strx_t*)v;
+		sv->nv_type = (x == 0)? 1: (x >= 1)? 2: 3;
+		sv->nv_strip = HAWK_RTX_IS_STRIPSTRSPC_ON(rtx);
+		if (x == 0) sv->nv.l = l;
+		else if (x >= 1) sv->nv.r = r;
+	}
+
 	return v;
 }
 
@@ -946,6 +1332,7 @@ static HAWK_INLINE hawk_val_t* make_mbs_val (hawk_rtx_t* rtx, const hawk_bch_t*
 		if (rtx->mbs_cache_count[i] > 0)
 		{
 			val = rtx->mbs_cache[i][--rtx->mbs_cache_count[i]];
+			rtx->vmgr.stat.cache_hits++;
 			goto init;
 		}
 	}
@@ -953,6 +1340,7 @@ static HAWK_INLINE hawk_val_t* make_mbs_val (hawk_rtx_t* rtx, const hawk_bch_t*
 
 	val = (hawk_val_mbs_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_mbs_t) + (aligned_len * HAWK_SIZEOF(hawk_bch_t)));
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
 #if defined(HAWK_ENABLE_MBS_CACHE)
 init:
@@ -1091,6 +1479,7 @@ hawk_val_t* hawk_rtx_makerexval (hawk_rtx_t* rtx, const hawk_oocs_t* str, hawk_t
 	totsz = HAWK_SIZEOF(*val) + (HAWK_SIZEOF(*str->ptr) * (str->len + 1));
 	val = (hawk_val_rex_t*)hawk_rtx_callocmem(rtx, totsz);
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
 	val->v_type = HAWK_VAL_REX;
 	val->v_refs = 0;
@@ -1132,6 +1521,20 @@ static void free_arrval (hawk_arr_t* arr, void* dptr, hawk_oow_t dlen)
 	hawk_rtx_refdownval_inline(rtx, v);
 }
 
+#if defined(HAWK_ENABLE_GC)
+static void* copy_arrval (hawk_arr_t* arr, void* dptr, hawk_oow_t dlen)
+{
+	hawk_val_t* v = (hawk_val_t*)dptr;
+
+	/* the array is embedded right after the value header in hawk_rtx_makearrval().
+	 * start tracking the owning array value if a map or an array is inserted */
+	if (HAWK_VTR_IS_POINTER(v) && v->v_gc)
+		gc_track_val(*(hawk_rtx_t**)hawk_arr_getxtn(arr), (hawk_val_t*)(((hawk_val_arr_t*)arr) - 1));
+
+	return dptr;
+}
+#endif
+
 static void same_arrval (hawk_arr_t* map, void* dptr, hawk_oow_t dlen)
 {
 	hawk_rtx_t* rtx = *(hawk_rtx_t**)hawk_arr_getxtn(map);
@@ -1150,7 +1553,11 @@ hawk_val_t* hawk_rtx_makearrval (hawk_rtx_t* rtx, hawk_ooi_t init_capa)
 	 * to the data allocated somewhere else is remembered in a pair. but
 	 * freeing the actual value is handled by free_arrval and same_arrval */
 
+	#if defined(HAWK_ENABLE_GC)
+		copy_arrval,
+	#else
 		HAWK_ARR_COPIER_DEFAULT,
+	#endif
 		free_arrval,
 		HAWK_ARR_COMPER_DEFAULT,
 		same_arrval,
@@ -1169,6 +1576,7 @@ retry:
 	val = (hawk_val_arr_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_arr_t) + HAWK_SIZEOF(hawk_arr_t) + HAWK_SIZEOF(rtx));
 #endif
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
 	val->v_type = HAWK_VAL_ARR;
 	val->v_refs = 0;
@@ -1200,7 +1608,8 @@ retry:
 	hawk_arr_setstyle (val->arr, &style);
 
 #if defined(HAWK_ENABLE_GC)
-	gc_chain_val (&rtx->gc.g[0], (hawk_val_t*)val);
+	/* a new container holds nothing. it's not tracked until a map or an array is inserted */
+	gc_untrack_gch(hawk_val_to_gch((hawk_val_t*)val));
 	val->v_gc = 1; /* only array and map are to be garbaged collected as of now */
 	#if defined(DEBUG_GC)
 	hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR, "[GC] MADE GCH %p VAL(ARR) %p\n", hawk_val_to_gch(val), val);
@@ -1234,6 +1643,20 @@ static void free_mapval (hawk_map_t* map, void* dptr, hawk_oow_t dlen)
 	hawk_rtx_refdownval_inline(rtx, v);
 }
 
+#if defined(HAWK_ENABLE_GC)
+static void* copy_mapval (hawk_map_t* map, void* dptr, hawk_oow_t dlen)
+{
+	hawk_val_t* v = (hawk_val_t*)dptr;
+
+	/* the map is embedded right after the value header in hawk_rtx_makemapval().
+	 * start tracking the owning map value if a map or an array is inserted */
+	if (HAWK_VTR_IS_POINTER(v) && v->v_gc)
+		gc_track_val(*(hawk_rtx_t**)hawk_map_getxtn(map), (hawk_val_t*)HAWK_MAPVAL_TABOWNER(map));
+
+	return dptr;
+}
+#endif
+
 static void same_mapval (hawk_map_t* map, void* dptr, hawk_oow_t dlen)
 {
 	hawk_rtx_t* rtx = *(hawk_rtx_t**)hawk_map_getxtn(map);
@@ -1253,7 +1676,11 @@ hawk_val_t* hawk_rtx_makemapval (hawk_rtx_t* rtx)
 	 * freeing the actual value is handled by free_mapval and same_mapval */
 		{
 			HAWK_MAP_COPIER_INLINE,
+		#if defined(HAWK_ENABLE_GC)
+			copy_mapval
+		#else
 			HAWK_MAP_COPIER_DEFAULT
+		#endif
 		},
 		{
 			HAWK_MAP_FREEER_DEFAULT,
@@ -1274,18 +1701,21 @@ hawk_val_t* hawk_rtx_makemapval (hawk_rtx_t* rtx)
 
 #if defined(HAWK_ENABLE_GC)
 retry:
-	val = (hawk_val_map_t*)gc_calloc_val(rtx, HAWK_SIZEOF(hawk_val_map_t) + HAWK_SIZEOF(hawk_map_t) + HAWK_SIZEOF(rtx));
+	val = (hawk_val_map_t*)gc_calloc_val(rtx, HAWK_SIZEOF(hawk_val_mapx_t) + HAWK_SIZEOF(hawk_map_t) + HAWK_SIZEOF(rtx));
 #else
-	val = (hawk_val_map_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_map_t) + HAWK_SIZEOF(hawk_map_t) + HAWK_SIZEOF(rtx));
+	val = (hawk_val_map_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_mapx_t) + HAWK_SIZEOF(hawk_map_t) + HAWK_SIZEOF(rtx));
 #endif
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
 	val->v_type = HAWK_VAL_MAP;
 	val->v_refs = 0;
 	val->v_static = 0;
 	val->v_nstr = 0;
 	val->v_gc = 0;
-	val->map = (hawk_map_t*)(val + 1);
+	val->map = HAWK_MAPVAL_OWNTAB(val);
+	HAWK_MAPVAL_TABREFS(val) = 1;
+	HAWK_MAPVAL_SERIAL(val) = ++rtx->imc.serial;
 
 	x = hawk_map_init(val->map, hawk_rtx_getgem(rtx), 256, 70, HAWK_SIZEOF(hawk_ooch_t), 1);
 	if (HAWK_UNLIKELY(x <= -1))
@@ -1309,7 +1739,8 @@ retry:
 	hawk_map_setstyle(val->map, &style);
 
 #if defined(HAWK_ENABLE_GC)
-	gc_chain_val(&rtx->gc.g[0], (hawk_val_t*)val);
+	/* a new container holds nothing. it's not tracked until a map or an array is inserted */
+	gc_untrack_gch(hawk_val_to_gch((hawk_val_t*)val));
 	val->v_gc = 1; /* only array and map are to be garbaged collected as of now */
 	#if defined(DEBUG_GC)
 	hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR, "[GC] MADE GCH %p VAL(MAP) %p\n", hawk_val_to_gch(val), val);
@@ -1319,6 +1750,116 @@ retry:
 	return (hawk_val_t*)val;
 }
 
+hawk_val_t* hawk_rtx_clonemapval (hawk_rtx_t* rtx, hawk_val_t* map)
+{
+	hawk_val_map_t* val, * owner;
+
+	HAWK_ASSERT(HAWK_RTX_GETVALTYPE(rtx, map) == HAWK_VAL_MAP);
+
+	val = (hawk_val_map_t*)hawk_rtx_makemapval(rtx);
+	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+
+	/* a table can't leave the value embedding it. point to the table
+	 * of the source and keep its owner alive while it's shared */
+	owner = HAWK_MAPVAL_TABOWNER(((hawk_val_map_t*)map)->map);
+	val->map = ((hawk_val_map_t*)map)->map;
+	HAWK_MAPVAL_TABREFS(val) = 0;
+	HAWK_MAPVAL_TABREFS(owner)++;
+	hawk_rtx_refupval_inline(rtx, (hawk_val_t*)owner);
+
+#if defined(HAWK_ENABLE_GC)
+	/* the owner is a child of the clone as far as gc is concerned */
+	gc_track_val(rtx, (hawk_val_t*)val);
+#endif
+
+	return (hawk_val_t*)val;
+}
+
+int hawk_rtx_unsharemapval (hawk_rtx_t* rtx, hawk_val_t* map)
+{
+	hawk_val_map_t* val = (hawk_val_map_t*)map;
+	hawk_val_map_t* owner, * body = HAWK_NULL;
+	hawk_map_t* tab;
+	hawk_map_pair_t* pair;
+	hawk_map_itr_t itr;
+
+	HAWK_ASSERT(HAWK_RTX_GETVALTYPE(rtx, map) == HAWK_VAL_MAP);
+
+	owner = HAWK_MAPVAL_TABOWNER(val->map);
+	if (HAWK_MAPVAL_TABREFS(owner) <= 1) return 0; /* not shared */
+
+	if (HAWK_MAPVAL_TABREFS(val) <= 0)
+	{
+		/* a clone copies the elements to its own table that has been unused */
+		tab = HAWK_MAPVAL_OWNTAB(val);
+		HAWK_ASSERT(HAWK_MAP_SIZE(tab) == 0);
+	}
+	else
+	{
+		/* the table embedded in this value is still used by its clones.
+		 * borrow the table of a new map value used by this value only */
+		body = (hawk_val_map_t*)hawk_rtx_makemapval(rtx);
+		if (HAWK_UNLIKELY(!body)) return -1;
+		tab = body->map;
+	}
+
+	hawk_init_map_itr(&itr, 0);
+	pair = hawk_map_getfirstpair(val->map, &itr);
+	while (pair)
+	{
+		if (HAWK_UNLIKELY(!hawk_map_upsert(tab, HAWK_MAP_KPTR(pair), HAWK_MAP_KLEN(pair), HAWK_MAP_VPTR(pair), 0)))
+		{
+			if (body) hawk_rtx_freeval(rtx, (hawk_val_t*)body, 0);
+			else hawk_map_clear(tab);
+			return -1;
+		}
+		hawk_rtx_refupval_inline(rtx, (hawk_val_t*)HAWK_MAP_VPTR(pair));
+		pair = hawk_map_getnextpair(val->map, &itr);
+	}
+
+	HAWK_MAPVAL_TABREFS(owner)--;
+	HAWK_ASSERT(HAWK_MAPVAL_TABREFS(owner) > 0);
+	if (body)
+	{
+		/* the body counts this value in its tabrefs already */
+		hawk_rtx_refupval_inline(rtx, (hawk_val_t*)body);
+	#if defined(HAWK_ENABLE_GC)
+		gc_track_val(rtx, (hawk_val_t*)val);
+	#endif
+	}
+	else
+	{
+		HAWK_MAPVAL_TABREFS(val) = 1;
+	}
+	val->map = tab;
+
+	/* a value pointing to another value's table holds a reference to the owner */
+	if (owner != val) hawk_rtx_refdownval_inline(rtx, (hawk_val_t*)owner);
+	return 0;
+}
+
+static void fini_mapval (hawk_rtx_t* rtx, hawk_val_map_t* val)
+{
+	if (val->map != HAWK_MAPVAL_OWNTAB(val))
+	{
+		hawk_val_map_t* owner;
+
+		owner = HAWK_MAPVAL_TABOWNER(val->map);
+	#if defined(HAWK_ENABLE_GC)
+		/* leave an unreachable owner to gc_free_unreachables() like free_mapval() */
+		if (hawk_val_to_gch((hawk_val_t*)owner)->gc_refs != GCH_UNREACHABLE)
+	#endif
+		{
+			HAWK_MAPVAL_TABREFS(owner)--;
+			/* release the elements of the table no map value uses any more */
+			if (HAWK_MAPVAL_TABREFS(owner) <= 0) hawk_map_clear(HAWK_MAPVAL_OWNTAB(owner));
+			hawk_rtx_refdownval_inline(rtx, (hawk_val_t*)owner);
+		}
+	}
+
+	hawk_map_fini(HAWK_MAPVAL_OWNTAB(val));
+}
+
 hawk_val_t* hawk_rtx_makemapvalwithdata (hawk_rtx_t* rtx, hawk_val_map_data_t data[], hawk_oow_t count)
 {
 	hawk_val_t* map, * tmp;
@@ -1409,6 +1950,7 @@ hawk_val_t* hawk_rtx_setmapvalfld (hawk_rtx_t* rtx, hawk_val_t* map, const hawk_
 {
 	HAWK_ASSERT(HAWK_RTX_GETVALTYPE(rtx, map) == HAWK_VAL_MAP);
 
+	if (HAWK_RTX_UNSHAREMAPVAL(rtx, map) <= -1) return HAWK_NULL;
 	if (hawk_map_upsert(((hawk_val_map_t*)map)->map, (hawk_ooch_t*)kptr, klen, v, 0) == HAWK_NULL) return HAWK_NULL;
 
 	/* the value is passed in by an external party. we can't refup()
@@ -1519,15 +2061,8 @@ hawk_val_t* hawk_rtx_makerefval (hawk_rtx_t* rtx, int id, hawk_val_t** adr)
 {
 	hawk_val_ref_t* val;
 
-	if (rtx->rcache_count > 0)
-	{
-		val = rtx->rcache[--rtx->rcache_count];
-	}
-	else
-	{
-		val = (hawk_val_ref_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*val));
-		if (!val) return HAWK_NULL;
-	}
+	val = (hawk_val_ref_t*)alloc_slab_slot(rtx, HAWK_SIZEOF(*val));
+	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
 
 	HAWK_RTX_INIT_REF_VAL (val, id, adr, 0);
 	return (hawk_val_t*)val;
@@ -1537,7 +2072,7 @@ hawk_val_t* hawk_rtx_makefunval (hawk_rtx_t* rtx, const hawk_fun_t* fun)
 {
 	hawk_val_fun_t* val;
 
-	val = (hawk_val_fun_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(*val));
+	val = (hawk_val_fun_t*)alloc_slab_slot(rtx, HAWK_SIZEOF(*val));
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
 
 	val->v_type = HAWK_VAL_FUN;
@@ -1556,6 +2091,7 @@ hawk_val_t* hawk_rtx_makebobval (hawk_rtx_t* rtx, const void* ptr, hawk_oow_t le
 
 	val = (hawk_val_bob_t*)hawk_rtx_callocmem(rtx, HAWK_SIZEOF(hawk_val_bob_t) + len);
 	if (HAWK_UNLIKELY(!val)) return HAWK_NULL;
+	rtx->vmgr.stat.heap_allocs++;
 
 	val->v_type = HAWK_VAL_BOB;
 	val->v_refs = 0;
@@ -1572,6 +2108,255 @@ hawk_val_t* hawk_rtx_makebobval (hawk_rtx_t* rtx, const void* ptr, hawk_oow_t le
 	return (hawk_val_t*)val;
 }
 
+/* --------------------------------------------------------------------- */
+
+typedef struct json_stack_t json_stack_t;
+struct json_stack_t
+{
+	hawk_val_t* container;
+	hawk_ooch_t* key_ptr;
+	hawk_oow_t key_len;
+	hawk_ooi_t next_index;
+	int is_map;
+	json_stack_t* prev;
+};
+
+typedef struct json_build_t json_build_t;
+struct json_build_t
+{
+	hawk_rtx_t* rtx;
+	hawk_val_t* root;
+	json_stack_t* top;
+};
+
+static int push_json_container (json_build_t* jb, hawk_val_t* container, int is_map)
+{
+	json_stack_t* node;
+
+	node = (json_stack_t*)hawk_rtx_callocmem(jb->rtx, HAWK_SIZEOF(*node));
+	if (HAWK_UNLIKELY(!node)) return -1;
+
+	node->container = container;
+	node->is_map = is_map;
+	node->next_index = 1;
+	node->prev = jb->top;
+	jb->top = node;
+	return 0;
+}
+
+static void pop_json_container (json_build_t* jb)
+{
+	json_stack_t* node;
+
+	node = jb->top;
+	jb->top = node->prev;
+	if (node->key_ptr) hawk_rtx_freemem(jb->rtx, node->key_ptr);
+	hawk_rtx_freemem(jb->rtx, node);
+}
+
+static int attach_json_value (hawk_json_t* json, json_build_t* jb, hawk_val_t* val)
+{
+	hawk_rtx_t* rtx = jb->rtx;
+
+	if (!jb->top)
+	{
+		if (jb->root)
+		{
+			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "multiple root values");
+			return -1;
+		}
+		/* hold the root so that it survives until the build completes */
+		jb->root = val;
+		hawk_rtx_refupval(rtx, val);
+		return 0;
+	}
+
+	if (jb->top->is_map)
+	{
+		if (!jb->top->key_ptr)
+		{
+			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "missing object key");
+			return -1;
+		}
+
+		if (!hawk_rtx_setmapvalfld(rtx, jb->top->container, jb->top->key_ptr, jb->top->key_len, val)) goto oops;
+
+		hawk_rtx_freemem(rtx, jb->top->key_ptr);
+		jb->top->key_ptr = HAWK_NULL;
+		jb->top->key_len = 0;
+	}
+	else
+	{
+		if (!hawk_rtx_setarrvalfld(rtx, jb->top->container, jb->top->next_index, val)) goto oops;
+		jb->top->next_index++;
+	}
+
+	return 0;
+
+oops:
+	hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
+	return -1;
+}
+
+static int build_json_value (hawk_json_t* json, hawk_json_inst_t inst, const hawk_oocs_t* str)
+{
+	json_build_t* jb = (json_build_t*)hawk_json_getxtn(json);
+	hawk_rtx_t* rtx = jb->rtx;
+	hawk_val_t* val;
+
+	switch (inst)
+	{
+		case HAWK_JSON_INST_START_ARRAY:
+		case HAWK_JSON_INST_START_DIC:
+			val = (inst == HAWK_JSON_INST_START_DIC)? hawk_rtx_makemapval(rtx): hawk_rtx_makearrval(rtx, 0);
+			if (HAWK_UNLIKELY(!val)) goto oops;
+			if (attach_json_value(json, jb, val) <= -1)
+			{
+				hawk_rtx_refupval(rtx, val);
+				hawk_rtx_refdownval(rtx, val);
+				return -1;
+			}
+			if (push_json_container(jb, val, (inst == HAWK_JSON_INST_START_DIC)) <= -1) goto oops;
+			return 0;
+
+		case HAWK_JSON_INST_END_ARRAY:
+			if (!jb->top || jb->top->is_map) goto invalid_state;
+			pop_json_container(jb);
+			return 0;
+
+		case HAWK_JSON_INST_END_DIC:
+			if (!jb->top || !jb->top->is_map) goto invalid_state;
+			if (jb->top->key_ptr)
+			{
+				hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "dangling object key");
+				return -1;
+			}
+			pop_json_container(jb);
+			return 0;
+
+		case HAWK_JSON_INST_KEY:
+			if (!jb->top || !jb->top->is_map) goto invalid_state;
+			if (jb->top->key_ptr)
+			{
+				hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "duplicate object key");
+				return -1;
+			}
+			jb->top->key_ptr = hawk_rtx_dupoochars(rtx, str->ptr, str->len);
+			if (HAWK_UNLIKELY(!jb->top->key_ptr)) goto oops;
+			jb->top->key_len = str->len;
+			return 0;
+
+		case HAWK_JSON_INST_STRING:
+		case HAWK_JSON_INST_CHARACTER:
+			val = hawk_rtx_makestrvalwithoochars(rtx, str->ptr, str->len);
+			if (HAWK_UNLIKELY(!val)) goto oops;
+			break;
+
+		case HAWK_JSON_INST_NUMBER:
+			val = hawk_rtx_makenumorstrvalwithoochars(rtx, str->ptr, str->len, 1);
+			if (HAWK_UNLIKELY(!val)) goto oops;
+			break;
+
+		case HAWK_JSON_INST_NIL:
+			val = hawk_val_nil;
+			break;
+
+		case HAWK_JSON_INST_TRUE:
+			val = hawk_val_true;
+			break;
+
+		case HAWK_JSON_INST_FALSE:
+			val = hawk_val_false;
+			break;
+
+		default:
+			goto invalid_state;
+	}
+
+	if (attach_json_value(json, jb, val) <= -1)
+	{
+		hawk_rtx_refupval(rtx, val);
+		hawk_rtx_refdownval(rtx, val);
+		return -1;
+	}
+	return 0;
+
+invalid_state:
+	hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "invalid parser state");
+	return -1;
+
+oops:
+	hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
+	return -1;
+}
+
+hawk_val_t* hawk_rtx_makejsonvalwithoochars (hawk_rtx_t* rtx, const hawk_ooch_t* ptr, hawk_oow_t len)
+{
+	hawk_json_t* json;
+	json_build_t* jb;
+	hawk_oow_t xlen;
+	hawk_val_t* val;
+	int x;
+
+	/* the parser is opened on the first use and kept until the runtime
+	 * context is closed. JSON Lines input and json::parse() call this
+	 * for every record and the parser setup cost is paid only once. */
+	json = (hawk_json_t*)rtx->json;
+	if (!json)
+	{
+		hawk_json_prim_t prim;
+
+		prim.instcb = build_json_value;
+		json = hawk_json_open(hawk_rtx_getmmgr(rtx), HAWK_SIZEOF(*jb), hawk_rtx_getcmgr(rtx), &prim, HAWK_NULL);
+		if (HAWK_UNLIKELY(!json))
+		{
+			hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_ENOMEM);
+			return HAWK_NULL;
+		}
+		rtx->json = json;
+	}
+
+	jb = (json_build_t*)hawk_json_getxtn(json);
+	jb->rtx = rtx;
+	jb->root = HAWK_NULL;
+	jb->top = HAWK_NULL;
+	hawk_json_seterrnum(json, HAWK_NULL, HAWK_ENOERR);
+
+	/* the containers built are all reachable from the root held. hold off
+	 * automatic collections that would only scan them over and over while
+	 * a large document is being built. the pressure accumulated triggers
+	 * a collection at the next allocation. */
+	rtx->gc.paused++;
+	x = hawk_json_feed(json, ptr, len, &xlen);
+	rtx->gc.paused--;
+	if (x <= -1 || xlen != len || hawk_json_getstate(json) != HAWK_JSON_STATE_START || jb->top)
+	{
+		hawk_errnum_t errnum;
+		const hawk_ooch_t* errmsg;
+
+		if (hawk_json_geterrnum(json) == HAWK_ENOERR)
+			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "incomplete json input");
+
+		hawk_json_geterror(json, &errnum, &errmsg, HAWK_NULL);
+		hawk_rtx_seterrfmt(rtx, HAWK_NULL, errnum, HAWK_T("json parse error: %js"), (errmsg? errmsg: HAWK_T("")));
+
+		while (jb->top) pop_json_container(jb);
+		if (jb->root) hawk_rtx_refdownval(rtx, jb->root);
+		jb->root = HAWK_NULL;
+		hawk_json_reset(json);
+		return HAWK_NULL;
+	}
+
+	if (!jb->root) return hawk_val_nil;
+
+	/* hand over the root with the reference count of 0 like other
+	 * value making functions do */
+	val = jb->root;
+	jb->root = HAWK_NULL;
+	hawk_rtx_refdownval_nofree(rtx, val);
+	return val;
+}
+
 int hawk_rtx_isstaticval (hawk_rtx_t* rtx, const hawk_val_t* val)
 {
 	return HAWK_VTR_IS_POINTER(val) && HAWK_IS_STATICVAL(val);
@@ -1647,6 +2432,12 @@ void hawk_rtx_freeval (hawk_rtx_t* rtx, hawk_val_t* val, int flags)
 
 			case HAWK_VAL_STR:
 			{
+				if (STR_VAL_SIZE(((hawk_val_str_t*)val)->val.len) <= SLAB_MAX_SIZE)
+				{
+					free_slab_slot(rtx, val, STR_VAL_SIZE(((hawk_val_str_t*)val)->val.len));
+					break;
+				}
+
 			#if defined(HAWK_ENABLE_STR_CACHE)
 				if (flags & HAWK_RTX_FREEVAL_CACHE)
 				{
@@ -1710,7 +2501,7 @@ void hawk_rtx_freeval (hawk_rtx_t* rtx, hawk_val_t* val, int flags)
 			}
 
 			case HAWK_VAL_FUN:
-				hawk_rtx_freemem(rtx, val);
+				free_slab_slot(rtx, val, HAWK_SIZEOF(hawk_val_fun_t));
 				break;
 
 			case HAWK_VAL_MAP:
@@ -1720,14 +2511,14 @@ void hawk_rtx_freeval (hawk_rtx_t* rtx, hawk_val_t* val, int flags)
 				hawk_logbfmt(hawk_rtx_gethawk(rtx), HAWK_LOG_STDERR, "[GC] FREEING GCH %p VAL(MAP) %p - flags %d\n", hawk_val_to_gch(val), val, flags);
 				#endif
 
-				hawk_map_fini(((hawk_val_map_t*)val)->map);
+				fini_mapval(rtx, (hawk_val_map_t*)val);
 				if (!(flags & HAWK_RTX_FREEVAL_GC_PRESERVE))
 				{
 					gc_unchain_val (val);
 					gc_free_val(rtx, val);
 				}
 			#else
-				hawk_map_fini(((hawk_val_map_t*)val)->map);
+				fini_mapval(rtx, (hawk_val_map_t*)val);
 				hawk_rtx_freemem(rtx, val);
 			#endif
 				break;
@@ -1752,11 +2543,7 @@ void hawk_rtx_freeval (hawk_rtx_t* rtx, hawk_val_t* val, int flags)
 				break;
 
 			case HAWK_VAL_REF:
-				if ((flags & HAWK_RTX_FREEVAL_CACHE) && rtx->rcache_count < HAWK_COUNTOF(rtx->rcache))
-				{
-					rtx->rcache[rtx->rcache_count++] = (hawk_val_ref_t*)val;
-				}
-				else hawk_rtx_freemem(rtx, val);
+				free_slab_slot(rtx, val, HAWK_SIZEOF(hawk_val_ref_t));
 				break;
 
 			case HAWK_VAL_BOB:
@@ -2783,6 +3570,41 @@ static int val_ref_to_num (hawk_rtx_t* rtx, const hawk_val_ref_t* ref, hawk_int_
 	}
 }
 
+int hawk_rtx_strvaltonum (hawk_rtx_t* rtx, const hawk_val_str_t* v, hawk_int_t* l, hawk_flt_t* r)
+{
+	hawk_val_strx_t* sv = (hawk_val_strx_t*)v;
+	int stripspc, x;
+
+	stripspc = HAWK_RTX_IS_STRIPSTRSPC_ON(rtx);
+	if (!HAWK_IS_STATICVAL((hawk_val_t*)v) && sv->nv_type > 0 && sv->nv_strip == stripspc)
+	{
+		switch (sv->nv_type)
+		{
+			case 1:
+				*l = sv->nv.l;
+				return 0;
+			case 2:
+				*r = sv->nv.r;
+				return 1;
+			default:
+				return -1;
+		}
+	}
+
+	x = hawk_oochars_to_num(HAWK_OOCHARS_TO_NUM_MAKE_OPTION(1, 0, stripspc, 0), v->val.ptr, v->val.len, l, r);
+
+	/* a string value is immutable and owned by a single runtime context.
+	 * the static empty string is shared and has no room for the cache */
+	if (!HAWK_IS_STATICVAL((hawk_val_t*)v))
+	{
+		sv->nv_type = (x == 0)? 1: (x >= 1)? 2: 3;
+		sv->nv_strip = stripspc;
+		if (x == 0) sv->nv.l = *l;
+		else if (x >= 1) sv->nv.r = *r;
+	}
+
+	return x;
+}
 
 int hawk_rtx_valtonum (hawk_rtx_t* rtx, const hawk_val_t* v, hawk_int_t* l, hawk_flt_t* r)
 {
@@ -2826,12 +3648,20 @@ int hawk_rtx_valtonum (hawk_rtx_t* rtx, const hawk_val_t* v, hawk_int_t* l, hawk
 			return 1; /* real */
 
 		case HAWK_VAL_STR:
+		{
+			int n;
+
+			n = hawk_rtx_strvaltonum(rtx, (hawk_val_str_t*)v, l, r);
+			if (n >= 0) return n;
+
+			/* not a valid number as a whole. take the valid leading part */
 			return hawk_oochars_to_num(
 				HAWK_OOCHARS_TO_NUM_MAKE_OPTION(0, 0, HAWK_RTX_IS_STRIPSTRSPC_ON(rtx), 0),
 				((hawk_val_str_t*)v)->val.ptr,
 				((hawk_val_str_t*)v)->val.len,
 				l, r
 			);
+		}
 
 		case HAWK_VAL_MBS:
 			return hawk_bchars_to_num(
@@ -3171,6 +4001,16 @@ hawk_val_type_t hawk_rtx_getrefvaltype (hawk_rtx_t* rtx, hawk_val_ref_t* ref)
 			return HAWK_RTX_GETVALTYPE(rtx, v);
 		}
 
+		case HAWK_VAL_REF_NAMED:
+		{
+			hawk_oow_t idx;
+			hawk_val_t* v;
+			idx = (hawk_oow_t)ref->adr;
+			HAWK_ASSERT(idx < rtx->named_slot_count);
+			v = HAWK_RTX_STACK_NAMED(rtx, idx);
+			return HAWK_RTX_GETVALTYPE(rtx, v);
+		}
+
 		default:
 		{
 			hawk_val_t** xref = (hawk_val_t**)ref->adr;
@@ -26,291 +26,66 @@
 
 #include "mod-json.h"
 
-#include <hawk-json.h>
 #include <hawk-ecs.h>
 
 #include "../lib/hawk-prv.h"
 
 #define JSON_MAX_DEPTH 64
 
-typedef struct json_stack_t json_stack_t;
-struct json_stack_t
-{
-	hawk_val_t* container;
-	hawk_ooch_t* key_ptr;
-	hawk_oow_t key_len;
-	hawk_ooi_t next_index;
-	int is_map;
-	json_stack_t* prev;
-};
-
-typedef struct json_parse_ctx_t json_parse_ctx_t;
-struct json_parse_ctx_t
-{
-	hawk_rtx_t* rtx;
-	hawk_val_t* root;
-	json_stack_t* top;
-};
-
-static void free_stack_node (hawk_rtx_t* rtx, hawk_json_t* json, json_stack_t* node)
-{
-	if (node->key_ptr) hawk_rtx_freemem(rtx, node->key_ptr);
-	hawk_json_freemem(json, node);
-}
-
-static int push_container (hawk_json_t* json, json_parse_ctx_t* ctx, hawk_val_t* container, int is_map)
-{
-	json_stack_t* node;
-
-	node = (json_stack_t*)hawk_json_callocmem(json, HAWK_SIZEOF(*node));
-	if (!node) return -1;
-
-	node->container = container;
-	node->is_map = is_map;
-	node->next_index = 1;
-	node->prev = ctx->top;
-	ctx->top = node;
-	return 0;
-}
-
-static int pop_container (hawk_json_t* json, json_parse_ctx_t* ctx)
-{
-	json_stack_t* node;
-
-	node = ctx->top;
-	if (!node) return -1;
-	ctx->top = node->prev;
-	free_stack_node(ctx->rtx, json, node);
-	return 0;
-}
-
-static int attach_value (hawk_json_t* json, json_parse_ctx_t* ctx, hawk_val_t* val)
-{
-	hawk_rtx_t* rtx = ctx->rtx;
-
-	if (!ctx->top)
-	{
-		if (ctx->root)
-		{
-			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "multiple root values");
-			return -1;
-		}
-		ctx->root = val;
-		return 0;
-	}
-
-	if (ctx->top->is_map)
-	{
-		if (!ctx->top->key_ptr)
-		{
-			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "missing object key");
-			return -1;
-		}
-
-		if (!hawk_rtx_setmapvalfld(rtx, ctx->top->container, ctx->top->key_ptr, ctx->top->key_len, val))
-		{
-			hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
-			return -1;
-		}
-
-		hawk_rtx_freemem(rtx, ctx->top->key_ptr);
-		ctx->top->key_ptr = HAWK_NULL;
-		ctx->top->key_len = 0;
-		return 0;
-	}
-	else
-	{
-		if (!hawk_rtx_setarrvalfld(rtx, ctx->top->container, ctx->top->next_index, val))
-		{
-			hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
-			return -1;
-		}
-
-		ctx->top->next_index++;
-		return 0;
-	}
-}
-
-static int build_value (hawk_json_t* json, hawk_json_inst_t inst, const hawk_oocs_t* str)
-{
-	json_parse_ctx_t* ctx = (json_parse_ctx_t*)hawk_json_getxtn(json);
-	hawk_rtx_t* rtx = ctx->rtx;
-	hawk_val_t* val;
-
-	switch (inst)
-	{
-		case HAWK_JSON_INST_STRING:
-		case HAWK_JSON_INST_CHARACTER:
-			val = hawk_rtx_makestrvalwithoochars(rtx, str->ptr, str->len);
-			if (!val) goto oops;
-			break;
-
-		case HAWK_JSON_INST_NUMBER:
-			val = hawk_rtx_makenumorstrvalwithoochars(rtx, str->ptr, str->len, 1);
-			if (!val) goto oops;
-			break;
-
-		case HAWK_JSON_INST_NIL:
-			val = hawk_val_nil;
-			break;
-
-		case HAWK_JSON_INST_TRUE:
-			val = hawk_val_true;
-			break;
-
-		case HAWK_JSON_INST_FALSE:
-			val = hawk_val_false;
-			break;
-
-		default:
-			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "unexpected instruction %d", (int)inst);
-			return -1;
-	}
-
-	return attach_value(json, ctx, val);
-
-oops:
-	hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
-	return -1;
-}
-
-static int instcb (hawk_json_t* json, hawk_json_inst_t inst, const hawk_oocs_t* str)
-{
-	json_parse_ctx_t* ctx = (json_parse_ctx_t*)hawk_json_getxtn(json);
-	hawk_rtx_t* rtx = ctx->rtx;
-	hawk_val_t* val;
-
-	switch (inst)
-	{
-		case HAWK_JSON_INST_START_ARRAY:
-			val = hawk_rtx_makearrval(rtx, 0);
-			if (!val) goto oops;
-			if (attach_value(json, ctx, val) <= -1) return -1;
-			if (push_container(json, ctx, val, 0) <= -1) goto oops;
-			return 0;
-
-		case HAWK_JSON_INST_END_ARRAY:
-			if (!ctx->top || ctx->top->is_map) goto invalid_state;
-			return pop_container(json, ctx);
-
-		case HAWK_JSON_INST_START_DIC:
-			val = hawk_rtx_makemapval(rtx);
-			if (!val) goto oops;
-			if (attach_value(json, ctx, val) <= -1) return -1;
-			if (push_container(json, ctx, val, 1) <= -1) goto oops;
-			return 0;
-
-		case HAWK_JSON_INST_END_DIC:
-			if (!ctx->top || !ctx->top->is_map) goto invalid_state;
-			if (ctx->top->key_ptr)
-			{
-				hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "dangling object key");
-				return -1;
-			}
-			return pop_container(json, ctx);
-
-		case HAWK_JSON_INST_KEY:
-			if (!ctx->top || !ctx->top->is_map) goto invalid_state;
-			if (ctx->top->key_ptr)
-			{
-				hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "duplicate object key");
-				return -1;
-			}
-			ctx->top->key_ptr = hawk_rtx_dupoochars(rtx, str->ptr, str->len);
-			if (!ctx->top->key_ptr) goto oops;
-			ctx->top->key_len = str->len;
-			return 0;
-
-		case HAWK_JSON_INST_STRING:
-		case HAWK_JSON_INST_CHARACTER:
-		case HAWK_JSON_INST_NUMBER:
-		case HAWK_JSON_INST_NIL:
-		case HAWK_JSON_INST_TRUE:
-		case HAWK_JSON_INST_FALSE:
-			return build_value(json, inst, str);
-
-		default:
-			break;
-	}
-
-invalid_state:
-	hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "invalid parser state");
-	return -1;
-
-oops:
-	hawk_json_seterrnum(json, HAWK_NULL, hawk_rtx_geterrnum(rtx));
-	return -1;
-}
-
 static int fnc_parse (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
-	hawk_json_t* json = HAWK_NULL;
 	hawk_val_t* arg;
 	hawk_ooch_t* ptr;
 	hawk_oow_t len;
-	hawk_oow_t xlen;
 	hawk_val_t* retv;
-	hawk_json_prim_t prim;
-	json_parse_ctx_t* ctx;
-	int x;
 
 	arg = hawk_rtx_getarg(rtx, 0);
 	ptr = hawk_rtx_getvaloocstr(rtx, arg, &len);
 	if (!ptr) return -1;
 
-	prim.instcb = instcb;
-	json = hawk_json_openstdwithmmgr(hawk_rtx_getmmgr(rtx), HAWK_SIZEOF(*ctx), hawk_rtx_getcmgr(rtx), &prim, HAWK_NULL);
-	if (!json)
-	{
-		hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_ENOMEM);
-		hawk_rtx_freevaloocstr(rtx, arg, ptr);
-		return -1;
-	}
-
-	ctx = (json_parse_ctx_t*)hawk_json_getxtn(json);
-	ctx->rtx = rtx;
-	ctx->root = HAWK_NULL;
-	ctx->top = HAWK_NULL;
-
-	x = hawk_json_feed(json, ptr, len, &xlen);
+	retv = hawk_rtx_makejsonvalwithoochars(rtx, ptr, len);
 	hawk_rtx_freevaloocstr(rtx, arg, ptr);
+	if (!retv) return -1;
 
-	if (x <= -1 || xlen != len || hawk_json_getstate(json) != HAWK_JSON_STATE_START || ctx->top)
-	{
-		hawk_errnum_t errnum;
-		const hawk_ooch_t* errmsg;
+	hawk_rtx_setretval(rtx, retv);
+	return 0;
+}
 
-		if (hawk_json_geterrnum(json) == HAWK_ENOERR)
-		{
-			hawk_json_seterrbfmt(json, HAWK_NULL, HAWK_EINVAL, "incomplete json input");
-		}
+/* the output accumulated by stringify_value(). json::stringify() keeps
+ * everything in the buffer while json::write() hands the buffer over to
+ * the output stream whenever it grows past JSON_FLUSH_THRESHOLD so that
+ * a large value is serialized in bounded memory. */
+#define JSON_FLUSH_THRESHOLD 4096
 
-		hawk_json_geterror(json, &errnum, &errmsg, HAWK_NULL);
-		hawk_rtx_seterrfmt(rtx, HAWK_NULL, errnum, HAWK_T("json parse error: %js"), (errmsg? errmsg: HAWK_T("")));
-		goto oops;
-	}
+typedef struct json_out_t json_out_t;
+struct json_out_t
+{
+	hawk_rtx_t* rtx;
+	hawk_ooecs_t buf;
+	hawk_out_type_t out_type;
+	const hawk_ooch_t* name; /* HAWK_NULL for json::stringify() */
+	int ioerr;
+};
 
-	retv = ctx->root? ctx->root: hawk_val_nil;
-	hawk_rtx_setretval(rtx, retv);
-	hawk_json_close(json);
-	return 0;
+static int flush_json_out (json_out_t* out)
+{
+	int n;
 
-oops:
-	if (ctx->root)
-	{
-		hawk_rtx_refupval(rtx, ctx->root);
-		hawk_rtx_refdownval(rtx, ctx->root);
-	}
+	if (HAWK_OOECS_LEN(&out->buf) <= 0) return 0;
 
-	while (ctx->top)
+	n = hawk_rtx_writeiostr(out->rtx, out->out_type, out->name, HAWK_OOECS_PTR(&out->buf), HAWK_OOECS_LEN(&out->buf));
+	hawk_ooecs_clear(&out->buf);
+	if (n <= -1)
 	{
-		json_stack_t* node = ctx->top;
-		ctx->top = node->prev;
-		free_stack_node(rtx, json, node);
+		out->ioerr = 1;
+		return -1;
 	}
+	return 0;
+}
 
-	hawk_json_close(json);
-	return -1;
+static HAWK_INLINE int check_json_out (json_out_t* out)
+{
+	return (out->name && HAWK_OOECS_LEN(&out->buf) >= JSON_FLUSH_THRESHOLD)? flush_json_out(out): 0;
 }
 
 static int append_hex2 (hawk_ooecs_t* buf, hawk_uint8_t val)
@@ -323,8 +98,9 @@ static int append_hex2 (hawk_ooecs_t* buf, hawk_uint8_t val)
 	return (hawk_ooecs_ncat(buf, tmp, 2) == (hawk_oow_t)-1)? -1: 0;
 }
 
-static int append_json_string (hawk_ooecs_t* buf, const hawk_ooch_t* ptr, hawk_oow_t len)
+static int append_json_string (json_out_t* out, const hawk_ooch_t* ptr, hawk_oow_t len)
 {
+	hawk_ooecs_t* buf = &out->buf;
 	hawk_oow_t i;
 
 	if (hawk_ooecs_ccat(buf, HAWK_T('"')) == (hawk_oow_t)-1) return -1;
@@ -333,6 +109,9 @@ static int append_json_string (hawk_ooecs_t* buf, const hawk_ooch_t* ptr, hawk_o
 	{
 		hawk_ooch_t c = ptr[i];
 
+		/* a long string must not defeat the bounded buffer */
+		if (check_json_out(out) <= -1) return -1;
+
 		switch (c)
 		{
 			case HAWK_T('"'):
@@ -377,8 +156,9 @@ static int append_json_string (hawk_ooecs_t* buf, const hawk_ooch_t* ptr, hawk_o
 	return 0;
 }
 
-static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out, int depth)
+static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, json_out_t* jo, int depth)
 {
+	hawk_ooecs_t* out = &jo->buf;
 	hawk_val_type_t vtype;
 
 	if (depth > JSON_MAX_DEPTH)
@@ -411,7 +191,7 @@ static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out,
 		case HAWK_VAL_STR:
 		{
 			hawk_val_str_t* sv = (hawk_val_str_t*)val;
-			return append_json_string(out, sv->val.ptr, sv->val.len);
+			return append_json_string(jo, sv->val.ptr, sv->val.len);
 		}
 
 		case HAWK_VAL_CHAR:
@@ -421,7 +201,7 @@ static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out,
 			hawk_oow_t len;
 			hawk_ooch_t* ptr = hawk_rtx_getvaloocstr(rtx, val, &len);
 			if (!ptr) return -1;
-			if (append_json_string(out, ptr, len) <= -1)
+			if (append_json_string(jo, ptr, len) <= -1)
 			{
 				hawk_rtx_freevaloocstr(rtx, val, ptr);
 				return -1;
@@ -449,9 +229,10 @@ static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out,
 				if (!first && hawk_ooecs_ccat(out, HAWK_T(',')) == (hawk_oow_t)-1) return -1;
 				first = 0;
 
-				if (append_json_string(out, key->ptr, key->len) <= -1) return -1;
+				if (append_json_string(jo, key->ptr, key->len) <= -1) return -1;
 				if (hawk_ooecs_ccat(out, HAWK_T(':')) == (hawk_oow_t)-1) return -1;
-				if (stringify_value(rtx, (hawk_val_t*)mapval, out, depth + 1) <= -1) return -1;
+				if (stringify_value(rtx, (hawk_val_t*)mapval, jo, depth + 1) <= -1) return -1;
+				if (check_json_out(jo) <= -1) return -1;
 
 				iptr = hawk_rtx_getnextmapvalitr(rtx, val, &itr);
 			}
@@ -471,7 +252,8 @@ static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out,
 			{
 				if (!first && hawk_ooecs_ccat(out, HAWK_T(',')) == (hawk_oow_t)-1) return -1;
 				first = 0;
-				if (stringify_value(rtx, iptr->elem, out, depth + 1) <= -1) return -1;
+				if (stringify_value(rtx, iptr->elem, jo, depth + 1) <= -1) return -1;
+				if (check_json_out(jo) <= -1) return -1;
 				iptr = hawk_rtx_getnextarrvalitr(rtx, val, &itr);
 			}
 			if (hawk_ooecs_ccat(out, HAWK_T(']')) == (hawk_oow_t)-1) return -1;
@@ -486,34 +268,115 @@ static int stringify_value (hawk_rtx_t* rtx, hawk_val_t* val, hawk_ooecs_t* out,
 
 static int fnc_stringify (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
-	hawk_ooecs_t buf;
+	json_out_t jo;
 	hawk_val_t* arg;
 	hawk_val_t* retv;
-	int inited = 0;
+
+	HAWK_MEMSET (&jo, 0, HAWK_SIZEOF(jo));
+	jo.rtx = rtx;
 
 	arg = hawk_rtx_getarg(rtx, 0);
-	if (hawk_ooecs_init(&buf, hawk_rtx_getgem(rtx), 256) <= -1) return -1;
-	inited = 1;
+	if (hawk_ooecs_init(&jo.buf, hawk_rtx_getgem(rtx), 256) <= -1) return -1;
 
-	if (stringify_value(rtx, arg, &buf, 0) <= -1) goto oops;
+	if (stringify_value(rtx, arg, &jo, 0) <= -1) goto oops;
 
-	retv = hawk_rtx_makestrvalwithoocs(rtx, HAWK_OOECS_OOCS(&buf));
+	retv = hawk_rtx_makestrvalwithoocs(rtx, HAWK_OOECS_OOCS(&jo.buf));
 	if (!retv) goto oops;
 
-	hawk_ooecs_fini(&buf);
+	hawk_ooecs_fini(&jo.buf);
 	hawk_rtx_setretval(rtx, retv);
 	return 0;
 
 oops:
-	if (inited) hawk_ooecs_fini(&buf);
+	hawk_ooecs_fini(&jo.buf);
 	return -1;
 }
 
+/*
+ * json::write(stream, value[, type]) serializes the value directly to an
+ * output stream as print does. the type is one of ">"(default), ">>", "|"
+ * and "|&". an empty stream name denotes the console output. it returns 0
+ * on success and -1 if writing fails.
+ */
+static int fnc_write (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	json_out_t jo;
+	hawk_val_t* a0;
+	hawk_ooch_t* name;
+	hawk_oow_t len;
+	hawk_out_type_t out_type = HAWK_OUT_FILE;
+	int n;
+
+	if (hawk_rtx_getnargs(rtx) >= 3)
+	{
+		hawk_val_t* a2;
+		hawk_ooch_t* tptr;
+		hawk_oow_t tlen;
+
+		a2 = hawk_rtx_getarg(rtx, 2);
+		tptr = hawk_rtx_getvaloocstr(rtx, a2, &tlen);
+		if (!tptr) return -1;
+
+		if (hawk_comp_oochars_oocstr(tptr, tlen, HAWK_T(">"), 0) == 0) out_type = HAWK_OUT_FILE;
+		else if (hawk_comp_oochars_oocstr(tptr, tlen, HAWK_T(">>"), 0) == 0) out_type = HAWK_OUT_APFILE;
+		else if (hawk_comp_oochars_oocstr(tptr, tlen, HAWK_T("|"), 0) == 0) out_type = HAWK_OUT_PIPE;
+		else if (hawk_comp_oochars_oocstr(tptr, tlen, HAWK_T("|&"), 0) == 0) out_type = HAWK_OUT_RWPIPE;
+		else
+		{
+			hawk_rtx_freevaloocstr(rtx, a2, tptr);
+			hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_EINVAL);
+			return -1;
+		}
+		hawk_rtx_freevaloocstr(rtx, a2, tptr);
+	}
+
+	a0 = hawk_rtx_getarg(rtx, 0);
+	name = hawk_rtx_getvaloocstr(rtx, a0, &len);
+	if (!name) return -1;
+
+	if (len == 0) out_type = HAWK_OUT_CONSOLE;
+	else if (hawk_find_oochar_in_oochars(name, len, '\0'))
+	{
+		hawk_rtx_freevaloocstr(rtx, a0, name);
+		hawk_rtx_seterrnum(rtx, HAWK_NULL, HAWK_EIONMNL);
+		return -1;
+	}
+
+	HAWK_MEMSET (&jo, 0, HAWK_SIZEOF(jo));
+	jo.rtx = rtx;
+	jo.out_type = out_type;
+	jo.name = name;
+
+	if (hawk_ooecs_init(&jo.buf, hawk_rtx_getgem(rtx), JSON_FLUSH_THRESHOLD + 256) <= -1)
+	{
+		hawk_rtx_freevaloocstr(rtx, a0, name);
+		return -1;
+	}
+
+	n = stringify_value(rtx, hawk_rtx_getarg(rtx, 1), &jo, 0);
+	if (n >= 0) n = flush_json_out(&jo);
+
+	hawk_ooecs_fini(&jo.buf);
+	hawk_rtx_freevaloocstr(rtx, a0, name);
+
+	if (n <= -1)
+	{
+		/* an i/o failure is reported through the return value like
+		 * close() and fflush(). an unencodable value aborts. */
+		if (!jo.ioerr) return -1;
+		n = -1;
+	}
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval(rtx, n));
+	return 0;
+}
+
 static hawk_mod_fnc_tab_t fnctab[] =
 {
 	/* keep this table sorted for binary search in query(). */
 	{ HAWK_T("parse"),     { { 1, 1, HAWK_NULL }, fnc_parse,     0 } },
-	{ HAWK_T("stringify"), { { 1, 1, HAWK_NULL }, fnc_stringify, 0 } }
+	{ HAWK_T("stringify"), { { 1, 1, HAWK_NULL }, fnc_stringify, 0 } },
+	{ HAWK_T("write"),     { { 2, 3, HAWK_NULL }, fnc_write,     0 } }
 };
 
 static int query (hawk_mod_t* mod, hawk_t* hawk, const hawk_ooch_t* name, hawk_mod_sym_t* sym)
@@ -151,7 +151,7 @@ static int fnc_connect (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	memc_list_t* memc_list;
 	memc_node_t* memc_node;
-	hawk_val_t* a0;
+	hawk_val_t* a1;
 	hawk_bch_t* conf = HAWK_NULL;
 	hawk_oow_t conf_len = 0;
 	int ret = -1, take_rtx_err = 0;
@@ -160,8 +160,8 @@ static int fnc_connect (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	memc_node = get_memc_list_node_with_arg(rtx, memc_list, hawk_rtx_getarg(rtx, 0));
 	if (memc_node)
 	{
-		a0 = hawk_rtx_getarg(rtx, 0);
-		if (!(conf = hawk_rtx_getvalbcstr(rtx, a0, &conf_len)))
+		a1 = hawk_rtx_getarg(rtx, 1);
+		if (!(conf = hawk_rtx_getvalbcstr(rtx, a1, &conf_len)))
 		{
 			take_rtx_err = 1;
 			goto done;
@@ -179,7 +179,7 @@ static int fnc_connect (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 done:
 	if (take_rtx_err) set_error_on_memc_list (rtx, memc_list, HAWK_NULL);
-	if (conf) hawk_rtx_freevalbcstr (rtx, a0, conf);
+	if (conf) hawk_rtx_freevalbcstr (rtx, a1, conf);
 
 	hawk_rtx_setretval (rtx, hawk_rtx_makeintval(rtx, ret));
 	return 0;
@@ -273,7 +273,7 @@ static int fnc_get (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 done:
 	if (rv == HAWK_NULL)
 	{
-		if (def_val != HAWK_NULL) rv = "";
+		if (def_val == HAWK_NULL) rv = "";
 		else
 		{
 			rv = def_val;
@@ -355,15 +355,353 @@ done:
 	return 0;
 }
 
+#define ENSURE_CONNECTED(rtx, memc_list, memc_node) \
+	do { \
+		if (!(memc_node)->memc) \
+		{ \
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("not connected")); \
+			goto done; \
+		} \
+	} while (0)
+
+static int set_map_field_with_bchars (hawk_rtx_t* rtx, hawk_val_t* map, const hawk_bch_t* kptr, hawk_oow_t klen, const hawk_bch_t* vptr, hawk_oow_t vlen)
+{
+	hawk_val_t* v;
+	hawk_val_t* tmp;
+#if defined(HAWK_OOCH_IS_BCH)
+	const hawk_ooch_t* key = kptr;
+#else
+	hawk_ooch_t* key;
+#endif
+
+	v = hawk_rtx_makestrvalwithbchars(rtx, vptr, vlen);
+	if (!v) return -1;
+
+#if !defined(HAWK_OOCH_IS_BCH)
+	key = hawk_rtx_dupbtouchars(rtx, kptr, klen, &klen, 1);
+	if (!key)
+	{
+		hawk_rtx_refupval (rtx, v);
+		hawk_rtx_refdownval (rtx, v);
+		return -1;
+	}
+#endif
+
+	hawk_rtx_refupval (rtx, v);
+	tmp = hawk_rtx_setmapvalfld(rtx, map, key, klen, v);
+	hawk_rtx_refdownval (rtx, v);
+
+#if !defined(HAWK_OOCH_IS_BCH)
+	hawk_rtx_freemem (rtx, key);
+#endif
+	return tmp? 0: -1;
+}
+
+/*
+ * memc::mget(handle, keys) requests all the keys in an array or a map at
+ * once and returns a map of the keys found to their values. it returns
+ * nil on failure.
+ */
+static int fnc_mget (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	memc_list_t* memc_list;
+	memc_node_t* memc_node;
+	int take_rtx_err = 0;
+
+	hawk_val_t* a1;
+	hawk_val_t** kvals = HAWK_NULL;
+	const char** keys = HAWK_NULL;
+	size_t* key_lens = HAWK_NULL;
+	hawk_oow_t nkeys = 0, i;
+	hawk_val_t* map = HAWK_NULL;
+	memcached_result_st* result = HAWK_NULL;
+	hawk_val_t* retv;
+
+	memc_list = rtx_to_memc_list(rtx, fi);
+	memc_node = get_memc_list_node_with_arg(rtx, memc_list, hawk_rtx_getarg(rtx, 0));
+	if (memc_node)
+	{
+		hawk_oow_t capa;
+		memcached_return_t rc;
+		memcached_result_st* r;
+
+		ENSURE_CONNECTED (rtx, memc_list, memc_node);
+
+		a1 = hawk_rtx_getarg(rtx, 1);
+		switch (HAWK_RTX_GETVALTYPE(rtx, a1))
+		{
+			case HAWK_VAL_MAP:
+				capa = hawk_map_getsize(((hawk_val_map_t*)a1)->map);
+				break;
+			case HAWK_VAL_ARR:
+				capa = HAWK_ARR_TALLY(((hawk_val_arr_t*)a1)->arr);
+				break;
+			default:
+				capa = 1; /* a single key */
+				break;
+		}
+
+		map = hawk_rtx_makemapval(rtx);
+		if (!map)
+		{
+			take_rtx_err = 1;
+			goto done;
+		}
+		hawk_rtx_refupval (rtx, map);
+
+		if (capa <= 0) goto done; /* nothing to request */
+
+		kvals = (hawk_val_t**)hawk_rtx_callocmem(rtx, capa * (HAWK_SIZEOF(*kvals) + HAWK_SIZEOF(*keys) + HAWK_SIZEOF(*key_lens)));
+		if (!kvals)
+		{
+			take_rtx_err = 1;
+			goto done;
+		}
+		keys = (const char**)(kvals + capa);
+		key_lens = (size_t*)(keys + capa);
+
+		/* collect the keys. the values are the keys as in the array
+		 * produced by split() */
+		if (HAWK_RTX_GETVALTYPE(rtx, a1) == HAWK_VAL_MAP)
+		{
+			hawk_val_map_itr_t itr;
+			hawk_val_map_itr_t* iptr;
+
+			iptr = hawk_rtx_getfirstmapvalitr(rtx, a1, &itr);
+			while (iptr && nkeys < capa)
+			{
+				kvals[nkeys] = (hawk_val_t*)HAWK_VAL_MAP_ITR_VAL(iptr);
+				nkeys++;
+				iptr = hawk_rtx_getnextmapvalitr(rtx, a1, &itr);
+			}
+		}
+		else if (HAWK_RTX_GETVALTYPE(rtx, a1) == HAWK_VAL_ARR)
+		{
+			hawk_val_arr_itr_t itr;
+			hawk_val_arr_itr_t* iptr;
+
+			iptr = hawk_rtx_getfirstarrvalitr(rtx, a1, &itr);
+			while (iptr && nkeys < capa)
+			{
+				kvals[nkeys] = iptr->elem;
+				nkeys++;
+				iptr = hawk_rtx_getnextarrvalitr(rtx, a1, &itr);
+			}
+		}
+		else
+		{
+			kvals[nkeys++] = a1;
+		}
+
+		for (i = 0; i < nkeys; i++)
+		{
+			hawk_oow_t len;
+			keys[i] = hawk_rtx_getvalbcstr(rtx, kvals[i], &len);
+			if (!keys[i])
+			{
+				nkeys = i; /* free the keys converted so far */
+				take_rtx_err = 1;
+				goto done;
+			}
+			key_lens[i] = len;
+		}
+
+		/* a single round trip for all the keys */
+		rc = memcached_mget(memc_node->memc, keys, key_lens, nkeys);
+		if (rc != MEMCACHED_SUCCESS)
+		{
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("%hs"), memcached_strerror(memc_node->memc, rc));
+			goto oops;
+		}
+
+		result = memcached_result_create(memc_node->memc, HAWK_NULL);
+		if (!result)
+		{
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("unable to create result"));
+			goto oops;
+		}
+
+		while ((r = memcached_fetch_result(memc_node->memc, result, &rc)))
+		{
+			if (set_map_field_with_bchars(rtx, map,
+				memcached_result_key_value(r), memcached_result_key_length(r),
+				memcached_result_value(r), memcached_result_length(r)) <= -1)
+			{
+				/* keep fetching to drain the pending responses */
+				take_rtx_err = 1;
+			}
+		}
+		if (take_rtx_err) goto oops;
+		if (rc != MEMCACHED_END && rc != MEMCACHED_SUCCESS && rc != MEMCACHED_NOTFOUND)
+		{
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("%hs"), memcached_strerror(memc_node->memc, rc));
+			goto oops;
+		}
+	}
+
+done:
+	if (take_rtx_err) set_error_on_memc_list (rtx, memc_list, HAWK_NULL);
+	if (result) memcached_result_free (result);
+	for (i = 0; i < nkeys; i++) hawk_rtx_freevalbcstr (rtx, kvals[i], (hawk_bch_t*)keys[i]);
+	if (kvals) hawk_rtx_freemem (rtx, kvals);
+
+	if (map && !take_rtx_err)
+	{
+		hawk_rtx_setretval (rtx, map);
+		hawk_rtx_refdownval (rtx, map);
+		return 0;
+	}
+
+	retv = hawk_rtx_makenilval(rtx);
+	if (map) hawk_rtx_refdownval (rtx, map);
+	hawk_rtx_setretval (rtx, retv);
+	return 0;
+
+oops:
+	if (map)
+	{
+		hawk_rtx_refdownval (rtx, map);
+		map = HAWK_NULL;
+	}
+	goto done;
+}
+
+/*
+ * memc::mset(handle, map[, ttl[, flag[, noreply]]]) stores all the items of
+ * a map with the requests buffered and sent together. with noreply set, the
+ * server doesn't acknowledge the requests. it returns the number of items
+ * sent or -1 on failure.
+ */
+static int fnc_mset (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	memc_list_t* memc_list;
+	memc_node_t* memc_node;
+	hawk_int_t ret = -1;
+	int take_rtx_err = 0;
+	int behavior_changed = 0;
+	uint64_t old_buffered = 0, old_noreply = 0;
+
+	memc_list = rtx_to_memc_list(rtx, fi);
+	memc_node = get_memc_list_node_with_arg(rtx, memc_list, hawk_rtx_getarg(rtx, 0));
+	if (memc_node)
+	{
+		hawk_val_t* a1;
+		hawk_oow_t nargs;
+		hawk_int_t ttl = 0, flag = 0, noreply = 0, count = 0;
+		hawk_val_map_itr_t itr;
+		hawk_val_map_itr_t* iptr;
+		memcached_return_t rc;
+
+		ENSURE_CONNECTED (rtx, memc_list, memc_node);
+
+		a1 = hawk_rtx_getarg(rtx, 1);
+		if (HAWK_RTX_GETVALTYPE(rtx, a1) != HAWK_VAL_MAP)
+		{
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("items not a map"));
+			goto done;
+		}
+
+		nargs = hawk_rtx_getnargs(rtx);
+		if ((nargs >= 3 && hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 2), &ttl) <= -1) ||
+		    (nargs >= 4 && hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 3), &flag) <= -1) ||
+		    (nargs >= 5 && hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 4), &noreply) <= -1))
+		{
+			take_rtx_err = 1;
+			goto done;
+		}
+
+		old_buffered = memcached_behavior_get(memc_node->memc, MEMCACHED_BEHAVIOR_BUFFER_REQUESTS);
+		old_noreply = memcached_behavior_get(memc_node->memc, MEMCACHED_BEHAVIOR_NOREPLY);
+		memcached_behavior_set (memc_node->memc, MEMCACHED_BEHAVIOR_BUFFER_REQUESTS, 1);
+		if (noreply) memcached_behavior_set (memc_node->memc, MEMCACHED_BEHAVIOR_NOREPLY, 1);
+		behavior_changed = 1;
+
+		iptr = hawk_rtx_getfirstmapvalitr(rtx, a1, &itr);
+		while (iptr)
+		{
+			const hawk_oocs_t* k;
+			hawk_val_t* v;
+			hawk_bch_t* key;
+			hawk_bch_t* val;
+			hawk_oow_t key_len, val_len;
+
+			k = HAWK_VAL_MAP_ITR_KEY(iptr);
+			v = (hawk_val_t*)HAWK_VAL_MAP_ITR_VAL(iptr);
+
+		#if defined(HAWK_OOCH_IS_BCH)
+			key = (hawk_bch_t*)k->ptr;
+			key_len = k->len;
+		#else
+			key = hawk_rtx_duputobchars(rtx, k->ptr, k->len, &key_len);
+			if (!key)
+			{
+				take_rtx_err = 1;
+				goto done;
+			}
+		#endif
+
+			val = hawk_rtx_getvalbcstr(rtx, v, &val_len);
+			if (!val)
+			{
+			#if !defined(HAWK_OOCH_IS_BCH)
+				hawk_rtx_freemem (rtx, key);
+			#endif
+				take_rtx_err = 1;
+				goto done;
+			}
+
+			rc = memcached_set(memc_node->memc, key, key_len, val, val_len, ttl, flag);
+
+			hawk_rtx_freevalbcstr (rtx, v, val);
+		#if !defined(HAWK_OOCH_IS_BCH)
+			hawk_rtx_freemem (rtx, key);
+		#endif
+
+			if (rc != MEMCACHED_SUCCESS && rc != MEMCACHED_BUFFERED)
+			{
+				set_error_on_memc_list (rtx, memc_list, HAWK_T("%hs"), memcached_strerror(memc_node->memc, rc));
+				goto done;
+			}
+
+			count++;
+			iptr = hawk_rtx_getnextmapvalitr(rtx, a1, &itr);
+		}
+
+		rc = memcached_flush_buffers(memc_node->memc);
+		if (rc != MEMCACHED_SUCCESS)
+		{
+			set_error_on_memc_list (rtx, memc_list, HAWK_T("%hs"), memcached_strerror(memc_node->memc, rc));
+			goto done;
+		}
+
+		ret = count;
+	}
+
+done:
+	if (behavior_changed)
+	{
+		/* flush whatever is left before restoring the behaviors */
+		memcached_flush_buffers (memc_node->memc);
+		memcached_behavior_set (memc_node->memc, MEMCACHED_BEHAVIOR_NOREPLY, old_noreply);
+		memcached_behavior_set (memc_node->memc, MEMCACHED_BEHAVIOR_BUFFER_REQUESTS, old_buffered);
+	}
+	if (take_rtx_err) set_error_on_memc_list (rtx, memc_list, HAWK_NULL);
+
+	hawk_rtx_setretval (rtx, hawk_rtx_makeintval(rtx, ret));
+	return 0;
+}
+
 /* ------------------------------------------------------------------------ */
 
 static hawk_mod_fnc_tab_t fnctab[] =
 {
 	/* keep this table sorted for binary search in query(). */
 	{ HAWK_T("close"),   { { 1, 1, HAWK_NULL }, fnc_close,   0 } },
-	{ HAWK_T("connect"), { { 1, 1, HAWK_NULL }, fnc_connect, 0 } },
+	{ HAWK_T("connect"), { { 2, 2, HAWK_NULL }, fnc_connect, 0 } },
 	{ HAWK_T("errmsg"),  { { 0, 0, HAWK_NULL }, fnc_errmsg,  0 } },
 	{ HAWK_T("get"),     { { 2, 3, HAWK_NULL }, fnc_get,     0 } },
+	{ HAWK_T("mget"),    { { 2, 2, HAWK_NULL }, fnc_mget,    0 } },
+	{ HAWK_T("mset"),    { { 2, 5, HAWK_NULL }, fnc_mset,    0 } },
 	{ HAWK_T("new"),     { { 0, 0, HAWK_NULL }, fnc_new,     0 } },
 	{ HAWK_T("set"),     { { 4, 5, HAWK_NULL }, fnc_set,     0 } },
 };
@@ -30,7 +30,7 @@
 
 #include "../lib/hawk-prv.h"
 
-#define __IDMAP_NODE_T_DATA  sqlite3* db; int connect_ever_attempted;
+#define __IDMAP_NODE_T_DATA  sqlite3* db; int connect_ever_attempted; hawk_rbt_t* stmt_cache;
 #define __IDMAP_LIST_T_DATA  hawk_ooch_t errmsg[256];
 #define __IDMAP_LIST_T sql_list_t
 #define __IDMAP_NODE_T sql_node_t
@@ -49,7 +49,7 @@
 #undef __MAKE_IDMAP_NODE
 #undef __FREE_IDMAP_NODE
 
-#define __IDMAP_NODE_T_DATA  sqlite3_stmt* stmt; sqlite3* db; int col_count;
+#define __IDMAP_NODE_T_DATA  sqlite3_stmt* stmt; sqlite3* db; int col_count; int at_end; sql_node_t* cache_owner; hawk_rbt_pair_t* cache_pair;
 #define __IDMAP_LIST_T_DATA  /* none */
 #define __IDMAP_LIST_T stmt_list_t
 #define __IDMAP_NODE_T stmt_node_t
@@ -84,12 +84,25 @@ static sql_node_t* new_sql_node (hawk_rtx_t* rtx, sql_list_t* sql_list)
 
 	sql_node->db = HAWK_NULL;
 	sql_node->connect_ever_attempted = 0;
+	sql_node->stmt_cache = HAWK_NULL;
 	return sql_node;
 }
 
+static void close_stmt_cache (sql_node_t* sql_node)
+{
+	/* the statements in the cache must have been finalized by now.
+	 * this only destroys the table mapping the sql text to them */
+	if (sql_node->stmt_cache)
+	{
+		hawk_rbt_close(sql_node->stmt_cache);
+		sql_node->stmt_cache = HAWK_NULL;
+	}
+}
+
 static void free_sql_node (hawk_rtx_t* rtx, sql_list_t* sql_list, sql_node_t* sql_node)
 {
 	HAWK_ASSERT(sql_node->db != HAWK_NULL);
+	close_stmt_cache(sql_node);
 	sqlite3_close(sql_node->db);
 	sql_node->db = HAWK_NULL;
 	__free_sql_node(rtx, sql_list, sql_node);
@@ -105,12 +118,22 @@ static stmt_node_t* new_stmt_node (hawk_rtx_t* rtx, stmt_list_t* stmt_list, sqli
 	stmt_node->stmt = stmt;
 	stmt_node->db = db;
 	stmt_node->col_count = sqlite3_column_count(stmt);
+	stmt_node->at_end = 0;
+	stmt_node->cache_owner = HAWK_NULL;
+	stmt_node->cache_pair = HAWK_NULL;
 	return stmt_node;
 }
 
 static void free_stmt_node (hawk_rtx_t* rtx, stmt_list_t* stmt_list, stmt_node_t* stmt_node)
 {
 	HAWK_ASSERT(stmt_node->stmt != HAWK_NULL);
+	if (stmt_node->cache_owner)
+	{
+		/* drop the cache entry of a statement created by prepare_cached() */
+		hawk_rbt_delete(stmt_node->cache_owner->stmt_cache, HAWK_RBT_KPTR(stmt_node->cache_pair), HAWK_RBT_KLEN(stmt_node->cache_pair));
+		stmt_node->cache_owner = HAWK_NULL;
+		stmt_node->cache_pair = HAWK_NULL;
+	}
 	sqlite3_finalize(stmt_node->stmt);
 	stmt_node->stmt = HAWK_NULL;
 	stmt_node->db = HAWK_NULL;
@@ -257,6 +280,20 @@ static int fnc_close (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	sql_node = get_sql_list_node_with_arg(rtx, sql_list, hawk_rtx_getarg(rtx, 0));
 	if (sql_node)
 	{
+		if (sql_node->stmt_cache)
+		{
+			/* the cached statements are owned by the connection */
+			stmt_list_t* stmt_list;
+			stmt_node_t* stmt_node, * next;
+
+			stmt_list = rtx_to_stmt_list(rtx, fi);
+			for (stmt_node = stmt_list->used.next; stmt_node != (stmt_node_t*)&stmt_list->used; stmt_node = next)
+			{
+				next = stmt_node->next;
+				if (stmt_node->cache_owner == sql_node) free_stmt_node(rtx, stmt_list, stmt_node);
+			}
+		}
+
 		free_sql_node(rtx, sql_list, sql_node);
 		ret = 0;
 	}
@@ -452,13 +489,58 @@ static int bind_blob (hawk_rtx_t* rtx, sql_list_t* sql_list, stmt_node_t* stmt_n
 	return 0;
 }
 
+static int bind_value (hawk_rtx_t* rtx, sql_list_t* sql_list, stmt_node_t* stmt_node, int index, hawk_val_t* val)
+{
+	switch (HAWK_RTX_GETVALTYPE(rtx, val))
+	{
+		case HAWK_VAL_INT:
+		{
+			hawk_int_t iv;
+			if (hawk_rtx_valtoint(rtx, val, &iv) <= -1) return -1;
+			if (sqlite3_bind_int64(stmt_node->stmt, index, (sqlite3_int64)iv) != SQLITE_OK)
+			{
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
+				return -1;
+			}
+			return 0;
+		}
+
+		case HAWK_VAL_FLT:
+		{
+			hawk_flt_t fv;
+			if (hawk_rtx_valtoflt(rtx, val, &fv) <= -1) return -1;
+			if (sqlite3_bind_double(stmt_node->stmt, index, (double)fv) != SQLITE_OK)
+			{
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
+				return -1;
+			}
+			return 0;
+		}
+
+		case HAWK_VAL_BCHR:
+		case HAWK_VAL_MBS:
+		case HAWK_VAL_BOB:
+			return bind_blob(rtx, sql_list, stmt_node, index, val);
+
+		case HAWK_VAL_NIL:
+			if (sqlite3_bind_null(stmt_node->stmt, index) != SQLITE_OK)
+			{
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
+				return -1;
+			}
+			return 0;
+
+		default:
+			return bind_text(rtx, sql_list, stmt_node, index, val);
+	}
+}
+
 static int fnc_bind (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	sql_list_t* sql_list;
 	stmt_list_t* stmt_list;
 	stmt_node_t* stmt_node;
 	hawk_val_t* a1;
-	hawk_val_t* a2;
 	hawk_int_t index;
 	int ret = -1;
 
@@ -474,51 +556,7 @@ static int fnc_bind (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 			goto done;
 		}
 
-		a2 = hawk_rtx_getarg(rtx, 2);
-		switch (HAWK_RTX_GETVALTYPE(rtx, a2))
-		{
-			case HAWK_VAL_INT:
-			{
-				hawk_int_t iv;
-				if (hawk_rtx_valtoint(rtx, a2, &iv) <= -1) goto done;
-				if (sqlite3_bind_int64(stmt_node->stmt, (int)index, (sqlite3_int64)iv) != SQLITE_OK)
-				{
-					set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
-					goto done;
-				}
-				break;
-			}
-
-			case HAWK_VAL_FLT:
-			{
-				hawk_flt_t fv;
-				if (hawk_rtx_valtoflt(rtx, a2, &fv) <= -1) goto done;
-				if (sqlite3_bind_double(stmt_node->stmt, (int)index, (double)fv) != SQLITE_OK)
-				{
-					set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
-					goto done;
-				}
-				break;
-			}
-
-			case HAWK_VAL_BCHR:
-			case HAWK_VAL_MBS:
-			case HAWK_VAL_BOB:
-				if (bind_blob(rtx, sql_list, stmt_node, (int)index, a2) <= -1) goto done;
-				break;
-
-			case HAWK_VAL_NIL:
-				if (sqlite3_bind_null(stmt_node->stmt, (int)index) != SQLITE_OK)
-				{
-					set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
-					goto done;
-				}
-				break;
-
-			default:
-				if (bind_text(rtx, sql_list, stmt_node, (int)index, a2) <= -1) goto done;
-				break;
-		}
+		if (bind_value(rtx, sql_list, stmt_node, (int)index, hawk_rtx_getarg(rtx, 2)) <= -1) goto done;
 
 		ret = 0;
 	}
@@ -803,6 +841,104 @@ done:
 	return 0;
 }
 
+/*
+ * prepare_cached() returns the statement prepared for the same sql text on
+ * the same connection if there is one. it's reset with the bindings cleared
+ * before being returned. the connection owns the cached statements and
+ * finalizes them when closed though finalize() may drop one earlier.
+ */
+static int fnc_prepare_cached (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sql_list_t* sql_list;
+	stmt_list_t* stmt_list;
+	sql_node_t* sql_node;
+	hawk_val_t* a1;
+	hawk_bch_t* sql = HAWK_NULL;
+	hawk_oow_t sql_len;
+	int ret = -1;
+	int take_rtx_err = 0;
+	sqlite3_stmt* stmt = HAWK_NULL;
+	int rc;
+
+	sql_list = rtx_to_sql_list(rtx, fi);
+	stmt_list = rtx_to_stmt_list(rtx, fi);
+	sql_node = get_sql_list_node_with_arg(rtx, sql_list, hawk_rtx_getarg(rtx, 0));
+	if (sql_node)
+	{
+		stmt_node_t* stmt_node;
+		hawk_rbt_pair_t* pair;
+
+		ENSURE_CONNECT_EVER_ATTEMPTED(rtx, sql_list, sql_node);
+
+		a1 = hawk_rtx_getarg(rtx, 1);
+		sql = hawk_rtx_getvalbcstr(rtx, a1, &sql_len);
+		if (!sql)
+		{
+			take_rtx_err = 1;
+			goto done;
+		}
+
+		if (sql_node->stmt_cache && (pair = hawk_rbt_search(sql_node->stmt_cache, sql, sql_len)))
+		{
+			stmt_node = *(stmt_node_t**)HAWK_RBT_VPTR(pair);
+			HAWK_ASSERT(stmt_node->cache_owner == sql_node);
+
+			/* sqlite3_reset() returns the error of the last step, if any.
+			 * it doesn't affect the reuse of the statement */
+			sqlite3_reset(stmt_node->stmt);
+			sqlite3_clear_bindings(stmt_node->stmt);
+			stmt_node->at_end = 0;
+			ret = stmt_node->id;
+			goto done;
+		}
+
+		if (!sql_node->stmt_cache)
+		{
+			sql_node->stmt_cache = hawk_rbt_open(hawk_rtx_getgem(rtx), 0, 1, 1);
+			if (HAWK_UNLIKELY(!sql_node->stmt_cache))
+			{
+				take_rtx_err = 1;
+				goto done;
+			}
+			hawk_rbt_setstyle(sql_node->stmt_cache, hawk_get_rbt_style(HAWK_RBT_STYLE_INLINE_COPIERS));
+		}
+
+		rc = sqlite3_prepare_v2(sql_node->db, sql, (int)sql_len, &stmt, HAWK_NULL);
+		if (rc != SQLITE_OK)
+		{
+			set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(sql_node->db));
+			goto done;
+		}
+
+		stmt_node = new_stmt_node(rtx, stmt_list, stmt, sql_node->db);
+		if (!stmt_node)
+		{
+			sqlite3_finalize(stmt);
+			take_rtx_err = 1;
+			goto done;
+		}
+
+		pair = hawk_rbt_insert(sql_node->stmt_cache, sql, sql_len, &stmt_node, HAWK_SIZEOF(stmt_node));
+		if (HAWK_UNLIKELY(!pair))
+		{
+			free_stmt_node(rtx, stmt_list, stmt_node);
+			take_rtx_err = 1;
+			goto done;
+		}
+		stmt_node->cache_owner = sql_node;
+		stmt_node->cache_pair = pair;
+
+		ret = stmt_node->id;
+	}
+
+done:
+	if (take_rtx_err) set_error_on_sql_list(rtx, sql_list, HAWK_NULL);
+	if (sql) hawk_rtx_freevalbcstr(rtx, a1, sql);
+
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval(rtx, ret));
+	return 0;
+}
+
 static int fnc_finalize (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	sql_list_t* sql_list;
@@ -837,6 +973,7 @@ static int fnc_reset (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	if (stmt_node)
 	{
 		rc = sqlite3_reset(stmt_node->stmt);
+		stmt_node->at_end = 0;
 		if (rc != SQLITE_OK)
 		{
 			set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
@@ -909,6 +1046,83 @@ static int fnc_column_name (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 #define FETCH_ROW_ARRAY (1)
 #define FETCH_ROW_MAP (2)
 
+static hawk_val_t* make_row_val (hawk_rtx_t* rtx, stmt_node_t* stmt_node, hawk_int_t mode)
+{
+	hawk_val_t* row_map;
+	hawk_val_t* row_val, * tmp;
+	int i;
+
+	row_map = (mode == FETCH_ROW_MAP? hawk_rtx_makemapval(rtx): hawk_rtx_makearrval(rtx, stmt_node->col_count));
+	if (HAWK_UNLIKELY(!row_map)) return HAWK_NULL;
+
+	hawk_rtx_refupval(rtx, row_map);
+
+	for (i = 0; i < stmt_node->col_count; )
+	{
+		int col_type;
+
+		col_type = sqlite3_column_type(stmt_node->stmt, i);
+		switch (col_type)
+		{
+			case SQLITE_INTEGER:
+				row_val = hawk_rtx_makeintval(rtx, (hawk_int_t)sqlite3_column_int64(stmt_node->stmt, i));
+				break;
+			case SQLITE_FLOAT:
+				row_val = hawk_rtx_makefltval(rtx, (hawk_flt_t)sqlite3_column_double(stmt_node->stmt, i));
+				break;
+			case SQLITE_BLOB:
+			{
+				const void* blob = sqlite3_column_blob(stmt_node->stmt, i);
+				int blen = sqlite3_column_bytes(stmt_node->stmt, i);
+				row_val = hawk_rtx_makembsvalwithbchars(rtx, (const hawk_bch_t*)blob, (hawk_oow_t)blen);
+				break;
+			}
+			case SQLITE_TEXT:
+			{
+				const hawk_bch_t* text = (const hawk_bch_t*)sqlite3_column_text(stmt_node->stmt, i);
+				int tlen = sqlite3_column_bytes(stmt_node->stmt, i);
+				row_val = hawk_rtx_makestrvalwithbchars(rtx, text, (hawk_oow_t)tlen);
+				break;
+			}
+			case SQLITE_NULL:
+			default:
+				row_val = hawk_rtx_makenilval(rtx);
+				break;
+		}
+
+		if (HAWK_UNLIKELY(!row_val)) goto oops;
+
+		++i;
+
+		if (mode == FETCH_ROW_MAP)
+		{
+			hawk_ooch_t key_buf[HAWK_SIZEOF(hawk_int_t) * 8 + 2];
+			hawk_oow_t key_len;
+
+			key_len = hawk_int_to_oocstr(i, 10, HAWK_NULL, key_buf, HAWK_COUNTOF(key_buf));
+			HAWK_ASSERT(key_len != (hawk_oow_t)-1);
+
+			hawk_rtx_refupval(rtx, row_val);
+			tmp = hawk_rtx_setmapvalfld(rtx, row_map, key_buf, key_len, row_val);
+			hawk_rtx_refdownval(rtx, row_val);
+		}
+		else
+		{
+			hawk_rtx_refupval(rtx, row_val);
+			tmp = hawk_rtx_setarrvalfld(rtx, row_map, i, row_val);
+			hawk_rtx_refdownval(rtx, row_val);
+		}
+		if (HAWK_UNLIKELY(!tmp)) goto oops;
+	}
+
+	hawk_rtx_refdownval_nofree(rtx, row_map);
+	return row_map;
+
+oops:
+	hawk_rtx_refdownval(rtx, row_map);
+	return HAWK_NULL;
+}
+
 static int fnc_fetch_row (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 {
 	sql_list_t* sql_list;
@@ -926,11 +1140,17 @@ static int fnc_fetch_row (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 	if (stmt_node)
 	{
 		hawk_oow_t nargs;
-		hawk_val_t* row_val, * tmp;
-		int i;
 
 		nargs = hawk_rtx_getnargs(rtx);
 
+		if (stmt_node->at_end)
+		{
+			/* fetch_rows() has seen the end already */
+			stmt_node->at_end = 0;
+			ret = 0;
+			goto done;
+		}
+
 		rc = sqlite3_step(stmt_node->stmt);
 		if (rc == SQLITE_DONE)
 		{
@@ -952,7 +1172,7 @@ static int fnc_fetch_row (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 			}
 		}
 
-		row_map = (mode == FETCH_ROW_MAP? hawk_rtx_makemapval(rtx): hawk_rtx_makearrval(rtx, -1));
+		row_map = make_row_val(rtx, stmt_node, mode);
 		if (HAWK_UNLIKELY(!row_map))
 		{
 			take_rtx_err = 1;
@@ -961,86 +1181,298 @@ static int fnc_fetch_row (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
 
 		hawk_rtx_refupval(rtx, row_map);
 
-		for (i = 0; i < stmt_node->col_count; )
+		if (hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 1), row_map) <= -1)
 		{
-			int col_type;
+			take_rtx_err = 1;
+			goto done;
+		}
 
-			col_type = sqlite3_column_type(stmt_node->stmt, i);
-			switch (col_type)
-			{
-				case SQLITE_INTEGER:
-					row_val = hawk_rtx_makeintval(rtx, (hawk_int_t)sqlite3_column_int64(stmt_node->stmt, i));
-					break;
-				case SQLITE_FLOAT:
-					row_val = hawk_rtx_makefltval(rtx, (hawk_flt_t)sqlite3_column_double(stmt_node->stmt, i));
-					break;
-				case SQLITE_BLOB:
-				{
-					const void* blob = sqlite3_column_blob(stmt_node->stmt, i);
-					int blen = sqlite3_column_bytes(stmt_node->stmt, i);
-					row_val = hawk_rtx_makembsvalwithbchars(rtx, (const hawk_bch_t*)blob, (hawk_oow_t)blen);
-					break;
-				}
-				case SQLITE_TEXT:
-				{
-					const hawk_bch_t* text = (const hawk_bch_t*)sqlite3_column_text(stmt_node->stmt, i);
-					int tlen = sqlite3_column_bytes(stmt_node->stmt, i);
-					row_val = hawk_rtx_makestrvalwithbchars(rtx, text, (hawk_oow_t)tlen);
-					break;
-				}
-				case SQLITE_NULL:
-				default:
-					row_val = hawk_rtx_makenilval(rtx);
-					break;
-			}
+		hawk_rtx_refdownval(rtx, row_map);
+		row_map = HAWK_NULL;
+		ret = 1;
+	}
+
+done:
+	if (take_rtx_err) set_error_on_sql_list(rtx, sql_list, HAWK_NULL);
+	if (row_map) hawk_rtx_refdownval(rtx, row_map);
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval(rtx, ret));
+	return 0;
+}
+
+/*
+ * fetch_rows(stmt, rows, max[, mode]) steps the statement up to max times
+ * and stores the rows fetched in an array. it returns the number of rows
+ * fetched, which is 0 when no more rows are available, or -1 on failure.
+ */
+static int fnc_fetch_rows (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sql_list_t* sql_list;
+	stmt_list_t* stmt_list;
+	stmt_node_t* stmt_node;
+	hawk_int_t ret = -1;
+	int take_rtx_err = 0;
+	hawk_val_t* rows = HAWK_NULL;
+	int rc;
+	hawk_int_t mode = FETCH_ROW_MAP;
+
+	sql_list = rtx_to_sql_list(rtx, fi);
+	stmt_list = rtx_to_stmt_list(rtx, fi);
+	stmt_node = get_stmt_list_node_with_arg(rtx, sql_list, stmt_list, hawk_rtx_getarg(rtx, 0));
+	if (stmt_node)
+	{
+		hawk_int_t max, count = 0;
+
+		if (hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 2), &max) <= -1 || max < 0)
+		{
+			set_error_on_sql_list(rtx, sql_list, HAWK_T("invalid row count"));
+			goto done;
+		}
 
-			if (HAWK_UNLIKELY(!row_val))
+		if (hawk_rtx_getnargs(rtx) >= 4)
+		{
+			if (hawk_rtx_valtoint(rtx, hawk_rtx_getarg(rtx, 3), &mode) <= -1)
 			{
-				take_rtx_err = 1;
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("illegal mode"));
 				goto done;
 			}
+		}
 
-			++i;
+		if (stmt_node->at_end)
+		{
+			/* the previous batch has seen the end. sqlite3_step() would
+			 * restart the statement from the beginning if called again */
+			stmt_node->at_end = 0;
+			max = 0;
+		}
 
-			if (mode == FETCH_ROW_MAP)
-			{
-				hawk_ooch_t key_buf[HAWK_SIZEOF(hawk_int_t) * 8 + 2];
-				hawk_oow_t key_len;
+		/* preallocate for a full batch. cap the hint for a huge max value */
+		rows = hawk_rtx_makearrval(rtx, (max > 1024? 1024: max));
+		if (HAWK_UNLIKELY(!rows))
+		{
+			take_rtx_err = 1;
+			goto done;
+		}
+		hawk_rtx_refupval(rtx, rows);
 
-				key_len = hawk_int_to_oocstr(i, 10, HAWK_NULL, key_buf, HAWK_COUNTOF(key_buf));
-				HAWK_ASSERT(key_len != (hawk_oow_t)-1);
+		while (count < max)
+		{
+			hawk_val_t* row;
 
-				hawk_rtx_refupval(rtx, row_val);
-				tmp = hawk_rtx_setmapvalfld(rtx, row_map, key_buf, key_len, row_val);
-				hawk_rtx_refdownval(rtx, row_val);
+			rc = sqlite3_step(stmt_node->stmt);
+			if (rc == SQLITE_DONE)
+			{
+				stmt_node->at_end = (count > 0);
+				break;
 			}
-			else
+			if (rc != SQLITE_ROW)
 			{
-				hawk_rtx_refupval(rtx, row_val);
-				tmp = hawk_rtx_setarrvalfld(rtx, row_map, i, row_val);
-				hawk_rtx_refdownval(rtx, row_val);
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
+				goto done;
 			}
-			if (HAWK_UNLIKELY(!tmp))
+
+			row = make_row_val(rtx, stmt_node, mode);
+			if (HAWK_UNLIKELY(!row))
 			{
 				take_rtx_err = 1;
 				goto done;
 			}
+
+			hawk_rtx_refupval(rtx, row);
+			if (HAWK_UNLIKELY(!hawk_rtx_setarrvalfld(rtx, rows, ++count, row)))
+			{
+				hawk_rtx_refdownval(rtx, row);
+				take_rtx_err = 1;
+				goto done;
+			}
+			hawk_rtx_refdownval(rtx, row);
 		}
 
-		if (hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 1), row_map) <= -1)
+		if (hawk_rtx_setrefval(rtx, (hawk_val_ref_t*)hawk_rtx_getarg(rtx, 1), rows) <= -1)
 		{
 			take_rtx_err = 1;
 			goto done;
 		}
 
-		hawk_rtx_refdownval(rtx, row_map);
-		row_map = HAWK_NULL;
-		ret = 1;
+		ret = count;
 	}
 
 done:
 	if (take_rtx_err) set_error_on_sql_list(rtx, sql_list, HAWK_NULL);
-	if (row_map) hawk_rtx_refdownval(rtx, row_map);
+	if (rows) hawk_rtx_refdownval(rtx, rows);
+	hawk_rtx_setretval(rtx, hawk_rtx_makeintval(rtx, ret));
+	return 0;
+}
+
+static int bind_row (hawk_rtx_t* rtx, sql_list_t* sql_list, stmt_node_t* stmt_node, hawk_val_t* row)
+{
+	switch (HAWK_RTX_GETVALTYPE(rtx, row))
+	{
+		case HAWK_VAL_ARR:
+		{
+			hawk_val_arr_itr_t itr;
+			hawk_val_arr_itr_t* iptr;
+
+			iptr = hawk_rtx_getfirstarrvalitr(rtx, row, &itr);
+			while (iptr)
+			{
+				if (bind_value(rtx, sql_list, stmt_node, (int)iptr->itr.idx, iptr->elem) <= -1) return -1;
+				iptr = hawk_rtx_getnextarrvalitr(rtx, row, &itr);
+			}
+			return 0;
+		}
+
+		case HAWK_VAL_MAP:
+		{
+			hawk_val_map_itr_t itr;
+			hawk_val_map_itr_t* iptr;
+
+			/* the keys are the parameter indices as in the array produced by split() */
+			iptr = hawk_rtx_getfirstmapvalitr(rtx, row, &itr);
+			while (iptr)
+			{
+				const hawk_oocs_t* key;
+				const hawk_ooch_t* end;
+				hawk_int_t index;
+
+				key = HAWK_VAL_MAP_ITR_KEY(iptr);
+				index = hawk_oochars_to_int(key->ptr, key->len, HAWK_OOCHARS_TO_INT_MAKE_OPTION(0, 0, 10), &end, HAWK_NULL);
+				if (end != key->ptr + key->len || index <= 0 || index > HAWK_TYPE_MAX(int))
+				{
+					set_error_on_sql_list(rtx, sql_list, HAWK_T("invalid bind index - %.*js"), (int)key->len, key->ptr);
+					return -1;
+				}
+				if (bind_value(rtx, sql_list, stmt_node, (int)index, (hawk_val_t*)HAWK_VAL_MAP_ITR_VAL(iptr)) <= -1) return -1;
+				iptr = hawk_rtx_getnextmapvalitr(rtx, row, &itr);
+			}
+			return 0;
+		}
+
+		default:
+			/* a scalar row binds to the first parameter */
+			return bind_value(rtx, sql_list, stmt_node, 1, row);
+	}
+}
+
+static int exec_row (hawk_rtx_t* rtx, sql_list_t* sql_list, stmt_node_t* stmt_node, hawk_val_t* row)
+{
+	int rc;
+
+	sqlite3_reset(stmt_node->stmt);
+	sqlite3_clear_bindings(stmt_node->stmt);
+	stmt_node->at_end = 0;
+	if (bind_row(rtx, sql_list, stmt_node, row) <= -1) return -1;
+
+	/* step over the result rows, if any, until done */
+	while ((rc = sqlite3_step(stmt_node->stmt)) == SQLITE_ROW) /* nothing */;
+	if (rc != SQLITE_DONE)
+	{
+		set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), sqlite3_errmsg(stmt_node->db));
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * exec_many(stmt, rows) binds each row in an array of rows to the statement
+ * and executes it. it begins a transaction for the whole batch unless one
+ * is already active so that the rows are either all stored or none of them.
+ * it returns the number of rows executed or -1 on failure.
+ */
+static int fnc_exec_many (hawk_rtx_t* rtx, const hawk_fnc_info_t* fi)
+{
+	sql_list_t* sql_list;
+	stmt_list_t* stmt_list;
+	stmt_node_t* stmt_node;
+	hawk_int_t ret = -1;
+	int take_rtx_err = 0;
+	int in_txn = 0;
+
+	sql_list = rtx_to_sql_list(rtx, fi);
+	stmt_list = rtx_to_stmt_list(rtx, fi);
+	stmt_node = get_stmt_list_node_with_arg(rtx, sql_list, stmt_list, hawk_rtx_getarg(rtx, 0));
+	if (stmt_node)
+	{
+		hawk_val_t* rows;
+		hawk_int_t count = 0;
+		char* err = HAWK_NULL;
+
+		if (sqlite3_get_autocommit(stmt_node->db))
+		{
+			if (sqlite3_exec(stmt_node->db, "BEGIN", HAWK_NULL, HAWK_NULL, &err) != SQLITE_OK)
+			{
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), (err? err: sqlite3_errmsg(stmt_node->db)));
+				if (err) sqlite3_free(err);
+				goto done;
+			}
+			in_txn = 1;
+		}
+
+		rows = hawk_rtx_getarg(rtx, 1);
+		switch (HAWK_RTX_GETVALTYPE(rtx, rows))
+		{
+			case HAWK_VAL_NIL:
+				break;
+
+			case HAWK_VAL_ARR:
+			{
+				hawk_val_arr_itr_t itr;
+				hawk_val_arr_itr_t* iptr;
+
+				iptr = hawk_rtx_getfirstarrvalitr(rtx, rows, &itr);
+				while (iptr)
+				{
+					if (exec_row(rtx, sql_list, stmt_node, iptr->elem) <= -1) goto done;
+					count++;
+					iptr = hawk_rtx_getnextarrvalitr(rtx, rows, &itr);
+				}
+				break;
+			}
+
+			case HAWK_VAL_MAP:
+			{
+				hawk_val_map_itr_t itr;
+				hawk_val_map_itr_t* iptr;
+
+				iptr = hawk_rtx_getfirstmapvalitr(rtx, rows, &itr);
+				while (iptr)
+				{
+					if (exec_row(rtx, sql_list, stmt_node, (hawk_val_t*)HAWK_VAL_MAP_ITR_VAL(iptr)) <= -1) goto done;
+					count++;
+					iptr = hawk_rtx_getnextmapvalitr(rtx, rows, &itr);
+				}
+				break;
+			}
+
+			default:
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("rows not an array"));
+				goto done;
+		}
+
+		sqlite3_reset(stmt_node->stmt);
+
+		if (in_txn)
+		{
+			in_txn = 0;
+			if (sqlite3_exec(stmt_node->db, "COMMIT", HAWK_NULL, HAWK_NULL, &err) != SQLITE_OK)
+			{
+				set_error_on_sql_list(rtx, sql_list, HAWK_T("%hs"), (err? err: sqlite3_errmsg(stmt_node->db)));
+				if (err) sqlite3_free(err);
+				sqlite3_exec(stmt_node->db, "ROLLBACK", HAWK_NULL, HAWK_NULL, HAWK_NULL);
+				goto done;
+			}
+		}
+
+		ret = count;
+	}
+
+done:
+	if (take_rtx_err) set_error_on_sql_list(rtx, sql_list, HAWK_NULL);
+	if (in_txn)
+	{
+		sqlite3_reset(stmt_node->stmt);
+		sqlite3_exec(stmt_node->db, "ROLLBACK", HAWK_NULL, HAWK_NULL, HAWK_NULL);
+	}
 	hawk_rtx_setretval(rtx, hawk_rtx_makeintval(rtx, ret));
 	return 0;
 }
@@ -1114,11 +1546,14 @@ static hawk_mod_fnc_tab_t fnctab[] =
 	{ HAWK_T("errmsg"),           { { 0, 0, HAWK_NULL },     fnc_errmsg,           0 } },
 	{ HAWK_T("escape_string"),    { { 3, 3, HAWK_T("vvr") }, fnc_escape_string,    0 } },
 	{ HAWK_T("exec"),             { { 2, 2, HAWK_NULL },     fnc_exec,             0 } },
+	{ HAWK_T("exec_many"),        { { 2, 2, HAWK_NULL },     fnc_exec_many,        0 } },
 	{ HAWK_T("fetch_row"),        { { 2, 3, HAWK_T("vrv") }, fnc_fetch_row,        0 } },
+	{ HAWK_T("fetch_rows"),       { { 3, 4, HAWK_T("vrvv") },fnc_fetch_rows,       0 } },
 	{ HAWK_T("finalize"),         { { 1, 1, HAWK_NULL },     fnc_finalize,         0 } },
 	{ HAWK_T("last_insert_rowid"),{ { 1, 1, HAWK_NULL },     fnc_last_insert_rowid,0 } },
 	{ HAWK_T("open"),             { { 0, 0, HAWK_NULL },     fnc_open,             0 } },
 	{ HAWK_T("prepare"),          { { 2, 2, HAWK_NULL },     fnc_prepare,          0 } },
+	{ HAWK_T("prepare_cached"),   { { 2, 2, HAWK_NULL },     fnc_prepare_cached,   0 } },
 	{ HAWK_T("reset"),            { { 1, 1, HAWK_NULL },     fnc_reset,            0 } }
 };
 
@@ -1177,6 +1612,11 @@ static void fini (hawk_mod_t* mod, hawk_rtx_t* rtx)
 		data = (rtx_data_t*)HAWK_RBT_VPTR(pair);
 
 		__fini_stmt_list(rtx, &data->stmt_list);
+		{
+			sql_node_t* sql_node;
+			for (sql_node = data->sql_list.used.next; sql_node != (sql_node_t*)&data->sql_list.used; sql_node = sql_node->next)
+				close_stmt_cache(sql_node);
+		}
 		__fini_sql_list(rtx, &data->sql_list);
 
 		hawk_rbt_delete(rbt, &rtx, HAWK_SIZEOF(rtx));
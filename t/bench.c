@@ -0,0 +1,382 @@
+/*
+ * benchmarks run by 'make bench'.
+ *
+ * the program generates a data file from a fixed seed so that every run
+ * works on the same input and prints one JSON object per benchmark to the
+ * standard output. the figures of the fastest of the repeated runs are
+ * reported so that successive versions can be compared line by line.
+ *
+ *   bench [-n records] [-r repeat] [-d datafile] [name ...]
+ */
+
+#include <hawk.h>
+#include <hawk-sed.h>
+#include <hawk-cut.h>
+#include <hawk-utl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(HAVE_CLOCK_GETTIME)
+#	include <time.h>
+#endif
+
+typedef struct bench_t bench_t;
+typedef int (*bench_run_t) (const bench_t* b, double* secs, hawk_oow_t* recs, hawk_oow_t* bytes);
+
+struct bench_t
+{
+	const hawk_bch_t* name;
+	bench_run_t run;
+	const hawk_bch_t* script; /* hawk program, sed script or cut selector */
+};
+
+static const hawk_bch_t* data_file = "bench.dat";
+static hawk_oow_t data_recs = 200000;
+static hawk_oow_t data_bytes = 0;
+
+/* ------------------------------------------------------------------------ */
+
+static double get_secs (void)
+{
+	hawk_ntime_t t;
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+	hawk_get_ntime(&t);
+	return (double)t.sec + (double)t.nsec / 1e9;
+}
+
+static hawk_uint32_t next_rand (hawk_uint32_t* seed)
+{
+	/* a fixed generator instead of rand() to produce the same data everywhere */
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) & 0xFFFFFF;
+}
+
+static int make_data (void)
+{
+	static const hawk_bch_t* words[] =
+	{
+		"alpha", "bravo", "charlie", "delta", "echo", "foxtrot",
+		"golf", "hotel", "india", "juliet", "kilo", "lima"
+	};
+	FILE* fp;
+	hawk_uint32_t seed = 20061225;
+	hawk_oow_t i;
+	int n;
+
+	fp = fopen(data_file, "wb");
+	if (!fp)
+	{
+		fprintf(stderr, "cannot create %s\n", data_file);
+		return -1;
+	}
+
+	data_bytes = 0;
+	for (i = 0; i < data_recs; i++)
+	{
+		hawk_uint32_t r1 = next_rand(&seed), r2 = next_rand(&seed), r3 = next_rand(&seed);
+		n = fprintf(fp, "%s%u %u %u.%02u key%u/%s %s %s text %u\n",
+			words[r1 % HAWK_COUNTOF(words)], (unsigned int)(r1 % 1000),
+			(unsigned int)(r2 % 100000), (unsigned int)(r3 % 10000), (unsigned int)(r3 % 100),
+			(unsigned int)(r2 % (data_recs / 4 + 1)), words[r2 % HAWK_COUNTOF(words)],
+			words[r3 % HAWK_COUNTOF(words)], words[(r1 + r3) % HAWK_COUNTOF(words)],
+			(unsigned int)i);
+		if (n <= 0) break;
+		data_bytes += n;
+	}
+
+	if (fclose(fp) != 0 || i < data_recs)
+	{
+		fprintf(stderr, "cannot write %s\n", data_file);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static int run_hawk (const bench_t* b, double* secs, hawk_oow_t* recs, hawk_oow_t* bytes)
+{
+	hawk_t* hawk;
+	hawk_rtx_t* rtx = HAWK_NULL;
+	hawk_parsestd_t psin[2];
+	hawk_bch_t* icf[2];
+	hawk_bch_t* ocf[2];
+	hawk_val_t* retv;
+	double start;
+	int ret = -1;
+
+	hawk = hawk_openstd(0, HAWK_NULL);
+	if (!hawk) return -1;
+
+	memset(psin, 0, HAWK_SIZEOF(psin));
+	psin[0].type = HAWK_PARSESTD_BCS;
+	psin[0].u.bcs.ptr = (hawk_bch_t*)b->script;
+	psin[0].u.bcs.len = hawk_count_bcstr(b->script);
+	psin[1].type = HAWK_PARSESTD_NULL;
+	if (hawk_parsestd(hawk, psin, HAWK_NULL) <= -1)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_geterrbmsg(hawk));
+		goto oops;
+	}
+
+	icf[0] = (hawk_bch_t*)data_file;
+	icf[1] = HAWK_NULL;
+	ocf[0] = (hawk_bch_t*)"/dev/null";
+	ocf[1] = HAWK_NULL;
+	rtx = hawk_rtx_openstdwithbcstr(hawk, 0, "bench", icf, ocf, HAWK_NULL);
+	if (!rtx)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_geterrbmsg(hawk));
+		goto oops;
+	}
+
+	start = get_secs();
+	retv = hawk_rtx_loop(rtx);
+	*secs = get_secs() - start;
+	if (!retv)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_rtx_geterrbmsg(rtx));
+		goto oops;
+	}
+	hawk_rtx_refdownval(rtx, retv);
+
+	*recs = data_recs;
+	*bytes = data_bytes;
+	ret = 0;
+
+oops:
+	if (rtx) hawk_rtx_close(rtx);
+	hawk_close(hawk);
+	return ret;
+}
+
+static int run_htb (const bench_t* b, double* secs, hawk_oow_t* recs, hawk_oow_t* bytes)
+{
+	hawk_t* hawk;
+	hawk_htb_t* htb = HAWK_NULL;
+	hawk_bch_t* keys = HAWK_NULL;
+	hawk_oow_t i, found = 0, klen = 16;
+	double start;
+	int ret = -1;
+
+	hawk = hawk_openstd(0, HAWK_NULL);
+	if (!hawk) return -1;
+
+	keys = (hawk_bch_t*)malloc(data_recs * klen);
+	if (!keys) goto oops;
+	for (i = 0; i < data_recs; i++) sprintf(&keys[i * klen], "key%012lx", (unsigned long)(i * 7919)); /* 15 characters */
+
+	htb = hawk_htb_open(hawk_getgem(hawk), 0, 128, 70, 1, 1);
+	if (!htb) goto oops;
+	hawk_htb_setstyle(htb, hawk_get_htb_style(HAWK_HTB_STYLE_DEFAULT));
+
+	start = get_secs();
+	for (i = 0; i < data_recs; i++)
+	{
+		if (!hawk_htb_upsert(htb, &keys[i * klen], 15, HAWK_NULL, 0)) goto oops;
+	}
+	for (i = 0; i < data_recs; i++)
+	{
+		if (hawk_htb_search(htb, &keys[((i * 31) % data_recs) * klen], 15)) found++;
+	}
+	*secs = get_secs() - start;
+
+	if (found != data_recs)
+	{
+		fprintf(stderr, "%s: %lu keys missing\n", b->name, (unsigned long)(data_recs - found));
+		goto oops;
+	}
+
+	*recs = data_recs * 2; /* insertions and lookups */
+	*bytes = data_recs * 2 * 15;
+	ret = 0;
+
+oops:
+	if (htb) hawk_htb_close(htb);
+	if (keys) free(keys);
+	hawk_close(hawk);
+	return ret;
+}
+
+static int run_sed (const bench_t* b, double* secs, hawk_oow_t* recs, hawk_oow_t* bytes)
+{
+	hawk_sed_t* sed;
+	hawk_sed_iostd_t script[2], in[2], out;
+	hawk_oow_t count;
+	double start;
+	int ret = -1;
+
+	sed = hawk_sed_openstd(0, HAWK_NULL);
+	if (!sed) return -1;
+
+	memset(script, 0, HAWK_SIZEOF(script));
+	script[0].type = HAWK_SED_IOSTD_BCS;
+	script[0].u.bcs.ptr = (hawk_bch_t*)b->script;
+	script[0].u.bcs.len = hawk_count_bcstr(b->script);
+	script[1].type = HAWK_SED_IOSTD_NULL;
+	if (hawk_sed_compstd(sed, script, &count) <= -1)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_sed_geterrbmsg(sed));
+		goto oops;
+	}
+
+	memset(in, 0, HAWK_SIZEOF(in));
+	in[0].type = HAWK_SED_IOSTD_FILEB;
+	in[0].u.fileb.path = data_file;
+	in[1].type = HAWK_SED_IOSTD_NULL;
+	memset(&out, 0, HAWK_SIZEOF(out));
+	out.type = HAWK_SED_IOSTD_FILEB;
+	out.u.fileb.path = "/dev/null";
+
+	start = get_secs();
+	if (hawk_sed_execstd(sed, in, &out) <= -1)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_sed_geterrbmsg(sed));
+		goto oops;
+	}
+	*secs = get_secs() - start;
+
+	*recs = data_recs;
+	*bytes = data_bytes;
+	ret = 0;
+
+oops:
+	hawk_sed_close(sed);
+	return ret;
+}
+
+static int run_cut (const bench_t* b, double* secs, hawk_oow_t* recs, hawk_oow_t* bytes)
+{
+	hawk_cut_t* cut;
+	hawk_cut_iostd_t script[2], in[2], out;
+	hawk_oow_t count;
+	double start;
+	int ret = -1;
+
+	cut = hawk_cut_openstd(0, HAWK_NULL);
+	if (!cut) return -1;
+
+	memset(script, 0, HAWK_SIZEOF(script));
+	script[0].type = HAWK_CUT_IOSTD_BCS;
+	script[0].u.bcs.ptr = (hawk_bch_t*)b->script;
+	script[0].u.bcs.len = hawk_count_bcstr(b->script);
+	script[1].type = HAWK_CUT_IOSTD_NULL;
+	if (hawk_cut_compstd(cut, script, &count) <= -1)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_cut_geterrbmsg(cut));
+		goto oops;
+	}
+
+	memset(in, 0, HAWK_SIZEOF(in));
+	in[0].type = HAWK_CUT_IOSTD_FILEB;
+	in[0].u.fileb.path = data_file;
+	in[1].type = HAWK_CUT_IOSTD_NULL;
+	memset(&out, 0, HAWK_SIZEOF(out));
+	out.type = HAWK_CUT_IOSTD_FILEB;
+	out.u.fileb.path = "/dev/null";
+
+	start = get_secs();
+	if (hawk_cut_execstd(cut, in, &out) <= -1)
+	{
+		fprintf(stderr, "%s: %s\n", b->name, hawk_cut_geterrbmsg(cut));
+		goto oops;
+	}
+	*secs = get_secs() - start;
+
+	*recs = data_recs;
+	*bytes = data_bytes;
+	ret = 0;
+
+oops:
+	hawk_cut_close(cut);
+	return ret;
+}
+
+/* ------------------------------------------------------------------------ */
+
+static bench_t benches[] =
+{
+	/* record reading and field splitting in rec.c */
+	{ "split",        run_hawk, "{ n += NF; }" },
+	{ "split-char",   run_hawk, "BEGIN { FS = \"/\"; } { n += NF; }" },
+	{ "split-regex",  run_hawk, "BEGIN { FS = \"[ /.]+\"; } { n += NF; }" },
+	/* regular expression matching with tre */
+	{ "regex",        run_hawk, "/key[0-9]*7\\/(alpha|golf) [a-z]+ lima/ { c++; }" },
+	{ "regex-field",  run_hawk, "$5 ~ /^(bravo|kilo|lima)$/ { c++; }" },
+	/* map insertion and lookup */
+	{ "map-insert",   run_hawk, "{ m[$4] = $2; }" },
+	{ "map-count",    run_hawk, "{ m[$5]++; } END { for (k in m) n += m[k]; }" },
+	{ "htb",          run_htb,  HAWK_NULL },
+	/* output formatting */
+	{ "print",        run_hawk, "{ print $1, $3, $2; }" },
+	{ "printf",       run_hawk, "{ printf \"%-10s %6d %10.2f %s\\n\", $1, $2, $3, $4; }" },
+	/* sed substitution and cut field selection */
+	{ "sed",          run_sed,  "s/key[0-9]*/K/g" },
+	{ "cut",          run_cut,  "d f1,3-4" },
+};
+
+static int is_selected (const hawk_bch_t* name, int argc, char* argv[], int first)
+{
+	int i;
+	if (first >= argc) return 1;
+	for (i = first; i < argc; i++)
+	{
+		if (strcmp(argv[i], name) == 0) return 1;
+	}
+	return 0;
+}
+
+int main (int argc, char* argv[])
+{
+	hawk_oow_t i, repeat = 3;
+	int first, failed = 0;
+
+	for (first = 1; first < argc; first++)
+	{
+		if (strcmp(argv[first], "-n") == 0 && first + 1 < argc) data_recs = strtoul(argv[++first], HAWK_NULL, 10);
+		else if (strcmp(argv[first], "-r") == 0 && first + 1 < argc) repeat = strtoul(argv[++first], HAWK_NULL, 10);
+		else if (strcmp(argv[first], "-d") == 0 && first + 1 < argc) data_file = argv[++first];
+		else break;
+	}
+	if (data_recs == 0) data_recs = 1;
+	if (repeat == 0) repeat = 1;
+
+	if (make_data() <= -1) return 1;
+
+	printf("{\"package\":\"%s\",\"records\":%lu,\"bytes\":%lu,\"repeat\":%lu}\n",
+		HAWK_PACKAGE_VERSION, (unsigned long)data_recs, (unsigned long)data_bytes, (unsigned long)repeat);
+
+	for (i = 0; i < HAWK_COUNTOF(benches); i++)
+	{
+		const bench_t* b = &benches[i];
+		double best = 0, secs;
+		hawk_oow_t r, recs = 0, bytes = 0;
+
+		if (!is_selected(b->name, argc, argv, first)) continue;
+
+		for (r = 0; r < repeat; r++)
+		{
+			if (b->run(b, &secs, &recs, &bytes) <= -1) break;
+			if (r == 0 || secs < best) best = secs;
+		}
+		if (r < repeat)
+		{
+			fprintf(stderr, "%s: failed\n", b->name);
+			failed = 1;
+			continue;
+		}
+		if (best <= 0) best = 1e-9;
+
+		printf("{\"bench\":\"%s\",\"records\":%lu,\"bytes\":%lu,\"seconds\":%.6f,\"records_per_sec\":%.0f,\"mb_per_sec\":%.3f}\n",
+			b->name, (unsigned long)recs, (unsigned long)bytes, best,
+			(double)recs / best, (double)bytes / best / (1024.0 * 1024.0));
+		fflush(stdout);
+	}
+
+	remove(data_file);
+	return failed;
+}
@@ -0,0 +1,156 @@
+#!/bin/sh
+
+[ $# -ge 1 ] && HAWK_BIN="$1"
+[ -z "$HAWK_BIN" ] && HAWK_BIN="hawk"
+
+set -u
+
+hawk_lib_path="${LD_LIBRARY_PATH-}"
+case "$HAWK_BIN" in
+*/.libs/*)
+	libdir=$(cd "$(dirname "$HAWK_BIN")/../../lib/.libs" 2>/dev/null && pwd)
+	if [ -n "${libdir-}" ]
+	then
+		if [ -n "$hawk_lib_path" ]
+		then
+			hawk_lib_path="$libdir:$hawk_lib_path"
+		else
+			hawk_lib_path="$libdir"
+		fi
+	fi
+	;;
+esac
+export LD_LIBRARY_PATH="$hawk_lib_path"
+
+srcdir=$(cd "$(dirname "$0")" && pwd)
+tmp_prog="/tmp/hawk-regress-compile-$$.hawk"
+tmp_in="/tmp/hawk-regress-compile-$$.in"
+tmp_out="/tmp/hawk-regress-compile-$$.hawkc"
+tmp_inc="/tmp/hawk-regress-compile-$$.inc"
+trap 'rm -f "$tmp_prog" "$tmp_in" "$tmp_out" "$tmp_inc"' EXIT
+
+cat > "$tmp_prog" <<'EOF'
+@pragma entry main
+@global G = 10;
+@const C = "cst";
+
+function add(a, b) { return a + b; }
+function fact(n) { return n <= 1? 1: n * fact(n - 1); }
+function swap(&a, &b, t) { t = a; a = b; b = t; }
+
+function main(x, y)
+{
+	f = function(z) { return z * 3; };
+	x = 1; y = 2; swap(x, y);
+	printf("%d %d %s %d %d %d\n", x, y, C, add(G, 5), f(4), fact(5));
+
+	while ((getline line) > 0)
+	{
+		split(line, fld, ":");
+		switch (fld[1])
+		{
+		case "a": print "A"; break;
+		case 1: print "one"; break;
+		default: print "def", str::length(fld[1]), toupper(fld[1]);
+		}
+		if (line ~ /^[0-9]+$/) n += line;
+		arr[fld[1], NR] = NR;
+	}
+
+	for (k in arr) cnt++;
+	printf("%d %d %.3f %s %d %s\n", n, cnt, sin(1), substr("hello", 2, 3), 0x10, @b"xy");
+	i = 0; do { i++; } while (i < 3);
+	print i, 1.5e2, (i > 2? "big": "small"), gsub(/l+/, "L", s = "hello"), s;
+}
+EOF
+
+printf 'a\nb\n1\nc:x\n42\n' > "$tmp_in"
+
+test_no=0
+failed=0
+
+ok() {
+	test_no=$((test_no + 1))
+	echo "ok $test_no - $1"
+}
+
+not_ok() {
+	test_no=$((test_no + 1))
+	failed=1
+	echo "not ok $test_no - $1"
+	echo "# expected: $2"
+	echo "# actual: $3"
+}
+
+check_eq() {
+	desc="$1"
+	expected="$2"
+	actual="$3"
+	if [ "x$actual" = "x$expected" ]
+	then
+		ok "$desc"
+	else
+		not_ok "$desc" "$expected" "$actual"
+	fi
+}
+
+echo "1..10"
+
+expected=$("$HAWK_BIN" -f "$tmp_prog" < "$tmp_in" 2>&1)
+
+if out=$("$HAWK_BIN" --compile-to="$tmp_out" -f "$tmp_prog" < "$tmp_in" 2>&1) && [ -z "$out" ] && [ -s "$tmp_out" ]
+then
+	ok "compile without running"
+else
+	not_ok "compile without running" "empty output and a compiled file" "$out"
+fi
+
+actual=$("$HAWK_BIN" -f "$tmp_out" < "$tmp_in" 2>&1)
+check_eq "compiled program gives the same output" "$expected" "$actual"
+
+actual=$("$HAWK_BIN" -f "$tmp_out" < "$tmp_in" 2>&1)
+check_eq "compiled program can be run again" "$expected" "$actual"
+
+"$HAWK_BIN" -vTDIR="$srcdir" --compile-to="$tmp_out" -f "$srcdir/h-009.hawk" 2>&1
+expected=$("$HAWK_BIN" -vTDIR="$srcdir" -f "$srcdir/h-009.hawk" < /dev/null 2>&1)
+actual=$("$HAWK_BIN" -vTDIR="$srcdir" -f "$tmp_out" < /dev/null 2>&1)
+check_eq "compiled test script gives the same output" "$expected" "$actual"
+
+if out=$("$HAWK_BIN" -f "$tmp_out" < /dev/null 2>&1)
+then
+	not_ok "different global variables rejected" "failure" "$out"
+else
+	ok "different global variables rejected"
+fi
+
+"$HAWK_BIN" --compile-to="$tmp_out" -f "$tmp_prog"
+printf 'x' >> "$tmp_out"
+if out=$("$HAWK_BIN" -f "$tmp_out" < "$tmp_in" 2>&1)
+then
+	not_ok "damaged file rejected" "failure" "$out"
+else
+	ok "damaged file rejected"
+fi
+
+actual=$("$HAWK_BIN" --compile-to="$tmp_out" 'BEGIN { print "x"; }' 2>&1 && "$HAWK_BIN" -f "$tmp_out" 2>&1)
+check_eq "compile a source string" "x" "$actual"
+
+## the sources changed after compiling are parsed again
+printf '@include "%s";\nBEGIN { print "old", inc(); }\n' "$tmp_inc" > "$tmp_prog"
+printf 'function inc() { return "inc1"; }\n' > "$tmp_inc"
+"$HAWK_BIN" --compile-to="$tmp_out" -f "$tmp_prog"
+printf '@include "%s";\nBEGIN { print "new", inc(); }\n' "$tmp_inc" > "$tmp_prog"
+actual=$("$HAWK_BIN" -f "$tmp_out" 2>&1)
+check_eq "changed source parsed again" "new inc1" "$actual"
+
+"$HAWK_BIN" --compile-to="$tmp_out" -f "$tmp_prog"
+printf 'function inc() { return "inc2"; }\n' > "$tmp_inc"
+actual=$("$HAWK_BIN" -f "$tmp_out" 2>&1)
+check_eq "changed included file parsed again" "new inc2" "$actual"
+
+"$HAWK_BIN" --compile-to="$tmp_out" -f "$tmp_prog"
+rm -f "$tmp_prog" "$tmp_inc"
+actual=$("$HAWK_BIN" -f "$tmp_out" 2>&1)
+check_eq "compiled program runs without the sources" "new inc2" "$actual"
+
+exit "$failed"
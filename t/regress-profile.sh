@@ -0,0 +1,94 @@
+#!/bin/sh
+
+[ $# -ge 1 ] && HAWK_BIN="$1"
+[ -z "$HAWK_BIN" ] && HAWK_BIN="hawk"
+
+set -u
+
+hawk_lib_path="${LD_LIBRARY_PATH-}"
+case "$HAWK_BIN" in
+*/.libs/*)
+	libdir=$(cd "$(dirname "$HAWK_BIN")/../../lib/.libs" 2>/dev/null && pwd)
+	if [ -n "${libdir-}" ]
+	then
+		if [ -n "$hawk_lib_path" ]
+		then
+			hawk_lib_path="$libdir:$hawk_lib_path"
+		else
+			hawk_lib_path="$libdir"
+		fi
+	fi
+	;;
+esac
+export LD_LIBRARY_PATH="$hawk_lib_path"
+
+tmp_prog="/tmp/hawk-regress-profile-$$.hawk"
+tmp_out="/tmp/hawk-regress-profile-$$.out"
+trap 'rm -f "$tmp_prog" "$tmp_out" "$tmp_out.folded"' EXIT
+
+cat > "$tmp_prog" <<'EOF'
+function fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }
+function cat(n, i, s) { for (i = 0; i < n; i++) s = s "x"; return length(s); }
+BEGIN { print fib(10), cat(100); }
+/a/ { c++; }
+END { print c + 0; }
+EOF
+
+test_no=0
+failed=0
+
+ok() {
+	test_no=$((test_no + 1))
+	echo "ok $test_no - $1"
+}
+
+not_ok() {
+	test_no=$((test_no + 1))
+	failed=1
+	echo "not ok $test_no - $1"
+	echo "# expected: $2"
+	echo "# actual: $3"
+}
+
+check_eq() {
+	desc="$1"
+	expected="$2"
+	actual="$3"
+	if [ "x$actual" = "x$expected" ]
+	then
+		ok "$desc"
+	else
+		not_ok "$desc" "$expected" "$actual"
+	fi
+}
+
+check_match() {
+	desc="$1"
+	pattern="$2"
+	file="$3"
+	if grep -E "$pattern" "$file" > /dev/null 2>&1
+	then
+		ok "$desc"
+	else
+		not_ok "$desc" "$pattern" "$(cat "$file" 2>/dev/null)"
+	fi
+}
+
+echo "1..8"
+
+expected=$(printf 'a\nb\na\n' | "$HAWK_BIN" -f "$tmp_prog" 2>&1)
+actual=$(printf 'a\nb\na\n' | "$HAWK_BIN" --profile="$tmp_out" -f "$tmp_prog" 2>&1)
+check_eq "profiling doesn't change the output" "$expected" "$actual"
+
+check_match "report header" "^# total [0-9]+\.[0-9]+ ms$" "$tmp_out"
+check_match "recursive function" "^ +177 +[0-9.]+ +[0-9.]+ +0 +0  fib \(.*:1\)$" "$tmp_out"
+check_match "function allocations" "^ +1 +[0-9.]+ +[0-9.]+ +[1-9][0-9]* +[1-9][0-9]*  cat \(.*:2\)$" "$tmp_out"
+check_match "pattern-action block" "^ +3 +[0-9.]+ +[0-9.]+ +[0-9]+ +[0-9]+  pattern \(.*:4\)$" "$tmp_out"
+check_match "source line" "^ +102 +[0-9.]+ +[0-9.]+ +[0-9]+ +[0-9]+  .*:2$" "$tmp_out"
+check_match "folded call path" "^BEGIN@.*:3;fib;fib [0-9]+$" "$tmp_out.folded"
+
+actual=$("$HAWK_BIN" --profile=/nonexistent/dir/file 'BEGIN { print "x"; }' 2>/dev/null; echo "$?")
+check_eq "unwritable profile file" "x
+255" "$actual"
+
+exit "$failed"
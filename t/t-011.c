@@ -0,0 +1,90 @@
+/* test number conversion functions */
+
+#include <hawk-utl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tap.h"
+
+#define OK_X(test) OK(test, #test)
+
+static int to_num (const char* str, int nopartial, hawk_int_t* l, hawk_flt_t* r)
+{
+	hawk_uch_t ubuf[64];
+	hawk_int_t ul, bl;
+	hawk_flt_t ur, br;
+	hawk_oow_t i, len;
+	int un, bn;
+
+	len = strlen(str);
+	for (i = 0; i < len; i++) ubuf[i] = str[i];
+
+	/* the wide and byte versions must agree */
+	un = hawk_uchars_to_num(HAWK_OOCHARS_TO_NUM_MAKE_OPTION(nopartial, 0, 0, 0), ubuf, len, &ul, &ur);
+	bn = hawk_bchars_to_num(HAWK_OOCHARS_TO_NUM_MAKE_OPTION(nopartial, 0, 0, 0), str, len, &bl, &br);
+	if (un != bn) return -9;
+	if (un == 0 && ul != bl) return -9;
+	if (un == 1 && ur != br) return -9;
+
+	*l = ul;
+	*r = ur;
+	return un;
+}
+
+static hawk_flt_t ref_flt (const char* str)
+{
+#if (HAWK_SIZEOF_FLT_T == HAWK_SIZEOF_LONG_DOUBLE)
+	return (hawk_flt_t)strtold(str, HAWK_NULL);
+#else
+	return (hawk_flt_t)strtod(str, HAWK_NULL);
+#endif
+}
+
+int main ()
+{
+	static const char* ints[] =
+	{
+		"0", "7", "-7", "+42", "12345678", "-12345678", "123456789",
+		"1234567890123456", "9223372036854775807", "-9223372036854775807",
+		"100000000000000000"
+	};
+	static const char* flts[] =
+	{
+		"0.5", ".5", "-.25", "5.", "3.14159", "-2.5e3", "1e5", "1E-5",
+		"0.1", "0.3", "123456.789", "9007199254740991e-3", "12345678.87654321",
+		"1.797693134862315e22", "4.35e-22", "0e10", "-0.0"
+	};
+	hawk_int_t l;
+	hawk_flt_t r;
+	hawk_oow_t i;
+
+	no_plan ();
+
+	for (i = 0; i < HAWK_COUNTOF(ints); i++)
+	{
+		OK (to_num(ints[i], 1, &l, &r) == 0 && l == (hawk_int_t)strtoll(ints[i], HAWK_NULL, 10), ints[i]);
+	}
+
+	for (i = 0; i < HAWK_COUNTOF(flts); i++)
+	{
+		OK (to_num(flts[i], 1, &l, &r) == 1 && r == ref_flt(flts[i]), flts[i]);
+	}
+
+	/* the general conversion must still handle these */
+	OK_X(to_num("0x1F", 1, &l, &r) == 0 && l == 31);
+	OK_X(to_num("0b101", 1, &l, &r) == 0 && l == 5);
+	OK_X(to_num("017", 1, &l, &r) == 0 && l == 15);
+	OK_X(to_num("--5", 1, &l, &r) == 0 && l == 5);
+	OK_X(to_num("12abc", 0, &l, &r) == 0 && l == 12);
+	OK_X(to_num("12abc", 1, &l, &r) == -1);
+	OK_X(to_num("1.5x", 0, &l, &r) == 1 && r == 1.5);
+	OK_X(to_num("1.5x", 1, &l, &r) == -1);
+	OK_X(to_num("1e", 1, &l, &r) == 1 && r == 1.0);
+	OK_X(to_num("1234567890123456789012", 1, &l, &r) == 0);
+	OK_X(to_num("1.5e300", 1, &l, &r) == 1 && r > 1e299);
+	OK_X(to_num("123456789012345678901.5", 1, &l, &r) == 1 && r > 1.2e20 && r < 1.3e20);
+	OK_X(to_num("", 0, &l, &r) == 0 && l == 0);
+	OK_X(to_num("abc", 1, &l, &r) == -1);
+
+	return exit_status();
+}
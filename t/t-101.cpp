@@ -1,5 +1,6 @@
 #include <Hawk.hpp>
 #include <stdio.h>
+#include <pthread.h>
 #include "tap.h"
 
 #define OK_X(test) OK(test, #test)
@@ -53,11 +54,208 @@ static void test1()
 	//hawk.close();
 }
 
+struct pool_worker_t
+{
+	HAWK::Hawk::RunPool* pool;
+	int failures;
+};
+
+static void* pool_worker (void* arg)
+{
+	pool_worker_t* w = (pool_worker_t*)arg;
+
+	for (int i = 1; i <= 200; i++)
+	{
+		HAWK::Hawk::Run* run = w->pool->acquire();
+		if (!run) { w->failures++; continue; }
+
+		{
+			HAWK::Hawk::Value ret(run);
+			HAWK::Hawk::Value arg(run);
+			hawk_int_t x;
+
+			// g must be reset to nil each time the context is acquired
+			arg.setInt(i);
+			if (run->call("f", &ret, &arg, 1) <= -1 || ret.getInt(&x) <= -1 || x != i) w->failures++;
+			if (run->call("f", &ret, &arg, 1) <= -1 || ret.getInt(&x) <= -1 || x != i * 2) w->failures++;
+		}
+
+		w->pool->release(run);
+	}
+
+	return HAWK_NULL;
+}
+
+static void test2()
+{
+	HAWK::HawkStd hawk;
+	HAWK::Hawk::Run* run;
+	int n;
+
+	n = hawk.open();
+	OK_X(n == 0);
+
+	HAWK::HawkStd::SourceString in("@global g; function f(x) { g += x; return g; } function setfs() { FS = \":\"; NR = 10; } function getfs() { return FS NR; }");
+	OK_X(hawk.parse(in, HAWK::Hawk::Source::NONE) != HAWK_NULL);
+
+	HAWK::Hawk::RunPool pool(&hawk);
+	OK_X(pool.open(2) == 0);
+
+	// the built-in variables go back to the default values
+	run = pool.acquire();
+	OK_X(run != HAWK_NULL);
+	{
+		HAWK::Hawk::Value ret(run);
+		OK_X(run->call("setfs", &ret, HAWK_NULL, 0) == 0);
+	}
+	pool.release(run);
+	OK_X(pool.getIdleCount() == 1);
+
+	run = pool.acquire();
+	OK_X(run != HAWK_NULL);
+	OK_X(pool.getIdleCount() == 0 && pool.getBusyCount() == 1);
+	{
+		HAWK::Hawk::Value ret(run);
+		hawk_oow_t len;
+		OK_X(run->call("getfs", &ret, HAWK_NULL, 0) == 0);
+		const hawk_ooch_t* p = ret.toStr(&len);
+		OK_X(len == 2 && p[0] == ' ' && p[1] == '0');
+	}
+	pool.release(run);
+
+	pool_worker_t w[4];
+	pthread_t t[4];
+	for (int i = 0; i < 4; i++)
+	{
+		w[i].pool = &pool;
+		w[i].failures = 0;
+		pthread_create(&t[i], HAWK_NULL, pool_worker, &w[i]);
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		pthread_join(t[i], HAWK_NULL);
+		OK_X(w[i].failures == 0);
+	}
+
+	OK_X(pool.getBusyCount() == 0);
+	OK_X(pool.getIdleCount() > 0 && pool.getIdleCount() <= 2);
+	pool.close();
+}
+
+static void test3()
+{
+	HAWK::HawkStd hawk;
+	HAWK::Hawk::Run* rtx;
+	const hawk_ooch_t* sp;
+	const hawk_bch_t* bp;
+	hawk_oow_t len;
+
+	OK_X(hawk.open() == 0);
+
+	HAWK::HawkStd::SourceString in("BEGIN{}");
+	rtx = hawk.parse(in, HAWK::Hawk::Source::NONE);
+	OK_X(rtx != HAWK_NULL);
+
+	HAWK::Hawk::Value s(rtx);
+	HAWK::Hawk::Value b(rtx);
+	HAWK::Hawk::Value i(rtx);
+
+	OK_X(s.getStrView(&sp, &len) == 0 && len == 0);
+
+	s.setMbs("hello", 5);
+	OK_X(s.getMbsView(&bp, &len) == 0 && len == 5 && bp == ((hawk_val_mbs_t*)s.toVal())->val.ptr);
+	OK_X(s.getStrView(&sp, &len) <= -1);
+
+	i.setInt(1234);
+	OK_X(i.getStrView(&sp, &len) <= -1);
+	OK_X(i.getMbsView(&bp, &len) <= -1);
+	OK_X(i.getStr(&sp, &len) == 0 && len == 4);
+
+	OK_X(b.setStr(i.toStr(HAWK_NULL)) == 0);
+	OK_X(b.getStrView(&sp, &len) == 0 && len == 4 && sp == ((hawk_val_str_t*)b.toVal())->val.ptr);
+
+#if defined(HAWK_CXX_ENABLE_CXX11_MOVE)
+	// i owns a cached string conversion buffer that must travel with it
+	HAWK::Hawk::Value m(HAWK_CXX_RVREF(i));
+	OK_X(m.getType() == HAWK_VAL_INT);
+	OK_X(i.getType() == HAWK_VAL_NIL);
+	OK_X(m.getStr(&sp, &len) == 0 && len == 4 && sp[0] == '1' && sp[3] == '4');
+
+	hawk_val_t* sv = s.toVal();
+	m = HAWK_CXX_RVREF(s);
+	OK_X(m.toVal() == sv && m.getType() == HAWK_VAL_MBS);
+	OK_X(s.getType() == HAWK_VAL_NIL);
+	OK_X(m.getMbsView(&bp, &len) == 0 && len == 5 && bp[0] == 'h');
+
+	// a moved-from value can be reused
+	OK_X(s.setInt(rtx, 99) == 0 && s.toInt() == 99);
+#endif
+}
+
+static void* sys_pool_worker (void* arg)
+{
+	pool_worker_t* w = (pool_worker_t*)arg;
+
+	for (int i = 1; i <= 200; i++)
+	{
+		HAWK::Hawk::Run* run = w->pool->acquire();
+		if (!run) { w->failures++; continue; }
+
+		{
+			HAWK::Hawk::Value ret(run);
+			HAWK::Hawk::Value arg(run);
+			hawk_int_t x;
+
+			arg.setInt(i);
+			if (run->call("f", &ret, &arg, 1) <= -1 || ret.getInt(&x) <= -1 || x != i) w->failures++;
+		}
+
+		w->pool->release(run);
+	}
+
+	return HAWK_NULL;
+}
+
+static void test4()
+{
+	HAWK::HawkStd hawk;
+
+	OK_X(hawk.open() == 0);
+
+	// the sys module keeps data per context. the contexts beyond the idle
+	// limit are closed while the others are looking up their data
+	HAWK::HawkStd::SourceString in("function f(x) { return (sys::getpid() > 0 && length(sys::errmsg()) >= 0)? x: -1; }");
+	OK_X(hawk.parse(in, HAWK::Hawk::Source::NONE) != HAWK_NULL);
+
+	HAWK::Hawk::RunPool pool(&hawk);
+	OK_X(pool.open(1) == 0);
+
+	pool_worker_t w[8];
+	pthread_t t[8];
+	for (int i = 0; i < 8; i++)
+	{
+		w[i].pool = &pool;
+		w[i].failures = 0;
+		pthread_create(&t[i], HAWK_NULL, sys_pool_worker, &w[i]);
+	}
+	for (int i = 0; i < 8; i++)
+	{
+		pthread_join(t[i], HAWK_NULL);
+		OK_X(w[i].failures == 0);
+	}
+
+	OK_X(pool.getBusyCount() == 0);
+	pool.close();
+}
+
 int main()
 {
 	no_plan ();
 
 	test1();
+	test2();
+	test3();
+	test4();
 
 	return exit_status();
 }